@@ -42,6 +42,17 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
   switch (Type)
   {
     case type_work_queue_entry_noop: { InvalidCodePath(); } break;
+    case type_work_queue_entry_run_job: { InvalidCodePath(); } break; // Unwrapped by RunWorkQueueEntry
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    case type_work_queue_entry_rasterize_occluders:
+    case type_work_queue_entry_init_lod_node:
+    case type_work_queue_entry_raycast_batch:
+    case type_work_queue_entry_build_chunk_lod:
+    case type_work_queue_entry_write_back_chunk:
+    {
+      InvalidCodePath();
+    } break;
 
     case type_work_queue_entry_init_asset:
     case type_work_queue_entry_rebuild_mesh:
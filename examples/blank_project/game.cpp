@@ -29,6 +29,17 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
     // in debug mode, and does nothing in release mode (in the hopes we handle
     // whatever else happens gracefully).
     case type_work_queue_entry_noop: { InvalidCodePath(); } break;
+    case type_work_queue_entry_run_job: { InvalidCodePath(); } break; // Unwrapped by RunWorkQueueEntry
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    case type_work_queue_entry_rasterize_occluders:
+    case type_work_queue_entry_init_lod_node:
+    case type_work_queue_entry_raycast_batch:
+    case type_work_queue_entry_build_chunk_lod:
+    case type_work_queue_entry_write_back_chunk:
+    {
+      InvalidCodePath();
+    } break;
 
     case type_work_queue_entry_update_world_region:
     case type_work_queue_entry_rebuild_mesh:
@@ -48,18 +59,19 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
        else
        {
          // NOTE(Jesse): For more examples of builtin noise functions, see the 
-         // terrain_gen example
-         s32 Frequency = 50;
-         s32 Amplititude = 15;
-         s32 StartingZDepth = -5;
-         InitializeWorldChunkPerlinPlane( Thread,
-                                          Chunk,
-                                          Chunk->Dim,
-                                          0,
-                                          Frequency,
-                                          Amplititude,
-                                          StartingZDepth,
-                                          ChunkInitFlag_Noop );
+         // terrain_gen example.  The LOD clipmap samples Noise_FBM2D with
+         // these same params, so chunks and clipmap nodes line up.
+         lod_clipmap_noise *Noise = &g_TerrainNoise;
+         InitializeChunkWithNoise( Noise_FBM2D,
+                                   Thread,
+                                   Chunk,
+                                   Chunk->Dim,
+                                   0,
+                                   Noise->Frequency,
+                                   Noise->Amplitude,
+                                   Noise->zMin,
+                                   ChunkInitFlag_Noop,
+                                   (void*)&Noise->Octaves );
 
        }
 
@@ -123,6 +135,10 @@ BONSAI_API_MAIN_THREAD_INIT_CALLBACK()
 
   AllocateWorld(World, WorldCenter, WORLD_CHUNK_DIM, g_VisibleRegion);
 
+  // NOTE(Jesse): Draws the terrain out past the visible region at lower
+  // resolution, from the same noise the init_world_chunk job uses.
+  EnableLodClipmap(World, g_TerrainNoise);
+
   World->Flags = WorldFlag_WorldCenterFollowsCameraTarget;
 
   entity *CameraTarget = GetFreeEntity(EntityTable);
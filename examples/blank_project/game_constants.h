@@ -13,3 +13,7 @@ global_variable chunk_dimension
 WORLD_CHUNK_DIM = Chunk_Dimension(32, 32, 32);
 
 #endif
+
+// NOTE(Jesse): The terrain noise; chunks and the LOD clipmap both read it
+global_variable lod_clipmap_noise
+g_TerrainNoise = {.Frequency = 50, .Amplitude = 15, .zMin = -5, .Octaves = 1};
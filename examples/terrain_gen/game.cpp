@@ -215,6 +215,17 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
     // in debug mode, and does nothing in release mode (in the hopes we handle
     // whatever else happens gracefully).
     case type_work_queue_entry_noop: { InvalidCodePath(); } break;
+    case type_work_queue_entry_run_job: { InvalidCodePath(); } break; // Unwrapped by RunWorkQueueEntry
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    case type_work_queue_entry_rasterize_occluders:
+    case type_work_queue_entry_init_lod_node:
+    case type_work_queue_entry_raycast_batch:
+    case type_work_queue_entry_build_chunk_lod:
+    case type_work_queue_entry_write_back_chunk:
+    {
+      InvalidCodePath();
+    } break;
 
     case type_work_queue_entry_update_world_region:
     case type_work_queue_entry_rebuild_mesh:
@@ -267,6 +278,16 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
          /*   InitializeChunkWithNoise( Noise_FBM2D, Thread, Chunk, Chunk->Dim, 0, Frequency, Amplititude, StartingZDepth, InitFlags, (void*)&Octaves); */
          /* } */
 
+         /* { */
+         /*   // FBM heightmap params; same as FBM, but evaluated once per column */
+         /*   s32 Frequency = 300; */
+         /*   s32 Amplititude = 220; */
+         /*   s32 StartingZDepth = -200; */
+         /*   u32 Octaves = 4; */
+         /*   chunk_init_flags InitFlags = ChunkInitFlag_Noop; */
+         /*   InitializeChunkWithNoise( Noise_FBM2D_Heightmap, Thread, Chunk, Chunk->Dim, 0, Frequency, Amplititude, StartingZDepth, InitFlags, (void*)&Octaves); */
+         /* } */
+
          /* { */
          /*   // Perlin 2D Params */
          /*   s32 Frequency = 100; */
@@ -20,6 +20,17 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
   switch (Entry->Type)
   {
     case type_work_queue_entry_noop: { InvalidCodePath(); } break;
+    case type_work_queue_entry_run_job: { InvalidCodePath(); } break; // Unwrapped by RunWorkQueueEntry
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    case type_work_queue_entry_rasterize_occluders:
+    case type_work_queue_entry_init_lod_node:
+    case type_work_queue_entry_raycast_batch:
+    case type_work_queue_entry_build_chunk_lod:
+    case type_work_queue_entry_write_back_chunk:
+    {
+      InvalidCodePath();
+    } break;
 
     case type_work_queue_entry_sim_particle_system:
     case type_work_queue_entry_update_world_region:
@@ -51,11 +62,10 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
         s32 Amplititude = 50;
         s32 StartingZDepth = -1 * WORLD_CHUNK_DIM.z;
 
-        native_file DummyAsset = {};
         InitializeWorldChunkPerlinPlane( Thread,
                                          Chunk,
                                          WORLD_CHUNK_DIM,
-                                         &DummyAsset,
+                                         0,
                                          Frequency,
                                          Amplititude,
                                          StartingZDepth,
@@ -25,6 +25,17 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
   switch (Entry->Type)
   {
     case type_work_queue_entry_noop: { InvalidCodePath(); } break;
+    case type_work_queue_entry_run_job: { InvalidCodePath(); } break; // Unwrapped by RunWorkQueueEntry
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    case type_work_queue_entry_rasterize_occluders:
+    case type_work_queue_entry_init_lod_node:
+    case type_work_queue_entry_raycast_batch:
+    case type_work_queue_entry_build_chunk_lod:
+    case type_work_queue_entry_write_back_chunk:
+    {
+      InvalidCodePath();
+    } break;
 
     case type_work_queue_entry_init_asset:
     {
@@ -15,6 +15,14 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
   switch (Type)
   {
     InvalidCase(type_work_queue_entry_noop);
+    InvalidCase(type_work_queue_entry_run_job);
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    InvalidCase(type_work_queue_entry_rasterize_occluders);
+    InvalidCase(type_work_queue_entry_init_lod_node);
+    InvalidCase(type_work_queue_entry_raycast_batch);
+    InvalidCase(type_work_queue_entry_build_chunk_lod);
+    InvalidCase(type_work_queue_entry_write_back_chunk);
 
     case type_work_queue_entry_init_asset:
     {
@@ -24,11 +32,7 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
     case type_work_queue_entry_update_world_region:
     {
       work_queue_entry_update_world_region *Job = SafeAccess(work_queue_entry_update_world_region, Entry);
-
-      picked_voxel Location = Job->Location;
-      r32 Radius = Job->Radius;
-
-      DoWorldUpdate(&Thread->EngineResources->Plat->LowPriority, World, Job->ChunkBuffer, Job->ChunkCount, &Location, Job->MinP, Job->MaxP, Job->Op, Job->ColorIndex, Radius, Thread);
+      RunWorldUpdateJob(&Thread->EngineResources->Plat->LowPriority, World, Job, Thread);
     } break;
 
     case type_work_queue_entry_sim_particle_system:
@@ -619,6 +623,8 @@ BONSAI_API_MAIN_THREAD_CALLBACK()
                 if ( Chunk->Flags & Chunk_Queued ) { continue; }
                 /* while ( Chunk->Flags & Chunk_Queued ) { SleepMs(1); } */
                 Chunk->Flags = chunk_flag(Chunk->Flags & ~Chunk_VoxelsInitialized);
+                // NOTE(Jesse): Uniform chunks have no voxels to clear or fill
+                DecompressChunkVoxels(World, Chunk);
                 ClearWorldChunk(Chunk);
                 ZeroMemory( Chunk->Voxels, sizeof(voxel)*umm(Volume(Chunk->Dim)) );
                 Chunk->WorldP = P;
@@ -63,6 +63,14 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
   switch (Type)
   {
     InvalidCase(type_work_queue_entry_noop);
+    InvalidCase(type_work_queue_entry_run_job);
+
+    // NOTE(Jesse): Engine jobs; RunWorkQueueEntry runs these itself
+    InvalidCase(type_work_queue_entry_rasterize_occluders);
+    InvalidCase(type_work_queue_entry_init_lod_node);
+    InvalidCase(type_work_queue_entry_raycast_batch);
+    InvalidCase(type_work_queue_entry_build_chunk_lod);
+    InvalidCase(type_work_queue_entry_write_back_chunk);
 
     case type_work_queue_entry_init_asset:
     {
@@ -72,11 +80,7 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
     case type_work_queue_entry_update_world_region:
     {
       work_queue_entry_update_world_region *Job = SafeAccess(work_queue_entry_update_world_region, Entry);
-
-      picked_voxel Location = Job->Location;
-      r32 Radius = Job->Radius;
-
-      DoWorldUpdate(&Thread->EngineResources->Plat->LowPriority, World, Job->ChunkBuffer, Job->ChunkCount, &Location, Job->MinP, Job->MaxP, Job->Op, Job->ColorIndex, Radius, Thread);
+      RunWorldUpdateJob(&Thread->EngineResources->Plat->LowPriority, World, Job, Thread);
     } break;
 
     case type_work_queue_entry_sim_particle_system:
@@ -97,10 +101,6 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
       work_queue_entry_init_world_chunk *Job = SafeAccess(work_queue_entry_init_world_chunk, Entry);
       world_chunk *Chunk = Job->Chunk;
 
-#if 1
-      counted_string AssetFilename = GetAssetFilenameFor(Global_AssetPrefixPath, Chunk->WorldP, Thread->TempMemory);
-      native_file AssetFile = OpenFile(AssetFilename, "r+b");
-#endif
       {
 
         /* s32 Frequency = 0; */
@@ -119,7 +119,7 @@ BONSAI_API_WORKER_THREAD_CALLBACK()
         InitializeWorldChunkPerlinPlane( Thread,
                                          Chunk,
                                          Chunk->Dim,
-                                         &AssetFile,
+                                         &Thread->EngineResources->WorldPack,
                                          Frequency,
                                          Amplititude,
                                          StartingZDepth,
@@ -313,7 +313,7 @@ EnemyUpdate(engine_resources *Engine, entity *Enemy)
           UpdateEntityP(World, Enemy, UpdateV);
 
           // Disallow enemies moving onto other entities
-          collision_event EntityCollision = DoEntityCollisions(World, EntityTable, Enemy);
+          collision_event EntityCollision = DoEntityCollisions(World, &Engine->EntityBroadphase, Enemy);
           if (EntityCollision.Count) { Enemy->P = EnemyOriginalP; }
         }
 
@@ -542,6 +542,16 @@ BONSAI_API_MAIN_THREAD_INIT_CALLBACK()
 
   Global_AssetPrefixPath = CSz("examples/turn_based/assets");
 
+  if (!OpenWorldPack(&Resources->WorldPack, GetWorldPackFilename(Global_AssetPrefixPath, GetTranArena()), Memory))
+  {
+    Warn("Unable to open world pack in (%S)", Global_AssetPrefixPath);
+  }
+
+  if (!OpenWorldEditJournal(&Resources->WorldEdits, GetWorldEditsFilename(Global_AssetPrefixPath, Memory)))
+  {
+    Warn("Unable to load world edits in (%S)", Global_AssetPrefixPath);
+  }
+
   world_position WorldCenter = World_Position(0);
   canonical_position PlayerSpawnP = Canonical_Position(Voxel_Position(0), WorldCenter + World_Position(0,0,1));
 
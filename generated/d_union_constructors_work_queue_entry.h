@@ -70,5 +70,59 @@ WorkQueueEntry(work_queue_entry_sim_particle_system A)
   };
   return Reuslt;
 }
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_write_back_chunk A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_write_back_chunk,
+    .work_queue_entry_write_back_chunk = A
+  };
+  return Reuslt;
+}
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_run_job A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_run_job,
+    .work_queue_entry_run_job = A
+  };
+  return Reuslt;
+}
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_rasterize_occluders A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_rasterize_occluders,
+    .work_queue_entry_rasterize_occluders = A
+  };
+  return Reuslt;
+}
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_init_lod_node A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_init_lod_node,
+    .work_queue_entry_init_lod_node = A
+  };
+  return Reuslt;
+}
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_raycast_batch A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_raycast_batch,
+    .work_queue_entry_raycast_batch = A
+  };
+  return Reuslt;
+}
+link_internal work_queue_entry
+WorkQueueEntry(work_queue_entry_build_chunk_lod A)
+{
+  work_queue_entry Reuslt = {
+    .Type = type_work_queue_entry_build_chunk_lod,
+    .work_queue_entry_build_chunk_lod = A
+  };
+  return Reuslt;
+}
 
 
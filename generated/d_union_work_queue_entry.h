@@ -9,6 +9,12 @@ enum work_queue_entry_type
   type_work_queue_entry_update_world_region,
   type_work_queue_entry_rebuild_mesh,
   type_work_queue_entry_sim_particle_system,
+  type_work_queue_entry_write_back_chunk,
+  type_work_queue_entry_run_job,
+  type_work_queue_entry_rasterize_occluders,
+  type_work_queue_entry_init_lod_node,
+  type_work_queue_entry_raycast_batch,
+  type_work_queue_entry_build_chunk_lod,
 };
 
 struct work_queue_entry
@@ -25,6 +31,12 @@ struct work_queue_entry
     struct work_queue_entry_update_world_region work_queue_entry_update_world_region;
     struct work_queue_entry_rebuild_mesh work_queue_entry_rebuild_mesh;
     struct work_queue_entry_sim_particle_system work_queue_entry_sim_particle_system;
+    struct work_queue_entry_write_back_chunk work_queue_entry_write_back_chunk;
+    struct work_queue_entry_run_job work_queue_entry_run_job;
+    struct work_queue_entry_rasterize_occluders work_queue_entry_rasterize_occluders;
+    struct work_queue_entry_init_lod_node work_queue_entry_init_lod_node;
+    struct work_queue_entry_raycast_batch work_queue_entry_raycast_batch;
+    struct work_queue_entry_build_chunk_lod work_queue_entry_build_chunk_lod;
   };
 };
 
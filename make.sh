@@ -388,6 +388,14 @@ function RunPoof
 
 TESTS_TO_BUILD="
   $TESTS/chunk.cpp
+  $TESTS/chunk_hashtable.cpp
+  $TESTS/chunk_format.cpp
+  $TESTS/work_queue.cpp
+  $TESTS/frustum_cull.cpp
+  $TESTS/occlusion.cpp
+  $TESTS/lod_clipmap.cpp
+  $TESTS/raycast.cpp
+  $TESTS/entity_collision.cpp
 "
 
 #   $TESTS/ui_command_buffer.cpp
@@ -37,6 +37,36 @@ precision highp sampler3D;
 #define SCR_WIDTH (3840/SCREEN_RATIO)
 #define SCR_HEIGHT (2160/SCREEN_RATIO)
 
+// Note(Jesse): Must match corresponding C++ define
+#define PACKED_CHUNK_VERTEX_PRECISION (64.0f)
+#define PACKED_CHUNK_VERTEX_BIAS      (64.0f)
+
+// Note(Jesse): Ordering must match GetPackedNormalIndex
+vec3 PackedChunkVertexNormals[6] = vec3[](
+   vec3(  1.0,  0.0,  0.0 ),
+   vec3( -1.0,  0.0,  0.0 ),
+   vec3(  0.0,  1.0,  0.0 ),
+   vec3(  0.0, -1.0,  0.0 ),
+   vec3(  0.0,  0.0,  1.0 ),
+   vec3(  0.0,  0.0, -1.0 )
+);
+
+// The packed_chunk_vertex u16s arrive as (exact) floats
+vec3 UnpackChunkVertexPosition(vec4 Packed)
+{
+  return (Packed.xyz / PACKED_CHUNK_VERTEX_PRECISION) - PACKED_CHUNK_VERTEX_BIAS;
+}
+
+int UnpackChunkVertexColorIndex(vec4 Packed)
+{
+  return int(Packed.w) & 0xff;
+}
+
+vec3 UnpackChunkVertexNormal(vec4 Packed)
+{
+  return PackedChunkVertexNormals[(int(Packed.w) >> 8) & 0x7];
+}
+
 #define PoissonDiskSize 16
 vec2 poissonDisk[PoissonDiskSize] = vec2[](
    vec2( -0.94201624, -0.39906216 ),
@@ -49,15 +49,36 @@ struct engine_resources
   memory_arena *Memory;
 
   entity **EntityTable;
+  entity_broadphase EntityBroadphase;
 
   u64 FrameIndex;
 
+  // NOTE(Jesse): The jobs that have to be done before the frame renders, and
+  // the memory they're allocated from.  Both are reset in Bonsai_FrameBegin.
+  work_counter FrameJobs;
+  memory_arena *FrameJobMemory;
+
+  worker_parking *WorkerParking;
+
+  // NOTE(Jesse): The game's worker callback, so the main thread can help run
+  // jobs while engine code waits on them.  Set by the loader every time the
+  // game lib is loaded.
+  bonsai_worker_thread_callback GameWorkerThreadCallback;
+
   // TODO(Jesse): Formalize this
   /* world_position *VisibleRegion; */
 
   entity *CameraTarget;
 
   tiered_mesh_freelist MeshFreelist;
+  packed_chunk_mesh_freelist PackedMeshFreelist;
+
+  // NOTE(Jesse): Chunk assets, mapped once for the lifetime of the game
+  world_pack WorldPack;
+
+  // NOTE(Jesse): Chunks the player has changed; these take precedence over
+  // the pack and the noise
+  world_edits WorldEdits;
 
   renderer_2d GameUiRenderer;
 
@@ -569,6 +590,7 @@ ClearWorldChunk( world_chunk *Chunk )
   Chunk->PointsToLeaveRemaining = {};
   Chunk->TriCount = {};
   Chunk->EdgeBoundaryVoxelCount = {};
+  Chunk->UniformVoxel = {};
   Chunk->StandingSpots.At = Chunk->StandingSpots.Start;
 }
 
@@ -707,8 +729,12 @@ NotFilled(voxel *Voxels, voxel_position VoxelP, chunk_dimension Dim)
 inline voxel*
 GetVoxel( world_chunk* Chunk, voxel_position VoxelP)
 {
-  s32 VoxelIndex = GetIndex(VoxelP, Chunk->Dim);
-  voxel *Result = Chunk->Voxels + VoxelIndex;
+  voxel *Result = &Chunk->UniformVoxel;
+  if (Chunk->Voxels)
+  {
+    s32 VoxelIndex = GetIndex(VoxelP, Chunk->Dim);
+    Result = Chunk->Voxels + VoxelIndex;
+  }
   return Result;
 }
 
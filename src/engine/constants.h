@@ -12,8 +12,76 @@
 // NOTE(Jesse): This should probably be dynamic by now..
 #define FREELIST_SIZE (Kilobytes(8))
 
+// NOTE(Jesse): CollectUnusedChunks visits 1/N of the resident chunks per frame
+#define WORLD_CHUNK_RESIDENT_SWEEP_FRAMES (8)
+
+// NOTE(Jesse): How many chunk init jobs each worker is allowed to have sitting
+// in the low priority queue.  Everything past that waits in
+// World->PendingInits where it can still be reordered as the camera moves.
+#define WORLD_CHUNK_INIT_JOBS_PER_WORKER (4)
+
+// NOTE(Jesse): Pending chunk inits outside the frustum are scheduled as if
+// they were this many times further away (squared)
+#define WORLD_CHUNK_INIT_OFFSCREEN_PENALTY (16.f)
+
+// NOTE(Jesse): Jobs each worker can hold in one of its own deques before
+// spilling into the shared queue.  Must be a power of two.
+#define WORK_STEALING_DEQUE_SIZE (256)
+
+// NOTE(Jesse): Pin each worker to its own logical core, so the memory it
+// keeps for itself stays on its own NUMA node
+#define PIN_WORKER_THREADS (1)
+
+// NOTE(Jesse): How many world pack records can be waiting on the reader
+// thread at once.  Must be a power of two.
+#define WORLD_PACK_STREAM_QUEUE_SIZE (1024)
+
+// NOTE(Jesse): How far along the camera's velocity the reader thread starts
+// pulling in world pack records, and the most chunks that can be on any axis
+#define WORLD_PACK_READ_AHEAD_SECONDS (1.5f)
+#define WORLD_PACK_READ_AHEAD_MAX_CHUNKS (8)
+
+// NOTE(Jesse): Edited chunks that stay resident get written back at most this
+// often, so a burst of edits to the same chunk turns into one write
+#define WORLD_EDIT_WRITE_BACK_SECONDS (5.f)
+
+// NOTE(Jesse): Buckets in the edited chunk table.  Must be a power of two.
+#define WORLD_EDIT_HASH_SIZE (4096)
+
+// NOTE(Jesse): The edit journal gets rewritten with just the live records once
+// it holds at least this many superseded ones, and they outnumber the live ones
+#define WORLD_EDIT_JOURNAL_COMPACT_THRESHOLD (256)
+
+// NOTE(Jesse): The CPU depth buffer chunks are tested against before they're
+// drawn.  The width must be a multiple of 4 and the height a multiple of the
+// band count; each band is rasterized by its own job.
+#define OCCLUSION_BUFFER_WIDTH      (256)
+#define OCCLUSION_BUFFER_HEIGHT     (128)
+#define OCCLUSION_BUFFER_BAND_COUNT (8)
+#define OCCLUSION_MAX_OCCLUDERS     (2048)
+
+// NOTE(Jesse): The LOD clipmap.  Level i is a grid of DIM nodes, each
+// covering 2^(i+1) world chunks a side at 1/2^(i+1) resolution, around the
+// world center.  Level 0 has to cover the visible region wherever the center
+// is, so the visible region can be at most (DIM-4)*2 chunks on each axis.  A
+// node is swapped for the level below it once its voxels would be bigger than
+// LOD_CLIPMAP_MAX_SCREEN_ERROR pixels on screen.  DIMs have to be even.
+#define LOD_CLIPMAP_LEVEL_COUNT       (3)
+#define LOD_CLIPMAP_DIM_XY            (16)
+#define LOD_CLIPMAP_DIM_Z             (6)
+#define LOD_CLIPMAP_MAX_IN_FLIGHT     (64)
+#define LOD_CLIPMAP_MAX_SCREEN_ERROR  (3.f)
+
+// NOTE(Jesse): Rays RaycastMany hands each worker at a time
+#define RAYCAST_BATCH_SIZE (64)
+
 #define NOISE_FREQUENCY (100L)
 
+// NOTE(Jesse): Must match TIERED_MESH_FREELIST_MAX_ELEMENTS
+#define GPU_CHUNK_SLAB_TIER_COUNT   (32)
+#define GPU_CHUNK_BUFFER_ELEMENTS   (Megabytes(32))
+#define GPU_CHUNK_MAX_DRAW_COMMANDS (Kilobytes(32))
+
 #define WORLD_GRAVITY (V3(0.0f, 0.0f, 0.0f))
 
 #define MODELS_PATH "models"
@@ -43,6 +111,12 @@
 
 #define TOTAL_ENTITY_COUNT     (1024*2)
 
+// NOTE(Jesse): Side length, in voxels, of the cells entities are filed in for
+// entity-vs-entity collision.  Anything bigger than this on an axis is tested
+// against everything.  The bucket count has to be a power of two.
+#define ENTITY_BROADPHASE_CELL_DIM     (8.f)
+#define ENTITY_BROADPHASE_BUCKET_COUNT (4096)
+
 // THIS MUST MATCH THE DEFINE IN header.glsl
 // Also must be a power of two
 #define MAX_LIGHTS 1024
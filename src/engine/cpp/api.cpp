@@ -11,6 +11,7 @@ Bonsai_OnLibraryLoad(engine_resources *Resources)
 
   Global_ThreadStates = Resources->ThreadStates;
   Global_EngineResources = Resources;
+  Global_WorkerParking = Resources->WorkerParking;
 
   // We should only ever call this from the main thread, and this sets our
   // thread index such that the game doesn't have to worry about doing it.
@@ -48,6 +49,12 @@ Bonsai_Init(engine_resources *Resources)
   InitRenderer2D(&Resources->GameUiRenderer, &Resources->Heap, GraphicsMemory2D, &Resources->Plat->MouseP, &Resources->Plat->MouseDP, &Resources->Plat->Input);
 
   Resources->EntityTable = AllocateEntityTable(BonsaiInitArena, TOTAL_ENTITY_COUNT);
+  InitEntityBroadphase(&Resources->EntityBroadphase, BonsaiInitArena);
+
+  Resources->FrameJobMemory = AllocateArena();
+  DEBUG_REGISTER_ARENA(Resources->FrameJobMemory, 0);
+
+  InitWorldEdits(&Resources->WorldEdits, BonsaiInitArena);
 
   return Result;
 }
@@ -57,11 +64,18 @@ Bonsai_FrameBegin(engine_resources *Resources)
 {
   TIMED_FUNCTION();
 
-  // Must come before we update the frame index
   CollectUnusedChunks(Resources, &Resources->MeshFreelist, Resources->World->Memory, Resources->World->VisibleRegion);
+  WriteBackDirtyChunks(Resources, Resources->Plat->dt);
 
   Resources->FrameIndex += 1;
 
+  // NOTE(Jesse): The loader waited on last frame's jobs before it rendered,
+  // so nobody is looking at these anymore.  The counter holds one count for
+  // the frame itself until Bonsai_FrameEnd is done pushing.
+  Assert(WorkCounterIsDone(&Resources->FrameJobs) || Resources->FrameIndex == 1);
+  RewindArena(Resources->FrameJobMemory);
+  InitWorkCounter(&Resources->FrameJobs, 1);
+
   // Must come before UNPACK_ENGINE_RESOURCES such that we unpack the correct GpuMap
   graphics *G = Resources->Graphics;
   G->GpuBufferWriteIndex = 0;
@@ -69,8 +83,6 @@ Bonsai_FrameBegin(engine_resources *Resources)
 
   UNPACK_ENGINE_RESOURCES(Resources);
 
-  World->ChunkHash = CurrentWorldHashtable(Resources);
-
   MapGpuElementBuffer(GpuMap);
 
   ClearFramebuffers(Graphics);
@@ -134,10 +146,17 @@ Bonsai_FrameEnd(engine_resources *Resources)
     World->Center = CameraTargetP.WorldP;
   }
 
+  UpdateWorldResidency(Resources);
+  PredictWorldPackReads(&Resources->WorldPack, World, Camera, Plat->dt);
+  DispatchChunkInitJobs(World, &Resources->WorldPack, &Plat->LowPriority, Camera);
+  if (World->Clipmap) { UpdateLodClipmap(World, &Resources->MeshFreelist, &Plat->LowPriority); }
   BufferWorld(Plat, &GpuMap->Buffer, World, Graphics, Heap);
   BufferEntities( EntityTable, &GpuMap->Buffer, Graphics, World, Plat->dt);
 
-  UnsignalFutex(&Resources->Plat->HighPriorityModeFutex);
+  // NOTE(Jesse): HighPriorityModeFutex stays signaled until the loader has
+  // waited on FrameJobs, so workers don't wander off into low priority jobs
+  // while the frame's still being built
+  SignalWorkCounter(&Resources->FrameJobs);
 
 #if DEBUG_SYSTEM_API
   Debug_DoWorldChunkPicking(Resources);
@@ -178,6 +197,7 @@ Bonsai_Render(engine_resources *Resources)
   /* Debug_DrawTextureToDebugQuad(&Graphics->gBuffer->DebugNormalShader); */
 
   GpuMap->Buffer.At = 0;
+  Graphics->ChunkBuffer.DrawCommandCount = 0;
   GL.DisableVertexAttribArray(0);
   GL.DisableVertexAttribArray(1);
   GL.DisableVertexAttribArray(2);
@@ -1,5 +1,43 @@
 
 
+link_internal world_chunk_file_header_v3
+MakeWorldChunkFileHeader_v3(world_chunk *Chunk, u32 FileFlags)
+{
+  world_chunk_file_header_v3 Result = {};
+
+  Result.WHNK = WorldChunkFileTag_WHNK;
+  Result.Version = 3;
+
+  Result.VoxelElementCount        = Volume(Chunk);
+  Result.StandingSpotElementCount = (u32)AtElements(&Chunk->StandingSpots);
+
+  if ( (FileFlags & WorldChunkFileFlag_MeshOmitted) == 0 && HasMesh(&Chunk->Meshes, MeshBit_Main))
+  {
+    // NOTE(Jesse): Meshes the world chunk meshers built are packed, and
+    // records only store float meshes, so those go out omitted and get
+    // rebuilt from the voxels on load.
+    if (Chunk->Meshes.E[MeshIndex_Main])
+    {
+      Result.MeshElementCount     = Chunk->Meshes.E[MeshIndex_Main]->At;
+    }
+    else
+    {
+      FileFlags |= WorldChunkFileFlag_MeshOmitted;
+    }
+  }
+
+  Result.VertexElementSize        = (u8)sizeof(v3);
+  Result.ColorElementSize         = (u8)sizeof(v4);
+  Result.NormalElementSize        = (u8)sizeof(v3);
+  Result.StandingSpotElementSize  = (u8)sizeof(v3i);
+  Result.VoxelElementSize         = (u8)sizeof(voxel);
+
+  Result.VoxelCodec               = VoxelCodec_RLE;
+  Result.Flags                    = (u8)FileFlags;
+
+  return Result;
+}
+
 link_internal world_chunk_file_header_v2
 MakeWorldChunkFileHeader_v2(world_chunk *Chunk)
 {
@@ -12,7 +50,7 @@ MakeWorldChunkFileHeader_v2(world_chunk *Chunk)
   Result.VoxelElementCount        = Volume(Chunk);
   Result.StandingSpotElementCount = (u32)AtElements(&Chunk->StandingSpots);
 
-  if (HasMesh(&Chunk->Meshes, MeshBit_Main))
+  if (HasMesh(&Chunk->Meshes, MeshBit_Main) && Chunk->Meshes.E[MeshIndex_Main])
   {
     Result.MeshElementCount       = Chunk->Meshes.E[MeshIndex_Main]->At;
   }
@@ -37,7 +75,7 @@ MakeWorldChunkFileHeader_v1(world_chunk *Chunk)
   Result.VoxelElementCount = Volume(Chunk);
   Result.VoxelElementSize  = (u32)sizeof(voxel);
 
-  if (HasMesh(&Chunk->Meshes, MeshBit_Main))
+  if (HasMesh(&Chunk->Meshes, MeshBit_Main) && Chunk->Meshes.E[MeshIndex_Main])
   {
     Result.MeshElementCount = Chunk->Meshes.E[MeshIndex_Main]->At;
   }
@@ -140,261 +178,1248 @@ SerializeMesh(native_file *File, untextured_3d_geometry_buffer *Mesh, world_chun
   return Result;
 }
 
-#if 0
-link_internal void*
-ReadBuffer(native_file *File, umm ByteCount, memory_arena *Memory)
+global_variable counted_string
+Global_AssetPrefixPath = CSz("");
+
+link_internal void
+ValidateWorldChunkFileHeader_v2(world_chunk_file_header_v2 *Header)
+{
+  Assert( Header->WHNK == WorldChunkFileTag_WHNK );
+  Assert( Header->Version == 2 );
+  Assert( Header->Checksum == 0xdeadbeef );
+
+  Assert( Header->VertexElementSize == sizeof(v3) );
+  Assert( Header->ColorElementSize  == sizeof(v4) );
+  Assert( Header->NormalElementSize == sizeof(v3) );
+  Assert( Header->StandingSpotElementSize  == sizeof(voxel_position) );
+  Assert( Header->VoxelElementSize  == sizeof(voxel) );
+}
+
+// NOTE(Jesse): Unlike v2 this doesn't assert; a v3 header that fails here
+// came from a bad file, not from a programming error.
+link_internal b32
+ValidateWorldChunkFileHeader_v3(world_chunk_file_header_v3 *Header)
 {
-  void* Result = 0;
-  NotImplemented;
+  b32 Result = Header->WHNK == WorldChunkFileTag_WHNK &&
+               Header->Version == 3 &&
+
+               Header->VertexElementSize == sizeof(v3) &&
+               Header->ColorElementSize  == sizeof(v4) &&
+               Header->NormalElementSize == sizeof(v3) &&
+               Header->StandingSpotElementSize  == sizeof(voxel_position) &&
+               Header->VoxelElementSize  == sizeof(voxel) &&
+
+               Header->VoxelCodec <= VoxelCodec_RLE &&
+               (Header->VoxelByteCount % sizeof(u32)) == 0;
   return Result;
 }
-#endif
 
+// NOTE(Jesse): Must agree with what SerializeChunk writes
 link_internal u64
-Read_u64(native_file *File)
+GetSerializedChunkSize(world_chunk_file_header_v3 *Header)
 {
-  u64 Result = 0;
-  Ensure(ReadBytesIntoBuffer(File, sizeof(u64), (u8*)&Result));
+  u64 Result = sizeof(*Header);
+
+  Result += sizeof(u32) + Header->VoxelByteCount;
+
+  if (Header->MeshElementCount)
+  {
+    u64 ElementSize = u64(Header->VertexElementSize) + Header->ColorElementSize + Header->NormalElementSize;
+    Result += (3*sizeof(u32)) + (u64(Header->MeshElementCount) * ElementSize);
+  }
+
+  Result += sizeof(u32) + (u64(Header->StandingSpotElementCount) * Header->StandingSpotElementSize);
+
   return Result;
 }
 
-link_internal u32
-Read_u32(native_file *File)
+//
+// Checksum
+//
+
+// NOTE(Jesse): Eight bytes at a time through a multiply/rotate mix, with the
+// tail done a byte at a time, then a final avalanche so every input bit can
+// reach every output bit.  It's there to catch truncated and bit-rotted
+// records, not to stand up to anyone trying to forge one.
+
+global_variable u64 Global_WorldChunkChecksumPrime0 = 0x9E3779B185EBCA87ull;
+global_variable u64 Global_WorldChunkChecksumPrime1 = 0xC2B2AE3D27D4EB4Full;
+global_variable u64 Global_WorldChunkChecksumPrime2 = 0x165667B19E3779F9ull;
+
+link_internal u64
+RotateLeft64(u64 Value, u32 Bits)
+{
+  u64 Result = (Value << Bits) | (Value >> (64-Bits));
+  return Result;
+}
+
+link_internal u64
+ComputeWorldChunkChecksum(u8 *Bytes, umm ByteCount)
+{
+  u64 P0 = Global_WorldChunkChecksumPrime0;
+  u64 P1 = Global_WorldChunkChecksumPrime1;
+  u64 P2 = Global_WorldChunkChecksumPrime2;
+
+  u64 Result = u64(ByteCount) * P2;
+
+  u8 *At = Bytes;
+  u8 *End = Bytes + ByteCount;
+  while (umm(End-At) >= sizeof(u64))
+  {
+    u64 Lane = *(u64*)At;
+    Result ^= RotateLeft64(Lane * P1, 31) * P0;
+    Result = (RotateLeft64(Result, 27) * P0) + P2;
+    At += sizeof(u64);
+  }
+
+  while (At < End)
+  {
+    Result ^= u64(*At) * P2;
+    Result = RotateLeft64(Result, 11) * P0;
+    ++At;
+  }
+
+  Result ^= Result >> 33;
+  Result *= P1;
+  Result ^= Result >> 29;
+  Result *= P2;
+  Result ^= Result >> 32;
+
+  return Result;
+}
+
+//
+// Voxel codec
+//
+// See the VoxelCodec_RLE layout in asset.h
+
+// NOTE(Jesse): Shorter runs than this stay in the surrounding literal packet;
+// splitting a literal packet for a run of two costs as much as it saves.
+#define VOXEL_RLE_MIN_RUN (3)
+
+CAssert(sizeof(voxel) == 2);
+
+// NOTE(Jesse): Every packet holds at least one voxel and costs at most five
+// token bytes, so this is loose, but it's only ever temp memory.
+link_internal umm
+GetEncodedVoxelByteCountBound(u32 VoxelCount)
+{
+  umm Result = (umm(VoxelCount) * (sizeof(voxel) + 5)) + sizeof(u32);
+  return Result;
+}
+
+link_internal u8 *
+WriteVarint(u8 *At, u32 Value)
+{
+  while (Value >= 0x80)
+  {
+    *At++ = u8(Value | 0x80);
+    Value >>= 7;
+  }
+  *At++ = u8(Value);
+  return At;
+}
+
+// NOTE(Jesse): Returns 0 if the varint runs off the end of the buffer or is
+// longer than a u32 can hold
+link_internal u8 *
+ReadVarint(u8 *At, u8 *End, u32 *Value)
 {
   u32 Result = 0;
-  Ensure(ReadBytesIntoBuffer(File, sizeof(u32), (u8*)&Result));
+  u8 *Next = 0;
+
+  for (u32 Shift = 0; Shift < 35 && At < End; Shift += 7)
+  {
+    u8 Byte = *At++;
+    Result |= u32(Byte & 0x7F) << Shift;
+    if ((Byte & 0x80) == 0)
+    {
+      Next = At;
+      break;
+    }
+  }
+
+  *Value = Result;
+  return Next;
+}
+
+link_internal b32
+VoxelsAreIdentical(voxel *A, voxel *B)
+{
+  b32 Result = A->Flags == B->Flags && A->Color == B->Color;
   return Result;
 }
 
-link_internal untextured_3d_geometry_buffer*
-DeserializeMesh(native_file *File, world_chunk_file_header *Header, untextured_3d_geometry_buffer *Result)
+link_internal u8 *
+WriteLiteralVoxels(u8 *At, voxel *Voxels, u32 VoxelCount)
 {
-  u64 TotalElements = Header->MeshElementCount;
+  if (VoxelCount)
+  {
+    At = WriteVarint(At, (VoxelCount << 1) | 1);
+    MemCopy((u8*)Voxels, At, VoxelCount*sizeof(voxel));
+    At += VoxelCount*sizeof(voxel);
+  }
+  return At;
+}
 
-  Assert(Result->At == 0);
-  Assert(TotalElements < Result->End);
-  Result->At = (u32)TotalElements;
+// NOTE(Jesse): Dest must hold GetEncodedVoxelByteCountBound(VoxelCount) bytes.
+// The returned size is padded out to 4 bytes so whatever follows it in a
+// record stays aligned.
+link_internal u32
+EncodeVoxels_RLE(voxel *Voxels, u32 VoxelCount, u8 *Dest)
+{
+  u8 *At = Dest;
 
-  //
-  // Vertex data
-  //
-  u32 Tag = Read_u32(File);
-  Assert(Tag ==  WorldChunkFileTag_VERT);
+  u32 LiteralStart = 0;
+  u32 VoxelIndex = 0;
+  while (VoxelIndex < VoxelCount)
+  {
+    voxel *V = Voxels + VoxelIndex;
 
-  u32 VertElementSize = Header->VertexElementSize;
-  Assert(VertElementSize == (u32)sizeof(v3));
-  ReadBytesIntoBuffer(File, VertElementSize*TotalElements, (u8*)Result->Verts);
+    u32 RunEnd = VoxelIndex + 1;
+    while (RunEnd < VoxelCount && VoxelsAreIdentical(Voxels + RunEnd, V)) { ++RunEnd; }
 
-  //
-  // Color data
-  Tag = Read_u32(File);
-  Assert(Tag == WorldChunkFileTag_COLO);
+    u32 RunLength = RunEnd - VoxelIndex;
+    if (RunLength >= VOXEL_RLE_MIN_RUN)
+    {
+      At = WriteLiteralVoxels(At, Voxels + LiteralStart, VoxelIndex - LiteralStart);
+
+      At = WriteVarint(At, RunLength << 1);
+      *(voxel*)At = *V;
+      At += sizeof(voxel);
 
-  u32 ColorElementSize = Header->ColorElementSize;
-  Assert(ColorElementSize == (u32)sizeof(v4));
-  ReadBytesIntoBuffer(File, ColorElementSize*TotalElements, (u8*)Result->Colors);
+      LiteralStart = RunEnd;
+    }
 
-  //
-  // Normal data
-  Tag = Read_u32(File);
-  Assert(Tag == WorldChunkFileTag_NORM);
+    VoxelIndex = RunEnd;
+  }
 
-  u32 NormalElementSize = Header->NormalElementSize;
-  Assert(NormalElementSize == (u32)sizeof(v3));
-  ReadBytesIntoBuffer(File, NormalElementSize*TotalElements, (u8*)Result->Normals);
+  At = WriteLiteralVoxels(At, Voxels + LiteralStart, VoxelCount - LiteralStart);
 
-  Result->Timestamp = __rdtsc();
+  while ( (umm(At-Dest) % sizeof(u32)) != 0 ) { *At++ = 0; }
 
+  u32 Result = u32(At-Dest);
+  Assert(Result <= GetEncodedVoxelByteCountBound(VoxelCount));
   return Result;
 }
 
-global_variable counted_string
-Global_AssetPrefixPath = CSz("");
+// NOTE(Jesse): Bounds-checks everything, so garbage in gets a False out
+// rather than a stomp.  Trailing padding after the last packet is ignored.
+link_internal b32
+DecodeVoxels_RLE(u8 *Src, u32 SrcByteCount, voxel *Dest, u32 VoxelCount)
+{
+  u8 *At = Src;
+  u8 *End = Src + SrcByteCount;
 
-link_internal world_chunk_file_header_v2
-ReadWorldChunkFileHeader_v2(native_file *File)
+  b32 Result = True;
+
+  u32 VoxelIndex = 0;
+  while (Result && VoxelIndex < VoxelCount)
+  {
+    u32 Token;
+    At = ReadVarint(At, End, &Token);
+
+    u32 Count = Token >> 1;
+    if (At == 0 || Count == 0 || Count > VoxelCount - VoxelIndex)
+    {
+      Result = False;
+    }
+    else if (Token & 1)
+    {
+      umm ByteCount = umm(Count)*sizeof(voxel);
+      if (umm(End-At) < ByteCount)
+      {
+        Result = False;
+      }
+      else
+      {
+        MemCopy(At, (u8*)(Dest + VoxelIndex), ByteCount);
+        At += ByteCount;
+        VoxelIndex += Count;
+      }
+    }
+    else
+    {
+      if (umm(End-At) < sizeof(voxel))
+      {
+        Result = False;
+      }
+      else
+      {
+        voxel V = *(voxel*)At;
+        At += sizeof(voxel);
+
+        voxel *Run = Dest + VoxelIndex;
+        for (u32 RunIndex = 0; RunIndex < Count; ++RunIndex) { Run[RunIndex] = V; }
+        VoxelIndex += Count;
+      }
+    }
+  }
+
+  return Result;
+}
+
+//
+// Chunk records
+//
+
+link_internal u8 *
+WriteChunkRecordBytes(u8 *At, void *Src, umm ByteCount)
 {
-  world_chunk_file_header_v2 Result = {};
+  MemCopy((u8*)Src, At, ByteCount);
+  u8 *Result = At + ByteCount;
+  return Result;
+}
+
+link_internal u8 *
+WriteChunkRecordTag(u8 *At, u32 Tag)
+{
+  u8 *Result = WriteChunkRecordBytes(At, &Tag, sizeof(Tag));
+  return Result;
+}
+
+// NOTE(Jesse): Builds a whole v3 record in Memory and returns it.  The
+// checksum covers everything after the header, so the header goes in last.
+//
+// Pass WorldChunkFileFlag_MeshOmitted to leave the mesh out; it's by far the
+// biggest part of a record and the loader can rebuild it from the voxels.
+link_internal u8 *
+SerializeChunk(world_chunk *Chunk, memory_arena *Memory, u32 FileFlags, umm *RecordSize)
+{
+  world_chunk_file_header_v3 Header = MakeWorldChunkFileHeader_v3(Chunk, FileFlags);
+
+  u64 MeshElementSize = u64(Header.VertexElementSize) + Header.ColorElementSize + Header.NormalElementSize;
+  umm MaxRecordSize = sizeof(Header) +
+                      sizeof(u32) + GetEncodedVoxelByteCountBound(Header.VoxelElementCount) +
+                      (3*sizeof(u32)) + (Header.MeshElementCount*MeshElementSize) +
+                      sizeof(u32) + (Header.StandingSpotElementCount*Header.StandingSpotElementSize);
 
-  Ensure( ReadBytesIntoBuffer(File, sizeof(Result), (u8*)&Result) );
+  u8 *Result = Allocate(u8, Memory, MaxRecordSize);
+  u8 *At = Result + sizeof(Header);
+
+  {
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_VOXD);
+    voxel *Voxels = GetDenseChunkVoxels(Chunk, GetTranArena());
+    Header.VoxelByteCount = EncodeVoxels_RLE(Voxels, Header.VoxelElementCount, At);
+    At += Header.VoxelByteCount;
+  }
+
+  if (Header.MeshElementCount)
+  {
+    auto Mesh = TakeOwnershipSync(&Chunk->Meshes, MeshBit_Main);
+    Assert(Mesh->At == Header.MeshElementCount);
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_VERT);
+    At = WriteChunkRecordBytes(At, Mesh->Verts, Header.MeshElementCount*Header.VertexElementSize);
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_COLO);
+    At = WriteChunkRecordBytes(At, Mesh->Colors, Header.MeshElementCount*Header.ColorElementSize);
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_NORM);
+    At = WriteChunkRecordBytes(At, Mesh->Normals, Header.MeshElementCount*Header.NormalElementSize);
+
+    ReleaseOwnership(&Chunk->Meshes, MeshBit_Main, Mesh);
+  }
+
+  {
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_SPOT);
+    At = WriteChunkRecordBytes(At, Chunk->StandingSpots.Start, Header.StandingSpotElementCount*Header.StandingSpotElementSize);
+  }
 
-  Assert( Result.WHNK == WorldChunkFileTag_WHNK );
-  Assert( Result.Version == 2 );
-  Assert( Result.Checksum == 0xdeadbeef );
+  *RecordSize = umm(At-Result);
+  Assert(*RecordSize <= MaxRecordSize);
+  Assert(*RecordSize == GetSerializedChunkSize(&Header));
 
-  Assert( Result.VertexElementSize == sizeof(v3) );
-  Assert( Result.ColorElementSize  == sizeof(v4) );
-  Assert( Result.NormalElementSize == sizeof(v3) );
-  Assert( Result.StandingSpotElementSize  == sizeof(voxel_position) );
-  Assert( Result.VoxelElementSize  == sizeof(voxel) );
+  Header.Checksum = ComputeWorldChunkChecksum(Result + sizeof(Header), *RecordSize - sizeof(Header));
+  MemCopy((u8*)&Header, Result, sizeof(Header));
 
   return Result;
 }
 
-link_internal world_chunk_file_header_v1
-ReadWorldChunkFileHeader_v1(native_file *File)
+//
+// World packs
+//
+
+// NOTE(Jesse): Orders chunks by z, then y, then x
+link_internal s32
+CompareWorldPackOrder(world_position A, world_position B)
 {
-  world_chunk_file_header_v1 Result = {};
+  s32 Result = 0;
+       if (A.z != B.z) { Result = A.z < B.z ? -1 : 1; }
+  else if (A.y != B.y) { Result = A.y < B.y ? -1 : 1; }
+  else if (A.x != B.x) { Result = A.x < B.x ? -1 : 1; }
+  return Result;
+}
+
+link_internal u64
+AlignToWorldPackPage(u64 Offset)
+{
+  u64 Result = (Offset + (WORLD_PACK_PAGE_SIZE-1)) & ~u64(WORLD_PACK_PAGE_SIZE-1);
+  return Result;
+}
+
+global_variable u8 Global_WorldPackZeroPage[WORLD_PACK_PAGE_SIZE];
+
+// NOTE(Jesse): Somewhere for the reader thread to put the bytes it touches so
+// the compiler can't throw the reads away
+global_variable volatile u32 Global_WorldPackFaultSink;
+
+// NOTE(Jesse): Chunks are written as v3 records; FileFlags is passed through to
+// SerializeChunk for every one of them.
+link_internal b32
+SerializeWorldPack(counted_string Filename, world_chunk **Chunks, u32 ChunkCount, u32 FileFlags)
+{
+  TIMED_FUNCTION();
+
+  b32 Result = True;
+
+  // NOTE(Jesse): Insertion sort; the packer hands us chunks in z/y/x order
+  // already, so this is a single pass in practice.
+  for (u32 ChunkIndex = 1; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks[ChunkIndex];
+
+    u32 InsertIndex = ChunkIndex;
+    while (InsertIndex > 0 && CompareWorldPackOrder(Chunk->WorldP, Chunks[InsertIndex-1]->WorldP) < 0)
+    {
+      Chunks[InsertIndex] = Chunks[InsertIndex-1];
+      --InsertIndex;
+    }
+    Chunks[InsertIndex] = Chunk;
+  }
+
+  memory_arena *TempMemory = GetTranArena();
+
+  world_pack_file_header PackHeader = {};
+  PackHeader.WPAK = WorldPackFileTag_WPAK;
+  PackHeader.Version = 1;
+  PackHeader.ChunkCount = ChunkCount;
+  PackHeader.PageSize = WORLD_PACK_PAGE_SIZE;
+
+  // NOTE(Jesse): Records are encoded up front; we don't know how big they
+  // are until the voxels have been through the codec.
+  u8 **Records = Allocate(u8*, TempMemory, ChunkCount);
+  world_pack_entry *Directory = Allocate(world_pack_entry, TempMemory, ChunkCount);
 
-  Ensure( ReadBytesIntoBuffer(File, sizeof(Result), (u8*)&Result) );
+  u64 Offset = AlignToWorldPackPage(sizeof(PackHeader) + (sizeof(world_pack_entry)*ChunkCount));
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks[ChunkIndex];
+    if (ChunkIndex) { Assert(CompareWorldPackOrder(Chunks[ChunkIndex-1]->WorldP, Chunk->WorldP) < 0); }
+
+    umm RecordSize = 0;
+    Records[ChunkIndex] = SerializeChunk(Chunk, TempMemory, FileFlags, &RecordSize);
+
+    world_pack_entry *Entry = Directory + ChunkIndex;
+    Entry->WorldP = Chunk->WorldP;
+    Entry->Offset = Offset;
+    Entry->Size = RecordSize;
+
+    Offset = AlignToWorldPackPage(Offset + Entry->Size);
+  }
+
+  native_file File = OpenFile(Filename, "w+b");
 
-  Assert( Result.WHNK == WorldChunkFileTag_WHNK );
-  Assert( Result.Version == 1 );
-  Assert( Result.Checksum == 0xdeadbeef );
+  Result &= WriteToFile(&File, (u8*)&PackHeader, sizeof(PackHeader));
+  Result &= WriteToFile(&File, (u8*)Directory, sizeof(world_pack_entry)*ChunkCount);
 
-  Assert( Result.VoxelElementSize  == sizeof(voxel) );
-  Assert( Result.VertexElementSize == sizeof(v3) );
-  Assert( Result.ColorElementSize  == sizeof(v4) );
-  Assert( Result.NormalElementSize == sizeof(v3) );
+  u64 At = sizeof(PackHeader) + (sizeof(world_pack_entry)*ChunkCount);
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_pack_entry *Entry = Directory + ChunkIndex;
+
+    Assert(Entry->Offset >= At);
+    Assert(Entry->Offset - At < WORLD_PACK_PAGE_SIZE);
+    Result &= WriteToFile(&File, Global_WorldPackZeroPage, Entry->Offset - At);
+
+    Result &= WriteToFile(&File, Records[ChunkIndex], Entry->Size);
+    At = Entry->Offset + Entry->Size;
+  }
+
+  CloseFile(&File);
 
   return Result;
 }
 
-link_internal u32
-ReadWorldChunkVersion(native_file *AssetFile )
+#if _WIN32
+link_internal u8 *
+PlatformMapFileReadOnly(const char *zFilename, umm *SizeOut)
 {
-  u32 WHNK = Read_u32(AssetFile);
-  Assert(WHNK == WorldChunkFileTag_WHNK);
+  u8 *Result = 0;
 
-  u32 Version = Read_u32(AssetFile);
+  HANDLE File = CreateFileA(zFilename, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if (File != INVALID_HANDLE_VALUE)
+  {
+    LARGE_INTEGER Size;
+    if (GetFileSizeEx(File, &Size) && Size.QuadPart > 0)
+    {
+      HANDLE Mapping = CreateFileMappingA(File, 0, PAGE_READONLY, 0, 0, 0);
+      if (Mapping)
+      {
+        // NOTE(Jesse): The view keeps the mapping alive after we close it
+        Result = (u8*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+        if (Result) { *SizeOut = umm(Size.QuadPart); }
+        CloseHandle(Mapping);
+      }
+    }
+    CloseHandle(File);
+  }
 
-  // In V1 of the header the WHNK is 64 bits, so if we get a 0 for the version
-  // number it was the second 4 bytes of that field.  This should be removed
-  // once we have no v1 chunks left in development
-  if (Version == 0) { Version = Read_u32(AssetFile); }
+  return Result;
+}
 
-  return Version;
+link_internal void
+PlatformUnmapFile(u8 *Base, umm Size)
+{
+  UnmapViewOfFile(Base);
 }
 
+// NOTE(Jesse): Nothing to do here; the reader thread touching the pages is
+// what gets them read.
 link_internal void
-DeserializeChunk(native_file *AssetFile, world_chunk *Result, tiered_mesh_freelist *MeshFreelist, memory_arena *PermMemory)
+PlatformPrefetchMappedRange(u8 *Base, umm Size)
+{
+}
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+link_internal u8 *
+PlatformMapFileReadOnly(const char *zFilename, umm *SizeOut)
 {
-  world_chunk_file_header Header = {}; //ReadWorldChunkFileHeader(&AssetFile);
-  Header.Version = ReadWorldChunkVersion(AssetFile);
-  Rewind(AssetFile);
+  u8 *Result = 0;
 
-  switch(Header.Version)
+  s32 File = open(zFilename, O_RDONLY);
+  if (File != -1)
   {
-    case 1:
+    struct stat Stat;
+    if (fstat(File, &Stat) == 0 && Stat.st_size > 0)
     {
-      world_chunk_file_header_v1 v1Header = ReadWorldChunkFileHeader_v1(AssetFile);
+      void *Mapped = mmap(0, umm(Stat.st_size), PROT_READ, MAP_PRIVATE, File, 0);
+      if (Mapped != MAP_FAILED)
+      {
+        Result = (u8*)Mapped;
+        *SizeOut = umm(Stat.st_size);
+      }
+    }
+
+    // NOTE(Jesse): The mapping keeps the file alive after we close it
+    close(File);
+  }
 
-      Header.WHNK = SafeTruncateToU32(v1Header.WHNK); // WorldChunkFileTag_WHNK
-      Header.Version = v1Header.Version;
-      Header.Checksum = v1Header.Checksum;
+  return Result;
+}
 
-      Header.VoxelElementCount = v1Header.VoxelElementCount;
-      Header.VoxelElementSize = SafeTruncateU8(v1Header.VoxelElementSize);
+link_internal void
+PlatformUnmapFile(u8 *Base, umm Size)
+{
+  munmap(Base, Size);
+}
 
-      Header.MeshElementCount = v1Header.MeshElementCount;
+// NOTE(Jesse): Gets the kernel reading the whole range in one go instead of a
+// page per fault.  Base has to be page aligned, which world pack records are.
+link_internal void
+PlatformPrefetchMappedRange(u8 *Base, umm Size)
+{
+  madvise(Base, Size, MADV_WILLNEED);
+}
+#endif
 
-      Header.VertexElementSize = SafeTruncateU8(v1Header.VertexElementSize);
-      Header.ColorElementSize = SafeTruncateU8(v1Header.ColorElementSize);
-      Header.NormalElementSize = SafeTruncateU8(v1Header.NormalElementSize);
-    } break;
+//
+// World pack streaming
+//
+
+CAssert((WORLD_PACK_STREAM_QUEUE_SIZE & (WORLD_PACK_STREAM_QUEUE_SIZE-1)) == 0);
+
+// NOTE(Jesse): Pulls every page of the record into memory.  It's the reader
+// thread that blocks on the disk doing this, not a worker.
+link_internal void
+FaultInWorldPackRecord(world_pack *Pack, u32 EntryIndex)
+{
+  world_pack_entry *Entry = Pack->Directory + EntryIndex;
+
+  u8 *Start = Pack->Base + Entry->Offset;
+  PlatformPrefetchMappedRange(Start, Entry->Size);
 
-    case 2:
+  u32 Sum = 0;
+  for (u64 PageOffset = 0; PageOffset < Entry->Size; PageOffset += WORLD_PACK_PAGE_SIZE)
+  {
+    Sum += ((volatile u8*)Start)[PageOffset];
+  }
+
+  Global_WorldPackFaultSink += Sum;
+}
+
+link_internal THREAD_MAIN_RETURN
+WorldPackReaderMain(void *Input)
+{
+  world_pack *Pack = (world_pack*)Input;
+  world_pack_stream *Stream = &Pack->Stream;
+
+  while (!Stream->ExitRequested)
+  {
+    u32 DequeueIndex = Stream->DequeueIndex;
+    if (DequeueIndex == Stream->EnqueueIndex)
+    {
+      SleepMs(1);
+    }
+    else
     {
-      world_chunk_file_header_v2 v2Header = ReadWorldChunkFileHeader_v2(AssetFile);
+      FullBarrier;
+      u32 EntryIndex = Stream->Requests[DequeueIndex];
 
-      Header.WHNK = v2Header.WHNK; // WorldChunkFileTag_WHNK
-      Header.Version = v2Header.Version;
-      Header.Checksum = v2Header.Checksum;
+      FaultInWorldPackRecord(Pack, EntryIndex);
 
-      Header.VoxelElementCount = v2Header.VoxelElementCount;
-      Header.StandingSpotElementCount = v2Header.StandingSpotElementCount;
+      FullBarrier;
+      Stream->RecordStates[EntryIndex] = WorldPackRecord_Resident;
+      Stream->DequeueIndex = (DequeueIndex + 1) & (WORLD_PACK_STREAM_QUEUE_SIZE-1);
+    }
+  }
 
-      Header.MeshElementCount = v2Header.MeshElementCount;
+  FullBarrier;
+  Stream->ReaderRunning = False;
 
-      Header.VertexElementSize = v2Header.VertexElementSize;
-      Header.ColorElementSize = v2Header.ColorElementSize;
-      Header.NormalElementSize = v2Header.NormalElementSize;
-      Header.StandingSpotElementSize = v2Header.StandingSpotElementSize;
+  return 0;
+}
 
-      Header.VoxelElementSize = v2Header.VoxelElementSize;
+// NOTE(Jesse): Main thread only.  Returns False if the ring is full, in which
+// case the record stays cold and gets asked for again next time.
+link_internal b32
+RequestWorldPackRecord(world_pack *Pack, u32 EntryIndex)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  world_pack_stream *Stream = &Pack->Stream;
+
+  b32 Result = False;
+  if (Stream->RecordStates[EntryIndex] == WorldPackRecord_Cold)
+  {
+    u32 EnqueueIndex = Stream->EnqueueIndex;
+    u32 NextIndex = (EnqueueIndex + 1) & (WORLD_PACK_STREAM_QUEUE_SIZE-1);
+    if (NextIndex != Stream->DequeueIndex)
+    {
+      Stream->RecordStates[EntryIndex] = WorldPackRecord_Requested;
+      Stream->Requests[EnqueueIndex] = EntryIndex;
+
+      FullBarrier;
+      Stream->EnqueueIndex = NextIndex;
+      Result = True;
+    }
+  }
+
+  return Result;
+}
+
+link_internal void
+StopWorldPackReader(world_pack *Pack)
+{
+  world_pack_stream *Stream = &Pack->Stream;
+
+  Stream->ExitRequested = True;
+  while (Stream->ReaderRunning) { SleepMs(1); }
+}
+
+link_internal void
+CloseWorldPack(world_pack *Pack)
+{
+  if (Pack->Base)
+  {
+    StopWorldPackReader(Pack);
+    PlatformUnmapFile(Pack->Base, Pack->Size);
+  }
+  Clear(Pack);
+}
+
+link_internal b32
+OpenWorldPack(world_pack *Pack, counted_string Filename, memory_arena *Memory)
+{
+  TIMED_FUNCTION();
+
+  Clear(Pack);
+
+  const char *zFilename = GetNullTerminated(Filename, GetTranArena());
+  Pack->Base = PlatformMapFileReadOnly(zFilename, &Pack->Size);
+
+  b32 Result = Pack->Base != 0;
+  if (Result)
+  {
+    Pack->Header = (world_pack_file_header*)Pack->Base;
+    Pack->Directory = (world_pack_entry*)(Pack->Base + sizeof(world_pack_file_header));
+
+    world_pack_file_header *Header = Pack->Header;
+
+    Result = Pack->Size >= sizeof(world_pack_file_header) &&
+             Header->WPAK == WorldPackFileTag_WPAK &&
+             Header->Version == 1 &&
+             sizeof(world_pack_file_header) + (u64(Header->ChunkCount)*sizeof(world_pack_entry)) <= Pack->Size;
+
+    for (u32 EntryIndex = 0; Result && EntryIndex < Header->ChunkCount; ++EntryIndex)
+    {
+      world_pack_entry *Entry = Pack->Directory + EntryIndex;
+      Result &= Entry->Offset + Entry->Size <= Pack->Size;
+      Result &= Entry->Size >= sizeof(world_chunk_file_header_v2);
+    }
+
+    if (Result)
+    {
+      world_pack_stream *Stream = &Pack->Stream;
+      Stream->RecordStates = Allocate(u8, Memory, Header->ChunkCount);
+      Stream->ReaderRunning = True;
+
+      // NOTE(Jesse): Not one of the worker threads, so it gets an index past
+      // the end of theirs
+      PlatformCreateThread( WorldPackReaderMain, Pack, s32(GetTotalThreadCount()) );
+    }
+    else
+    {
+      SoftError("Invalid world pack (%S)", Filename);
+      PlatformUnmapFile(Pack->Base, Pack->Size);
+      Clear(Pack);
+    }
+  }
+
+  return Result;
+}
+
+link_internal world_pack_entry *
+GetWorldPackEntry(world_pack *Pack, world_position P)
+{
+  world_pack_entry *Result = 0;
+
+  if (Pack->Base)
+  {
+    s32 Lo = 0;
+    s32 Hi = s32(Pack->Header->ChunkCount)-1;
+    while (Lo <= Hi)
+    {
+      s32 Mid = Lo + ((Hi-Lo)/2);
+      world_pack_entry *Entry = Pack->Directory + Mid;
+
+      s32 Cmp = CompareWorldPackOrder(Entry->WorldP, P);
+           if (Cmp < 0) { Lo = Mid+1; }
+      else if (Cmp > 0) { Hi = Mid-1; }
+      else { Result = Entry; break; }
+    }
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Main thread only.  A chunk is ready to initialize when its
+// record is resident, or when there's no record for it at all.  Asks the
+// reader thread for the record if nobody has yet.
+link_internal b32
+WorldPackRecordIsReady(world_pack *Pack, world_position P)
+{
+  b32 Result = True;
+
+  world_pack_entry *Entry = GetWorldPackEntry(Pack, P);
+  if (Entry)
+  {
+    u32 EntryIndex = u32(Entry - Pack->Directory);
+    Result = Pack->Stream.RecordStates[EntryIndex] == WorldPackRecord_Resident;
+    if (!Result) { RequestWorldPackRecord(Pack, EntryIndex); }
+  }
+
+  return Result;
+}
+
+link_internal u32
+ReadWorldChunkTag(u8 **At)
+{
+  u32 Result = *(u32*)*At;
+  *At += sizeof(u32);
+  return Result;
+}
+
+link_internal b32
+ParseWorldChunkRecord_v2(u8 *Record, umm RecordSize, world_chunk_view *Result)
+{
+  u8 *At = Record;
+
+  world_chunk_file_header_v2 *Header = (world_chunk_file_header_v2*)At;
+  ValidateWorldChunkFileHeader_v2(Header);
+  At += sizeof(*Header);
+
+  Result->Version                  = Header->Version;
+  Result->VoxelElementCount        = Header->VoxelElementCount;
+  Result->MeshElementCount         = u32(Header->MeshElementCount);
+  Result->StandingSpotElementCount = Header->StandingSpotElementCount;
+
+  Ensure( ReadWorldChunkTag(&At) == WorldChunkFileTag_VOXD );
+  Result->VoxelCodec = VoxelCodec_Raw;
+  Result->EncodedVoxels = At;
+  Result->EncodedVoxelByteCount = Header->VoxelElementCount * Header->VoxelElementSize;
+  At += Result->EncodedVoxelByteCount;
+
+  u64 MeshElementCount = Header->MeshElementCount;
+  if (MeshElementCount)
+  {
+    Ensure( ReadWorldChunkTag(&At) == WorldChunkFileTag_VERT );
+    Result->Verts = (v3*)At;
+    At += MeshElementCount * Header->VertexElementSize;
+
+    Ensure( ReadWorldChunkTag(&At) == WorldChunkFileTag_COLO );
+    Result->Colors = (v4*)At;
+    At += MeshElementCount * Header->ColorElementSize;
+
+    Ensure( ReadWorldChunkTag(&At) == WorldChunkFileTag_NORM );
+    Result->Normals = (v3*)At;
+    At += MeshElementCount * Header->NormalElementSize;
+  }
+
+  Ensure( ReadWorldChunkTag(&At) == WorldChunkFileTag_SPOT );
+  Result->StandingSpots = (voxel_position*)At;
+  At += Header->StandingSpotElementCount * Header->StandingSpotElementSize;
+
+  b32 Success = umm(At - Record) == RecordSize;
+  return Success;
+}
+
+link_internal b32
+ParseWorldChunkRecord_v3(u8 *Record, umm RecordSize, world_chunk_view *Result)
+{
+  u8 *At = Record;
+
+  world_chunk_file_header_v3 *Header = (world_chunk_file_header_v3*)At;
+  At += sizeof(*Header);
+
+  b32 Success = ValidateWorldChunkFileHeader_v3(Header) &&
+                GetSerializedChunkSize(Header) == RecordSize &&
+                ComputeWorldChunkChecksum(At, RecordSize - sizeof(*Header)) == Header->Checksum;
+
+  if (Success)
+  {
+    Result->Version                  = Header->Version;
+    Result->Flags                    = Header->Flags;
+    Result->VoxelElementCount        = Header->VoxelElementCount;
+    Result->MeshElementCount         = Header->MeshElementCount;
+    Result->StandingSpotElementCount = Header->StandingSpotElementCount;
+
+    Success &= ReadWorldChunkTag(&At) == WorldChunkFileTag_VOXD;
+    Result->VoxelCodec = world_chunk_voxel_codec(Header->VoxelCodec);
+    Result->EncodedVoxels = At;
+    Result->EncodedVoxelByteCount = Header->VoxelByteCount;
+    At += Header->VoxelByteCount;
+
+    u64 MeshElementCount = Header->MeshElementCount;
+    if (MeshElementCount)
+    {
+      Success &= ReadWorldChunkTag(&At) == WorldChunkFileTag_VERT;
+      Result->Verts = (v3*)At;
+      At += MeshElementCount * Header->VertexElementSize;
+
+      Success &= ReadWorldChunkTag(&At) == WorldChunkFileTag_COLO;
+      Result->Colors = (v4*)At;
+      At += MeshElementCount * Header->ColorElementSize;
+
+      Success &= ReadWorldChunkTag(&At) == WorldChunkFileTag_NORM;
+      Result->Normals = (v3*)At;
+      At += MeshElementCount * Header->NormalElementSize;
+    }
+
+    Success &= ReadWorldChunkTag(&At) == WorldChunkFileTag_SPOT;
+    Result->StandingSpots = (voxel_position*)At;
+    At += Header->StandingSpotElementCount * Header->StandingSpotElementSize;
+
+    Assert(umm(At - Record) == RecordSize);
+  }
+
+  return Success;
+}
+
+// NOTE(Jesse): Fills out a view of a single record, which can be in a mapped
+// pack or anywhere else in memory.  v3 records are checked against their
+// checksum here, so a view that comes back True is safe to read from.
+link_internal b32
+ParseWorldChunkRecord(u8 *Record, umm RecordSize, world_chunk_view *Result)
+{
+  Clear(Result);
+
+  b32 Success = RecordSize >= sizeof(world_chunk_file_header_v3);
+  if (Success)
+  {
+    u32 Version = ((world_chunk_file_header_v3*)Record)->Version;
+    switch (Version)
+    {
+      case 2: { Success = ParseWorldChunkRecord_v2(Record, RecordSize, Result); } break;
+      case 3: { Success = ParseWorldChunkRecord_v3(Record, RecordSize, Result); } break;
+      default: { Success = False; } break;
+    }
+  }
+
+  return Success;
+}
+
+link_internal b32
+GetWorldChunkView(world_pack *Pack, world_position P, world_chunk_view *Result)
+{
+  b32 Found = False;
+
+  world_pack_entry *Entry = GetWorldPackEntry(Pack, P);
+  if (Entry)
+  {
+    Found = ParseWorldChunkRecord(Pack->Base + Entry->Offset, Entry->Size, Result);
+    if (!Found)
+    {
+      SoftError("Corrupt chunk record (%d, %d, %d) in world pack", P.x, P.y, P.z);
+    }
+  }
+
+  return Found;
+}
+
+// NOTE(Jesse): Raw voxels come straight out of the view; encoded ones are
+// decoded into TempMemory.  Returns 0 if the voxel data doesn't decode.
+link_internal voxel *
+GetWorldChunkViewVoxels(world_chunk_view *View, memory_arena *TempMemory)
+{
+  voxel *Result = 0;
+
+  switch (View->VoxelCodec)
+  {
+    case VoxelCodec_Raw:
+    {
+      Result = (voxel*)View->EncodedVoxels;
     } break;
 
-    default:
+    case VoxelCodec_RLE:
     {
-      SoftError("Invalid chunk version encountered (%u)", Header.Version);
+      Result = Allocate(voxel, TempMemory, View->VoxelElementCount);
+      if (!DecodeVoxels_RLE(View->EncodedVoxels, View->EncodedVoxelByteCount, Result, View->VoxelElementCount))
+      {
+        Result = 0;
+      }
     } break;
+
+    InvalidDefaultCase;
   }
 
-  Assert(Header.VoxelElementCount == Volume(Result));
+  return Result;
+}
 
-  u32 Tag = Read_u32(AssetFile);
-  Assert( Tag ==  WorldChunkFileTag_VOXD );
-  umm VoxByteCount = Header.VoxelElementCount * Header.VoxelElementSize;
-  ReadBytesIntoBuffer(AssetFile, VoxByteCount, (u8*)Result->Voxels);
+// NOTE(Jesse): Copies a chunk out of a pack into chunk-owned memory.  Chunk
+// init doesn't need this; it merges straight out of the view.
+//
+// Records written with WorldChunkFileFlag_MeshOmitted get their mesh rebuilt
+// from the voxels here, so the voxels in those have to be boundary-marked.
+link_internal b32
+DeserializeChunk(world_chunk_view *View, world_chunk *Result, packed_chunk_mesh_freelist *MeshFreelist, memory_arena *PermMemory)
+{
+  memory_arena *TempMemory = GetTranArena();
 
-  Result->FilledCount = Header.VoxelElementCount;
+  voxel *Voxels = GetWorldChunkViewVoxels(View, TempMemory);
 
-  if (MeshFreelist && Header.MeshElementCount)
+  b32 Success = Voxels != 0;
+  if (Success)
   {
-    u32 TotalElements = u32(Header.MeshElementCount);
-    untextured_3d_geometry_buffer *Mesh = GetPermMeshForChunk(MeshFreelist, TotalElements, PermMemory);
+    Assert(View->VoxelElementCount == u32(Volume(Result)));
+    MemCopy((u8*)Voxels, (u8*)Result->Voxels, View->VoxelElementCount*sizeof(voxel));
+
+    Result->FilledCount = 0;
+    for (u32 VoxelIndex = 0; VoxelIndex < View->VoxelElementCount; ++VoxelIndex)
+    {
+      Result->FilledCount += Result->Voxels[VoxelIndex].Flags & Voxel_Filled;
+    }
 
-    DeserializeMesh(AssetFile, &Header, Mesh);
-    Ensure( AtomicReplaceMesh(&Result->Meshes, MeshBit_Main, Mesh, Mesh->Timestamp) == 0);
+    if (MeshFreelist && View->MeshElementCount)
+    {
+      // NOTE(Jesse): Records store float meshes; pack it here, on the worker,
+      // so uploading it is a plain copy like every other chunk mesh
+      untextured_3d_geometry_buffer ViewMesh = {};
+      ViewMesh.Verts   = View->Verts;
+      ViewMesh.Normals = View->Normals;
+      ViewMesh.Colors  = View->Colors;
+      ViewMesh.At      = View->MeshElementCount;
+      ViewMesh.End     = View->MeshElementCount;
+      ViewMesh.Timestamp = __rdtsc();
+
+      palette_lookup *Lookup = Allocate(palette_lookup, TempMemory, 1);
+      InitPaletteLookup(Lookup, DefaultPalette, ArrayCount(DefaultPalette));
+
+      packed_chunk_mesh *Mesh = GetPermPackedChunkMesh(MeshFreelist, ViewMesh.At, PermMemory);
+      PackChunkMesh(Lookup, &ViewMesh, Mesh);
+      Ensure( AtomicReplacePackedMesh(&Result->Meshes, MeshBit_Main, Mesh, Mesh->Timestamp) == 0);
+    }
+    else if (MeshFreelist && (View->Flags & WorldChunkFileFlag_MeshOmitted))
+    {
+      packed_chunk_mesh *TempMesh = AllocateTempPackedChunkMesh(TempMemory);
+      BuildWorldChunkMeshFromMarkedVoxels(Result->Voxels, Result->Dim, {}, Result->Dim, TempMesh, TempMemory);
+
+      if (TempMesh->At)
+      {
+        packed_chunk_mesh *Mesh = GetPermPackedChunkMesh(MeshFreelist, TempMesh->At, PermMemory);
+        DeepCopy(TempMesh, Mesh);
+        Ensure( AtomicReplacePackedMesh(&Result->Meshes, MeshBit_Main, Mesh, Mesh->Timestamp) == 0);
+      }
+    }
+
+    if (View->StandingSpotElementCount)
+    {
+      u64 TotalElements = View->StandingSpotElementCount;
+
+      // NOTE(Jesse): World chunks come with a cursor already
+      if (Result->StandingSpots.Start == 0)
+      {
+        Result->StandingSpots = V3iCursor(WORLD_CHUNK_STANDING_SPOT_COUNT, PermMemory);
+      }
+
+      Assert(TotalElements <= WORLD_CHUNK_STANDING_SPOT_COUNT);
+      MemCopy((u8*)View->StandingSpots, (u8*)Result->StandingSpots.Start, TotalElements*sizeof(voxel_position));
+      Result->StandingSpots.At = Result->StandingSpots.Start + TotalElements;
+    }
   }
 
-  if (Header.StandingSpotElementCount)
+  return Success;
+}
+
+link_internal void
+InitWorldEdits(world_edits *Edits, memory_arena *Memory)
+{
+  Clear(Edits);
+  Edits->Table = Allocate(world_edit_record*, Memory, WORLD_EDIT_HASH_SIZE);
+  Edits->Heap = InitHeap(Megabytes(256));
+}
+
+// NOTE(Jesse): Caller holds Edits->Lock
+link_internal world_edit_record *
+GetWorldEditRecord(world_edits *Edits, world_position P)
+{
+  CAssert((WORLD_EDIT_HASH_SIZE & (WORLD_EDIT_HASH_SIZE-1)) == 0);
+
+  world_edit_record *Result = Edits->Table[GetWorldChunkHash(P) & (WORLD_EDIT_HASH_SIZE-1)];
+  while (Result && Result->WorldP != P) { Result = Result->Next; }
+  return Result;
+}
+
+// NOTE(Jesse): Caller holds Edits->Lock.  Replaces whatever was there; the
+// latest write-back of a chunk is the only one we care about.
+link_internal b32
+StoreWorldEditRecord(world_edits *Edits, world_position P, u8 *Record, u32 RecordSize)
+{
+  world_edit_record *Edit = GetWorldEditRecord(Edits, P);
+  if (Edit == 0)
   {
-    u64 TotalElements = Header.StandingSpotElementCount;
-    Result->StandingSpots = V3iCursor(WORLD_CHUNK_STANDING_SPOT_COUNT, PermMemory);
+    Edit = (world_edit_record*)HeapAllocate(&Edits->Heap, sizeof(world_edit_record));
+    if (Edit)
+    {
+      Clear(Edit);
+      Edit->WorldP = P;
 
-    DebugLine("Standing Spots (%u)", TotalElements);
+      world_edit_record **Bucket = Edits->Table + (GetWorldChunkHash(P) & (WORLD_EDIT_HASH_SIZE-1));
+      Edit->Next = *Bucket;
+      *Bucket = Edit;
 
-    //
-    // SPOT data
-    //
-    Tag = Read_u32(AssetFile);
-    Assert(Tag ==  WorldChunkFileTag_SPOT);
+      ++Edits->RecordCount;
+    }
+  }
+  else
+  {
+    ++Edits->SupersededCount;
+  }
+
+  u8 *Copy = Edit ? HeapAllocate(&Edits->Heap, RecordSize) : 0;
+
+  b32 Result = Copy != 0;
+  if (Result)
+  {
+    MemCopy(Record, Copy, RecordSize);
 
-    u32 SpotElementSize = Header.StandingSpotElementSize;
-    Assert(SpotElementSize == (u32)sizeof(v3));
-    umm ByteCount = SpotElementSize*TotalElements;
-    ReadBytesIntoBuffer(AssetFile, ByteCount, (u8*)Result->StandingSpots.Start);
+    if (Edit->Record) { HeapDeallocate(Edit->Record); }
+    Edit->Record = Copy;
+    Edit->RecordSize = RecordSize;
+  }
+  else
+  {
+    SoftError("Out of memory storing edited chunk (%d, %d, %d)", P.x, P.y, P.z);
   }
 
+  return Result;
 }
 
+// NOTE(Jesse): Caller holds Edits->Lock
 link_internal b32
-SerializeChunk(world_chunk *Chunk, counted_string AssetPath)
+AppendWorldEditJournal(world_edits *Edits, world_position P, u8 *Record, u32 RecordSize)
 {
   b32 Result = True;
 
-  auto WorldP = Chunk->WorldP;
-  counted_string Filename = GetAssetFilenameFor(AssetPath, WorldP, GetTranArena());
+  if (Edits->JournalFilename.Count)
+  {
+    world_edit_journal_entry Entry = {};
+    Entry.WEDT = WorldEditFileTag_WEDT;
+    Entry.WorldP = P;
+    Entry.RecordSize = RecordSize;
 
-  native_file File = OpenFile(Filename, "w+b");
+    native_file File = OpenFile(Edits->JournalFilename, "ab");
+    Result &= WriteToFile(&File, (u8*)&Entry, sizeof(Entry));
+    Result &= WriteToFile(&File, Record, RecordSize);
+    CloseFile(&File);
 
-  world_chunk_file_header_v2 FileHeader = MakeWorldChunkFileHeader_v2(Chunk);
+    if (!Result) { SoftError("Writing edited chunk (%d, %d, %d) to (%S)", P.x, P.y, P.z, Edits->JournalFilename); }
+  }
+
+  return Result;
+}
 
-  Result &= WriteToFile(&File, (u8*)&FileHeader, sizeof(FileHeader));
+// NOTE(Jesse): Caller holds Edits->Lock.  Writes every live record out to a
+// fresh journal.
+link_internal b32
+RewriteWorldEditJournal(world_edits *Edits)
+{
+  b32 Result = True;
 
+  native_file File = OpenFile(Edits->JournalFilename, "w+b");
+  for (u32 BucketIndex = 0; BucketIndex < WORLD_EDIT_HASH_SIZE; ++BucketIndex)
   {
-    u64 VoxByteCount = FileHeader.VoxelElementCount * FileHeader.VoxelElementSize;
+    for (world_edit_record *Edit = Edits->Table[BucketIndex]; Edit; Edit = Edit->Next)
+    {
+      world_edit_journal_entry Entry = {};
+      Entry.WEDT = WorldEditFileTag_WEDT;
+      Entry.WorldP = Edit->WorldP;
+      Entry.RecordSize = Edit->RecordSize;
+
+      Result &= WriteToFile(&File, (u8*)&Entry, sizeof(Entry));
+      Result &= WriteToFile(&File, Edit->Record, Edit->RecordSize);
+    }
+  }
+  CloseFile(&File);
+
+  Edits->SupersededCount = 0;
+
+  return Result;
+}
+
+// NOTE(Jesse): Caller holds Edits->Lock.  The journal is append-only, so every
+// write-back of a chunk that was already in it leaves a dead record behind.
+// Once those pile up, start it over with just the live ones.
+link_internal b32
+CompactWorldEditJournal(world_edits *Edits)
+{
+  b32 Result = True;
 
-    u32 Tag = WorldChunkFileTag_VOXD;
-    Result &= WriteToFile(&File, Tag);
-    Result &= WriteToFile(&File, (u8*)Chunk->Voxels, VoxByteCount);
+  if ( Edits->JournalFilename.Count &&
+       Edits->SupersededCount >= WORLD_EDIT_JOURNAL_COMPACT_THRESHOLD &&
+       Edits->SupersededCount >= Edits->RecordCount )
+  {
+    TIMED_FUNCTION();
+    Result = RewriteWorldEditJournal(Edits);
+    if (!Result) { SoftError("Compacting (%S)", Edits->JournalFilename); }
   }
 
-  auto Mesh = TakeOwnershipSync(&Chunk->Meshes, MeshBit_Main);
-  Result &= SerializeMesh(&File, Mesh, &FileHeader);
-  ReleaseOwnership(&Chunk->Meshes, MeshBit_Main, Mesh);
+  return Result;
+}
 
+// NOTE(Jesse): Called from the write-back jobs
+link_internal b32
+PutWorldEdit(world_edits *Edits, world_position P, u8 *Record, u32 RecordSize)
+{
+  AcquireFutex(&Edits->Lock);
+
+  // NOTE(Jesse): If the journal write fails the edit still survives until
+  // the game shuts down, so that's not a failure as far as the caller cares
+  b32 Result = StoreWorldEditRecord(Edits, P, Record, RecordSize);
+  if (Result)
   {
-    DebugLine("Writing (%u) StandingSpots", FileHeader.StandingSpotElementCount);
-    u64 StandingSpotByteCount = FileHeader.StandingSpotElementSize * FileHeader.StandingSpotElementCount;
-    u32 Tag = WorldChunkFileTag_SPOT;
-    Result &= WriteToFile(&File, Tag);
-    Result &= WriteToFile(&File, (u8*)Chunk->StandingSpots.Start, StandingSpotByteCount);
+    AppendWorldEditJournal(Edits, P, Record, RecordSize);
+    CompactWorldEditJournal(Edits);
   }
 
-  CloseFile(&File);
+  ReleaseFutex(&Edits->Lock);
 
   return Result;
 }
 
+// NOTE(Jesse): Called from the chunk init jobs.  The record gets copied out
+// because a write-back can replace it as soon as we let go of the lock.
+// Returns 0 if the chunk has never been edited.
+link_internal u8 *
+CopyWorldEdit(world_edits *Edits, world_position P, memory_arena *Memory, u32 *RecordSize)
+{
+  u8 *Result = 0;
+
+  // NOTE(Jesse): Most worlds never get edited; don't take the lock for them
+  if (Edits->Table && Edits->RecordCount)
+  {
+    AcquireFutex(&Edits->Lock);
+
+    world_edit_record *Edit = GetWorldEditRecord(Edits, P);
+    if (Edit)
+    {
+      Result = Allocate(u8, Memory, Edit->RecordSize);
+      MemCopy(Edit->Record, Result, Edit->RecordSize);
+      *RecordSize = Edit->RecordSize;
+    }
+
+    ReleaseFutex(&Edits->Lock);
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Loads whatever's already in the journal and appends to it from
+// then on.  A missing journal is fine; it gets created on the first write.
+// Filename has to outlive Edits.
+link_internal b32
+OpenWorldEditJournal(world_edits *Edits, counted_string Filename)
+{
+  TIMED_FUNCTION();
+
+  Assert(Edits->Table);
+
+  b32 Result = True;
+
+  AcquireFutex(&Edits->Lock);
+
+  Edits->JournalFilename = Filename;
+
+  umm Size = 0;
+  u8 *Base = PlatformMapFileReadOnly(GetNullTerminated(Filename, GetTranArena()), &Size);
+  if (Base)
+  {
+    u32 SkippedCount = 0;
+
+    umm At = 0;
+    while (At + sizeof(world_edit_journal_entry) <= Size)
+    {
+      world_edit_journal_entry *Entry = (world_edit_journal_entry*)(Base + At);
+      if (Entry->WEDT != WorldEditFileTag_WEDT) { break; }
+      if (At + sizeof(world_edit_journal_entry) + Entry->RecordSize > Size) { break; }
+
+      u8 *Record = Base + At + sizeof(world_edit_journal_entry);
+      At += sizeof(world_edit_journal_entry) + Entry->RecordSize;
+
+      world_chunk_view View = {};
+      if (ParseWorldChunkRecord(Record, Entry->RecordSize, &View))
+      {
+        StoreWorldEditRecord(Edits, Entry->WorldP, Record, Entry->RecordSize);
+      }
+      else
+      {
+        ++SkippedCount;
+      }
+    }
+
+    PlatformUnmapFile(Base, Size);
+
+    if (SkippedCount) { SoftError("Skipped (%u) corrupt records in (%S)", SkippedCount, Filename); }
+
+    // NOTE(Jesse): Most likely a write that got cut off when the game went
+    // down.  Anything appended after it would never be read back, so start
+    // the journal over with what we could load.
+    if (At != Size)
+    {
+      Warn("Dropping (%u) unreadable bytes at the end of (%S)", u32(Size - At), Filename);
+      Result = RewriteWorldEditJournal(Edits);
+    }
+    else
+    {
+      Result = CompactWorldEditJournal(Edits);
+    }
+  }
+
+  ReleaseFutex(&Edits->Lock);
+
+  return Result;
+}
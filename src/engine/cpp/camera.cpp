@@ -81,17 +81,18 @@ UpdateCameraP(world *World, canonical_position NewTarget, camera *Camera)
   plane Left(CameraSimP,  Normalize(Cross(MinMax, MaxMax)));
   plane Right(CameraSimP, Normalize(Cross(MaxMin, MinMin)));
 
+  plane Near(CameraSimP + Camera->Front*Camera->Frust.nearClip,      Camera->Front);
+  plane Far( CameraSimP + Camera->Front*Camera->Frust.farClip,  -1.f*Camera->Front);
+
   Camera->Frust.Top = Top;
   Camera->Frust.Bot = Bot;
   Camera->Frust.Left = Left;
   Camera->Frust.Right = Right;
+  Camera->Frust.Near = Near;
+  Camera->Frust.Far = Far;
 
 #endif
 
-  // TODO(Jesse, id: 128, tags: correctness, robustness, speed): Do culling on these as well?
-  /* plane Near; */
-  /* plane Far; */
-
 
   return;
 }
@@ -149,12 +150,37 @@ IsInFrustum(world *World, camera *Camera, canonical_position P)
   return Result;
 }
 
+// NOTE(Jesse): Conservative; a box that's outside every plane's half space
+// only near a corner of the frustum can come back Intersecting, never the
+// other way around.
+link_internal frustum_test_result
+TestFrustum(frustum *Frust, aabb *Box)
+{
+  frustum_test_result Result = FrustumTest_Inside;
+
+  plane *Planes[] = { &Frust->Top, &Frust->Bot, &Frust->Left, &Frust->Right, &Frust->Near, &Frust->Far };
+  for (u32 PlaneIndex = 0; PlaneIndex < ArrayCount(Planes); ++PlaneIndex)
+  {
+    plane *Plane = Planes[PlaneIndex];
+
+    // NOTE(Jesse): How far the box reaches along the normal from its center
+    r32 Extent = Abs(Plane->Normal.x)*Box->Radius.x +
+                 Abs(Plane->Normal.y)*Box->Radius.y +
+                 Abs(Plane->Normal.z)*Box->Radius.z;
+
+    r32 Distance = DistanceToPlane(Plane, Box->Center);
+    if (Distance < -Extent) { Result = FrustumTest_Outside; break; }
+    if (Distance <  Extent) { Result = FrustumTest_Intersecting; }
+  }
+
+  return Result;
+}
+
 inline bool
 IsInFrustum( world *World, camera *Camera, world_chunk *Chunk )
 {
-  v3 ChunkMid = World->ChunkDim/2.0f;
-  canonical_position P1 = Canonical_Position(ChunkMid, Chunk->WorldP );
-  bool Result = IsInFrustum(World, Camera, P1);
+  aabb ChunkAABB = GetSimSpaceAABB(World, Chunk);
+  bool Result = TestFrustum(&Camera->Frust, &ChunkAABB) != FrustumTest_Outside;
   return Result;
 }
 
@@ -37,7 +37,8 @@ IsFilledInChunk( world_chunk *Chunk, voxel_position VoxelP, chunk_dimension Dim)
     Assert(i > -1);
     Assert(i < Volume(Dim));
 
-    isFilled = IsSet(&Chunk->Voxels[i], Voxel_Filled);
+    voxel *V = Chunk->Voxels ? Chunk->Voxels + i : &Chunk->UniformVoxel;
+    isFilled = IsSet(V, Voxel_Filled);
   }
 
   return isFilled;
@@ -58,7 +59,8 @@ NotFilledInChunk( world_chunk *Chunk, s32 Index)
 
   if (Index > -1)
   {
-    NotFilled = !IsSet(&Chunk->Voxels[Index], Voxel_Filled);
+    voxel *V = Chunk->Voxels ? Chunk->Voxels + Index : &Chunk->UniformVoxel;
+    NotFilled = !IsSet(V, Voxel_Filled);
   }
 
   return NotFilled;
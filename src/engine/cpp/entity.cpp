@@ -102,26 +102,207 @@ GetCollision(world *World, entity *First, entity *Second)
   return Result;
 }
 
-inline b32
-GetCollision(world *World, entity **Entities, entity *Entity)
+link_internal void
+InitEntityBroadphase(entity_broadphase *Broadphase, memory_arena *Memory)
+{
+  Broadphase->Nodes   = Allocate(entity_broadphase_node, Memory, TOTAL_ENTITY_COUNT);
+  Broadphase->Buckets = Allocate(u32, Memory, ENTITY_BROADPHASE_BUCKET_COUNT);
+  Broadphase->Large   = Allocate(u32, Memory, TOTAL_ENTITY_COUNT);
+}
+
+link_internal v3i
+GetEntityBroadphaseCell(v3 SimP)
+{
+  v3i Result = V3i( s32(Floor(SimP.x/ENTITY_BROADPHASE_CELL_DIM)),
+                    s32(Floor(SimP.y/ENTITY_BROADPHASE_CELL_DIM)),
+                    s32(Floor(SimP.z/ENTITY_BROADPHASE_CELL_DIM)) );
+  return Result;
+}
+
+link_internal u32
+GetEntityBroadphaseBucket(v3i Cell)
+{
+  u32 Result = GetWorldChunkHash(Cell) & (ENTITY_BROADPHASE_BUCKET_COUNT-1);
+  return Result;
+}
+
+link_internal void
+UnfileEntity(entity_broadphase *Broadphase, u32 Slot)
+{
+  entity_broadphase_node *Node = Broadphase->Nodes + Slot;
+
+  if (Node->Bucket == ENTITY_BROADPHASE_LARGE)
+  {
+    for (u32 LargeIndex = 0; LargeIndex < Broadphase->LargeCount; ++LargeIndex)
+    {
+      if (Broadphase->Large[LargeIndex] == Slot)
+      {
+        Broadphase->Large[LargeIndex] = Broadphase->Large[--Broadphase->LargeCount];
+        break;
+      }
+    }
+  }
+  else if (Node->Bucket != ENTITY_BROADPHASE_NOT_FILED)
+  {
+    u32 *At = Broadphase->Buckets + Node->Bucket;
+    while (*At != Slot) { At = &Broadphase->Nodes[*At].Next; }
+    *At = Node->Next;
+  }
+
+  Node->Bucket = ENTITY_BROADPHASE_NOT_FILED;
+}
+
+link_internal void
+FileEntity(world *World, entity_broadphase *Broadphase, u32 Slot)
+{
+  entity_broadphase_node *Node = Broadphase->Nodes + Slot;
+  Assert(Node->Bucket == ENTITY_BROADPHASE_NOT_FILED);
+
+  if (Spawned(Node->Entity))
+  {
+    Node->AABB = GetSimSpaceAABB(World, Node->Entity);
+
+    v3 Dim = Node->AABB.Radius*2.f;
+    if (Dim.x > ENTITY_BROADPHASE_CELL_DIM || Dim.y > ENTITY_BROADPHASE_CELL_DIM || Dim.z > ENTITY_BROADPHASE_CELL_DIM)
+    {
+      Node->Bucket = ENTITY_BROADPHASE_LARGE;
+      Broadphase->Large[Broadphase->LargeCount++] = Slot;
+    }
+    else
+    {
+      Node->Cell = GetEntityBroadphaseCell(Node->AABB.Center - Node->AABB.Radius);
+      Node->Bucket = GetEntityBroadphaseBucket(Node->Cell);
+      Node->Next = Broadphase->Buckets[Node->Bucket];
+      Broadphase->Buckets[Node->Bucket] = Slot;
+    }
+  }
+}
+
+link_internal void
+BuildEntityBroadphase(world *World, entity_broadphase *Broadphase, entity **EntityTable)
+{
+  TIMED_FUNCTION();
+
+  for (u32 BucketIndex = 0; BucketIndex < ENTITY_BROADPHASE_BUCKET_COUNT; ++BucketIndex)
+  {
+    Broadphase->Buckets[BucketIndex] = ENTITY_BROADPHASE_NOT_FILED;
+  }
+
+  Broadphase->LargeCount = 0;
+  Broadphase->PairsTested = 0;
+
+  for (u32 Slot = 0; Slot < TOTAL_ENTITY_COUNT; ++Slot)
+  {
+    entity_broadphase_node *Node = Broadphase->Nodes + Slot;
+    Node->Entity = EntityTable[Slot];
+    Node->Bucket = ENTITY_BROADPHASE_NOT_FILED;
+    FileEntity(World, Broadphase, Slot);
+  }
+}
+
+// NOTE(Jesse): Call after moving, spawning or unspawning the entity in Slot,
+// or other entities won't see it where it is till the next rebuild
+link_internal void
+UpdateEntityBroadphase(world *World, entity_broadphase *Broadphase, u32 Slot)
+{
+  UnfileEntity(Broadphase, Slot);
+  FileEntity(World, Broadphase, Slot);
+}
+
+link_internal b32
+TestEntityBroadphaseNode(entity_broadphase *Broadphase, u32 Slot, entity *Entity, aabb *EntityAABB)
 {
   b32 Result = False;
 
-  for (s32 EntityIndex = 0;
-      EntityIndex < TOTAL_ENTITY_COUNT;
-      ++EntityIndex)
+  entity_broadphase_node *Node = Broadphase->Nodes + Slot;
+  if (Node->Entity != Entity)
   {
-    entity *TestEntity = Entities[EntityIndex];
+    ++Broadphase->PairsTested;
+    Result = Spawned(Node->Entity) && Intersect(EntityAABB, &Node->AABB);
+  }
 
-    if (TestEntity == Entity)
-      continue;
+  return Result;
+}
+
+// NOTE(Jesse): Counts the entities Entity overlaps, and writes the first
+// MaxHits of them to Hits.  Entity is tested where it is now, which doesn't
+// have to be where it was filed.
+link_internal u32
+GetEntityCollisions(world *World, entity_broadphase *Broadphase, entity *Entity, entity **Hits = 0, u32 MaxHits = 0)
+{
+  TIMED_FUNCTION();
+
+  u32 Result = 0;
+  if (Spawned(Entity) == False) { return Result; }
+
+  aabb EntityAABB = GetSimSpaceAABB(World, Entity);
+  v3 EntityMin = EntityAABB.Center - EntityAABB.Radius;
+  v3 EntityMax = EntityAABB.Center + EntityAABB.Radius;
+
+  // NOTE(Jesse): Anything filed in a cell fits in one, so it can start at
+  // most a cell below EntityMin
+  v3i MinCell = GetEntityBroadphaseCell(EntityMin - V3(ENTITY_BROADPHASE_CELL_DIM));
+  v3i MaxCell = GetEntityBroadphaseCell(EntityMax);
+  v3i CellDim = MaxCell - MinCell + 1;
+
+  if (Volume(CellDim) <= TOTAL_ENTITY_COUNT)
+  {
+    for (s32 z = MinCell.z; z <= MaxCell.z; ++z)
+    {
+      for (s32 y = MinCell.y; y <= MaxCell.y; ++y)
+      {
+        for (s32 x = MinCell.x; x <= MaxCell.x; ++x)
+        {
+          v3i Cell = V3i(x,y,z);
+          u32 Slot = Broadphase->Buckets[GetEntityBroadphaseBucket(Cell)];
+          for (; Slot != ENTITY_BROADPHASE_NOT_FILED; Slot = Broadphase->Nodes[Slot].Next)
+          {
+            if (Broadphase->Nodes[Slot].Cell == Cell &&
+                TestEntityBroadphaseNode(Broadphase, Slot, Entity, &EntityAABB))
+            {
+              if (Result < MaxHits) { Hits[Result] = Broadphase->Nodes[Slot].Entity; }
+              ++Result;
+            }
+          }
+        }
+      }
+    }
+  }
+  else
+  {
+    // NOTE(Jesse): Entity covers more cells than there are entities
+    for (u32 Slot = 0; Slot < TOTAL_ENTITY_COUNT; ++Slot)
+    {
+      u32 Bucket = Broadphase->Nodes[Slot].Bucket;
+      if (Bucket != ENTITY_BROADPHASE_NOT_FILED && Bucket != ENTITY_BROADPHASE_LARGE &&
+          TestEntityBroadphaseNode(Broadphase, Slot, Entity, &EntityAABB))
+      {
+        if (Result < MaxHits) { Hits[Result] = Broadphase->Nodes[Slot].Entity; }
+        ++Result;
+      }
+    }
+  }
 
-    Result = GetCollision(World, Entity, TestEntity);
+  for (u32 LargeIndex = 0; LargeIndex < Broadphase->LargeCount; ++LargeIndex)
+  {
+    u32 Slot = Broadphase->Large[LargeIndex];
+    if (TestEntityBroadphaseNode(Broadphase, Slot, Entity, &EntityAABB))
+    {
+      if (Result < MaxHits) { Hits[Result] = Broadphase->Nodes[Slot].Entity; }
+      ++Result;
+    }
   }
 
   return Result;
 }
 
+inline b32
+GetCollision(world *World, entity_broadphase *Broadphase, entity *Entity)
+{
+  b32 Result = GetEntityCollisions(World, Broadphase, Entity) > 0;
+  return Result;
+}
+
 /* TODO(Jesse, id: 130, tags: be_smarter): This offset is only used to check if
  * entities are grounded.  Can we do that in a more intelligent way?
  */
@@ -716,6 +897,7 @@ SpawnPlayerLikeEntity( platform *Plat,
         canonical_position CP = Canonicalize(World->ChunkDim, V3(x, y, z), InitialP.WorldP);
 
         world_chunk *Chunk = GetWorldChunkFromHashtable( World, CP.WorldP );
+        if (Chunk == 0) { Chunk = ReclaimEvictedChunk(World, CP.WorldP); }
         if (Chunk == 0)
         {
           Chunk = GetWorldChunkFor(World->Memory, World, CP.WorldP);
@@ -973,27 +1155,15 @@ ProcessCollisionRule(
 
 
 link_internal collision_event
-DoEntityCollisions(world *World, entity** EntityTable, entity *Entity)
+DoEntityCollisions(world *World, entity_broadphase *Broadphase, entity *Entity)
 {
   TIMED_FUNCTION();
 
   Assert(Spawned(Entity));
 
+  // TODO(Jesse): Should we actually test the overlapping area here?  Probably.
   collision_event Result = {};
-  for (s32 EntityIndex = 0;
-      EntityIndex < TOTAL_ENTITY_COUNT;
-      ++EntityIndex)
-  {
-    entity *TestEntity = EntityTable[EntityIndex];
-    if (Entity != TestEntity)
-    {
-      if (GetCollision(World, Entity, TestEntity))
-      {
-        // TODO(Jesse): Should we actually test the overlapping area here?  Probably.
-        Result.Count ++;
-      }
-    }
-  }
+  Result.Count = GetEntityCollisions(World, Broadphase, Entity);
 
   return Result;
 }
@@ -1366,6 +1536,9 @@ SimulateEntities(engine_resources *Resources, r32 dt, chunk_dimension VisibleReg
   TIMED_FUNCTION();
   UNPACK_ENGINE_RESOURCES(Resources);
 
+  entity_broadphase *Broadphase = &Resources->EntityBroadphase;
+  BuildEntityBroadphase(World, Broadphase, EntityTable);
+
   for ( s32 EntityIndex = 0;
         EntityIndex < TOTAL_ENTITY_COUNT;
         ++EntityIndex )
@@ -1429,6 +1602,8 @@ SimulateEntities(engine_resources *Resources, r32 dt, chunk_dimension VisibleReg
       /* default: { InvalidCodePath(); } break; */
     }
 
+    UpdateEntityBroadphase(World, Broadphase, u32(EntityIndex));
+
     particle_system *System = Entity->Emitter;
     if (Active(System))
     {
@@ -1437,7 +1612,7 @@ SimulateEntities(engine_resources *Resources, r32 dt, chunk_dimension VisibleReg
       v3 RenderSpaceP  = GetRenderP(Entity->P, Camera, World->ChunkDim);
       auto Job = WorkQueueEntry(System, Dest, EntityDelta, RenderSpaceP, dt);
       /* SimulateParticleSystem(&Job.work_queue_entry_sim_particle_system); */
-      PushWorkQueueEntry(Queue, &Job);
+      PushCountedWorkQueueEntry(Queue, &Job, &Resources->FrameJobs, Resources->FrameJobMemory);
     }
   }
 
@@ -25,6 +25,10 @@ FlushBuffersToCard(gpu_mapped_element_buffer* GpuMap)
   GL.VertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
   AssertNoGlErrors;
 
+  // NOTE(Jesse): The packed chunk vertex attribute is unused when drawing
+  // from the gpu_mapped_element_buffer
+  GL.DisableVertexAttribArray(3);
+
   if (BufferUnmapped == False) { Error("glUnmapBuffer Failed"); }
 
   GL.BindBuffer(GL_ARRAY_BUFFER, 0);
@@ -90,3 +94,312 @@ AllocateGpuElementBuffer(gpu_mapped_element_buffer *GpuMap, u32 ElementCount)
   GpuMap->Buffer.End = ElementCount;
 }
 
+
+link_internal void
+BindGpuElementBuffer(gpu_mapped_element_buffer *GpuMap)
+{
+  GL.EnableVertexAttribArray(0);
+  GL.BindBuffer(GL_ARRAY_BUFFER, GpuMap->VertexHandle);
+  GL.VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+  GL.EnableVertexAttribArray(1);
+  GL.BindBuffer(GL_ARRAY_BUFFER, GpuMap->NormalHandle);
+  GL.VertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+
+  GL.EnableVertexAttribArray(2);
+  GL.BindBuffer(GL_ARRAY_BUFFER, GpuMap->ColorHandle);
+  GL.VertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 0, (void*)0);
+  AssertNoGlErrors;
+
+  GL.DisableVertexAttribArray(3);
+
+  GL.BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+link_internal void
+BindGpuChunkBuffer(gpu_chunk_buffer *ChunkBuffer)
+{
+  GL.DisableVertexAttribArray(0);
+  GL.DisableVertexAttribArray(1);
+  GL.DisableVertexAttribArray(2);
+
+  GL.EnableVertexAttribArray(3);
+  GL.BindBuffer(GL_ARRAY_BUFFER, ChunkBuffer->VertexHandle);
+  GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ChunkBuffer->QuadIndexHandle);
+  AssertNoGlErrors;
+}
+
+// NOTE(Jesse): Points the packed attribute at the start of a slab, which lets
+// every slab share the same quad indices.  Requires BindGpuChunkBuffer.
+link_internal void
+BindGpuChunkSlab(u32 FirstElement)
+{
+  // NOTE(Jesse): Not normalized, so the shader receives the integer values of
+  // the u16s as floats, which is exact, and decodes them itself.
+  umm ByteOffset = sizeof(packed_chunk_vertex)*FirstElement;
+  GL.VertexAttribPointer(3, 4, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(packed_chunk_vertex), (void*)ByteOffset);
+}
+
+link_internal void
+UnbindGpuChunkBuffer()
+{
+  GL.DisableVertexAttribArray(3);
+  GL.BindBuffer(GL_ARRAY_BUFFER, 0);
+  GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+link_internal void
+AllocateGpuChunkBuffer(gpu_chunk_buffer *ChunkBuffer, u32 ElementCount, memory_arena *Memory)
+{
+  u32 BufferSize = sizeof(packed_chunk_vertex)*ElementCount;
+
+  GL.GenBuffers(1, &ChunkBuffer->VertexHandle);
+
+  GL.BindBuffer(GL_ARRAY_BUFFER, ChunkBuffer->VertexHandle);
+  GL.BufferData(GL_ARRAY_BUFFER, BufferSize, 0, GL_DYNAMIC_DRAW);
+
+  GL.BindBuffer(GL_ARRAY_BUFFER, 0);
+  AssertNoGlErrors;
+
+  {
+    // NOTE(Jesse): The largest slab holds this many quads
+    u32 QuadCount = (WORLD_CHUNK_MESH_MIN_SIZE*GPU_CHUNK_SLAB_TIER_COUNT)/4;
+    CAssert( (WORLD_CHUNK_MESH_MIN_SIZE*GPU_CHUNK_SLAB_TIER_COUNT) <= 0xffff+1 );
+
+    ChunkBuffer->QuadIndexCount = QuadCount*6;
+    u16 *Indices = Allocate(u16, Memory, ChunkBuffer->QuadIndexCount);
+    for (u32 QuadIndex = 0; QuadIndex < QuadCount; ++QuadIndex)
+    {
+      u16 Base = u16(QuadIndex*4);
+      u16 *Dest = Indices + (QuadIndex*6);
+      Dest[0] = u16(Base+0);
+      Dest[1] = u16(Base+1);
+      Dest[2] = u16(Base+2);
+      Dest[3] = u16(Base+2);
+      Dest[4] = u16(Base+1);
+      Dest[5] = u16(Base+3);
+    }
+
+    GL.GenBuffers(1, &ChunkBuffer->QuadIndexHandle);
+    GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ChunkBuffer->QuadIndexHandle);
+    GL.BufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u16)*ChunkBuffer->QuadIndexCount, Indices, GL_STATIC_DRAW);
+    GL.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    AssertNoGlErrors;
+  }
+
+  {
+    v3 *PaletteData = Allocate(v3, Memory, 0xff+1);
+    for (u32 PaletteIndex = 0; PaletteIndex < ArrayCount(DefaultPalette); ++PaletteIndex)
+    {
+      PaletteData[PaletteIndex] = GetColorData(DefaultPalette, PaletteIndex).rgb;
+    }
+    ChunkBuffer->PaletteTexture = MakeTexture_RGB(V2i(0xff+1, 1), PaletteData, Memory);
+  }
+
+  ChunkBuffer->ElementCount = ElementCount;
+  ChunkBuffer->ElementsReserved = 0;
+
+  for (u32 TierIndex = 0; TierIndex < GPU_CHUNK_SLAB_TIER_COUNT; ++TierIndex)
+  {
+    gpu_chunk_slab_tier *Tier = ChunkBuffer->Tiers + TierIndex;
+
+    // NOTE(Jesse): A tier can never have more slabs outstanding than would
+    // fit in the whole buffer
+    u32 SlabSize = WORLD_CHUNK_MESH_MIN_SIZE*(TierIndex+1);
+    Tier->Capacity = ElementCount/SlabSize;
+    Tier->FreeSlabs = Allocate(u32, Memory, Tier->Capacity);
+    Tier->FreeCount = 0;
+  }
+
+  ChunkBuffer->DrawCommands = Allocate(gpu_chunk_draw_command, Memory, GPU_CHUNK_MAX_DRAW_COMMANDS);
+  ChunkBuffer->DrawCommandCount = 0;
+}
+
+link_internal s32
+GetGpuChunkSlabTierIndex(u32 ElementCount)
+{
+  Assert(ElementCount);
+
+  // NOTE(Jesse): Same bucketing as TryGetTierForSize
+  if (ElementCount % WORLD_CHUNK_MESH_MIN_SIZE == 0) { ElementCount = ElementCount-1; }
+
+  s32 Result = -1;
+  u32 Index = ElementCount/WORLD_CHUNK_MESH_MIN_SIZE;
+  if (Index < GPU_CHUNK_SLAB_TIER_COUNT) { Result = (s32)Index; }
+  return Result;
+}
+
+link_internal b32
+AllocateGpuChunkSlab(gpu_chunk_buffer *ChunkBuffer, gpu_chunk_slab *Slab, u32 ElementCount)
+{
+  Assert(Slab->ElementCount == 0);
+
+  b32 Result = False;
+
+  s32 TierIndex = GetGpuChunkSlabTierIndex(ElementCount);
+  if (TierIndex >= 0)
+  {
+    gpu_chunk_slab_tier *Tier = ChunkBuffer->Tiers + TierIndex;
+    u32 SlabSize = WORLD_CHUNK_MESH_MIN_SIZE*u32(TierIndex+1);
+
+    if (Tier->FreeCount)
+    {
+      Slab->FirstElement = Tier->FreeSlabs[--Tier->FreeCount];
+      Slab->ElementCount = SlabSize;
+      Result = True;
+    }
+    else if (ChunkBuffer->ElementsReserved + SlabSize <= ChunkBuffer->ElementCount)
+    {
+      Slab->FirstElement = ChunkBuffer->ElementsReserved;
+      Slab->ElementCount = SlabSize;
+      ChunkBuffer->ElementsReserved += SlabSize;
+      Result = True;
+    }
+    else
+    {
+      Perf("gpu_chunk_buffer exhausted allocating slab of (%u) elements", SlabSize);
+    }
+  }
+  else
+  {
+    Warn("Chunk mesh of (%u) elements too large for gpu_chunk_buffer", ElementCount);
+  }
+
+  return Result;
+}
+
+link_internal void
+FreeGpuChunkSlab(gpu_chunk_buffer *ChunkBuffer, gpu_chunk_slab *Slab)
+{
+  if (Slab->ElementCount)
+  {
+    s32 TierIndex = GetGpuChunkSlabTierIndex(Slab->ElementCount);
+    Assert(TierIndex >= 0);
+
+    gpu_chunk_slab_tier *Tier = ChunkBuffer->Tiers + TierIndex;
+    Assert(Tier->FreeCount < Tier->Capacity);
+    Tier->FreeSlabs[Tier->FreeCount++] = Slab->FirstElement;
+  }
+
+  *Slab = {};
+}
+
+// NOTE(Jesse): Maps the front of the slab for writing ElementCount verts.
+// Requires the chunk buffer be bound to GL_ARRAY_BUFFER; returns 0 on failure.
+link_internal packed_chunk_vertex *
+MapGpuChunkSlab(gpu_chunk_slab *Slab, u32 ElementCount)
+{
+  Assert(ElementCount <= Slab->ElementCount);
+
+  umm ByteOffset = sizeof(packed_chunk_vertex)*Slab->FirstElement;
+  umm ByteCount = sizeof(packed_chunk_vertex)*ElementCount;
+
+#if DEBUG_SYSTEM_API
+  debug_state *DebugState = GetDebugState();
+  DebugState->BytesBufferedToCard += ByteCount;
+#endif
+
+  packed_chunk_vertex *Result = (packed_chunk_vertex*)GL.MapBufferRange(GL_ARRAY_BUFFER, (s64)ByteOffset, (s64)ByteCount, GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_RANGE_BIT);
+  if (Result == 0) { Error("Mapping gpu_chunk_buffer range"); }
+  return Result;
+}
+
+link_internal void
+UnmapGpuChunkSlab()
+{
+  if (GL.UnmapBuffer(GL_ARRAY_BUFFER) == False) { Error("glUnmapBuffer Failed"); }
+  AssertNoGlErrors;
+}
+
+// NOTE(Jesse): Makes sure the slab can hold ElementCount verts.  Returns
+// False if it couldn't get one big enough, in which case the slab it had is
+// left alone (and still has the old mesh in it).
+link_internal b32
+ReserveGpuChunkSlab(gpu_chunk_buffer *ChunkBuffer, gpu_chunk_slab *Slab, u32 ElementCount)
+{
+  b32 Result = Slab->ElementCount >= ElementCount;
+  if (!Result)
+  {
+    gpu_chunk_slab NewSlab = {};
+    Result = AllocateGpuChunkSlab(ChunkBuffer, &NewSlab, ElementCount);
+    if (Result)
+    {
+      FreeGpuChunkSlab(ChunkBuffer, Slab);
+      *Slab = NewSlab;
+    }
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Called from the main thread with ownership of the mesh held.
+// A null or empty mesh releases the slab.
+//
+// The meshers already wrote the verts in the format the card wants, so this
+// is a straight copy.  Returns False if the mesh didn't make it onto the card
+// but might next time (the buffer was full, or the map failed); the slab
+// keeps drawing whatever it had until then.
+link_internal b32
+UploadChunkMeshToGpu(gpu_chunk_buffer *ChunkBuffer, gpu_chunk_slab *Slab, packed_chunk_mesh *Mesh)
+{
+  TIMED_FUNCTION();
+
+  b32 Result = True;
+
+  if (Mesh && Mesh->At)
+  {
+    if (GetGpuChunkSlabTierIndex(Mesh->At) < 0)
+    {
+      // NOTE(Jesse): Never going to fit; no sense trying again
+      Warn("Chunk mesh of (%u) elements too large for gpu_chunk_buffer", Mesh->At);
+      FreeGpuChunkSlab(ChunkBuffer, Slab);
+    }
+    else if (ReserveGpuChunkSlab(ChunkBuffer, Slab, Mesh->At))
+    {
+      GL.BindBuffer(GL_ARRAY_BUFFER, ChunkBuffer->VertexHandle);
+      if (packed_chunk_vertex *Dest = MapGpuChunkSlab(Slab, Mesh->At))
+      {
+        MemCopy((u8*)Mesh->Verts, (u8*)Dest, sizeof(packed_chunk_vertex)*Mesh->At);
+        UnmapGpuChunkSlab();
+
+        Slab->UsedCount = Mesh->At;
+        Slab->QuadCount = Mesh->QuadCount;
+      }
+      else
+      {
+        Result = False;
+      }
+      GL.BindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else
+    {
+      Result = False;
+    }
+  }
+  else
+  {
+    FreeGpuChunkSlab(ChunkBuffer, Slab);
+  }
+
+  return Result;
+}
+
+link_internal void
+PushGpuChunkDrawCommand(gpu_chunk_buffer *ChunkBuffer, gpu_chunk_slab *Slab, v3 Basis)
+{
+  if (Slab->UsedCount)
+  {
+    if (ChunkBuffer->DrawCommandCount < GPU_CHUNK_MAX_DRAW_COMMANDS)
+    {
+      gpu_chunk_draw_command *Command = ChunkBuffer->DrawCommands + ChunkBuffer->DrawCommandCount++;
+      Command->FirstElement = Slab->FirstElement;
+      Command->ElementCount = Slab->UsedCount;
+      Command->QuadCount = Slab->QuadCount;
+      Command->Basis = Basis;
+    }
+    else
+    {
+      Perf("Exceeded GPU_CHUNK_MAX_DRAW_COMMANDS");
+    }
+  }
+}
@@ -166,6 +166,263 @@ DeallocateMesh(untextured_3d_geometry_buffer* Mesh, tiered_mesh_freelist* MeshFr
 }
 
 
+// NOTE(Jesse): Ordering must match PackedChunkVertexNormals in the shaders
+link_internal u16
+GetPackedNormalIndex(v3 Normal)
+{
+  r32 AbsX = Abs(Normal.x);
+  r32 AbsY = Abs(Normal.y);
+  r32 AbsZ = Abs(Normal.z);
+
+  u16 Result = 0;
+  if (AbsX >= AbsY && AbsX >= AbsZ)
+  {
+    Result = Normal.x >= 0.f ? 0 : 1;
+  }
+  else if (AbsY >= AbsZ)
+  {
+    Result = Normal.y >= 0.f ? 2 : 3;
+  }
+  else
+  {
+    Result = Normal.z >= 0.f ? 4 : 5;
+  }
+
+  return Result;
+}
+
+link_internal u16
+PackChunkVertexComponent(r32 P)
+{
+  r32 Fixed = (P + PACKED_CHUNK_VERTEX_BIAS) * PACKED_CHUNK_VERTEX_PRECISION;
+  Assert(Fixed >= 0.f && Fixed <= r32(u16_MAX));
+  u16 Result = u16(Min(Max(Fixed + 0.5f, 0.f), r32(u16_MAX)));
+  return Result;
+}
+
+link_internal void
+InitPaletteLookup(palette_lookup *Lookup, v4 *Palette, u32 PaletteCount)
+{
+  Assert(PaletteCount <= 0xff+1);
+
+  Lookup->Palette = Palette;
+  Lookup->PaletteCount = PaletteCount;
+  ZeroMemory(Lookup->Entries, sizeof(Lookup->Entries));
+}
+
+link_internal u32
+PaletteLookupKey(v4 Color)
+{
+  u32 R = u32(Min(Max(Color.r, 0.f), 1.f)*255.f + 0.5f);
+  u32 G = u32(Min(Max(Color.g, 0.f), 1.f)*255.f + 0.5f);
+  u32 B = u32(Min(Max(Color.b, 0.f), 1.f)*255.f + 0.5f);
+  u32 Result = (1 << 24) | (R << 16) | (G << 8) | B;
+  return Result;
+}
+
+// NOTE(Jesse): Meshes store colors as floats after they've been looked up in
+// the palette, so we have to go back the other way to pack them.  Colors that
+// aren't in the palette (ie. LODs that blend colors) get the closest entry.
+link_internal u8
+GetPaletteIndex(palette_lookup *Lookup, v4 Color)
+{
+  u32 Key = PaletteLookupKey(Color);
+
+  u32 Slot = (Key * 2654435761u) % PALETTE_LOOKUP_TABLE_SIZE;
+  for (u32 Probe = 0; Probe < PALETTE_LOOKUP_TABLE_SIZE; ++Probe)
+  {
+    palette_lookup_entry *Entry = Lookup->Entries + ((Slot + Probe) % PALETTE_LOOKUP_TABLE_SIZE);
+
+    if (Entry->Key == Key) { return Entry->ColorIndex; }
+
+    if (Entry->Key == 0)
+    {
+      u8 Closest = 0;
+      r32 ClosestDistSq = f32_MAX;
+      for (u32 PaletteIndex = 0; PaletteIndex < Lookup->PaletteCount; ++PaletteIndex)
+      {
+        v3 PaletteColor = GetColorData(Lookup->Palette, PaletteIndex).rgb;
+        r32 DistSq = LengthSq(PaletteColor - Color.rgb);
+        if (DistSq < ClosestDistSq)
+        {
+          ClosestDistSq = DistSq;
+          Closest = u8(PaletteIndex);
+        }
+      }
+
+      Entry->Key = Key;
+      Entry->ColorIndex = Closest;
+      return Closest;
+    }
+  }
+
+  // NOTE(Jesse): The table is full; this should be impossible because there
+  // are fewer possible keys (distinct palette colors + LOD blends) seen in
+  // practice than there are slots, but don't fall over if it happens.
+  Perf("palette_lookup full");
+  return 0;
+}
+
+link_internal packed_chunk_vertex
+PackChunkVertex(palette_lookup *Lookup, v3 P, v3 Normal, v4 Color)
+{
+  packed_chunk_vertex Result = {
+    .X = PackChunkVertexComponent(P.x),
+    .Y = PackChunkVertexComponent(P.y),
+    .Z = PackChunkVertexComponent(P.z),
+    .NormalAndColor = u16(GetPaletteIndex(Lookup, Color) | (GetPackedNormalIndex(Normal) << 8)),
+  };
+  return Result;
+}
+
+// NOTE(Jesse): Same bucketing as TryGetTierForSize; anything at or past
+// TIERED_MESH_FREELIST_MAX_ELEMENTS is too big to be pooled
+link_internal u32
+GetPackedChunkMeshTierIndex(u32 ElementCount)
+{
+  if (ElementCount % WORLD_CHUNK_MESH_MIN_SIZE == 0) { ElementCount = ElementCount-1; }
+  u32 Result = ElementCount/WORLD_CHUNK_MESH_MIN_SIZE;
+  return Result;
+}
+
+link_internal packed_chunk_mesh *
+AllocatePackedChunkMesh(memory_arena *Memory, u32 ElementCount)
+{
+  packed_chunk_mesh *Result = AllocateAlignedProtection(packed_chunk_mesh, Memory, 1, CACHE_LINE_SIZE, False);
+  Result->Verts = AllocateAlignedProtection(packed_chunk_vertex, Memory, ElementCount, CACHE_LINE_SIZE, False);
+  Result->End = ElementCount;
+  return Result;
+}
+
+link_internal packed_chunk_mesh *
+AllocateTempPackedChunkMesh(memory_arena *TempMemory)
+{
+  packed_chunk_mesh *Result = AllocatePackedChunkMesh(TempMemory, ELEMENTS_PER_TEMP_MESH);
+  return Result;
+}
+
+link_internal packed_chunk_mesh *
+GetTempPackedChunkMesh(packed_chunk_mesh *ScratchMesh, memory_arena *TempMemory)
+{
+  packed_chunk_mesh *Result = ScratchMesh;
+  if (Result)
+  {
+    Result->At = 0;
+    Result->QuadCount = 0;
+  }
+  else
+  {
+    Result = AllocateTempPackedChunkMesh(TempMemory);
+  }
+  return Result;
+}
+
+link_internal packed_chunk_mesh *
+GetPermPackedChunkMesh(packed_chunk_mesh_freelist *Freelist, u32 ElementCount, memory_arena *PermMemory)
+{
+  packed_chunk_mesh *Result = 0;
+
+  u32 TierIndex = GetPackedChunkMeshTierIndex(ElementCount);
+  if (TierIndex < TIERED_MESH_FREELIST_MAX_ELEMENTS)
+  {
+    AcquireFutex(&Freelist->Lock);
+    Result = Freelist->FirstFree[TierIndex];
+    if (Result) { Freelist->FirstFree[TierIndex] = Result->NextFree; }
+    ReleaseFutex(&Freelist->Lock);
+
+    if (Result) { Result->NextFree = 0; }
+    else        { Result = AllocatePackedChunkMesh(PermMemory, WORLD_CHUNK_MESH_MIN_SIZE*(TierIndex+1)); }
+  }
+  else
+  {
+    Result = AllocatePackedChunkMesh(PermMemory, ElementCount);
+  }
+
+  Assert(Result->At == 0);
+  Assert(Result->End >= ElementCount);
+  return Result;
+}
+
+link_internal void
+DeallocatePackedChunkMesh(packed_chunk_mesh_freelist *Freelist, packed_chunk_mesh *Mesh)
+{
+  Assert(Mesh);
+
+  u32 TierIndex = GetPackedChunkMeshTierIndex(Mesh->End);
+  if (TierIndex < TIERED_MESH_FREELIST_MAX_ELEMENTS)
+  {
+    Assert(Mesh->End == WORLD_CHUNK_MESH_MIN_SIZE*(TierIndex+1));
+
+    Mesh->At = 0;
+    Mesh->QuadCount = 0;
+
+    AcquireFutex(&Freelist->Lock);
+    Mesh->NextFree = Freelist->FirstFree[TierIndex];
+    Freelist->FirstFree[TierIndex] = Mesh;
+    ReleaseFutex(&Freelist->Lock);
+  }
+  else
+  {
+    Leak("Large packed mesh detected!");
+  }
+}
+
+link_internal void
+DeepCopy(packed_chunk_mesh *Src, packed_chunk_mesh *Dest)
+{
+  Assert(Dest->End >= Src->At);
+
+  MemCopy((u8*)Src->Verts, (u8*)Dest->Verts, sizeof(packed_chunk_vertex)*Src->At);
+  Dest->At = Src->At;
+  Dest->QuadCount = Src->QuadCount;
+  Dest->Timestamp = Src->Timestamp;
+}
+
+// NOTE(Jesse): Packs a float mesh as plain triangles.  For the meshes that
+// don't come out of the world chunk meshers (smooth LODs, and meshes stored in
+// chunk records); runs on the workers so the main thread only ever copies.
+link_internal void
+PackChunkMesh(palette_lookup *Lookup, untextured_3d_geometry_buffer *Src, packed_chunk_mesh *Dest)
+{
+  TIMED_FUNCTION();
+
+  Assert(Dest->End >= Src->At);
+
+  for (u32 VertIndex = 0; VertIndex < Src->At; ++VertIndex)
+  {
+    Dest->Verts[VertIndex] = PackChunkVertex(Lookup, Src->Verts[VertIndex], Src->Normals[VertIndex], Src->Colors[VertIndex]);
+  }
+
+  Dest->At = Src->At;
+  Dest->QuadCount = 0;
+  Dest->Timestamp = Src->Timestamp;
+}
+
+// NOTE(Jesse): Scales the positions about the chunk origin, which is
+// PACKED_CHUNK_VERTEX_BIAS voxels in.  Done on the fixed point values, which
+// is exact because they're already on the voxel grid.
+link_internal u16
+ScalePackedChunkVertexComponent(u16 Component, s32 Scale)
+{
+  s32 Origin = s32(PACKED_CHUNK_VERTEX_BIAS*PACKED_CHUNK_VERTEX_PRECISION);
+  s32 Scaled = Origin + (s32(Component) - Origin)*Scale;
+  Assert(Scaled >= 0 && Scaled <= s32(u16_MAX));
+  u16 Result = u16(Min(Max(Scaled, 0), s32(u16_MAX)));
+  return Result;
+}
+
+link_internal void
+ScalePackedChunkMesh(packed_chunk_mesh *Mesh, s32 Scale)
+{
+  for (u32 VertIndex = 0; VertIndex < Mesh->At; ++VertIndex)
+  {
+    packed_chunk_vertex *Vert = Mesh->Verts + VertIndex;
+    Vert->X = ScalePackedChunkVertexComponent(Vert->X, Scale);
+    Vert->Y = ScalePackedChunkVertexComponent(Vert->Y, Scale);
+    Vert->Z = ScalePackedChunkVertexComponent(Vert->Z, Scale);
+  }
+}
+
 link_internal void
 DeallocateMeshes(threadsafe_geometry_buffer *Buf, tiered_mesh_freelist* MeshFreelist, memory_arena* Memory)
 {
@@ -173,6 +430,15 @@ DeallocateMeshes(threadsafe_geometry_buffer *Buf, tiered_mesh_freelist* MeshFree
   if ( auto Mesh = AtomicReplaceMesh(Buf, MeshBit_Lod,   0, __rdtsc()) ) { DeallocateMesh(Mesh, MeshFreelist, Memory); }
   if ( auto Mesh = AtomicReplaceMesh(Buf, MeshBit_Debug, 0, __rdtsc()) ) { DeallocateMesh(Mesh, MeshFreelist, Memory); }
 
+  // NOTE(Jesse): Chunks that never had a packed mesh (ie. the ones the tests
+  // build) don't need the engine resources to be around
+  if (Buf->Packed[MeshIndex_Main] || Buf->Packed[MeshIndex_Lod])
+  {
+    packed_chunk_mesh_freelist *PackedFreelist = &GetEngineResources()->PackedMeshFreelist;
+    if ( auto Mesh = AtomicReplacePackedMesh(Buf, MeshBit_Main, 0, __rdtsc()) ) { DeallocatePackedChunkMesh(PackedFreelist, Mesh); }
+    if ( auto Mesh = AtomicReplacePackedMesh(Buf, MeshBit_Lod,  0, __rdtsc()) ) { DeallocatePackedChunkMesh(PackedFreelist, Mesh); }
+  }
+
   Buf->MeshMask = 0;
 }
 
@@ -0,0 +1,201 @@
+// NOTE(Jesse): Batched improved-Perlin noise.
+//
+// Evaluates PERLIN_NOISE_BATCH_WIDTH samples per call.  The lattice math
+// (floor, fade, gradient, lerp) runs four lanes at a time in SSE2; the
+// permutation lookups are done per-lane since SSE2 has no gather.  The
+// result is the same [0, 1] value the scalar PerlinNoise(x, y, z) returns.
+//
+// Callers are expected to lay their samples out as a struct-of-arrays, ie.
+// eight x's, eight y's and eight z's.
+
+#define PERLIN_NOISE_BATCH_WIDTH (8)
+
+global_variable u8 Global_PerlinPermutation[512] =
+{
+  151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,
+  8,99,37,240,21,10,23,190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,
+  35,11,32,57,177,33,88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,
+  134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,
+  55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,
+  18,169,200,196,135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,
+  250,124,123,5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,
+  189,28,42,223,183,170,213,119,248,152,2,44,154,163,70,221,153,101,155,167,43,
+  172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,
+  228,251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,
+  107,49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,
+
+  // NOTE(Jesse): Repeated so lookups of p[Hash+1] never need to wrap
+  151,160,137,91,90,15,131,13,201,95,96,53,194,233,7,225,140,36,103,30,69,142,
+  8,99,37,240,21,10,23,190,6,148,247,120,234,75,0,26,197,62,94,252,219,203,117,
+  35,11,32,57,177,33,88,237,149,56,87,174,20,125,136,171,168,68,175,74,165,71,
+  134,139,48,27,166,77,146,158,231,83,111,229,122,60,211,133,230,220,105,92,41,
+  55,46,245,40,244,102,143,54,65,25,63,161,1,216,80,73,209,76,132,187,208,89,
+  18,169,200,196,135,130,116,188,159,86,164,100,109,198,173,186,3,64,52,217,226,
+  250,124,123,5,202,38,147,118,126,255,82,85,212,207,206,59,227,47,16,58,17,182,
+  189,28,42,223,183,170,213,119,248,152,2,44,154,163,70,221,153,101,155,167,43,
+  172,9,129,22,39,253,19,98,108,110,79,113,224,232,178,185,112,104,218,246,97,
+  228,251,34,242,193,238,210,144,12,191,179,162,241,81,51,145,235,249,14,239,
+  107,49,192,214,31,181,199,106,157,184,84,204,176,115,121,50,45,127,4,150,254,
+  138,236,205,93,222,114,67,29,24,72,243,141,128,195,78,66,215,61,156,180,
+};
+
+#if defined(__SSE2__)
+
+struct perlin_corner_hashes
+{
+  // NOTE(Jesse): Hash of each of the 8 cell corners, for each of 4 lanes.
+  // Corners are numbered by their (z,y,x) offset bits.
+  s32 E[8][4];
+};
+
+link_internal __m128
+PerlinFloor_4x(__m128 V)
+{
+  __m128 Truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(V));
+  __m128 Correction = _mm_and_ps(_mm_cmpgt_ps(Truncated, V), _mm_set1_ps(1.f));
+  __m128 Result = _mm_sub_ps(Truncated, Correction);
+  return Result;
+}
+
+link_internal __m128
+PerlinFade_4x(__m128 t)
+{
+  // t * t * t * (t * (t * 6 - 15) + 10)
+  __m128 Result = _mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.f)), _mm_set1_ps(15.f)));
+  Result = _mm_add_ps(Result, _mm_set1_ps(10.f));
+  Result = _mm_mul_ps(Result, _mm_mul_ps(t, _mm_mul_ps(t, t)));
+  return Result;
+}
+
+link_internal __m128
+PerlinLerp_4x(__m128 t, __m128 a, __m128 b)
+{
+  __m128 Result = _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+  return Result;
+}
+
+link_internal __m128
+PerlinSelect_4x(__m128 Mask, __m128 IfTrue, __m128 IfFalse)
+{
+  __m128 Result = _mm_or_ps(_mm_and_ps(Mask, IfTrue), _mm_andnot_ps(Mask, IfFalse));
+  return Result;
+}
+
+link_internal __m128
+PerlinGrad_4x(s32 *Hashes, __m128 x, __m128 y, __m128 z)
+{
+  __m128i h = _mm_and_si128(_mm_loadu_si128((__m128i*)Hashes), _mm_set1_epi32(15));
+
+  __m128 LessThan8 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+  __m128 LessThan4 = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+  __m128 Is12or14  = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                    _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+
+  __m128 u = PerlinSelect_4x(LessThan8, x, y);
+  __m128 v = PerlinSelect_4x(LessThan4, y, PerlinSelect_4x(Is12or14, x, z));
+
+  // NOTE(Jesse): Move bit 0 and bit 1 of the hash up to the float sign bit
+  __m128 uSign = _mm_castsi128_ps(_mm_slli_epi32(h, 31));
+  __m128 vSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_srli_epi32(h, 1), 31));
+
+  __m128 Result = _mm_add_ps(_mm_xor_ps(u, uSign), _mm_xor_ps(v, vSign));
+  return Result;
+}
+
+link_internal void
+PerlinNoise_4x(f32 *InX, f32 *InY, f32 *InZ, f32 *Result)
+{
+  __m128 x = _mm_loadu_ps(InX);
+  __m128 y = _mm_loadu_ps(InY);
+  __m128 z = _mm_loadu_ps(InZ);
+
+  __m128 FloorX = PerlinFloor_4x(x);
+  __m128 FloorY = PerlinFloor_4x(y);
+  __m128 FloorZ = PerlinFloor_4x(z);
+
+  __m128i Mask255 = _mm_set1_epi32(255);
+
+  s32 CellX[4], CellY[4], CellZ[4];
+  _mm_storeu_si128((__m128i*)CellX, _mm_and_si128(_mm_cvtps_epi32(FloorX), Mask255));
+  _mm_storeu_si128((__m128i*)CellY, _mm_and_si128(_mm_cvtps_epi32(FloorY), Mask255));
+  _mm_storeu_si128((__m128i*)CellZ, _mm_and_si128(_mm_cvtps_epi32(FloorZ), Mask255));
+
+  x = _mm_sub_ps(x, FloorX);
+  y = _mm_sub_ps(y, FloorY);
+  z = _mm_sub_ps(z, FloorZ);
+
+  perlin_corner_hashes Hashes;
+  u8 *p = Global_PerlinPermutation;
+  for (u32 Lane = 0; Lane < 4; ++Lane)
+  {
+    s32 A  = p[CellX[Lane]]   + CellY[Lane];
+    s32 AA = p[A]             + CellZ[Lane];
+    s32 AB = p[A+1]           + CellZ[Lane];
+    s32 B  = p[CellX[Lane]+1] + CellY[Lane];
+    s32 BA = p[B]             + CellZ[Lane];
+    s32 BB = p[B+1]           + CellZ[Lane];
+
+    Hashes.E[0][Lane] = p[AA];
+    Hashes.E[1][Lane] = p[BA];
+    Hashes.E[2][Lane] = p[AB];
+    Hashes.E[3][Lane] = p[BB];
+    Hashes.E[4][Lane] = p[AA+1];
+    Hashes.E[5][Lane] = p[BA+1];
+    Hashes.E[6][Lane] = p[AB+1];
+    Hashes.E[7][Lane] = p[BB+1];
+  }
+
+  __m128 u = PerlinFade_4x(x);
+  __m128 v = PerlinFade_4x(y);
+  __m128 w = PerlinFade_4x(z);
+
+  __m128 One = _mm_set1_ps(1.f);
+  __m128 x1 = _mm_sub_ps(x, One);
+  __m128 y1 = _mm_sub_ps(y, One);
+  __m128 z1 = _mm_sub_ps(z, One);
+
+  __m128 Near = PerlinLerp_4x(v, PerlinLerp_4x(u, PerlinGrad_4x(Hashes.E[0], x, y,  z),
+                                                  PerlinGrad_4x(Hashes.E[1], x1, y,  z)),
+                                 PerlinLerp_4x(u, PerlinGrad_4x(Hashes.E[2], x, y1, z),
+                                                  PerlinGrad_4x(Hashes.E[3], x1, y1, z)));
+
+  __m128 Far  = PerlinLerp_4x(v, PerlinLerp_4x(u, PerlinGrad_4x(Hashes.E[4], x, y,  z1),
+                                                  PerlinGrad_4x(Hashes.E[5], x1, y,  z1)),
+                                 PerlinLerp_4x(u, PerlinGrad_4x(Hashes.E[6], x, y1, z1),
+                                                  PerlinGrad_4x(Hashes.E[7], x1, y1, z1)));
+
+  __m128 Noise = PerlinLerp_4x(w, Near, Far);
+
+  // NOTE(Jesse): Remap from [-1, 1] to [0, 1]
+  Noise = _mm_mul_ps(_mm_add_ps(Noise, One), _mm_set1_ps(0.5f));
+
+  _mm_storeu_ps(Result, Noise);
+}
+
+link_internal void
+PerlinNoise_8x(f32 *InX, f32 *InY, f32 *InZ, f32 *Result)
+{
+  PerlinNoise_4x(InX,   InY,   InZ,   Result);
+  PerlinNoise_4x(InX+4, InY+4, InZ+4, Result+4);
+}
+
+#else
+
+link_internal void
+PerlinNoise_8x(f32 *InX, f32 *InY, f32 *InZ, f32 *Result)
+{
+  for (u32 Lane = 0; Lane < PERLIN_NOISE_BATCH_WIDTH; ++Lane)
+  {
+    Result[Lane] = PerlinNoise(InX[Lane], InY[Lane], InZ[Lane]);
+  }
+}
+
+#endif
+
+link_internal void
+PerlinNoise_16x(f32 *InX, f32 *InY, f32 *InZ, f32 *Result)
+{
+  PerlinNoise_8x(InX,   InY,   InZ,   Result);
+  PerlinNoise_8x(InX+8, InY+8, InZ+8, Result+8);
+}
@@ -0,0 +1,368 @@
+// NOTE(Jesse): See occlusion_buffer.  Occluders are boxes the caller knows are
+// solid; each one's faces that point at the eye go in as triangles, and every
+// band of rows is rasterized by its own job.  Pixels are covered when their
+// center is, so an occluder can cover up to half a pixel more than it really
+// does, same as a GPU would.  The depth written is the farthest the triangle
+// gets anywhere in the pixel, which is what keeps the test conservative.
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+CAssert(OCCLUSION_BUFFER_WIDTH % 4 == 0);
+CAssert(OCCLUSION_BUFFER_HEIGHT % OCCLUSION_BUFFER_BAND_COUNT == 0);
+
+// NOTE(Jesse): Tangent of half the buffer's field of view on each axis; wide
+// enough to cover the real camera, with square pixels
+#define OCCLUSION_TAN_HALF_FOV_X (1.f)
+#define OCCLUSION_TAN_HALF_FOV_Y (OCCLUSION_TAN_HALF_FOV_X*r32(OCCLUSION_BUFFER_HEIGHT)/r32(OCCLUSION_BUFFER_WIDTH))
+
+// NOTE(Jesse): Anything closer to the eye than this isn't projected; boxes
+// that reach past it are skipped as occluders and always visible as occludees
+#define OCCLUSION_NEAR_CLIP (1.f)
+
+// NOTE(Jesse): Corner i of a box is Min, plus the x dim if bit 0 is set, the
+// y dim if bit 1 is, and the z dim if bit 2 is.  Faces go -x, +x, -y, +y, -z, +z.
+global_variable u32 Global_BoxFaceCorners[6][4] =
+{
+  {0, 2, 6, 4},
+  {1, 3, 7, 5},
+  {0, 1, 5, 4},
+  {2, 3, 7, 6},
+  {0, 1, 3, 2},
+  {4, 5, 7, 6},
+};
+
+link_internal occlusion_buffer *
+AllocateOcclusionBuffer(memory_arena *Memory)
+{
+  occlusion_buffer *Buffer = Allocate(occlusion_buffer, Memory, 1);
+  Buffer->InvDepth = AllocateAlignedProtection(r32, Memory, OCCLUSION_BUFFER_WIDTH*OCCLUSION_BUFFER_HEIGHT, CACHE_LINE_SIZE, False);
+  Buffer->Triangles = AllocateAlignedProtection(occluder_triangle, Memory, OCCLUSION_MAX_OCCLUDERS*6, CACHE_LINE_SIZE, False);
+  InitWorkCounter(&Buffer->Bands, 0);
+  return Buffer;
+}
+
+link_internal void
+BeginOcclusionBuffer(occlusion_buffer *Buffer, v3 EyeP, v3 Front)
+{
+  Buffer->TriangleCount = 0;
+  Buffer->OccluderCount = 0;
+
+  Buffer->Enabled = LengthSq(Front) > 0.f;
+  if (Buffer->Enabled)
+  {
+    Buffer->EyeP = EyeP;
+    Buffer->Front = Normalize(Front);
+
+    // NOTE(Jesse): Our own basis; the camera's is degenerate looking straight
+    // up or down
+    v3 WorldUp = Abs(Buffer->Front.z) < 0.99f ? V3(0,0,1) : V3(0,1,0);
+    Buffer->Right = Normalize(Cross(Buffer->Front, WorldUp));
+    Buffer->Up = Cross(Buffer->Right, Buffer->Front);
+  }
+
+  ZeroMemory(Buffer->InvDepth, sizeof(r32)*OCCLUSION_BUFFER_WIDTH*OCCLUSION_BUFFER_HEIGHT);
+}
+
+// NOTE(Jesse): x and y are in pixels, z is the distance along Front
+link_internal v3
+ProjectToOcclusionBuffer(occlusion_buffer *Buffer, v3 P)
+{
+  v3 ToP = P - Buffer->EyeP;
+
+  r32 Depth = Dot(ToP, Buffer->Front);
+  r32 x = Dot(ToP, Buffer->Right) / (Depth*OCCLUSION_TAN_HALF_FOV_X);
+  r32 y = Dot(ToP, Buffer->Up)    / (Depth*OCCLUSION_TAN_HALF_FOV_Y);
+
+  v3 Result = V3( (x*0.5f + 0.5f)*r32(OCCLUSION_BUFFER_WIDTH),
+                  (y*0.5f + 0.5f)*r32(OCCLUSION_BUFFER_HEIGHT),
+                  Depth );
+  return Result;
+}
+
+// NOTE(Jesse): Returns false if the box is too close to the eye to project,
+// in which case Corners is garbage
+link_internal b32
+ProjectBoxToOcclusionBuffer(occlusion_buffer *Buffer, aabb *Box, v3 *Corners)
+{
+  b32 Result = True;
+
+  v3 BoxMin = Box->Center - Box->Radius;
+  v3 Dim = Box->Radius*2.f;
+
+  for (u32 CornerIndex = 0; CornerIndex < 8; ++CornerIndex)
+  {
+    v3 P = BoxMin + V3( (CornerIndex & 1) ? Dim.x : 0.f,
+                     (CornerIndex & 2) ? Dim.y : 0.f,
+                     (CornerIndex & 4) ? Dim.z : 0.f );
+
+    Corners[CornerIndex] = ProjectToOcclusionBuffer(Buffer, P);
+    if (Corners[CornerIndex].z < OCCLUSION_NEAR_CLIP) { Result = False; break; }
+  }
+
+  return Result;
+}
+
+link_internal void
+PushOccluderTriangle(occlusion_buffer *Buffer, v3 A, v3 B, v3 C)
+{
+  Assert(Buffer->TriangleCount < OCCLUSION_MAX_OCCLUDERS*6);
+
+  occluder_triangle *Tri = Buffer->Triangles + Buffer->TriangleCount++;
+  Tri->P[0] = A.xy; Tri->InvDepth[0] = 1.f/A.z;
+  Tri->P[1] = B.xy; Tri->InvDepth[1] = 1.f/B.z;
+  Tri->P[2] = C.xy; Tri->InvDepth[2] = 1.f/C.z;
+}
+
+// NOTE(Jesse): Box has to be solid all the way through.  Returns false if it
+// wasn't added.
+link_internal b32
+AddOccluder(occlusion_buffer *Buffer, aabb *Box)
+{
+  b32 Result = False;
+
+  if (Buffer->Enabled && Buffer->OccluderCount < OCCLUSION_MAX_OCCLUDERS)
+  {
+    v3 Corners[8];
+    if (ProjectBoxToOcclusionBuffer(Buffer, Box, Corners))
+    {
+      v3 BoxMin = Box->Center - Box->Radius;
+      v3 BoxMax = Box->Center + Box->Radius;
+
+      for (u32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+      {
+        u32 Axis = FaceIndex/2;
+        b32 FacesEye = (FaceIndex & 1) ? Buffer->EyeP.E[Axis] > BoxMax.E[Axis] :
+                                         Buffer->EyeP.E[Axis] < BoxMin.E[Axis];
+        if (FacesEye)
+        {
+          u32 *Face = Global_BoxFaceCorners[FaceIndex];
+          PushOccluderTriangle(Buffer, Corners[Face[0]], Corners[Face[1]], Corners[Face[2]]);
+          PushOccluderTriangle(Buffer, Corners[Face[0]], Corners[Face[2]], Corners[Face[3]]);
+        }
+      }
+
+      ++Buffer->OccluderCount;
+      Result = True;
+    }
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): a*x + b*y + c, positive on the inside of the edge from P0 to
+// P1 when the triangle winds counter-clockwise
+struct occlusion_edge
+{
+  r32 a;
+  r32 b;
+  r32 c;
+};
+
+link_internal occlusion_edge
+OcclusionEdge(v2 P0, v2 P1)
+{
+  occlusion_edge Result;
+  Result.a = -(P1.y - P0.y);
+  Result.b =  (P1.x - P0.x);
+  Result.c = -(Result.a*P0.x + Result.b*P0.y);
+  return Result;
+}
+
+link_internal void
+RasterizeOccluderTriangle(r32 *InvDepth, occluder_triangle *Tri, s32 BandMinY, s32 BandMaxY)
+{
+  v2 P0 = Tri->P[0];
+  v2 P1 = Tri->P[1];
+  v2 P2 = Tri->P[2];
+  r32 W0 = Tri->InvDepth[0];
+  r32 W1 = Tri->InvDepth[1];
+  r32 W2 = Tri->InvDepth[2];
+
+  r32 Area = (P1.x - P0.x)*(P2.y - P0.y) - (P1.y - P0.y)*(P2.x - P0.x);
+  if (Abs(Area) < 0.0001f) { return; }
+
+  if (Area < 0.f)
+  {
+    v2 TempP = P1; P1 = P2; P2 = TempP;
+    r32 TempW = W1; W1 = W2; W2 = TempW;
+    Area = -Area;
+  }
+
+  s32 MinX = Max(0,                      s32(Floor(Min(P0.x, Min(P1.x, P2.x)))));
+  s32 MaxX = Min(OCCLUSION_BUFFER_WIDTH, s32(Ceil( Max(P0.x, Max(P1.x, P2.x)))));
+  s32 MinY = Max(BandMinY,               s32(Floor(Min(P0.y, Min(P1.y, P2.y)))));
+  s32 MaxY = Min(BandMaxY,               s32(Ceil( Max(P0.y, Max(P1.y, P2.y)))));
+  if (MinX >= MaxX || MinY >= MaxY) { return; }
+
+  MinX &= ~3;
+
+  // NOTE(Jesse): Each edge function is the barycentric weight of the vertex
+  // across from it, times Area
+  occlusion_edge E12 = OcclusionEdge(P1, P2);
+  occlusion_edge E20 = OcclusionEdge(P2, P0);
+  occlusion_edge E01 = OcclusionEdge(P0, P1);
+
+  r32 OneOverArea = 1.f/Area;
+  r32 Wa = (W0*E12.a + W1*E20.a + W2*E01.a)*OneOverArea;
+  r32 Wb = (W0*E12.b + W1*E20.b + W2*E01.b)*OneOverArea;
+  r32 Wc = (W0*E12.c + W1*E20.c + W2*E01.c)*OneOverArea;
+
+  // NOTE(Jesse): From the pixel center to the farthest point in the pixel
+  r32 WSlack = 0.5f*(Abs(Wa) + Abs(Wb));
+
+  for (s32 y = MinY; y < MaxY; ++y)
+  {
+    r32 Py = r32(y) + 0.5f;
+    r32 *Row = InvDepth + y*OCCLUSION_BUFFER_WIDTH;
+
+    r32 RowE12 = E12.b*Py + E12.c;
+    r32 RowE20 = E20.b*Py + E20.c;
+    r32 RowE01 = E01.b*Py + E01.c;
+    r32 RowW   = Wb*Py + Wc - WSlack;
+
+#if defined(__SSE2__)
+    __m128 Zero = _mm_setzero_ps();
+    __m128 LaneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+    for (s32 x = MinX; x < MaxX; x += 4)
+    {
+      __m128 Px = _mm_add_ps(_mm_set1_ps(r32(x)), LaneOffsets);
+
+      __m128 Inside =                  _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(E12.a), Px), _mm_set1_ps(RowE12)), Zero);
+      Inside = _mm_and_ps(Inside,      _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(E20.a), Px), _mm_set1_ps(RowE20)), Zero));
+      Inside = _mm_and_ps(Inside,      _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(E01.a), Px), _mm_set1_ps(RowE01)), Zero));
+
+      if (_mm_movemask_ps(Inside))
+      {
+        __m128 W   = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(Wa), Px), _mm_set1_ps(RowW));
+        __m128 Old = _mm_load_ps(Row + x);
+        __m128 New = _mm_max_ps(Old, W);
+        _mm_store_ps(Row + x, _mm_or_ps(_mm_and_ps(Inside, New), _mm_andnot_ps(Inside, Old)));
+      }
+    }
+#else
+    for (s32 x = MinX; x < MaxX; ++x)
+    {
+      r32 Px = r32(x) + 0.5f;
+      if ( E12.a*Px + RowE12 >= 0.f &&
+           E20.a*Px + RowE20 >= 0.f &&
+           E01.a*Px + RowE01 >= 0.f )
+      {
+        Row[x] = Max(Row[x], Wa*Px + RowW);
+      }
+    }
+#endif
+  }
+}
+
+link_internal void
+RasterizeOcclusionBand(occlusion_buffer *Buffer, u32 BandIndex)
+{
+  TIMED_FUNCTION();
+
+  s32 BandHeight = OCCLUSION_BUFFER_HEIGHT/OCCLUSION_BUFFER_BAND_COUNT;
+  s32 BandMinY = s32(BandIndex)*BandHeight;
+  s32 BandMaxY = BandMinY + BandHeight;
+
+  for (u32 TriIndex = 0; TriIndex < Buffer->TriangleCount; ++TriIndex)
+  {
+    RasterizeOccluderTriangle(Buffer->InvDepth, Buffer->Triangles + TriIndex, BandMinY, BandMaxY);
+  }
+}
+
+// NOTE(Jesse): Rasterizes the occluders that have been added.  The bands go
+// out as jobs on Queue, except for the first, which we do ourselves; then we
+// help with whatever's left.  With no Queue every band is done right here.
+link_internal void
+RasterizeOcclusionBuffer(occlusion_buffer *Buffer, work_queue *Queue, memory_arena *JobMemory)
+{
+  TIMED_FUNCTION();
+
+  if (Buffer->TriangleCount == 0) { return; }
+
+  if (Queue)
+  {
+    Assert(WorkCounterIsDone(&Buffer->Bands));
+    InitWorkCounter(&Buffer->Bands, 1);
+
+    for (u32 BandIndex = 1; BandIndex < OCCLUSION_BUFFER_BAND_COUNT; ++BandIndex)
+    {
+      work_queue_entry_rasterize_occluders Job = { .Buffer = Buffer, .BandIndex = BandIndex };
+      work_queue_entry Entry = WorkQueueEntry(Job);
+      PushCountedWorkQueueEntry(Queue, &Entry, &Buffer->Bands, JobMemory);
+    }
+
+    RasterizeOcclusionBand(Buffer, 0);
+    SignalWorkCounter(&Buffer->Bands);
+
+    WaitForWorkCounterOnMainThread(&Buffer->Bands, Queue);
+  }
+  else
+  {
+    for (u32 BandIndex = 0; BandIndex < OCCLUSION_BUFFER_BAND_COUNT; ++BandIndex)
+    {
+      RasterizeOcclusionBand(Buffer, BandIndex);
+    }
+  }
+}
+
+// NOTE(Jesse): True only if every pixel the box could touch has an occluder
+// in front of the nearest point of the box
+link_internal b32
+IsOccluded(occlusion_buffer *Buffer, aabb *Box)
+{
+  if (Buffer->Enabled == False || Buffer->TriangleCount == 0) { return False; }
+
+  v3 Corners[8];
+  if (ProjectBoxToOcclusionBuffer(Buffer, Box, Corners) == False) { return False; }
+
+  v3 MinP = Corners[0];
+  v3 MaxP = Corners[0];
+  for (u32 CornerIndex = 1; CornerIndex < 8; ++CornerIndex)
+  {
+    MinP = Min(MinP, Corners[CornerIndex]);
+    MaxP = Max(MaxP, Corners[CornerIndex]);
+  }
+
+  // NOTE(Jesse): Anything hanging off the edge of the buffer might be seen
+  if ( MinP.x < 0.f || MaxP.x > r32(OCCLUSION_BUFFER_WIDTH) ||
+       MinP.y < 0.f || MaxP.y > r32(OCCLUSION_BUFFER_HEIGHT) ) { return False; }
+
+  r32 NearestInvDepth = 1.f/MinP.z;
+
+  s32 MinX = s32(Floor(MinP.x));
+  s32 MaxX = Min(OCCLUSION_BUFFER_WIDTH,  s32(Ceil(MaxP.x)));
+  s32 MinY = s32(Floor(MinP.y));
+  s32 MaxY = Min(OCCLUSION_BUFFER_HEIGHT, s32(Ceil(MaxP.y)));
+
+  for (s32 y = MinY; y < MaxY; ++y)
+  {
+    r32 *Row = Buffer->InvDepth + y*OCCLUSION_BUFFER_WIDTH;
+
+#if defined(__SSE2__)
+    __m128 Nearest = _mm_set1_ps(NearestInvDepth);
+    __m128i LaneIndices = _mm_setr_epi32(0, 1, 2, 3);
+
+    for (s32 x = MinX & ~3; x < MaxX; x += 4)
+    {
+      // NOTE(Jesse): Only the lanes in [MinX, MaxX) count
+      __m128i Lanes = _mm_add_epi32(_mm_set1_epi32(x), LaneIndices);
+      __m128i InRange = _mm_and_si128( _mm_cmpgt_epi32(Lanes, _mm_set1_epi32(MinX - 1)),
+                                       _mm_cmplt_epi32(Lanes, _mm_set1_epi32(MaxX)) );
+
+      __m128 Hidden = _mm_cmpgt_ps(_mm_load_ps(Row + x), Nearest);
+      __m128 Seen = _mm_andnot_ps(Hidden, _mm_castsi128_ps(InRange));
+      if (_mm_movemask_ps(Seen)) { return False; }
+    }
+#else
+    for (s32 x = MinX; x < MaxX; ++x)
+    {
+      if (Row[x] <= NearestInvDepth) { return False; }
+    }
+#endif
+  }
+
+  return True;
+}
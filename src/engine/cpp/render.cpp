@@ -186,6 +186,37 @@ GetShadowMapMVP(light *Sun)
 #endif
 
 
+link_internal void
+DrawGpuChunkBuffer(gpu_chunk_buffer *ChunkBuffer, s32 ChunkBasisUniform, s32 UsePackedVerticesUniform)
+{
+  TIMED_FUNCTION();
+
+  BindGpuChunkBuffer(ChunkBuffer);
+  GL.Uniform1i(UsePackedVerticesUniform, True);
+
+  for (u32 CommandIndex = 0; CommandIndex < ChunkBuffer->DrawCommandCount; ++CommandIndex)
+  {
+    gpu_chunk_draw_command *Command = ChunkBuffer->DrawCommands + CommandIndex;
+    GL.Uniform3fv(ChunkBasisUniform, 1, Command->Basis.E);
+    BindGpuChunkSlab(Command->FirstElement);
+
+    if (Command->QuadCount)
+    {
+      Assert(Command->QuadCount*6 <= ChunkBuffer->QuadIndexCount);
+      DrawQuads(Command->QuadCount);
+    }
+    else
+    {
+      Draw(Command->ElementCount);
+    }
+  }
+
+  GL.Uniform1i(UsePackedVerticesUniform, False);
+  UnbindGpuChunkBuffer();
+
+  AssertNoGlErrors;
+}
+
 link_internal void
 RenderShadowMap(gpu_mapped_element_buffer *GpuMap, graphics *Graphics)
 {
@@ -201,8 +232,13 @@ RenderShadowMap(gpu_mapped_element_buffer *GpuMap, graphics *Graphics)
   SG->MVP = GetShadowMapMVP(&SG->Sun);
   GL.UniformMatrix4fv(SG->MVP_ID, 1, GL_FALSE, &SG->MVP.E[0].E[0]);
 
+  GL.Uniform3fv(SG->ChunkBasis_ID, 1, V3(0).E);
+  GL.Uniform1i(SG->UsePackedVertices_ID, False);
+  BindGpuElementBuffer(GpuMap);
   Draw(GpuMap->Buffer.At);
 
+  DrawGpuChunkBuffer(&Graphics->ChunkBuffer, SG->ChunkBasis_ID, SG->UsePackedVertices_ID);
+
   GL.BindFramebuffer(GL_FRAMEBUFFER, 0);
 
   return;
@@ -223,9 +259,13 @@ RenderGBuffer(gpu_mapped_element_buffer *GpuMap, graphics *Graphics)
 
   BindShaderUniforms(&RG->gBufferShader);
 
+  GL.Uniform3fv(RG->ChunkBasisUniform, 1, V3(0).E);
+  GL.Uniform1i(RG->UsePackedVerticesUniform, False);
   FlushBuffersToCard(GpuMap);
   Draw(GpuMap->Buffer.At);
 
+  DrawGpuChunkBuffer(&Graphics->ChunkBuffer, RG->ChunkBasisUniform, RG->UsePackedVerticesUniform);
+
   AssertNoGlErrors;
 
   return;
@@ -693,7 +733,7 @@ inline b32
 IsBoundaryVoxel(world_chunk *Chunk, voxel_position Offset, chunk_dimension Dim)
 {
   s32 VoxelIndex = GetIndex(Offset, Dim);
-  voxel *V = &Chunk->Voxels[VoxelIndex];
+  voxel *V = Chunk->Voxels ? &Chunk->Voxels[VoxelIndex] : &Chunk->UniformVoxel;
 
   b32 Result = False;
   Result |= IsSet( V, Voxel_BackFace);
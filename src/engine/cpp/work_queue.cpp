@@ -1,48 +1,316 @@
+// NOTE(Jesse): The queue is a bounded MPMC ring where every slot carries a
+// sequence number saying whose turn it is.  EnqueueIndex and DequeueIndex
+// count up forever and are only reduced to a slot index on use.
+//
+// Slot sequence == Position         : empty, the producer at Position may write it
+// Slot sequence == Position + 1     : full, the consumer at Position may read it
+// Slot sequence == Position + SIZE  : read; empty again for the next lap
+//
+// Producers and consumers each claim a position with a compare-exchange and
+// then only ever touch their own slot, so nobody takes a lock and a consumer
+// can't read a slot a producer is halfway through writing.
+CAssert((WORK_QUEUE_SIZE & (WORK_QUEUE_SIZE-1)) == 0);
+
 link_internal void
 InitQueue(work_queue* Queue, memory_arena* Memory) //, semaphore* Semaphore)
 {
   Queue->EnqueueIndex = 0;
   Queue->DequeueIndex = 0;
 
-  Queue->Entries = Allocate(work_queue_entry, Memory, WORK_QUEUE_SIZE);
+  // NOTE(Jesse): work_queue is defined in the stdlib, so the sequence numbers
+  // go in the same allocation as the entries, directly in front of them.
+  // See GetWorkQueueSequences
+  umm SequenceBytes = sizeof(u32)*WORK_QUEUE_SIZE;
+  CAssert((sizeof(u32)*WORK_QUEUE_SIZE) % CACHE_LINE_SIZE == 0);
+
+  u8 *Block = AllocateAligned(u8, Memory, SequenceBytes + (sizeof(work_queue_entry)*WORK_QUEUE_SIZE), CACHE_LINE_SIZE);
+  Queue->Entries = (work_queue_entry*)(Block + SequenceBytes);
+
+  volatile u32 *Sequences = GetWorkQueueSequences(Queue);
+  for (u32 SlotIndex = 0; SlotIndex < WORK_QUEUE_SIZE; ++SlotIndex)
+  {
+    Sequences[SlotIndex] = SlotIndex;
+  }
 
   InitializeFutex(&Queue->EnqueueFutex);
 }
 
+// NOTE(Jesse): Claims Count consecutive positions with a single
+// compare-exchange (unless another producer gets in first) and returns the
+// first one.  The slots might not be free yet if the ring is full.
+link_internal u32
+ReserveWorkQueuePositions(work_queue *Queue, u32 Count)
+{
+  Assert(Count <= WORK_QUEUE_SIZE);
+
+  u32 Result = Queue->EnqueueIndex;
+  while (!AtomicCompareExchange(&Queue->EnqueueIndex, Result + Count, Result))
+  {
+    Result = Queue->EnqueueIndex;
+  }
+
+  return Result;
+}
+
+link_internal void
+PublishWorkQueueEntry(work_queue *Queue, u32 Position, work_queue_entry *Entry)
+{
+  Assert(Entry->Type != type_work_queue_entry_noop);
+
+  volatile u32 *Sequences = GetWorkQueueSequences(Queue);
+  u32 SlotIndex = Position % WORK_QUEUE_SIZE;
+
+  // NOTE(Jesse): Only waits when the ring is full, or when a consumer has
+  // claimed the slot and is still copying it out.  The latter is over in a
+  // few hundred cycles, so spin a little before going to sleep.
+  for (u32 SpinCount = 0; Sequences[SlotIndex] != Position; ++SpinCount)
+  {
+    if (SpinCount > 64)
+    {
+      Perf("Queue full!");
+      SleepMs(1);
+    }
+  }
+
+  MemCopy((u8*)Entry, (u8*)(Queue->Entries + SlotIndex), sizeof(work_queue_entry));
+
+  FullBarrier;
+
+  Sequences[SlotIndex] = Position + 1;
+}
+
+link_internal void
+InitWorkStealingDeque(work_stealing_deque *Deque, memory_arena *Memory)
+{
+  CAssert((WORK_STEALING_DEQUE_SIZE & (WORK_STEALING_DEQUE_SIZE-1)) == 0);
+
+  Deque->Top = 0;
+  Deque->Bottom = 0;
+  Deque->Entries = AllocateAligned(work_queue_entry, Memory, WORK_STEALING_DEQUE_SIZE, CACHE_LINE_SIZE);
+}
+
+// NOTE(Jesse): Owner only.  Returns False if the deque is full.
+link_internal b32
+PushWorkStealingDeque(work_stealing_deque *Deque, work_queue_entry *Entry)
+{
+  u32 Bottom = Deque->Bottom;
+  u32 Top = Deque->Top;
+
+  // NOTE(Jesse): Top only moves forward, so a stale read makes us think
+  // we're fuller than we are, never emptier
+  b32 Result = s32(Bottom - Top) < WORK_STEALING_DEQUE_SIZE;
+  if (Result)
+  {
+    MemCopy((u8*)Entry, (u8*)(Deque->Entries + (Bottom % WORK_STEALING_DEQUE_SIZE)), sizeof(work_queue_entry));
+
+    FullBarrier;
+
+    Deque->Bottom = Bottom + 1;
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Owner only.  Takes the most recently pushed job, which is the
+// one most likely to still be in cache.
+link_internal b32
+PopWorkStealingDeque(work_stealing_deque *Deque, work_queue_entry *Result)
+{
+  u32 Bottom = Deque->Bottom - 1;
+  Deque->Bottom = Bottom;
+
+  // NOTE(Jesse): Thieves have to see Bottom go down before we read Top
+  FullBarrier;
+
+  u32 Top = Deque->Top;
+
+  b32 Got = False;
+
+  s32 Count = s32(Bottom - Top);
+  if (Count < 0)
+  {
+    Deque->Bottom = Top;
+  }
+  else
+  {
+    MemCopy((u8*)(Deque->Entries + (Bottom % WORK_STEALING_DEQUE_SIZE)), (u8*)Result, sizeof(work_queue_entry));
+
+    if (Count > 0)
+    {
+      Got = True;
+    }
+    else
+    {
+      // NOTE(Jesse): Last one; race the thieves for it
+      Got = AtomicCompareExchange(&Deque->Top, Top + 1, Top);
+      Deque->Bottom = Top + 1;
+    }
+  }
+
+  return Got;
+}
+
+// NOTE(Jesse): Any thread.  Takes the oldest job.  Returns False if the deque
+// is empty or another thread got there first.
+link_internal b32
+StealWorkStealingDeque(work_stealing_deque *Deque, work_queue_entry *Result)
+{
+  u32 Top = Deque->Top;
+  FullBarrier;
+  u32 Bottom = Deque->Bottom;
+
+  b32 Got = False;
+  if (s32(Bottom - Top) > 0)
+  {
+    // NOTE(Jesse): The owner can't write this slot again until Top moves past
+    // it, so if the exchange succeeds what we copied is intact
+    MemCopy((u8*)(Deque->Entries + (Top % WORK_STEALING_DEQUE_SIZE)), (u8*)Result, sizeof(work_queue_entry));
+    Got = AtomicCompareExchange(&Deque->Top, Top + 1, Top);
+  }
+
+  return Got;
+}
+
+link_internal b32
+WorkStealingDequeIsEmpty(work_stealing_deque *Deque)
+{
+  b32 Result = s32(Deque->Bottom - Deque->Top) <= 0;
+  return Result;
+}
+
+// NOTE(Jesse): Jobs pushed by a worker go on its own deque for that queue, if
+// it has one.  Everything else (the main thread, threads that aren't workers,
+// builds without engine resources) uses the shared queue.
+link_internal work_stealing_deque *
+GetLocalWorkStealingDeque(work_queue *Queue)
+{
+  work_stealing_deque *Result = 0;
+
+  s32 ThreadIndex = ThreadLocal_ThreadIndex;
+  if (ThreadIndex > 0 && ThreadIndex < s32(GetTotalThreadCount()) && Global_EngineResources)
+  {
+    platform *Plat = Global_EngineResources->Plat;
+    thread_startup_params *Params = Plat->Threads + ThreadIndex;
+
+    if (Queue == &Plat->LowPriority)  { Result = &Params->LowPriorityDeque; }
+    if (Queue == &Plat->HighPriority) { Result = &Params->HighPriorityDeque; }
+
+    if (Result && Result->Entries == 0) { Result = 0; }
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Wakes up to Count parked workers.  Has to come after the jobs
+// they're being woken for are visible; see worker_parking.
+link_internal void
+WakeParkedWorkers(worker_parking *Parking, u32 Count)
+{
+  if (Parking == 0) { return; }
+
+  FullBarrier;
+
+  u32 Woken = 0;
+  while (Woken < Count)
+  {
+    u32 Parked = Parking->ParkedCount;
+    if (Parked == 0) { break; }
+
+    if (AtomicCompareExchange(&Parking->ParkedCount, Parked - 1, Parked))
+    {
+      Parking->LastWakeCycles = __rdtsc();
+      WakeThread(&Parking->Semaphore);
+      ++Woken;
+    }
+  }
+}
+
 void
 PushWorkQueueEntry(work_queue *Queue, work_queue_entry *Entry)
 {
   TIMED_FUNCTION();
 
-  AcquireFutex(&Queue->EnqueueFutex);
+  work_stealing_deque *Local = GetLocalWorkStealingDeque(Queue);
+  if (Local && PushWorkStealingDeque(Local, Entry))
+  {
+    // NOTE(Jesse): We'll get to it ourselves, but someone idle can steal it
+    WakeParkedWorkers(Global_WorkerParking, 1);
+    return;
+  }
+
+  u32 Position = ReserveWorkQueuePositions(Queue, 1);
+  PublishWorkQueueEntry(Queue, Position, Entry);
 
-  while (QueueIsFull(Queue))
+  WakeParkedWorkers(Global_WorkerParking, 1);
+}
+
+// NOTE(Jesse): Entries are consumed in order, but workers may pick up the
+// first ones before the later ones are written
+link_internal void
+PushWorkQueueEntries(work_queue *Queue, work_queue_entry *Entries, u32 Count)
+{
+  TIMED_FUNCTION();
+
+  work_stealing_deque *Local = GetLocalWorkStealingDeque(Queue);
+  u32 LocalCount = 0;
+  while (Local && Count && PushWorkStealingDeque(Local, Entries))
   {
-    Perf("Queue full!");
-    SleepMs(1);
+    ++Entries;
+    --Count;
+    ++LocalCount;
   }
 
+  if (LocalCount) { WakeParkedWorkers(Global_WorkerParking, LocalCount); }
 
+  // NOTE(Jesse): Batches bigger than the ring would wait on themselves
+  while (Count)
+  {
+    u32 BatchCount = Min(Count, u32(WORK_QUEUE_SIZE/2));
 
-  volatile work_queue_entry* Dest = Queue->Entries + Queue->EnqueueIndex;
-  Clear(Dest);
-  Assert(Dest->Type == type_work_queue_entry_noop);
+    u32 Position = ReserveWorkQueuePositions(Queue, BatchCount);
+    for (u32 EntryIndex = 0; EntryIndex < BatchCount; ++EntryIndex)
+    {
+      PublishWorkQueueEntry(Queue, Position + EntryIndex, Entries + EntryIndex);
+    }
 
-  MemCopy((u8*)Entry, (u8*)Dest, sizeof(work_queue_entry));
-  /* *Dest = *((volatile work_queue_entry*)Entry); */
+    // NOTE(Jesse): Get workers started on this batch while we push the next
+    WakeParkedWorkers(Global_WorkerParking, BatchCount);
 
-  Assert(Dest->Type != type_work_queue_entry_noop);
+    Entries += BatchCount;
+    Count -= BatchCount;
+  }
+}
 
-  FullBarrier;
+// NOTE(Jesse): Copies the entry out so the slot can go back to the producers
+// before the job runs.  Returns False when there's nothing ready, which
+// includes an entry a producer has reserved but not finished writing.
+link_internal b32
+DequeueWorkQueueEntry(work_queue *Queue, work_queue_entry *Result)
+{
+  volatile u32 *Sequences = GetWorkQueueSequences(Queue);
 
-  u32 NewIndex = GetNextQueueIndex(Queue->EnqueueIndex);
-  AtomicExchange(&Queue->EnqueueIndex, NewIndex);
+  for (;;)
+  {
+    u32 Position = Queue->DequeueIndex;
+    u32 SlotIndex = Position % WORK_QUEUE_SIZE;
 
-  FullBarrier;
+    s32 Delta = s32(Sequences[SlotIndex] - (Position + 1));
+    if (Delta < 0)
+    {
+      return False;
+    }
 
-  ReleaseFutex(&Queue->EnqueueFutex);
+    // NOTE(Jesse): Delta > 0 means another consumer took it; try the next one
+    if (Delta == 0 && AtomicCompareExchange(&Queue->DequeueIndex, Position + 1, Position))
+    {
+      MemCopy((u8*)(Queue->Entries + SlotIndex), (u8*)Result, sizeof(work_queue_entry));
+
+      FullBarrier;
 
-  /* WakeThread( Queue->GlobalQueueSemaphore ); */
+      Sequences[SlotIndex] = Position + WORK_QUEUE_SIZE;
+      return True;
+    }
+  }
 }
 
 // TODO(Jesse): Generate these
@@ -208,3 +476,334 @@ DoCopyJob(volatile work_queue_entry_copy_buffer *Job, tiered_mesh_freelist* Mesh
   Ensure( AtomicCompareExchange((volatile void**)Job->Src, Src, 0) );
 #endif
 }
+
+// NOTE(Jesse): Where a worker looks for its next job on one priority level:
+// its own deque first, then the shared queue, then the other workers' deques.
+link_internal b32
+GetNextWorkerJob(thread_startup_params *Params, work_queue *Queue, b32 HighPriority, work_queue_entry *Result)
+{
+  work_stealing_deque *Local = HighPriority ? &Params->HighPriorityDeque : &Params->LowPriorityDeque;
+
+  b32 Got = PopWorkStealingDeque(Local, Result);
+
+  if (!Got)
+  {
+    Got = DequeueWorkQueueEntry(Queue, Result);
+  }
+
+  // NOTE(Jesse): Start with the next worker over so everyone doesn't go after
+  // the same victim
+  s32 ThreadCount = s32(GetTotalThreadCount());
+  for (s32 Offset = 1; !Got && Offset < ThreadCount; ++Offset)
+  {
+    s32 VictimIndex = (Params->ThreadIndex + Offset) % ThreadCount;
+    if (VictimIndex == 0) { continue; }
+
+    thread_startup_params *Victim = Params->AllThreads + VictimIndex;
+    work_stealing_deque *Deque = HighPriority ? &Victim->HighPriorityDeque : &Victim->LowPriorityDeque;
+    Got = StealWorkStealingDeque(Deque, Result);
+  }
+
+  return Got;
+}
+
+link_internal b32
+AnyWorkerHasJobs(thread_startup_params *Params, b32 HighPriority)
+{
+  b32 Result = False;
+
+  s32 ThreadCount = s32(GetTotalThreadCount());
+  for (s32 ThreadIndex = 1; !Result && ThreadIndex < ThreadCount; ++ThreadIndex)
+  {
+    thread_startup_params *Worker = Params->AllThreads + ThreadIndex;
+    Result = !WorkStealingDequeIsEmpty(HighPriority ? &Worker->HighPriorityDeque : &Worker->LowPriorityDeque);
+  }
+
+  return Result;
+}
+
+link_internal void
+InitWorkCounter(work_counter *Counter, u32 Pending)
+{
+  Counter->Pending = Pending;
+  Counter->Continuations = 0;
+  Counter->Fired = (Pending == 0);
+}
+
+// NOTE(Jesse): Only legal before the counter fires; hold one extra job's worth
+// (and signal it when you're done adding) if jobs might finish while you're
+// still pushing them.
+link_internal void
+AddWorkCounterJobs(work_counter *Counter, u32 Count)
+{
+  Assert(Counter->Fired == False);
+
+  for (;;)
+  {
+    u32 Pending = Counter->Pending;
+    Assert(Pending);
+    if (AtomicCompareExchange(&Counter->Pending, Pending + Count, Pending)) { break; }
+  }
+}
+
+// NOTE(Jesse): Checks Fired rather than Pending, so the counter's done with
+// its lock by the time anyone can see it's done and reuse it
+link_internal b32
+WorkCounterIsDone(work_counter *Counter)
+{
+  b32 Result = Counter->Fired;
+  return Result;
+}
+
+link_internal void
+PushWorkJob(work_job *Job)
+{
+  Assert(Job->Queue);
+
+  work_queue_entry_run_job RunJob = { .Job = Job };
+  work_queue_entry Entry = WorkQueueEntry(RunJob);
+  PushWorkQueueEntry(Job->Queue, &Entry);
+}
+
+link_internal void
+SignalWorkCounter(work_counter *Counter)
+{
+  u32 Pending = 0;
+  for (;;)
+  {
+    Pending = Counter->Pending;
+    Assert(Pending);
+    if (AtomicCompareExchange(&Counter->Pending, Pending - 1, Pending)) { break; }
+  }
+
+  if (Pending == 1)
+  {
+    AcquireFutex(&Counter->Lock);
+      Assert(Counter->Fired == False);
+      work_job *Job = Counter->Continuations;
+      Counter->Continuations = 0;
+    ReleaseFutex(&Counter->Lock);
+
+    // NOTE(Jesse): Whoever's waiting can reuse the counter as soon as this is
+    // set, so it has to come after we're done with the lock
+    FullBarrier;
+    Counter->Fired = True;
+
+    while (Job)
+    {
+      // NOTE(Jesse): The job can be run (and its storage reused) as soon as
+      // it's pushed, so get Next first
+      work_job *Next = Job->Next;
+      PushWorkJob(Job);
+      Job = Next;
+    }
+  }
+}
+
+// NOTE(Jesse): Pushes Job once every job counted on WaitFor is done, or right
+// away if they already are.
+//
+// Checks Pending rather than Fired; Fired isn't set until the signaller has
+// taken the continuations and let go of the lock, and anything we chain on in
+// between would never get pushed.
+link_internal void
+PushWorkJobAfter(work_counter *WaitFor, work_job *Job)
+{
+  b32 Ready = False;
+
+  AcquireFutex(&WaitFor->Lock);
+    if (WaitFor->Pending == 0)
+    {
+      Ready = True;
+    }
+    else
+    {
+      Job->Next = WaitFor->Continuations;
+      WaitFor->Continuations = Job;
+    }
+  ReleaseFutex(&WaitFor->Lock);
+
+  if (Ready) { PushWorkJob(Job); }
+}
+
+// NOTE(Jesse): Allocates the job out of JobMemory, which has to outlive it,
+// and counts it on Counter.
+link_internal work_job *
+PushCountedWorkQueueEntry(work_queue *Queue, work_queue_entry *Entry, work_counter *Counter, memory_arena *JobMemory)
+{
+  work_job *Job = Allocate(work_job, JobMemory, 1);
+  Job->Entry = *Entry;
+  Job->Queue = Queue;
+  Job->Signal = Counter;
+
+  AddWorkCounterJobs(Counter, 1);
+  PushWorkJob(Job);
+
+  return Job;
+}
+
+// NOTE(Jesse): Called by a job that's about to return without being done.
+// Once WaitFor fires it gets pushed again, to the same queue, and runs from
+// ResumePoint; its own Signal isn't touched until it returns without yielding.
+link_internal void
+YieldWorkJob(work_job *Job, work_counter *WaitFor, u32 ResumePoint)
+{
+  Assert(WaitFor);
+  Assert(Job->YieldedOn == 0);
+
+  Job->YieldedOn = WaitFor;
+  Job->ResumePoint = ResumePoint;
+}
+
+link_internal void
+RunWorkQueueEntry(work_queue_entry *Entry, thread_local_state *Thread, bonsai_worker_thread_callback GameWorkerThreadCallback)
+{
+  if (Entry->Type == type_work_queue_entry_run_job)
+  {
+    work_job *Job = Entry->work_queue_entry_run_job.Job;
+    work_counter *Signal = Job->Signal;
+
+    Job->YieldedOn = 0;
+    if (!RunEngineWorkQueueEntry(&Job->Entry, Thread))
+    {
+      GameWorkerThreadCallback(&Job->Entry, Thread);
+    }
+
+    // NOTE(Jesse): Either way someone else owns the job after this (another
+    // worker, or whoever's waiting on the counter), so don't touch it
+    work_counter *YieldedOn = Job->YieldedOn;
+    if (YieldedOn)
+    {
+      PushWorkJobAfter(YieldedOn, Job);
+    }
+    else if (Signal)
+    {
+      SignalWorkCounter(Signal);
+    }
+  }
+  else if (!RunEngineWorkQueueEntry(Entry, Thread))
+  {
+    GameWorkerThreadCallback(Entry, Thread);
+  }
+}
+
+// NOTE(Jesse): Runs jobs off Queue while it waits, so the waiting thread isn't
+// just burning a core.  A worker looks in its own deque first; jobs it pushed
+// land there, and nobody else might be around to steal them.
+link_internal void
+WaitForWorkCounter(work_counter *Counter, work_queue *Queue, thread_local_state *Thread, bonsai_worker_thread_callback GameWorkerThreadCallback)
+{
+  TIMED_FUNCTION();
+
+  work_stealing_deque *Local = Queue ? GetLocalWorkStealingDeque(Queue) : 0;
+
+  while (!WorkCounterIsDone(Counter))
+  {
+    work_queue_entry Entry;
+    if ( (Local && PopWorkStealingDeque(Local, &Entry)) ||
+         (Queue && DequeueWorkQueueEntry(Queue, &Entry)) )
+    {
+      RunWorkQueueEntry(&Entry, Thread, GameWorkerThreadCallback);
+    }
+    else
+    {
+      FullBarrier;
+    }
+  }
+}
+
+// NOTE(Jesse): For engine code on the main thread that pushed some jobs and
+// has to wait for them.  Runs jobs off Queue in the meantime, the same as the
+// frame join in the loader does, so the main thread isn't spinning while the
+// workers do all the work.
+link_internal void
+WaitForWorkCounterOnMainThread(work_counter *Counter, work_queue *Queue)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  engine_resources *Engine = GetEngineResources();
+  WaitForWorkCounter(Counter, Queue, GetThreadLocalState(ThreadLocal_ThreadIndex), Engine->GameWorkerThreadCallback);
+}
+
+link_internal void
+InitWorkerParking(worker_parking *Parking)
+{
+  Parking->Semaphore = CreateSemaphore();
+  Parking->ParkedCount = 0;
+  Parking->LastWakeCycles = 0;
+}
+
+// NOTE(Jesse): Everything that should get a worker out of its idle loop
+link_internal b32
+WorkerHasWork(thread_startup_params *Params)
+{
+  if (!QueueIsEmpty(Params->HighPriority)) return True;
+  if (AnyWorkerHasJobs(Params, True)) return True;
+
+  if ( ! FutexIsSignaled(Params->HighPriorityModeFutex) &&
+       ( ! QueueIsEmpty(Params->LowPriority) || AnyWorkerHasJobs(Params, False) ) ) return True;
+
+  if ( FutexIsSignaled(Params->WorkerThreadsSuspendFutex) ) return True;
+
+  if ( FutexIsSignaled(Params->WorkerThreadsExitFutex) ) return True;
+
+  return False;
+}
+
+// NOTE(Jesse): Sleeps until someone wakes us.  Returns without sleeping if
+// there's work by the time we've said we're parked, since whoever pushed it
+// may have looked at ParkedCount before we bumped it.
+link_internal void
+ParkWorker(thread_startup_params *Params)
+{
+  worker_parking *Parking = Params->Parking;
+
+  AtomicIncrement(&Parking->ParkedCount);
+  FullBarrier;
+
+  if (WorkerHasWork(Params))
+  {
+    // NOTE(Jesse): If someone already took us off the count they've posted
+    // the semaphore too, and the next worker to park goes straight through.
+    // That's fine; it'll find nothing and park again.
+    for (;;)
+    {
+      u32 Parked = Parking->ParkedCount;
+      if (Parked == 0) { break; }
+      if (AtomicCompareExchange(&Parking->ParkedCount, Parked - 1, Parked)) { break; }
+    }
+  }
+  else
+  {
+    ThreadSleep(&Parking->Semaphore);
+
+    u64 WakeCycles = Parking->LastWakeCycles;
+    u64 Now = __rdtsc();
+    if (WakeCycles && Now > WakeCycles)
+    {
+      u64 Latency = Now - WakeCycles;
+      Params->WakeCount += 1;
+      Params->TotalWakeLatencyCycles += Latency;
+      Params->MaxWakeLatencyCycles = Max(Params->MaxWakeLatencyCycles, Latency);
+    }
+  }
+}
+
+// NOTE(Jesse): Parked workers can't see a futex change until they're woken
+link_internal void
+WakeAllParkedWorkers(worker_parking *Parking)
+{
+  WakeParkedWorkers(Parking, GetWorkerThreadCount());
+}
+
+link_internal void
+PrintWorkerWakeLatency(platform *Plat)
+{
+  s32 TotalThreadCount = s32(GetTotalThreadCount());
+  for (s32 ThreadIndex = 1; ThreadIndex < TotalThreadCount; ++ThreadIndex)
+  {
+    thread_startup_params *Params = Plat->Threads + ThreadIndex;
+    u64 Average = Params->WakeCount ? Params->TotalWakeLatencyCycles/Params->WakeCount : 0;
+    Info("Worker (%d) woke (%u) times : wake latency avg (%lu) max (%lu) cycles", ThreadIndex, Params->WakeCount, Average, Params->MaxWakeLatencyCycles);
+  }
+}
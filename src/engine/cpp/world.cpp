@@ -6,13 +6,13 @@ AllocateWorld(world* World, world_position Center, voxel_position WorldChunkDim,
 
   World->Memory = WorldMemory;
 
-  World->HashSize = (u32)(Volume(VisibleRegion)*4); //WorldHashSize;
-  /* World->HashSize = (u32)(Volume(VisibleRegion)*4); //WorldHashSize; */
-  World->ChunkHashMemory[0] = Allocate(world_chunk*, WorldMemory, World->HashSize );
-  World->ChunkHashMemory[1] = Allocate(world_chunk*, WorldMemory, World->HashSize );
+  AllocateWorldChunkHashtable(World, WorldMemory, VisibleRegion);
 
-  World->ChunkHash = World->ChunkHashMemory[0];
   World->FreeChunks = Allocate(world_chunk*, WorldMemory, FREELIST_SIZE );
+  World->FreeVoxelBlocks = Allocate(voxel*, WorldMemory, FREELIST_SIZE );
+
+  World->PendingInits = Allocate(pending_chunk_init, WorldMemory, World->HashSize );
+  World->InFlightInits = Allocate(world_chunk*, WorldMemory, World->HashSize );
 
   World->ChunkDim = WorldChunkDim;
   World->VisibleRegion = VisibleRegion;
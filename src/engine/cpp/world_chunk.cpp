@@ -33,6 +33,28 @@ UnSetMeshBit(world_chunk *Chunk, world_chunk_mesh_bitfield MeshBit)
   Chunk->Meshes.MeshMask = Chunk->Meshes.MeshMask & (~MeshBit);
 }
 
+// NOTE(Jesse): Must be called with the futex for MeshBit held.  The CAS is
+// because other threads may be setting the bits for the other meshes.
+link_internal void
+SetGpuDirtyBit(threadsafe_geometry_buffer *Meshes, world_chunk_mesh_bitfield MeshBit)
+{
+  for (;;)
+  {
+    u32 Current = Meshes->GpuDirtyMask;
+    if (AtomicCompareExchange(&Meshes->GpuDirtyMask, Current | MeshBit, Current)) { break; }
+  }
+}
+
+link_internal void
+UnSetGpuDirtyBit(threadsafe_geometry_buffer *Meshes, world_chunk_mesh_bitfield MeshBit)
+{
+  for (;;)
+  {
+    u32 Current = Meshes->GpuDirtyMask;
+    if (AtomicCompareExchange(&Meshes->GpuDirtyMask, Current & (~MeshBit), Current)) { break; }
+  }
+}
+
 link_internal untextured_3d_geometry_buffer *
 ReplaceMesh( threadsafe_geometry_buffer *Meshes,
              world_chunk_mesh_bitfield MeshBit,
@@ -53,6 +75,7 @@ ReplaceMesh( threadsafe_geometry_buffer *Meshes,
     {
       Meshes->E[ToIndex(MeshBit)] = Buf;
       Result = CurrentMesh;
+      SetGpuDirtyBit(Meshes, MeshBit);
     }
     else
     {
@@ -63,6 +86,7 @@ ReplaceMesh( threadsafe_geometry_buffer *Meshes,
   else
   {
     Meshes->E[ToIndex(MeshBit)] = Buf;
+    SetGpuDirtyBit(Meshes, MeshBit);
   }
 
   if (Meshes->E[ToIndex(MeshBit)]) { Meshes->MeshMask |= MeshBit; }
@@ -82,6 +106,57 @@ AtomicReplaceMesh( threadsafe_geometry_buffer *Meshes,
   return Replace;
 }
 
+// NOTE(Jesse): ReplaceMesh for the packed slots
+link_internal packed_chunk_mesh *
+ReplacePackedMesh( threadsafe_geometry_buffer *Meshes,
+                   world_chunk_mesh_bitfield MeshBit,
+                   packed_chunk_mesh *Mesh,
+                   u64 MeshTimestamp )
+{
+  Assert( Meshes->Futexes[ToIndex(MeshBit)].SignalValue == (u32)ThreadLocal_ThreadIndex );
+  if (Mesh) { Assert(Mesh->At); }
+
+  packed_chunk_mesh *Result = {};
+
+  packed_chunk_mesh *CurrentMesh = (packed_chunk_mesh*)Meshes->Packed[ToIndex(MeshBit)];
+
+  if (CurrentMesh)
+  {
+    if (CurrentMesh->Timestamp < MeshTimestamp)
+    {
+      Meshes->Packed[ToIndex(MeshBit)] = Mesh;
+      Result = CurrentMesh;
+      SetGpuDirtyBit(Meshes, MeshBit);
+    }
+    else
+    {
+      // NOTE(Jesse): If we don't swap this in, we have to return it so it gets freed
+      Result = Mesh;
+    }
+  }
+  else
+  {
+    Meshes->Packed[ToIndex(MeshBit)] = Mesh;
+    SetGpuDirtyBit(Meshes, MeshBit);
+  }
+
+  if (Meshes->Packed[ToIndex(MeshBit)]) { Meshes->MeshMask |= MeshBit; }
+
+  return Result;
+}
+
+link_internal packed_chunk_mesh *
+AtomicReplacePackedMesh( threadsafe_geometry_buffer *Meshes,
+                         world_chunk_mesh_bitfield MeshBit,
+                         packed_chunk_mesh *Mesh,
+                         u64 MeshTimestamp )
+{
+  TakeOwnershipSync(Meshes, MeshBit);
+  auto Replace = ReplacePackedMesh(Meshes, MeshBit, Mesh, MeshTimestamp);
+  ReleaseOwnership(Meshes, MeshBit, 0);
+  return Replace;
+}
+
 #if 0
 link_internal untextured_3d_geometry_buffer *
 SetMesh(world_chunk *Chunk, world_chunk_mesh_bitfield MeshBit, mesh_freelist *MeshFreelist, memory_arena *PermMemory)
@@ -138,75 +213,146 @@ AllocateWorldChunk(memory_arena *Storage, world_position WorldP, chunk_dimension
   return Result;
 }
 
+// NOTE(Jesse): Multiply each axis by a large odd constant and run the
+// murmur3 finalizer over the sum, so neighboring chunks land in unrelated
+// slots and the table can be indexed with a mask.
 inline u32
-GetWorldChunkHash(world_position P, chunk_dimension VisibleRegion, u32 WorldHashSize)
+GetWorldChunkHash(world_position P)
 {
-  s32 WHS_Factor = (s32)WorldHashSize / (Volume(VisibleRegion))+1;
+  u32 Hash = (u32(P.x) * 0x8da6b343u) +
+             (u32(P.y) * 0xd8163841u) +
+             (u32(P.z) * 0xcb1ab31fu);
+
+  Hash ^= Hash >> 16;
+  Hash *= 0x85ebca6bu;
+  Hash ^= Hash >> 13;
+  Hash *= 0xc2b2ae35u;
+  Hash ^= Hash >> 16;
 
-  s32 xFactor = WHS_Factor;
-  s32 yFactor = WHS_Factor * VisibleRegion.x;
-  s32 zFactor = WHS_Factor * VisibleRegion.x * VisibleRegion.y;
+  return Hash;
+}
+
+// NOTE(Jesse): How far the chunk in SlotIndex is from the slot it hashes to
+inline u32
+GetWorldChunkProbeDistance(world *World, world_chunk *Chunk, u32 SlotIndex)
+{
+  u32 Mask = World->HashSize-1;
+  u32 HomeIndex = GetWorldChunkHash(Chunk->WorldP) & Mask;
+  u32 Result = (SlotIndex - HomeIndex) & Mask;
+  return Result;
+}
 
-  s32 Ix = (P.x * xFactor);
+link_internal void
+AllocateWorldChunkHashtable(world *World, memory_arena *Memory, chunk_dimension VisibleRegion)
+{
+  u32 MinHashSize = u32(Volume(VisibleRegion)*4);
 
-  s32 Iy = (P.y * yFactor);
+  u32 HashSize = 1;
+  while (HashSize < MinHashSize) { HashSize <<= 1; }
 
-  s32 Iz = (P.z * zFactor);
+  World->HashSize = HashSize;
+  World->ChunkCount = 0;
+  World->ChunkHash = Allocate(world_chunk*, Memory, HashSize);
 
-  u32 I = u32(Ix ^ Iy ^ Iz);
+  World->ResidentChunks = Allocate(world_chunk*, Memory, HashSize);
+  World->ResidentRegion = {};
+  World->ResidentSweepCursor = 0;
 
-  u32 HashIndex = I % WorldHashSize;
-  return HashIndex;
+  World->EvictedChunks = Allocate(world_chunk*, Memory, HashSize);
+  World->EvictedChunkCount = 0;
 }
 
 link_internal b32
-InsertChunkIntoWorld(world_chunk **WorldChunkHash, world_chunk *Chunk, chunk_dimension VisibleRegion, u32 WorldHashSize)
+InsertChunkIntoWorld(world *World, world_chunk *Chunk)
 {
-  b32 Result = True;
-  u32 HashIndex = GetWorldChunkHash(Chunk->WorldP, VisibleRegion, WorldHashSize);
-  u32 StartingHashIndex = HashIndex;
-
-#if BONSAI_INTERNAL
-  u32 BucketsSkipped = 0;
-#endif
+  TIMED_FUNCTION();
 
-  world_chunk **Current = WorldChunkHash + HashIndex;
-  while (*Current)
+  // NOTE(Jesse): Always leave one empty slot so probing terminates
+  if (World->ChunkCount+1 >= World->HashSize)
   {
-    HashIndex = (HashIndex + 1) % WorldHashSize;
-    Current = WorldChunkHash + HashIndex;
+    return False;
+  }
+
+  u32 Mask = World->HashSize-1;
+  u32 SlotIndex = GetWorldChunkHash(Chunk->WorldP) & Mask;
 
-    if (HashIndex == StartingHashIndex)
+  // NOTE(Jesse): Robin Hood insertion; whichever chunk is further from its
+  // home slot keeps the slot, and we carry on inserting the other one.
+  world_chunk *Inserting = Chunk;
+  u32 Distance = 0;
+
+  for (;;)
+  {
+    world_chunk *Resident = World->ChunkHash[SlotIndex];
+    if (Resident == 0)
     {
-      Result = False;
+      World->ChunkHash[SlotIndex] = Inserting;
       break;
     }
 
-#if BONSAI_INTERNAL
-    ++ BucketsSkipped;
-#endif
+    Assert(Resident->WorldP != Chunk->WorldP);
+
+    u32 ResidentDistance = GetWorldChunkProbeDistance(World, Resident, SlotIndex);
+    if (ResidentDistance < Distance)
+    {
+      World->ChunkHash[SlotIndex] = Inserting;
+      Inserting = Resident;
+      Distance = ResidentDistance;
+    }
 
+    SlotIndex = (SlotIndex + 1) & Mask;
+    ++Distance;
   }
 
 #if BONSAI_INTERNAL
-  if (BucketsSkipped > 10)
+  if (Distance > 10)
   {
     world_position P = Chunk->WorldP;
-    Warn("%u Collisions encountered while inserting chunk into world for chunk (%d, %d, %d) with hash value (%u)", BucketsSkipped, P.x, P.y, P.z, StartingHashIndex);
+    Warn("Probe length (%u) encountered while inserting chunk into world for chunk (%d, %d, %d)", Distance, P.x, P.y, P.z);
   }
 #endif
 
-  *Current = Chunk;
+  Chunk->ResidentIndex = World->ChunkCount;
+  World->ResidentChunks[World->ChunkCount++] = Chunk;
 
-  return Result;
+  return True;
 }
 
-link_internal b32
-InsertChunkIntoWorld(world *World, world_chunk *Chunk)
+// NOTE(Jesse): Backward-shift deletion; pulls the following run of displaced
+// chunks back one slot so we never need tombstones.
+link_internal void
+RemoveChunkFromWorld(world *World, u32 SlotIndex)
 {
-  TIMED_FUNCTION();
-  b32 Result = InsertChunkIntoWorld(World->ChunkHash, Chunk, World->VisibleRegion, World->HashSize);
-  return Result;
+  world_chunk *Removed = World->ChunkHash[SlotIndex];
+  Assert(Removed);
+  Assert(World->ResidentChunks[Removed->ResidentIndex] == Removed);
+
+  u32 Mask = World->HashSize-1;
+
+  World->ChunkHash[SlotIndex] = 0;
+
+  // NOTE(Jesse): Swap the last resident chunk into the hole
+  u32 LastIndex = --World->ChunkCount;
+  world_chunk *Last = World->ResidentChunks[LastIndex];
+  World->ResidentChunks[Removed->ResidentIndex] = Last;
+  Last->ResidentIndex = Removed->ResidentIndex;
+  World->ResidentChunks[LastIndex] = 0;
+
+  u32 NextIndex = (SlotIndex + 1) & Mask;
+  for (;;)
+  {
+    world_chunk *Next = World->ChunkHash[NextIndex];
+    if (Next == 0 || GetWorldChunkProbeDistance(World, Next, NextIndex) == 0)
+    {
+      break;
+    }
+
+    World->ChunkHash[SlotIndex] = Next;
+    World->ChunkHash[NextIndex] = 0;
+
+    SlotIndex = NextIndex;
+    NextIndex = (NextIndex + 1) & Mask;
+  }
 }
 
 link_internal world_chunk*
@@ -241,6 +387,75 @@ AllocateAndInsertChunk(memory_arena *Storage, world *World, world_position P)
   return Result;
 }
 
+link_internal voxel *
+GetFreeVoxelBlock(world *World, memory_arena *Storage)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  voxel *Result = 0;
+  if (World->FreeVoxelBlockCount)
+  {
+    Result = World->FreeVoxelBlocks[--World->FreeVoxelBlockCount];
+  }
+  else
+  {
+    Result = AllocateVoxels(Storage, World->ChunkDim);
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Gives a uniform chunk its dense voxels back, so it can be
+// written to.  Main thread only.
+link_internal void
+DecompressChunkVoxels(world *World, world_chunk *Chunk)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  if (Chunk->Voxels == 0)
+  {
+    Assert(Chunk->Dim == World->ChunkDim);
+
+    Chunk->Voxels = GetFreeVoxelBlock(World, World->Memory);
+
+    s32 VoxelCount = Volume(Chunk->Dim);
+    for (s32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+    {
+      Chunk->Voxels[VoxelIndex] = Chunk->UniformVoxel;
+    }
+  }
+
+  UnSetFlag(&Chunk->Flags, Chunk_VoxelsUniform);
+}
+
+// NOTE(Jesse): Releases the dense voxels of a chunk a worker flagged as
+// uniform.  Main thread only.
+link_internal void
+CompressUniformChunk(world *World, world_chunk *Chunk)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+  Assert ( IsSet(Chunk, Chunk_VoxelsUniform) );
+  Assert ( NotSet(Chunk, Chunk_Queued) );
+
+  if (Chunk->Voxels && World->FreeVoxelBlockCount < FREELIST_SIZE)
+  {
+    Assert(Chunk->Voxels[0] == Chunk->UniformVoxel);
+    World->FreeVoxelBlocks[World->FreeVoxelBlockCount++] = Chunk->Voxels;
+    Chunk->Voxels = 0;
+  }
+}
+
+link_internal b32
+VoxelsAreUniform(voxel *Voxels, s32 VoxelCount)
+{
+  b32 Result = True;
+  voxel First = Voxels[0];
+  for (s32 VoxelIndex = 1; VoxelIndex < VoxelCount; ++VoxelIndex)
+  {
+    if (Voxels[VoxelIndex] != First) { Result = False; break; }
+  }
+  return Result;
+}
+
 link_internal world_chunk*
 GetWorldChunkFor(memory_arena *Storage, world *World, world_position P)
 {
@@ -257,6 +472,12 @@ GetWorldChunkFor(memory_arena *Storage, world *World, world_position P)
     world_chunk *Chunk = World->FreeChunks[--World->FreeChunkCount];
     Chunk->WorldP = P;
 
+    if (Chunk->Voxels == 0)
+    {
+      Chunk->Voxels = GetFreeVoxelBlock(World, Storage);
+      ZeroMemory( Chunk->Voxels, sizeof(voxel)*umm(Volume(Chunk->Dim)) );
+    }
+
     if (InsertChunkIntoWorld(World, Chunk))
     {
       Result = Chunk;
@@ -287,13 +508,68 @@ FreeWorldChunk(world *World, world_chunk *Chunk, tiered_mesh_freelist* MeshFreel
   Assert ( NotSet(Chunk, Chunk_Queued) );
 
   DeallocateMeshes(&Chunk->Meshes, MeshFreelist, Memory);
+
+#if PLATFORM_GL_IMPLEMENTATIONS
+  gpu_chunk_buffer *ChunkBuffer = &GetEngineResources()->Graphics->ChunkBuffer;
+  for (u32 MeshIndex = 0; MeshIndex < MeshIndex_Count; ++MeshIndex)
+  {
+    FreeGpuChunkSlab(ChunkBuffer, Chunk->GpuSlabs + MeshIndex);
+  }
+#endif
+  Chunk->Meshes.GpuDirtyMask = 0;
+
+  // NOTE(Jesse): The init job may have finished since DispatchChunkInitJobs
+  // last retired jobs, in which case it's still on the in-flight list
+  for (u32 InFlightIndex = 0; InFlightIndex < World->InFlightInitCount; ++InFlightIndex)
+  {
+    if (World->InFlightInits[InFlightIndex] == Chunk)
+    {
+      World->InFlightInits[InFlightIndex] = World->InFlightInits[--World->InFlightInitCount];
+      break;
+    }
+  }
+
   ClearWorldChunk(Chunk);
 
   Assert(World->FreeChunkCount < FREELIST_SIZE);
   Assert(Chunk->Flags == Chunk_Uninitialized);
   World->FreeChunks[World->FreeChunkCount++] = Chunk;
 
-  ZeroMemory( Chunk->Voxels, sizeof(voxel)*umm(Volume(Chunk->Dim)) );
+  // NOTE(Jesse): Uniform chunks already gave their voxels back
+  if (Chunk->Voxels)
+  {
+    ZeroMemory( Chunk->Voxels, sizeof(voxel)*umm(Volume(Chunk->Dim)) );
+  }
+}
+
+// NOTE(Jesse): Returns World->HashSize if there's no chunk at P
+link_internal u32
+GetWorldChunkSlot( world *World, world_position P)
+{
+  u32 Mask = World->HashSize-1;
+  u32 SlotIndex = GetWorldChunkHash(P) & Mask;
+
+  u32 Result = World->HashSize;
+  for (u32 Distance = 0; ; ++Distance)
+  {
+    world_chunk *Chunk = World->ChunkHash[SlotIndex];
+
+    if (Chunk == 0) break;
+
+    if (Chunk->WorldP == P)
+    {
+      Result = SlotIndex;
+      break;
+    }
+
+    // NOTE(Jesse): If P were in the table, Robin Hood insertion would have
+    // placed it before any chunk that's closer to its own home slot.
+    if (GetWorldChunkProbeDistance(World, Chunk, SlotIndex) < Distance) break;
+
+    SlotIndex = (SlotIndex + 1) & Mask;
+  }
+
+  return Result;
 }
 
 link_internal world_chunk*
@@ -301,33 +577,66 @@ GetWorldChunkFromHashtable( world *World, world_position P)
 {
   /* TIMED_FUNCTION(); */ // This makes things much slower
 
-  u32 HashIndex = GetWorldChunkHash(P, World->VisibleRegion, World->HashSize);
-  u32 StartingHashIndex = HashIndex;
+  world_chunk *Result = 0;
 
-  world_chunk **WorldHash = World->ChunkHash;
+  u32 SlotIndex = GetWorldChunkSlot(World, P);
+  if (SlotIndex < World->HashSize)
+  {
+    Result = World->ChunkHash[SlotIndex];
+  }
 
-  world_chunk *Result = WorldHash[HashIndex];
+  return Result;
+}
 
-  for (;;)
+// NOTE(Jesse): Pulls the chunk out of the world.  If a worker still has it
+// queued, or it has edits that haven't been written back, we mark it garbage
+// and CollectUnusedChunks frees it once that's been taken care of.
+link_internal void
+EvictChunkFromWorld(world *World, u32 SlotIndex, tiered_mesh_freelist* MeshFreelist, memory_arena* Memory)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  world_chunk *Chunk = World->ChunkHash[SlotIndex];
+  RemoveChunkFromWorld(World, SlotIndex);
+
+  if (IsSet(Chunk, Chunk_Queued) || IsSet(Chunk, Chunk_Dirty))
   {
-#if 1
-    if (!Result) break;
-#else
-    if (Result)
-#endif
-    {
-      if (Result->WorldP == P)
-      {
-        break;
-      }
-    }
+    SetFlag(&Chunk->Flags, Chunk_Garbage);
+
+    Assert(World->EvictedChunkCount < World->HashSize);
+    World->EvictedChunks[World->EvictedChunkCount++] = Chunk;
+  }
+  else
+  {
+    FreeWorldChunk(World, Chunk, MeshFreelist, Memory);
+  }
+}
 
-    HashIndex = (HashIndex + 1) % World->HashSize;
-    Result = WorldHash[HashIndex];
+// NOTE(Jesse): Puts a chunk that was evicted, but not freed yet, back into the
+// world.  A dirty chunk's edits aren't in world_edits until its write-back is
+// stored, so if the chunk comes back into the region before that, initializing
+// a fresh one would load stale data.  Anything that finished initializing gets
+// reclaimed, which also saves generating it again.  Returns 0 if there's
+// nothing at P to reclaim.
+link_internal world_chunk *
+ReclaimEvictedChunk(world *World, world_position P)
+{
+  Assert ( ThreadLocal_ThreadIndex == 0 );
 
-    if (HashIndex == StartingHashIndex)
+  world_chunk *Result = 0;
+  for (u32 EvictedIndex = 0; EvictedIndex < World->EvictedChunkCount; ++EvictedIndex)
+  {
+    world_chunk *Chunk = World->EvictedChunks[EvictedIndex];
+    if (Chunk->WorldP == P)
     {
-      Result = 0;
+      // NOTE(Jesse): Evicted before its init finished, so there's nothing on
+      // it worth keeping.  CollectUnusedChunks frees it when the worker's done.
+      if (IsSet(Chunk, Chunk_VoxelsInitialized) && InsertChunkIntoWorld(World, Chunk))
+      {
+        UnSetFlag(&Chunk->Flags, Chunk_Garbage);
+        World->EvictedChunks[EvictedIndex] = World->EvictedChunks[--World->EvictedChunkCount];
+        Result = Chunk;
+      }
       break;
     }
   }
@@ -335,21 +644,7 @@ GetWorldChunkFromHashtable( world *World, world_position P)
   return Result;
 }
 
-link_internal world_chunk**
-CurrentWorldHashtable(engine_resources *Engine)
-{
-  u32 Index = Engine->FrameIndex % 2;
-  world_chunk **Hashtable = Engine->World->ChunkHashMemory[Index];
-  return Hashtable;
-}
-
-link_internal world_chunk**
-NextWorldHashtable(engine_resources *Engine)
-{
-  u32 Index = (Engine->FrameIndex+1) % 2;
-  world_chunk **Hashtable = Engine->World->ChunkHashMemory[Index];
-  return Hashtable;
-}
+link_internal void ScheduleChunkForInit(world *World, world_chunk *Chunk);
 
 link_internal void
 CollectUnusedChunks(engine_resources *Engine, tiered_mesh_freelist* MeshFreelist, memory_arena* Memory, chunk_dimension VisibleRegion)
@@ -358,56 +653,117 @@ CollectUnusedChunks(engine_resources *Engine, tiered_mesh_freelist* MeshFreelist
 
   world *World = Engine->World;
 
-#if 1
-  world_chunk ** CurrentWorldHash = CurrentWorldHashtable(Engine);
-  world_chunk ** NextWorldHash = NextWorldHashtable(Engine);
+  // NOTE(Jesse): Free evicted chunks the workers have finished with.  Edited
+  // ones get written back first, and freed the time around after that.
+  for (u32 EvictedIndex = 0; EvictedIndex < World->EvictedChunkCount; )
+  {
+    world_chunk *Chunk = World->EvictedChunks[EvictedIndex];
+    if (NotSet(Chunk, Chunk_Queued))
+    {
+      if (IsSet(Chunk, Chunk_Dirty))
+      {
+        QueueChunkForWriteBack(&Engine->Plat->LowPriority, Chunk);
+        ++EvictedIndex;
+      }
+      else
+      {
+        FreeWorldChunk(World, Chunk, MeshFreelist, Memory);
+        World->EvictedChunks[EvictedIndex] = World->EvictedChunks[--World->EvictedChunkCount];
+      }
+    }
+    else
+    {
+      ++EvictedIndex;
+    }
+  }
 
-  world_position CenterP = World->Center;
+  // NOTE(Jesse): UpdateWorldResidency takes care of chunks leaving the
+  // visible region as the center moves.  This sweep picks up the stragglers
+  // (chunks that got created outside the region, or got reset inside it) and
+  // hands the voxels of uniform chunks back to the world.  It visits a slice
+  // of the resident list each frame and doesn't touch the hashtable unless it
+  // has something to remove.
   chunk_dimension Radius = (VisibleRegion/2);
-  world_position Min = CenterP - Radius;
-  world_position Max = CenterP + Radius;
+  world_position Min = World->Center - Radius;
+  world_position Max = World->Center + Radius;
 
-  for (u32 ChunkIndex = 0;
-      ChunkIndex < World->HashSize;
-      ++ChunkIndex)
+  u32 ChunksToVisit = World->ChunkCount/WORLD_CHUNK_RESIDENT_SWEEP_FRAMES;
+  if (ChunksToVisit == 0) { ChunksToVisit = World->ChunkCount; }
+
+  u32 ChunkIndex = World->ResidentSweepCursor;
+  for (u32 VisitIndex = 0; VisitIndex < ChunksToVisit; ++VisitIndex)
   {
-    world_chunk **ChunkBucket = CurrentWorldHash + ChunkIndex;
-    world_chunk *Chunk = *ChunkBucket;
-    *ChunkBucket = 0;
+    if (ChunkIndex >= World->ChunkCount) { ChunkIndex = 0; }
+    if (World->ChunkCount == 0) break;
 
+    world_chunk *Chunk = World->ResidentChunks[ChunkIndex];
+    world_position ChunkP = Chunk->WorldP;
 
-    if ( Chunk )
+    b32 Evict = False;
+    if ( ChunkP >= Min && ChunkP < Max )
     {
       if (Chunk->Flags == Chunk_Uninitialized)
       {
-        FreeWorldChunk(World, Chunk, MeshFreelist, Memory);
+        // NOTE(Jesse): Got reset while resident (the debug window's
+        // reinitialize button does this).  Residency only looks at chunks
+        // entering the region, so nothing else would ever init it again.
+        DecompressChunkVoxels(World, Chunk);
+        ScheduleChunkForInit(World, Chunk);
       }
-      else
+      else if ( IsSet(Chunk, Chunk_VoxelsUniform) && NotSet(Chunk, Chunk_Queued) )
       {
-        world_position ChunkP = Chunk->WorldP;
-
-        if ( ChunkP >= Min && ChunkP < Max )
-        {
-          InsertChunkIntoWorld(NextWorldHash, Chunk, World->VisibleRegion, World->HashSize);
-        }
-        else
-        {
-          if (Chunk->Flags & Chunk_Queued)
-          {
-            SetFlag(&Chunk->Flags, Chunk_Garbage);
-            InsertChunkIntoWorld(NextWorldHash, Chunk, World->VisibleRegion, World->HashSize);
-          }
-          else
-          {
-            FreeWorldChunk(World, Chunk, MeshFreelist, Memory);
-          }
-        }
+        CompressUniformChunk(World, Chunk);
       }
     }
+    else
+    {
+      Evict = True;
+    }
+
+    if (Evict)
+    {
+      // NOTE(Jesse): The last resident chunk gets swapped into this index, so
+      // look at it again instead of advancing.
+      u32 SlotIndex = GetWorldChunkSlot(World, ChunkP);
+      Assert(SlotIndex < World->HashSize);
+      EvictChunkFromWorld(World, SlotIndex, MeshFreelist, Memory);
+    }
+    else
+    {
+      ++ChunkIndex;
+    }
   }
 
-#endif
-  return;
+  World->ResidentSweepCursor = ChunkIndex;
+}
+
+// NOTE(Jesse): Edited chunks that stay resident get written back on a timer
+// instead of after every edit, so all the edits to a chunk between two sweeps
+// go out in one write.  Evicted chunks don't wait on this; CollectUnusedChunks
+// writes those back straight away.
+link_internal void
+WriteBackDirtyChunks(engine_resources *Engine, r32 dt)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  world_edits *Edits = &Engine->WorldEdits;
+
+  Edits->SecondsSinceWriteBack += dt;
+  if (Edits->SecondsSinceWriteBack < WORLD_EDIT_WRITE_BACK_SECONDS) { return; }
+  Edits->SecondsSinceWriteBack = 0.f;
+
+  world *World = Engine->World;
+  for (u32 ChunkIndex = 0; ChunkIndex < World->ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = World->ResidentChunks[ChunkIndex];
+
+    // NOTE(Jesse): A chunk that's queued gets picked up on the next sweep
+    if ( IsSet(Chunk, Chunk_Dirty) && NotSet(Chunk, Chunk_Queued) )
+    {
+      QueueChunkForWriteBack(&Engine->Plat->LowPriority, Chunk);
+    }
+  }
 }
 
 #if 0
@@ -543,8 +899,55 @@ Noise_Flat( perlin_noise *Noise,
   return Result;;
 }
 
-link_internal u32
-Noise_FBM2D( perlin_noise *Noise,
+// NOTE(Jesse): Evaluates the FBM sum for a run of PERLIN_NOISE_BATCH_WIDTH
+// voxels along x, starting at the world-space integer coordinate (WorldX,
+// WorldY, WorldZ) and StrideX voxels apart.  The y and z inputs are the same
+// for every lane, so the divisions for those are only done once per octave.
+link_internal void
+FBM2D_8x( s32 WorldX, s32 WorldY, s32 WorldZ, s32 StrideX, s32 Frequency, s32 Amplitude, u32 Octaves, r32 *NoiseValues )
+{
+  f32 InX[PERLIN_NOISE_BATCH_WIDTH];
+  f32 InY[PERLIN_NOISE_BATCH_WIDTH];
+  f32 InZ[PERLIN_NOISE_BATCH_WIDTH];
+  f32 N[PERLIN_NOISE_BATCH_WIDTH];
+
+  for (u32 Lane = 0; Lane < PERLIN_NOISE_BATCH_WIDTH; ++Lane)
+  {
+    NoiseValues[Lane] = 0.f;
+  }
+
+  s32 InteriorFreq = Frequency;
+  s32 InteriorAmp = Amplitude;
+  for (u32 OctaveIndex = 0; OctaveIndex < Octaves; ++OctaveIndex)
+  {
+    f32 OctaveY = SafeDivide0(f32(WorldY), f32(InteriorFreq));
+    f32 OctaveZ = SafeDivide0(f32(WorldZ), f32(InteriorFreq));
+
+    for (u32 Lane = 0; Lane < PERLIN_NOISE_BATCH_WIDTH; ++Lane)
+    {
+      InX[Lane] = SafeDivide0(f32(WorldX + s32(Lane)*StrideX), f32(InteriorFreq));
+      InY[Lane] = OctaveY;
+      InZ[Lane] = OctaveZ;
+    }
+
+    PerlinNoise_8x(InX, InY, InZ, N);
+
+    for (u32 Lane = 0; Lane < PERLIN_NOISE_BATCH_WIDTH; ++Lane)
+    {
+      Assert(N[Lane] <= 1.05f);
+      Assert(N[Lane] > -1.05f);
+
+      NoiseValues[Lane] += N[Lane]*(r32(OctaveIndex+1));
+      NoiseValues[Lane] += N[Lane]*InteriorAmp;
+    }
+
+    InteriorAmp = Max(1, InteriorAmp/2);
+    InteriorFreq = Max(1, InteriorFreq/2);
+  }
+}
+
+link_internal u32
+Noise_FBM2D( perlin_noise *Noise,
              world_chunk *Chunk,
              chunk_dimension Dim,
              chunk_dimension SrcToDest,
@@ -581,65 +984,188 @@ Noise_FBM2D( perlin_noise *Noise,
   Assert(Frequency != INT_MIN);
 
   u32 Octaves = *(u32*)OctaveCount;
+
+  s32 WorldBaseX = SrcToDest.x + (WorldChunkDim.x*Chunk->WorldP.x);
+  s32 WorldBaseY = SrcToDest.y + (WorldChunkDim.y*Chunk->WorldP.y);
+  s32 WorldBaseZ = SrcToDest.z + (WorldChunkDim.z*Chunk->WorldP.z);
+
+  r32 NoiseValues[PERLIN_NOISE_BATCH_WIDTH];
+
   for ( s32 z = 0; z < Dim.z; ++ z)
   {
     s64 WorldZ = z - SrcToDest.z + (WorldChunkDim.z*Chunk->WorldP.z);
     s64 WorldZBiased = WorldZ - zMin;
     for ( s32 y = 0; y < Dim.y; ++ y)
     {
-      for ( s32 x = 0; x < Dim.x; ++ x)
+      for ( s32 x = 0; x < Dim.x; x += PERLIN_NOISE_BATCH_WIDTH)
       {
-        r32 NoiseValue = 0.f;
-        s32 VoxIndex = GetIndex(Voxel_Position(x,y,z), Dim);
-        Chunk->Voxels[VoxIndex].Flags = Voxel_Empty;
-        Assert( NotSet(&Chunk->Voxels[VoxIndex], Voxel_Filled) );
-
-        Assert(Frequency != INT_MIN);
-        s32 InteriorFreq = Frequency;
-        s32 InteriorAmp = Amplitude;
-        for (u32 OctaveIndex = 0; OctaveIndex < Octaves; ++OctaveIndex)
+        FBM2D_8x(WorldBaseX + x, WorldBaseY + y, WorldBaseZ + z, 1, Frequency, Amplitude, Octaves, NoiseValues);
+
+        s32 LaneCount = Min(PERLIN_NOISE_BATCH_WIDTH, Dim.x - x);
+        for (s32 Lane = 0; Lane < LaneCount; ++Lane)
         {
+          s32 VoxIndex = GetIndex(Voxel_Position(x+Lane,y,z), Dim);
+
+          b32 NoiseChoice = r64(NoiseValues[Lane]) > r64(WorldZBiased);
+
+          Chunk->Voxels[VoxIndex].Flags = u8(Voxel_Filled*NoiseChoice);
+          Chunk->Voxels[VoxIndex].Color = ColorIndex*u8(NoiseChoice);
+          ChunkSum += NoiseChoice;
+
+          Assert( (Chunk->Voxels[VoxIndex].Flags&VoxelFaceMask) == 0);
+        }
+      }
+    }
+  }
 
-          f32 InX = SafeDivide0((x + SrcToDest.x + ( WorldChunkDim.x*Chunk->WorldP.x)), f32(InteriorFreq));
-          f32 InY = SafeDivide0((y + SrcToDest.y + ( WorldChunkDim.y*Chunk->WorldP.y)), f32(InteriorFreq));
-          f32 InZ = SafeDivide0((z + SrcToDest.z + ( WorldChunkDim.z*Chunk->WorldP.z)), f32(InteriorFreq));
-          /* f32 InZ = 1.0; */
+  return ChunkSum;
+}
 
-          r32 Warp = 0.f;
+// NOTE(Jesse): Noise_FBM2D for a clipmap node, sampled every Scale voxels.
+// Voxel v of the synthetic chunk stands for world voxel
+// NodeBase + (v - Global_ChunkApronMinDim)*Scale, and is fed to the noise
+// with the same offset Noise_FBM2D applies, so nodes line up with the chunks
+// they replace.
+link_internal u32
+Noise_FBM2D_Lod( voxel *Voxels,
+                 chunk_dimension SynChunkDim,
+                 world_position NodeP,
+                 s32 Scale,
+                 lod_clipmap_noise *Params,
+                 u8 ColorIndex,
+                 chunk_dimension WorldChunkDim )
+{
+  TIMED_FUNCTION();
 
-          r32 N = PerlinNoise(InX+Warp, InY+Warp, InZ+Warp);
-          Assert(N <= 1.05f);
-          Assert(N > -1.05f);
+  u32 ChunkSum = 0;
 
-          s32 zValue = (s32)Abs( (N*InteriorAmp) );
+  s32 Amplitude = Params->Amplitude;
+  s32 Frequency = Max(Params->Frequency, 1);
 
-          b32 IsUnderground =  zValue < WorldZBiased;
-          b32 NoiseChoice = IsUnderground;
+  v3i NodeBase = NodeP*WorldChunkDim;
 
-          NoiseValue += N*(r32(OctaveIndex+1));
-          NoiseValue += N*InteriorAmp;
+  s32 MinZ = NodeBase.z;
+  s32 MaxZ = MinZ + (WorldChunkDim.z*Scale);
 
-          InteriorAmp = Max(1, InteriorAmp/2);
-          InteriorFreq = Max(1, InteriorFreq/2);
-        }
+  if (MaxZ < -Amplitude)
+  {
+    s32 MaxIndex = Volume(SynChunkDim);
+    for ( s32 VoxIndex = 0; VoxIndex < MaxIndex; ++VoxIndex)
+    {
+      Voxels[VoxIndex].Flags = Voxel_Filled;
+      Voxels[VoxIndex].Color = ColorIndex;
+    }
+    return (u32)MaxIndex;
+  }
 
-        b32 NoiseChoice = r64(NoiseValue) > r64(WorldZBiased);
+  if (MinZ > Amplitude)
+    return ChunkSum;
 
-        u8 ThisColor = ColorIndex;
+  v3i SampleBase = NodeBase - (Global_ChunkApronMinDim*Scale);
+  v3i NoiseOffset = Global_ChunkApronMinDim*2;
 
-        SetFlag(&Chunk->Voxels[VoxIndex], (voxel_flag)(Voxel_Filled*NoiseChoice));
-        Chunk->Voxels[VoxIndex].Color = ThisColor*u8(NoiseChoice);
-        ChunkSum += NoiseChoice;
+  r32 NoiseValues[PERLIN_NOISE_BATCH_WIDTH];
 
-        Assert( (Chunk->Voxels[VoxIndex].Flags&VoxelFaceMask) == 0);
+  for ( s32 z = 0; z < SynChunkDim.z; ++ z)
+  {
+    s32 WorldZ = SampleBase.z + (z*Scale);
+    s64 WorldZBiased = s64(WorldZ) - s64(Params->zMin);
+    for ( s32 y = 0; y < SynChunkDim.y; ++ y)
+    {
+      s32 WorldY = SampleBase.y + (y*Scale);
+      for ( s32 x = 0; x < SynChunkDim.x; x += PERLIN_NOISE_BATCH_WIDTH)
+      {
+        s32 WorldX = SampleBase.x + (x*Scale);
+        FBM2D_8x(WorldX + NoiseOffset.x, WorldY + NoiseOffset.y, WorldZ + NoiseOffset.z, Scale, Frequency, Amplitude, Params->Octaves, NoiseValues);
 
-        if (NoiseChoice)
+        s32 LaneCount = Min(PERLIN_NOISE_BATCH_WIDTH, SynChunkDim.x - x);
+        for (s32 Lane = 0; Lane < LaneCount; ++Lane)
         {
-          Assert( IsSet(&Chunk->Voxels[VoxIndex], Voxel_Filled) );
+          s32 VoxIndex = GetIndex(Voxel_Position(x+Lane,y,z), SynChunkDim);
+
+          b32 NoiseChoice = r64(NoiseValues[Lane]) > r64(WorldZBiased);
+
+          Voxels[VoxIndex].Flags = u8(Voxel_Filled*NoiseChoice);
+          Voxels[VoxIndex].Color = ColorIndex*u8(NoiseChoice);
+          ChunkSum += NoiseChoice;
         }
-        else
+      }
+    }
+  }
+
+  return ChunkSum;
+}
+
+// NOTE(Jesse): Heightmap fast-path for Noise_FBM2D.  The noise is sampled on
+// the z == 0 plane, so the height only depends on x/y; we evaluate it once per
+// column and fill the column in one pass, instead of once per voxel.
+//
+// Produces different terrain than Noise_FBM2D (which also feeds z into the
+// noise), so it's a separate callback rather than a drop-in replacement.
+link_internal u32
+Noise_FBM2D_Heightmap( perlin_noise *Noise,
+                       world_chunk *Chunk,
+                       chunk_dimension Dim,
+                       chunk_dimension SrcToDest,
+                       u8 ColorIndex,
+                       s32 Frequency,
+                       s32 Amplitude,
+                       s64 zMin,
+                       chunk_dimension WorldChunkDim,
+                       void *OctaveCount )
+{
+  TIMED_FUNCTION();
+  Assert(Frequency != INT_MIN);
+
+  u32 ChunkSum = 0;
+
+  s32 MinZ = Chunk->WorldP.z*WorldChunkDim.z;
+  s32 MaxZ = MinZ+WorldChunkDim.z ;
+
+  if (MaxZ < -Amplitude)
+  {
+    s32 MaxIndex = Volume(Dim);
+    for ( s32 VoxIndex = 0; VoxIndex < MaxIndex; ++VoxIndex)
+    {
+      Chunk->Voxels[VoxIndex].Flags = Voxel_Filled;
+      Chunk->Voxels[VoxIndex].Color = ColorIndex;
+    }
+    return (u32)MaxIndex;
+  }
+
+  if (MinZ > Amplitude)
+    return ChunkSum;
+
+  Frequency = Max(Frequency, 1);
+  Assert(Frequency != INT_MIN);
+
+  u32 Octaves = *(u32*)OctaveCount;
+
+  s32 WorldBaseX = SrcToDest.x + (WorldChunkDim.x*Chunk->WorldP.x);
+  s32 WorldBaseY = SrcToDest.y + (WorldChunkDim.y*Chunk->WorldP.y);
+
+  r32 Heights[PERLIN_NOISE_BATCH_WIDTH];
+
+  for ( s32 y = 0; y < Dim.y; ++ y)
+  {
+    for ( s32 x = 0; x < Dim.x; x += PERLIN_NOISE_BATCH_WIDTH)
+    {
+      FBM2D_8x(WorldBaseX + x, WorldBaseY + y, 0, 1, Frequency, Amplitude, Octaves, Heights);
+
+      s32 LaneCount = Min(PERLIN_NOISE_BATCH_WIDTH, Dim.x - x);
+      for ( s32 z = 0; z < Dim.z; ++ z)
+      {
+        s64 WorldZ = z - SrcToDest.z + (WorldChunkDim.z*Chunk->WorldP.z);
+        s64 WorldZBiased = WorldZ - zMin;
+
+        voxel *Row = Chunk->Voxels + GetIndex(Voxel_Position(x,y,z), Dim);
+        for (s32 Lane = 0; Lane < LaneCount; ++Lane)
         {
-          Assert( NotSet(&Chunk->Voxels[VoxIndex], Voxel_Filled) );
+          b32 NoiseChoice = r64(Heights[Lane]) > r64(WorldZBiased);
+
+          Row[Lane].Flags = u8(Voxel_Filled*NoiseChoice);
+          Row[Lane].Color = ColorIndex*u8(NoiseChoice);
+          ChunkSum += NoiseChoice;
         }
       }
     }
@@ -730,10 +1256,10 @@ typedef u32 (*chunk_init_callback)( perlin_noise *Noise, world_chunk *Chunk, chu
 
 
 link_internal void
-MarkBoundaryVoxels_MakeExteriorFaces( voxel *Voxels,
-                                      chunk_dimension SrcChunkDim,
-                                      chunk_dimension SrcChunkMin,
-                                      chunk_dimension SrcChunkMax )
+MarkBoundaryVoxels_MakeExteriorFaces_Scalar( voxel *Voxels,
+                                             chunk_dimension SrcChunkDim,
+                                             chunk_dimension SrcChunkMin,
+                                             chunk_dimension SrcChunkMax )
 {
   TIMED_FUNCTION();
 
@@ -796,13 +1322,13 @@ MarkBoundaryVoxels_MakeExteriorFaces( voxel *Voxels,
 }
 
 link_internal void
-MarkBoundaryVoxels_NoExteriorFaces( voxel *Voxels,
-                                    chunk_dimension SrcChunkDim,
-                                    chunk_dimension SrcChunkMin,
-                                    chunk_dimension SrcChunkMax,
-                                    random_series *Entropy = 0,
-                                    u8 NewColorMin = 0,
-                                    u8 NewColorMax = 0 )
+MarkBoundaryVoxels_NoExteriorFaces_Scalar( voxel *Voxels,
+                                           chunk_dimension SrcChunkDim,
+                                           chunk_dimension SrcChunkMin,
+                                           chunk_dimension SrcChunkMax,
+                                           random_series *Entropy = 0,
+                                           u8 NewColorMin = 0,
+                                           u8 NewColorMax = 0 )
 {
   TIMED_FUNCTION();
 
@@ -884,6 +1410,233 @@ MarkBoundaryVoxels_NoExteriorFaces( voxel *Voxels,
   }
 }
 
+// NOTE(Jesse): Vectorized boundary marking.
+//
+// Works on whole x-rows at a time.  Since a voxel is {u8 Flags, u8 Color}
+// each 16-bit lane holds one voxel, with the flags in the low byte.  For a
+// run of voxels we load the row, the row shifted by one voxel in each
+// direction along x, and the same run of the rows at +-y and +-z, then build
+// the six face bits with compares and and-nots.  Neighbor rows that fall
+// outside the chunk are replaced by a constant that's either all-empty
+// (MakeExteriorFaces) or all-filled (NoExteriorFaces).
+//
+// The first and last voxel along x, and any leftover tail of a row, go
+// through MarkBoundaryVoxel, which is also the scalar fallback when neither
+// AVX2 nor SSE2 are available.
+//
+// Only the filled bit of a neighbor is ever read, and that's never written,
+// so marking the chunk in-place is safe.
+
+CAssert(sizeof(voxel) == 2);
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MARK_BOUNDARY_VOXELS_LANE_COUNT (16)
+#elif defined(__SSE2__)
+#define MARK_BOUNDARY_VOXELS_LANE_COUNT (8)
+#else
+#define MARK_BOUNDARY_VOXELS_LANE_COUNT (0)
+#endif
+
+link_internal void
+MarkBoundaryVoxel( voxel *Voxels, chunk_dimension SrcChunkDim, voxel_position DestP, b32 MakeExteriorFaces )
+{
+  voxel *Voxel = Voxels + GetIndex(DestP, SrcChunkDim);
+
+  if (IsFilled(Voxel))
+  {
+    Voxel->Flags = Voxel_Filled;
+
+    voxel_position Neighbors[6] =
+    {
+      DestP + Voxel_Position(1, 0, 0),
+      DestP - Voxel_Position(1, 0, 0),
+      DestP + Voxel_Position(0, 0, 1),
+      DestP - Voxel_Position(0, 0, 1),
+      DestP + Voxel_Position(0, 1, 0),
+      DestP - Voxel_Position(0, 1, 0),
+    };
+
+    voxel_flag Faces[6] =
+    {
+      Voxel_RightFace,
+      Voxel_LeftFace,
+      Voxel_TopFace,
+      Voxel_BottomFace,
+      Voxel_FrontFace,
+      Voxel_BackFace,
+    };
+
+    for (u32 NeighborIndex = 0; NeighborIndex < 6; ++NeighborIndex)
+    {
+      voxel_position NeighborP = Neighbors[NeighborIndex];
+
+      b32 IsFace = IsInsideDim(SrcChunkDim, NeighborP) ? NotFilled(Voxels, NeighborP, SrcChunkDim) : MakeExteriorFaces;
+      if (IsFace)
+      {
+        Voxel->Flags |= Faces[NeighborIndex];
+      }
+    }
+  }
+}
+
+link_internal void
+MarkBoundaryVoxels_Simd( voxel *Voxels,
+                         chunk_dimension SrcChunkDim,
+                         chunk_dimension SrcChunkMin,
+                         chunk_dimension SrcChunkMax,
+                         b32 MakeExteriorFaces )
+{
+  TIMED_FUNCTION();
+
+  auto MinDim = SrcChunkMin;
+  auto MaxDim = Min(SrcChunkDim, SrcChunkMax); // SrcChunkMin+DestChunkDim+1
+
+  // NOTE(Jesse): The vector loop needs both x-neighbors of every voxel in the
+  // run to be inside the chunk.
+  s32 VectorMinX = Max(MinDim.x, 1);
+  s32 VectorMaxX = Min(MaxDim.x, SrcChunkDim.x-1);
+
+#if MARK_BOUNDARY_VOXELS_LANE_COUNT == 16
+  __m256i FilledBit  = _mm256_set1_epi16(Voxel_Filled);
+  __m256i ColorMask  = _mm256_set1_epi16(s16(0xFF00));
+  __m256i OutsideRow = MakeExteriorFaces ? _mm256_setzero_si256() : FilledBit;
+
+  __m256i RightFace  = _mm256_set1_epi16(Voxel_RightFace);
+  __m256i LeftFace   = _mm256_set1_epi16(Voxel_LeftFace);
+  __m256i TopFace    = _mm256_set1_epi16(Voxel_TopFace);
+  __m256i BottomFace = _mm256_set1_epi16(Voxel_BottomFace);
+  __m256i FrontFace  = _mm256_set1_epi16(Voxel_FrontFace);
+  __m256i BackFace   = _mm256_set1_epi16(Voxel_BackFace);
+#elif MARK_BOUNDARY_VOXELS_LANE_COUNT == 8
+  __m128i FilledBit  = _mm_set1_epi16(Voxel_Filled);
+  __m128i ColorMask  = _mm_set1_epi16(s16(0xFF00));
+  __m128i OutsideRow = MakeExteriorFaces ? _mm_setzero_si128() : FilledBit;
+
+  __m128i RightFace  = _mm_set1_epi16(Voxel_RightFace);
+  __m128i LeftFace   = _mm_set1_epi16(Voxel_LeftFace);
+  __m128i TopFace    = _mm_set1_epi16(Voxel_TopFace);
+  __m128i BottomFace = _mm_set1_epi16(Voxel_BottomFace);
+  __m128i FrontFace  = _mm_set1_epi16(Voxel_FrontFace);
+  __m128i BackFace   = _mm_set1_epi16(Voxel_BackFace);
+#endif
+
+  for ( s32 z = MinDim.z; z < MaxDim.z ; ++z )
+  {
+    for ( s32 y = MinDim.y; y < MaxDim.y ; ++y )
+    {
+      voxel *Row = Voxels + GetIndex(Voxel_Position(0,y,z), SrcChunkDim);
+
+      // NOTE(Jesse): Null when the neighboring row is outside the chunk
+      voxel *FrontRow  = y+1 < SrcChunkDim.y ? Row + SrcChunkDim.x : 0;
+      voxel *BackRow   = y   > 0             ? Row - SrcChunkDim.x : 0;
+      voxel *TopRow    = z+1 < SrcChunkDim.z ? Row + (SrcChunkDim.x*SrcChunkDim.y) : 0;
+      voxel *BottomRow = z   > 0             ? Row - (SrcChunkDim.x*SrcChunkDim.y) : 0;
+
+      s32 x = MinDim.x;
+      for ( ; x < VectorMinX && x < MaxDim.x; ++x )
+      {
+        MarkBoundaryVoxel(Voxels, SrcChunkDim, Voxel_Position(x,y,z), MakeExteriorFaces);
+      }
+
+#if MARK_BOUNDARY_VOXELS_LANE_COUNT == 16
+      for ( ; x + MARK_BOUNDARY_VOXELS_LANE_COUNT <= VectorMaxX; x += MARK_BOUNDARY_VOXELS_LANE_COUNT )
+      {
+        __m256i Center = _mm256_loadu_si256((__m256i*)(Row + x));
+        __m256i Right  = _mm256_loadu_si256((__m256i*)(Row + x + 1));
+        __m256i Left   = _mm256_loadu_si256((__m256i*)(Row + x - 1));
+        __m256i Front  = FrontRow  ? _mm256_loadu_si256((__m256i*)(FrontRow + x))  : OutsideRow;
+        __m256i Back   = BackRow   ? _mm256_loadu_si256((__m256i*)(BackRow + x))   : OutsideRow;
+        __m256i Top    = TopRow    ? _mm256_loadu_si256((__m256i*)(TopRow + x))    : OutsideRow;
+        __m256i Bottom = BottomRow ? _mm256_loadu_si256((__m256i*)(BottomRow + x)) : OutsideRow;
+
+#define FilledLanes(V) _mm256_cmpeq_epi16(_mm256_and_si256((V), FilledBit), FilledBit)
+        __m256i CenterFilled = FilledLanes(Center);
+
+        __m256i Faces =                   _mm256_andnot_si256(FilledLanes(Right),  RightFace);
+        Faces = _mm256_or_si256(Faces,    _mm256_andnot_si256(FilledLanes(Left),   LeftFace));
+        Faces = _mm256_or_si256(Faces,    _mm256_andnot_si256(FilledLanes(Top),    TopFace));
+        Faces = _mm256_or_si256(Faces,    _mm256_andnot_si256(FilledLanes(Bottom), BottomFace));
+        Faces = _mm256_or_si256(Faces,    _mm256_andnot_si256(FilledLanes(Front),  FrontFace));
+        Faces = _mm256_or_si256(Faces,    _mm256_andnot_si256(FilledLanes(Back),   BackFace));
+#undef FilledLanes
+
+        __m256i Marked = _mm256_or_si256(_mm256_and_si256(Center, ColorMask), _mm256_or_si256(FilledBit, Faces));
+
+        __m256i Result = _mm256_or_si256( _mm256_and_si256(CenterFilled, Marked),
+                                          _mm256_andnot_si256(CenterFilled, Center) );
+
+        _mm256_storeu_si256((__m256i*)(Row + x), Result);
+      }
+#elif MARK_BOUNDARY_VOXELS_LANE_COUNT == 8
+      for ( ; x + MARK_BOUNDARY_VOXELS_LANE_COUNT <= VectorMaxX; x += MARK_BOUNDARY_VOXELS_LANE_COUNT )
+      {
+        __m128i Center = _mm_loadu_si128((__m128i*)(Row + x));
+        __m128i Right  = _mm_loadu_si128((__m128i*)(Row + x + 1));
+        __m128i Left   = _mm_loadu_si128((__m128i*)(Row + x - 1));
+        __m128i Front  = FrontRow  ? _mm_loadu_si128((__m128i*)(FrontRow + x))  : OutsideRow;
+        __m128i Back   = BackRow   ? _mm_loadu_si128((__m128i*)(BackRow + x))   : OutsideRow;
+        __m128i Top    = TopRow    ? _mm_loadu_si128((__m128i*)(TopRow + x))    : OutsideRow;
+        __m128i Bottom = BottomRow ? _mm_loadu_si128((__m128i*)(BottomRow + x)) : OutsideRow;
+
+#define FilledLanes(V) _mm_cmpeq_epi16(_mm_and_si128((V), FilledBit), FilledBit)
+        __m128i CenterFilled = FilledLanes(Center);
+
+        __m128i Faces =                _mm_andnot_si128(FilledLanes(Right),  RightFace);
+        Faces = _mm_or_si128(Faces,    _mm_andnot_si128(FilledLanes(Left),   LeftFace));
+        Faces = _mm_or_si128(Faces,    _mm_andnot_si128(FilledLanes(Top),    TopFace));
+        Faces = _mm_or_si128(Faces,    _mm_andnot_si128(FilledLanes(Bottom), BottomFace));
+        Faces = _mm_or_si128(Faces,    _mm_andnot_si128(FilledLanes(Front),  FrontFace));
+        Faces = _mm_or_si128(Faces,    _mm_andnot_si128(FilledLanes(Back),   BackFace));
+#undef FilledLanes
+
+        __m128i Marked = _mm_or_si128(_mm_and_si128(Center, ColorMask), _mm_or_si128(FilledBit, Faces));
+
+        __m128i Result = _mm_or_si128( _mm_and_si128(CenterFilled, Marked),
+                                       _mm_andnot_si128(CenterFilled, Center) );
+
+        _mm_storeu_si128((__m128i*)(Row + x), Result);
+      }
+#endif
+
+      for ( ; x < MaxDim.x; ++x )
+      {
+        MarkBoundaryVoxel(Voxels, SrcChunkDim, Voxel_Position(x,y,z), MakeExteriorFaces);
+      }
+    }
+  }
+}
+
+link_internal void
+MarkBoundaryVoxels_MakeExteriorFaces( voxel *Voxels,
+                                      chunk_dimension SrcChunkDim,
+                                      chunk_dimension SrcChunkMin,
+                                      chunk_dimension SrcChunkMax )
+{
+  MarkBoundaryVoxels_Simd(Voxels, SrcChunkDim, SrcChunkMin, SrcChunkMax, True);
+}
+
+link_internal void
+MarkBoundaryVoxels_NoExteriorFaces( voxel *Voxels,
+                                    chunk_dimension SrcChunkDim,
+                                    chunk_dimension SrcChunkMin,
+                                    chunk_dimension SrcChunkMax,
+                                    random_series *Entropy = 0,
+                                    u8 NewColorMin = 0,
+                                    u8 NewColorMax = 0 )
+{
+  // NOTE(Jesse): Recoloring uncovered voxels needs the per-voxel before and
+  // after state, so that path stays scalar.  It only runs on edits.
+  if (Entropy)
+  {
+    MarkBoundaryVoxels_NoExteriorFaces_Scalar(Voxels, SrcChunkDim, SrcChunkMin, SrcChunkMax, Entropy, NewColorMin, NewColorMax);
+  }
+  else
+  {
+    MarkBoundaryVoxels_Simd(Voxels, SrcChunkDim, SrcChunkMin, SrcChunkMax, False);
+  }
+}
+
 link_internal void
 DrawDebugVoxels( voxel *Voxels,
                  chunk_dimension SrcChunkDim,
@@ -1264,14 +2017,53 @@ BuildWorldChunkMesh_DebugVoxels( voxel *Voxels,
   DestGeometry->Timestamp = __rdtsc();
 }
 
+// NOTE(Jesse): Pushes one face the *FaceVertexData helpers generated.  The
+// meshers are templated on the mesh type so the world chunks get meshed
+// straight into packed_chunk_mesh, and models into regular triangle meshes.
+link_internal void
+BufferChunkMeshFace(untextured_3d_geometry_buffer *Dest, v3 *VertexData, u32 *QuadVerts, v3 *NormalData, u8 Color, v4 *ColorPallette)
+{
+  v4 FaceColors[VERTS_PER_FACE];
+  FillColorArray(Color, FaceColors, ColorPallette, VERTS_PER_FACE);
+  BufferVertsDirect(Dest, VERTS_PER_FACE, VertexData, NormalData, FaceColors);
+}
+
+// NOTE(Jesse): Packed meshes store the voxel color index as is; it indexes
+// the gpu_chunk_buffer palette texture, which is built from DefaultPalette.
 link_internal void
+BufferChunkMeshFace(packed_chunk_mesh *Dest, v3 *VertexData, u32 *QuadVerts, v3 *NormalData, u8 Color, v4 *ColorPallette)
+{
+  Assert(ColorPallette == DefaultPalette);
+
+  if (!BufferHasRoomFor(Dest, 4))
+  {
+    Assert(false);
+    Error("Ran out of memory pushing a quad onto packed mesh with %d/%d used", Dest->At, Dest->End);
+    return;
+  }
+
+  u16 NormalAndColor = u16(Color | (GetPackedNormalIndex(NormalData[0]) << 8));
+  for (u32 CornerIndex = 0; CornerIndex < 4; ++CornerIndex)
+  {
+    v3 P = VertexData[QuadVerts[CornerIndex]];
+    packed_chunk_vertex *Vert = Dest->Verts + Dest->At++;
+    Vert->X = PackChunkVertexComponent(P.x);
+    Vert->Y = PackChunkVertexComponent(P.y);
+    Vert->Z = PackChunkVertexComponent(P.z);
+    Vert->NormalAndColor = NormalAndColor;
+  }
+
+  ++Dest->QuadCount;
+}
+
+template <typename mesh_t> link_internal void
 BuildWorldChunkMeshFromMarkedVoxels_Greedy( voxel *Voxels,
                                             chunk_dimension SrcChunkDim,
 
                                             chunk_dimension SrcChunkMin,
                                             chunk_dimension SrcChunkMax,
 
-                                            untextured_3d_geometry_buffer *DestGeometry,
+                                            mesh_t *DestGeometry,
                                             memory_arena *TempMemory,
                                             v4* ColorPallette = DefaultPalette )
 {
@@ -1296,7 +2088,6 @@ BuildWorldChunkMeshFromMarkedVoxels_Greedy( voxel *Voxels,
 
 
   v3 VertexData[VERTS_PER_FACE];
-  v4 FaceColors[VERTS_PER_FACE];
 
   auto SrcMinP = SrcChunkMin;
   auto MaxDim = Min(SrcChunkDim, SrcChunkMax); // SrcChunkMin+DestChunkDim+1
@@ -1337,45 +2128,42 @@ BuildWorldChunkMeshFromMarkedVoxels_Greedy( voxel *Voxels,
         /* u8 C =  ((Voxel->Color + RandomU32(&ColorEntropy)) & 0xFF); */
         u8 C = Voxel->Color;
 
-        // TODO(Jesse): This copy could be avoided in multiple ways, and should be.
-        FillColorArray(C, FaceColors, ColorPallette, VERTS_PER_FACE);
-
         if (Voxel->Flags & Voxel_RightFace)
         {
           v3 Dim = DoXStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_RightFace, Voxel->Color);
           RightFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, RightFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, RightFaceQuadVerts, RightFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_LeftFace)
         {
           v3 Dim = DoXStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_LeftFace, Voxel->Color);
           LeftFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, LeftFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, LeftFaceQuadVerts, LeftFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_BottomFace)
         {
           v3 Dim = DoZStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_BottomFace, Voxel->Color);
           BottomFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, BottomFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, BottomFaceQuadVerts, BottomFaceNormalData, C, ColorPallette);
         }
 
         if (Voxel->Flags & Voxel_TopFace)
         {
           v3 Dim = DoZStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_TopFace, Voxel->Color);
           TopFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, TopFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, TopFaceQuadVerts, TopFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_FrontFace)
         {
           v3 Dim = DoYStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_FrontFace, Voxel->Color);
           FrontFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, FrontFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, FrontFaceQuadVerts, FrontFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_BackFace)
         {
           v3 Dim = DoYStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_BackFace, Voxel->Color);
           BackFaceVertexData( V3(TmpVoxP), Dim, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, BackFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, BackFaceQuadVerts, BackFaceNormalData, C, ColorPallette);
         }
       }
     }
@@ -1392,43 +2180,289 @@ BuildWorldChunkMeshFromMarkedVoxels_Greedy( vox_data *Vox,
   BuildWorldChunkMeshFromMarkedVoxels_Greedy(Vox->ChunkData->Voxels, Vox->ChunkData->Dim, {}, Vox->ChunkData->Dim, DestGeometry, TempMemory, Vox->Palette);
 }
 
-link_internal void
-BuildMipMesh( voxel *Voxels,
-              chunk_dimension VoxDim,
-
-              chunk_dimension InnerMin,
-              chunk_dimension InnerMax,
+// NOTE(Jesse): Bitmask greedy mesher.
+//
+// Instead of walking every voxel and stepping outwards from each face, we
+// build a u64 row mask per (face, slice, row) from the marked face flags,
+// then merge faces a row at a time using bit scans: the lowest set bit
+// starts a run, the run length is a scan of the inverted row, and the run
+// grows into the next rows by testing the same bits with a single AND.
+//
+// The face flags are the source of truth (rather than recomputing faces
+// from occupancy) because they already account for the neighbours in the
+// chunk aprons and for DoWorldUpdate edits.
+//
+// Runs are merged along the same axes, in the same order, as DoXStepping
+// and friends, so the quads it emits are the same ones that
+// BuildWorldChunkMeshFromMarkedVoxels_Greedy produces (see tests/chunk.cpp).  Each axis of the
+// meshed region must be <= BINARY_MESHER_MAX_DIM.
 
-              untextured_3d_geometry_buffer *DestGeometry,
-              memory_arena *TempMemory,
-              v4* ColorPallette = DefaultPalette )
-{
-  TIMED_FUNCTION();
+#define BINARY_MESHER_MAX_DIM (64)
 
-  /* Assert(IsSet(SrcChunk, Chunk_VoxelsInitialized)); */
-  /* Assert(IsSet(DestChunk, Chunk_VoxelsInitialized)); */
+typedef void (*face_vertex_data_proc)(v3 MinP, v3 Diameter, v3 *Result);
 
-  /* Assert(InnerMin-InnerMax */
+struct binary_mesher_face
+{
+  voxel_flag Flag;
 
-  voxel_position rightVoxel;
-  voxel_position leftVoxel;
-  voxel_position topVoxel;
-  voxel_position botVoxel;
-  voxel_position frontVoxel;
-  voxel_position backVoxel;
+  s32 SliceAxis;
+  s32 ColAxis; // Bits of a row mask
+  s32 RowAxis;
 
-  s32 rightVoxelReadIndex;
-  s32 leftVoxelReadIndex;
-  s32 topVoxelReadIndex;
-  s32 botVoxelReadIndex;
-  s32 frontVoxelReadIndex;
-  s32 backVoxelReadIndex;
+  face_vertex_data_proc FaceVertexData;
+  v3 *NormalData;
+  u32 *QuadVerts;
+};
 
+global_variable binary_mesher_face BinaryMesherFaces[] =
+{
+  { Voxel_RightFace,  0, 1, 2, RightFaceVertexData,  RightFaceNormalData,  RightFaceQuadVerts  },
+  { Voxel_LeftFace,   0, 1, 2, LeftFaceVertexData,   LeftFaceNormalData,   LeftFaceQuadVerts   },
+  { Voxel_FrontFace,  1, 0, 2, FrontFaceVertexData,  FrontFaceNormalData,  FrontFaceQuadVerts  },
+  { Voxel_BackFace,   1, 0, 2, BackFaceVertexData,   BackFaceNormalData,   BackFaceQuadVerts   },
+  { Voxel_TopFace,    2, 0, 1, TopFaceVertexData,    TopFaceNormalData,    TopFaceQuadVerts    },
+  { Voxel_BottomFace, 2, 0, 1, BottomFaceVertexData, BottomFaceNormalData, BottomFaceQuadVerts },
+};
 
-  v3 VertexData[VERTS_PER_FACE];
-  v4 FaceColors[VERTS_PER_FACE];
+link_internal u32
+GetIndexOfLowestSetBit(u64 Mask)
+{
+  Assert(Mask);
+  u32 Result = u32(__builtin_ctzll(Mask));
+  return Result;
+}
 
-  Assert(VoxDim >= InnerMax);
+link_internal u64
+BitRunMask(u32 FirstBit, u32 Count)
+{
+  Assert(Count);
+  Assert(FirstBit + Count <= 64);
+  u64 Result = (Count == 64 ? ~0ull : ((1ull << Count) - 1)) << FirstBit;
+  return Result;
+}
+
+link_internal b32
+ColorsMatch(voxel *Voxels, chunk_dimension VoxDim, v3i StartP, s32 Axis, s32 Count, u8 Color)
+{
+  b32 Result = True;
+  v3i P = StartP;
+  for (s32 Index = 0; Index < Count; ++Index)
+  {
+    if (Voxels[GetIndex(P, VoxDim)].Color != Color) { Result = False; break; }
+    P.E[Axis] += 1;
+  }
+  return Result;
+}
+
+template <typename mesh_t> link_internal void
+BuildWorldChunkMeshFromMarkedVoxels_BinaryGreedy( voxel *Voxels,
+                                                  chunk_dimension SrcChunkDim,
+
+                                                  chunk_dimension SrcChunkMin,
+                                                  chunk_dimension SrcChunkMax,
+
+                                                  mesh_t *DestGeometry,
+                                                  memory_arena *TempMemory,
+                                                  v4* ColorPallette = DefaultPalette )
+{
+  TIMED_FUNCTION();
+
+  v3i MinP = SrcChunkMin;
+  v3i MaxP = Min(SrcChunkDim, SrcChunkMax);
+  v3i TmpDim = MaxP-MinP;
+
+  Assert(TmpDim.x <= BINARY_MESHER_MAX_DIM);
+  Assert(TmpDim.y <= BINARY_MESHER_MAX_DIM);
+  Assert(TmpDim.z <= BINARY_MESHER_MAX_DIM);
+
+  // NOTE(Jesse): Rows for each face are laid out [Slice][Row]
+  u64 *FaceRows[ArrayCount(BinaryMesherFaces)];
+  for (u32 FaceIndex = 0; FaceIndex < ArrayCount(BinaryMesherFaces); ++FaceIndex)
+  {
+    binary_mesher_face *Face = BinaryMesherFaces + FaceIndex;
+    umm RowCount = umm(TmpDim.E[Face->SliceAxis] * TmpDim.E[Face->RowAxis]);
+    FaceRows[FaceIndex] = Allocate(u64, TempMemory, RowCount);
+    for (umm RowIndex = 0; RowIndex < RowCount; ++RowIndex) { FaceRows[FaceIndex][RowIndex] = 0; }
+  }
+
+  {
+    TIMED_NAMED_BLOCK("BinaryGreedy Build Masks");
+    for ( s32 z = 0; z < TmpDim.z ; ++z )
+    {
+      for ( s32 y = 0; y < TmpDim.y ; ++y )
+      {
+        for ( s32 x = 0; x < TmpDim.x ; ++x )
+        {
+          v3i LocalP = V3i(x,y,z);
+          u8 Flags = Voxels[GetIndex(MinP + LocalP, SrcChunkDim)].Flags;
+
+          if ((Flags & VoxelFaceMask) == 0) { continue; }
+
+          for (u32 FaceIndex = 0; FaceIndex < ArrayCount(BinaryMesherFaces); ++FaceIndex)
+          {
+            binary_mesher_face *Face = BinaryMesherFaces + FaceIndex;
+            if (Flags & Face->Flag)
+            {
+              s32 Slice = LocalP.E[Face->SliceAxis];
+              s32 Row   = LocalP.E[Face->RowAxis];
+              s32 Col   = LocalP.E[Face->ColAxis];
+              FaceRows[FaceIndex][Slice*TmpDim.E[Face->RowAxis] + Row] |= (1ull << Col);
+            }
+          }
+        }
+      }
+    }
+    END_BLOCK("BinaryGreedy Build Masks");
+  }
+
+  v3 VertexData[VERTS_PER_FACE];
+
+  for (u32 FaceIndex = 0; FaceIndex < ArrayCount(BinaryMesherFaces); ++FaceIndex)
+  {
+    binary_mesher_face *Face = BinaryMesherFaces + FaceIndex;
+
+    s32 SliceCount = TmpDim.E[Face->SliceAxis];
+    s32 RowCount   = TmpDim.E[Face->RowAxis];
+    s32 ColCount   = TmpDim.E[Face->ColAxis];
+
+    for (s32 Slice = 0; Slice < SliceCount; ++Slice)
+    {
+      u64 *Rows = FaceRows[FaceIndex] + (Slice*RowCount);
+
+      for (s32 Row = 0; Row < RowCount; ++Row)
+      {
+        while (Rows[Row])
+        {
+          u32 Col = GetIndexOfLowestSetBit(Rows[Row]);
+
+          v3i StartP = {};
+          StartP.E[Face->SliceAxis] = Slice;
+          StartP.E[Face->RowAxis] = Row;
+          StartP.E[Face->ColAxis] = s32(Col);
+
+          u8 Color = Voxels[GetIndex(MinP + StartP, SrcChunkDim)].Color;
+
+          // NOTE(Jesse): Length of the run of set bits starting at Col, then
+          // trimmed to the voxels that are the same color
+          u64 Shifted = Rows[Row] >> Col;
+          u32 Width = (~Shifted) ? GetIndexOfLowestSetBit(~Shifted) : (64 - Col);
+          Width = Min(Width, u32(ColCount) - Col);
+          {
+            v3i P = MinP + StartP;
+            for (u32 ColIndex = 1; ColIndex < Width; ++ColIndex)
+            {
+              P.E[Face->ColAxis] += 1;
+              if (Voxels[GetIndex(P, SrcChunkDim)].Color != Color) { Width = ColIndex; break; }
+            }
+          }
+
+          u64 RunMask = BitRunMask(Col, Width);
+
+          s32 Height = 1;
+          while ( Row + Height < RowCount &&
+                  (Rows[Row+Height] & RunMask) == RunMask )
+          {
+            v3i NextRowP = MinP + StartP;
+            NextRowP.E[Face->RowAxis] += Height;
+            if (!ColorsMatch(Voxels, SrcChunkDim, NextRowP, Face->ColAxis, s32(Width), Color)) { break; }
+            ++Height;
+          }
+
+          for (s32 RowIndex = 0; RowIndex < Height; ++RowIndex)
+          {
+            Rows[Row+RowIndex] &= ~RunMask;
+          }
+
+          v3 Dim = {};
+          Dim.E[Face->SliceAxis] = 1.f;
+          Dim.E[Face->ColAxis] = r32(Width);
+          Dim.E[Face->RowAxis] = r32(Height);
+
+          Face->FaceVertexData(V3(StartP), Dim, VertexData);
+          BufferChunkMeshFace(DestGeometry, VertexData, Face->QuadVerts, Face->NormalData, Color, ColorPallette);
+        }
+      }
+    }
+  }
+
+  DestGeometry->Timestamp = __rdtsc();
+}
+
+enum chunk_mesher
+{
+  ChunkMesher_Greedy,
+  ChunkMesher_BinaryGreedy,
+};
+
+// NOTE(Jesse): Selects the mesher used for world chunks.  TestBinaryGreedyMesher
+// in tests/chunk.cpp checks the two emit the same quads, and prints
+// cycles/chunk for each.  Greedy stays the default until those numbers say
+// BinaryGreedy is worth switching to.
+global_variable chunk_mesher Global_ChunkMesher = ChunkMesher_Greedy;
+
+link_internal void
+BuildWorldChunkMeshFromMarkedVoxels( voxel *Voxels,
+                                     chunk_dimension SrcChunkDim,
+
+                                     chunk_dimension SrcChunkMin,
+                                     chunk_dimension SrcChunkMax,
+
+                                     packed_chunk_mesh *DestGeometry,
+                                     memory_arena *TempMemory,
+                                     v4* ColorPallette )
+{
+  v3i MeshDim = Min(SrcChunkDim, SrcChunkMax) - SrcChunkMin;
+
+  b32 FitsBinaryMesher = MeshDim.x <= BINARY_MESHER_MAX_DIM &&
+                         MeshDim.y <= BINARY_MESHER_MAX_DIM &&
+                         MeshDim.z <= BINARY_MESHER_MAX_DIM;
+
+  if (Global_ChunkMesher == ChunkMesher_BinaryGreedy && FitsBinaryMesher)
+  {
+    BuildWorldChunkMeshFromMarkedVoxels_BinaryGreedy(Voxels, SrcChunkDim, SrcChunkMin, SrcChunkMax, DestGeometry, TempMemory, ColorPallette);
+  }
+  else
+  {
+    BuildWorldChunkMeshFromMarkedVoxels_Greedy(Voxels, SrcChunkDim, SrcChunkMin, SrcChunkMax, DestGeometry, TempMemory, ColorPallette);
+  }
+}
+
+template <typename mesh_t> link_internal void
+BuildMipMesh( voxel *Voxels,
+              chunk_dimension VoxDim,
+
+              chunk_dimension InnerMin,
+              chunk_dimension InnerMax,
+
+              mesh_t *DestGeometry,
+              memory_arena *TempMemory,
+              v4* ColorPallette = DefaultPalette )
+{
+  TIMED_FUNCTION();
+
+  /* Assert(IsSet(SrcChunk, Chunk_VoxelsInitialized)); */
+  /* Assert(IsSet(DestChunk, Chunk_VoxelsInitialized)); */
+
+  /* Assert(InnerMin-InnerMax */
+
+  voxel_position rightVoxel;
+  voxel_position leftVoxel;
+  voxel_position topVoxel;
+  voxel_position botVoxel;
+  voxel_position frontVoxel;
+  voxel_position backVoxel;
+
+  s32 rightVoxelReadIndex;
+  s32 leftVoxelReadIndex;
+  s32 topVoxelReadIndex;
+  s32 botVoxelReadIndex;
+  s32 frontVoxelReadIndex;
+  s32 backVoxelReadIndex;
+
+
+  v3 VertexData[VERTS_PER_FACE];
+
+  Assert(VoxDim >= InnerMax);
 
   s32 MipLevel = 2;
   v3i InnerDim = InnerMax - InnerMin;
@@ -1543,45 +2577,42 @@ BuildMipMesh( voxel *Voxels,
         /* u8 C =  ((Voxel->Color + RandomU32(&ColorEntropy)) & 0xFF); */
         u8 C = Voxel->Color;
 
-        // TODO(Jesse): This copy could be avoided in multiple ways, and should be.
-        FillColorArray(C, FaceColors, ColorPallette, VERTS_PER_FACE);
-
         if (Voxel->Flags & Voxel_RightFace)
         {
           v3 Dim = DoXStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_RightFace, Voxel->Color);
           RightFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, RightFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, RightFaceQuadVerts, RightFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_LeftFace)
         {
           v3 Dim = DoXStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_LeftFace, Voxel->Color);
           LeftFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, LeftFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, LeftFaceQuadVerts, LeftFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_BottomFace)
         {
           v3 Dim = DoZStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_BottomFace, Voxel->Color);
           BottomFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, BottomFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, BottomFaceQuadVerts, BottomFaceNormalData, C, ColorPallette);
         }
 
         if (Voxel->Flags & Voxel_TopFace)
         {
           v3 Dim = DoZStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_TopFace, Voxel->Color);
           TopFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, TopFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, TopFaceQuadVerts, TopFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_FrontFace)
         {
           v3 Dim = DoYStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_FrontFace, Voxel->Color);
           FrontFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, FrontFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, FrontFaceQuadVerts, FrontFaceNormalData, C, ColorPallette);
         }
         if (Voxel->Flags & Voxel_BackFace)
         {
           v3 Dim = DoYStepping(TempVoxels, TmpDim, TmpVoxP, Voxel_BackFace, Voxel->Color);
           BackFaceVertexData( V3(ActualP)*MipLevel, Dim*MipLevel, VertexData);
-          BufferVertsDirect(DestGeometry, 6, VertexData, BackFaceNormalData, FaceColors);
+          BufferChunkMeshFace(DestGeometry, VertexData, BackFaceQuadVerts, BackFaceNormalData, C, ColorPallette);
         }
       }
     }
@@ -1803,6 +2834,119 @@ AllocateTempWorldChunkMesh(memory_arena* TempMemory)
   return Result;
 }
 
+link_internal chunk_scratch *
+AllocateChunkScratch(chunk_dimension SynChunkDim)
+{
+  memory_arena *Memory = AllocateArena();
+  chunk_scratch *Result = AllocateAlignedProtection(chunk_scratch, Memory, 1, CACHE_LINE_SIZE, False);
+  Result->Memory = Memory;
+
+  Result->SynChunkDim = SynChunkDim;
+  AllocateWorldChunk(&Result->SyntheticChunk, Memory, {}, SynChunkDim);
+
+  Result->PrimaryMesh = AllocateTempPackedChunkMesh(Memory);
+  Result->LodMesh = AllocateTempWorldChunkMesh(Memory);
+  Result->MipMesh = AllocateTempPackedChunkMesh(Memory);
+
+  Result->BoundaryVoxels = AllocateBoundaryVoxels(u32(Volume(SynChunkDim)), Memory);
+
+  InitPaletteLookup(&Result->PaletteLookup, DefaultPalette, ArrayCount(DefaultPalette));
+
+  return Result;
+}
+
+// NOTE(Jesse): Returns zero if the calling thread's scratch is busy (a job
+// that ran another job while it waited) or was built for a different chunk
+// size, in which case the caller allocates out of temp memory like it used to.
+link_internal chunk_scratch *
+AcquireChunkScratch(thread_local_state *Thread, chunk_dimension SynChunkDim)
+{
+  chunk_scratch *Result = 0;
+
+  s32 ThreadIndex = ThreadLocal_ThreadIndex;
+  platform *Plat = Thread->EngineResources ? Thread->EngineResources->Plat : 0;
+  if (Plat && Plat->Threads && ThreadIndex >= 0 && ThreadIndex < s32(GetTotalThreadCount()))
+  {
+    thread_startup_params *Params = Plat->Threads + ThreadIndex;
+    if (Params->ChunkScratch == 0)
+    {
+      Params->ChunkScratch = AllocateChunkScratch(SynChunkDim);
+      ++Params->ChunkScratch->Allocations;
+    }
+
+    chunk_scratch *Scratch = Params->ChunkScratch;
+    if (Scratch->InUse == False && Scratch->SynChunkDim == SynChunkDim)
+    {
+      Scratch->InUse = True;
+      ++Scratch->Reuses;
+      Result = Scratch;
+    }
+    else
+    {
+      ++Scratch->Allocations;
+    }
+  }
+
+  return Result;
+}
+
+link_internal void
+ReleaseChunkScratch(chunk_scratch *Scratch)
+{
+  if (Scratch)
+  {
+    Assert(Scratch->InUse);
+    Scratch->InUse = False;
+  }
+}
+
+link_internal void
+PrintChunkScratchStats(platform *Plat)
+{
+  s32 TotalThreadCount = s32(GetTotalThreadCount());
+  for (s32 ThreadIndex = 0; ThreadIndex < TotalThreadCount; ++ThreadIndex)
+  {
+    chunk_scratch *Scratch = Plat->Threads[ThreadIndex].ChunkScratch;
+    if (Scratch)
+    {
+      Info("Thread (%d) chunk scratch : reused (%u) times, allocated (%u) times", ThreadIndex, Scratch->Reuses, Scratch->Allocations);
+    }
+  }
+}
+
+link_internal untextured_3d_geometry_buffer *
+GetTempChunkMesh(untextured_3d_geometry_buffer *ScratchMesh, memory_arena *TempMemory)
+{
+  untextured_3d_geometry_buffer *Result = ScratchMesh;
+  if (Result)
+  {
+    ZeroMesh(Result);
+  }
+  else
+  {
+    Result = AllocateTempWorldChunkMesh(TempMemory);
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Each worker's scratch has a lookup that's warmed up over many
+// chunks; without one we start a cold one in temp memory.
+link_internal palette_lookup *
+GetChunkScratchPaletteLookup(chunk_scratch *Scratch, memory_arena *TempMemory)
+{
+  palette_lookup *Result = 0;
+  if (Scratch)
+  {
+    Result = &Scratch->PaletteLookup;
+  }
+  else
+  {
+    Result = Allocate(palette_lookup, TempMemory, 1);
+    InitPaletteLookup(Result, DefaultPalette, ArrayCount(DefaultPalette));
+  }
+  return Result;
+}
+
 link_internal untextured_3d_geometry_buffer*
 GetPermMeshForChunk(mesh_freelist* Freelist, u32 Elements, memory_arena* PermMemory)
 {
@@ -2754,14 +3898,25 @@ ComputeLodMesh( thread_local_state *Thread,
                 world_chunk *DestChunk, chunk_dimension WorldChunkDim,
                 world_chunk *SyntheticChunk, chunk_dimension SynChunkDim,
                 untextured_3d_geometry_buffer *LodMesh,
-                b32 DoOffset
+                b32 DoOffset,
+                boundary_voxels *BoundingPoints = 0
               )
 {
 #if 1
     {
 
       u32 SynChunkVolume = (u32)Volume(SynChunkDim);
-      boundary_voxels* BoundingPoints = AllocateBoundaryVoxels(SynChunkVolume, Thread->TempMemory);
+      if (BoundingPoints)
+      {
+        Assert(BoundingPoints->End >= SynChunkVolume);
+        BoundingPoints->At = 0;
+        BoundingPoints->Min = Voxel_Position(s32_MAX);
+        BoundingPoints->Max = Voxel_Position(s32_MIN);
+      }
+      else
+      {
+        BoundingPoints = AllocateBoundaryVoxels(SynChunkVolume, Thread->TempMemory);
+      }
 
       GetBoundingVoxelsClippedTo(SyntheticChunk, SynChunkDim, BoundingPoints, MinMaxAABB( V3(1), V3(SynChunkDim)-V3(2) ) );
 
@@ -3067,11 +4222,10 @@ InitializeWorldChunkEmpty(world_chunk *DestChunk)
 // TODO(Jesse)(hack): Remove this!
 global_variable memory_arena Global_PermMemory = {};
 
-inline void
-QueueChunkForInit(work_queue *Queue, world_chunk *Chunk)
+link_internal work_queue_entry
+InitWorldChunkJob(world_chunk *Chunk)
 {
-  TIMED_FUNCTION();
-  Assert( NotSet(Chunk->Flags, Chunk_Queued) );
+  Assert( IsSet(Chunk->Flags, Chunk_Queued) );
 
 /*   DebugLine("Queuing Chunk (%p)(%d, %d, %d)", Chunk, Chunk->WorldP.x, Chunk->WorldP.y, Chunk->WorldP.z); */
 
@@ -3082,74 +4236,1143 @@ QueueChunkForInit(work_queue *Queue, world_chunk *Chunk)
     Job->Chunk = Chunk;
   }
 
-  Assert( NotSet(Chunk->Flags, Chunk_Queued) );
-  SetFlag(&Chunk->Flags, Chunk_Queued);
-  PushWorkQueueEntry(Queue, &Entry);
+  return Entry;
+}
 
-  return;
+link_internal void
+PushInitWorldChunkJob(work_queue *Queue, world_chunk *Chunk)
+{
+  work_queue_entry Entry = InitWorldChunkJob(Chunk);
+  PushWorkQueueEntry(Queue, &Entry);
 }
 
 inline void
-QueueChunkForMeshRebuild(work_queue *Queue, world_chunk *Chunk)
+QueueChunkForInit(work_queue *Queue, world_chunk *Chunk)
 {
   TIMED_FUNCTION();
 
-  // NOTE(Jesse): This is legal
-  /* Assert( NotSet(Chunk->Flags, Chunk_Queued) ); */
-
-  work_queue_entry Entry = {};
-
-  {
-    Entry.Type = type_work_queue_entry_rebuild_mesh;
-    work_queue_entry_rebuild_mesh *Job = SafeAccess(work_queue_entry_rebuild_mesh, &Entry);
-    Job->Chunk = Chunk;
-  }
-
+  Assert( NotSet(Chunk->Flags, Chunk_Queued) );
   SetFlag(&Chunk->Flags, Chunk_Queued);
-  PushWorkQueueEntry(Queue, &Entry);
+  PushInitWorldChunkJob(Queue, Chunk);
 
   return;
 }
 
-#if PLATFORM_GL_IMPLEMENTATIONS
-link_internal work_queue_entry_rebuild_mesh
-WorkQueueEntryRebuildMesh(world_chunk *Chunk)
+// NOTE(Jesse): Like QueueChunkForInit, but the chunk waits in
+// World->PendingInits until DispatchChunkInitJobs decides it's next.
+link_internal void
+ScheduleChunkForInit(world *World, world_chunk *Chunk)
 {
-  work_queue_entry_rebuild_mesh Result = { .Chunk = Chunk };
-  return Result;
-}
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+  Assert( NotSet(Chunk->Flags, Chunk_Queued) );
+  Assert( World->PendingInitCount < World->HashSize );
 
-link_internal work_queue_entry_update_world_region
-WorkQueueEntryUpdateWorldRegion(world_update_operation Op, u8 ColorIndex, picked_voxel *Location, f32 Radius, canonical_position MinP, canonical_position MaxP, world_chunk** ChunkBuffer, u32 ChunkCount)
-{
-  work_queue_entry_update_world_region Result =
-  {
-    .Op = Op,
-    .ColorIndex = ColorIndex,
-    .Location = *Location,
-    .Radius = Radius,
-    .ChunkBuffer = ChunkBuffer,
-    .ChunkCount = ChunkCount,
-    .MinP = MinP,
-    .MaxP = MaxP
-  };
-  return Result;
+  SetFlag(&Chunk->Flags, Chunk_Queued);
+
+  // NOTE(Jesse): Priority gets computed in DispatchChunkInitJobs
+  World->PendingInits[World->PendingInitCount++] = { .Chunk = Chunk, .Priority = 0.f };
 }
 
-link_internal work_queue_entry_copy_buffer_ref
-WorkQueueEntryCopyBufferRef(threadsafe_geometry_buffer *Buf, world_chunk_mesh_bitfield MeshBit, untextured_3d_geometry_buffer* Dest, world_position ChunkP, camera* Camera, chunk_dimension WorldChunkDim)
+// NOTE(Jesse): Splits the positions in A that aren't in B into at most 6
+// disjoint boxes, returning how many were written to Result.
+link_internal u32
+SubtractRect3i(rect3i A, rect3i B, rect3i *Result)
 {
-  work_queue_entry_copy_buffer_ref Result = {};
-
-  Result.Buf = Buf;
-  Result.MeshBit = MeshBit;
-  Result.Dest = Dest;
-  Result.Basis = GetRenderP(WorldChunkDim, ChunkP, Camera);
+  u32 Count = 0;
 
-  return Result;
-}
+  b32 Overlaps = A.Min.x < B.Max.x && B.Min.x < A.Max.x &&
+                 A.Min.y < B.Max.y && B.Min.y < A.Max.y &&
+                 A.Min.z < B.Max.z && B.Min.z < A.Max.z;
 
-link_internal work_queue_entry_copy_buffer
+  if (Overlaps)
+  {
+    // NOTE(Jesse): Peel off the slab below and above B on each axis, then
+    // shrink what's left to the overlap on that axis before moving on.
+    rect3i Rest = A;
+    for (u32 Axis = 0; Axis < 3; ++Axis)
+    {
+      if (Rest.Min.E[Axis] < B.Min.E[Axis])
+      {
+        rect3i Slab = Rest;
+        Slab.Max.E[Axis] = B.Min.E[Axis];
+        Result[Count++] = Slab;
+        Rest.Min.E[Axis] = B.Min.E[Axis];
+      }
+
+      if (Rest.Max.E[Axis] > B.Max.E[Axis])
+      {
+        rect3i Slab = Rest;
+        Slab.Min.E[Axis] = B.Max.E[Axis];
+        Result[Count++] = Slab;
+        Rest.Max.E[Axis] = B.Max.E[Axis];
+      }
+    }
+  }
+  else if (A.Min.x < A.Max.x && A.Min.y < A.Max.y && A.Min.z < A.Max.z)
+  {
+    Result[Count++] = A;
+  }
+
+  Assert(Count <= 6);
+  return Count;
+}
+
+// NOTE(Jesse): Brings the world in line with the visible region around
+// World->Center.  Only the chunk positions that left or entered the region
+// since last time are visited, so a frame where the center didn't cross a
+// chunk boundary costs nothing.
+link_internal void
+UpdateWorldResidency(engine_resources *Engine)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  world *World = Engine->World;
+
+  chunk_dimension Radius = World->VisibleRegion/2;
+  rect3i Region = Rect3iMinMax(World->Center - Radius, World->Center + Radius);
+  rect3i Resident = World->ResidentRegion;
+
+  if (Region.Min == Resident.Min && Region.Max == Resident.Max) { return; }
+
+  rect3i Slabs[6];
+
+  // NOTE(Jesse): Evict first so the slots are free for what's coming in
+  u32 SlabCount = SubtractRect3i(Resident, Region, Slabs);
+  for (u32 SlabIndex = 0; SlabIndex < SlabCount; ++SlabIndex)
+  {
+    rect3i *Slab = Slabs + SlabIndex;
+    for (s32 z = Slab->Min.z; z < Slab->Max.z; ++ z)
+    {
+      for (s32 y = Slab->Min.y; y < Slab->Max.y; ++ y)
+      {
+        for (s32 x = Slab->Min.x; x < Slab->Max.x; ++ x)
+        {
+          u32 SlotIndex = GetWorldChunkSlot(World, World_Position(x,y,z));
+          if (SlotIndex < World->HashSize)
+          {
+            EvictChunkFromWorld(World, SlotIndex, &Engine->MeshFreelist, World->Memory);
+          }
+        }
+      }
+    }
+  }
+
+  SlabCount = SubtractRect3i(Region, Resident, Slabs);
+  for (u32 SlabIndex = 0; SlabIndex < SlabCount; ++SlabIndex)
+  {
+    rect3i *Slab = Slabs + SlabIndex;
+    for (s32 z = Slab->Min.z; z < Slab->Max.z; ++ z)
+    {
+      for (s32 y = Slab->Min.y; y < Slab->Max.y; ++ y)
+      {
+        for (s32 x = Slab->Min.x; x < Slab->Max.x; ++ x)
+        {
+          world_position P = World_Position(x,y,z);
+          if (GetWorldChunkFromHashtable(World, P) == 0 && ReclaimEvictedChunk(World, P) == 0)
+          {
+            world_chunk *Chunk = GetWorldChunkFor(World->Memory, World, P);
+            if (Chunk)
+            { ScheduleChunkForInit(World, Chunk);  }
+            else
+            { InvalidCodePath(); }
+          }
+        }
+      }
+    }
+  }
+
+  World->ResidentRegion = Region;
+}
+
+link_internal void
+SiftDownPendingInit(pending_chunk_init *Heap, u32 Count, u32 Index)
+{
+  for (;;)
+  {
+    u32 Smallest = Index;
+    u32 Left = (Index*2) + 1;
+    u32 Right = Left + 1;
+
+    if (Left  < Count && Heap[Left].Priority  < Heap[Smallest].Priority) { Smallest = Left; }
+    if (Right < Count && Heap[Right].Priority < Heap[Smallest].Priority) { Smallest = Right; }
+
+    if (Smallest == Index) break;
+
+    pending_chunk_init Tmp = Heap[Index];
+    Heap[Index] = Heap[Smallest];
+    Heap[Smallest] = Tmp;
+
+    Index = Smallest;
+  }
+}
+
+// NOTE(Jesse): Pops the closest chunks off the first PendingCount entries of
+// World->PendingInits, which have to be a heap, into Batch until there are
+// MaxInFlight init jobs going.  Returns how many went in Batch.
+//
+// Chunks still waiting on their record get parked in the slot that frees up
+// at the end of the heap each time we pop, so the stalled ones always sit in
+// one run right after it and stay pending without costing any extra memory.
+link_internal u32
+PopPendingChunkInits(world *World, world_pack *Pack, u32 PendingCount, u32 MaxInFlight, work_queue_entry *Batch)
+{
+  u32 BatchCount = 0;
+  u32 StalledCount = 0;
+
+  while (PendingCount && World->InFlightInitCount < MaxInFlight && StalledCount < WORLD_PACK_STREAM_QUEUE_SIZE)
+  {
+    pending_chunk_init Next = World->PendingInits[0];
+
+    --PendingCount;
+    World->PendingInits[0] = World->PendingInits[PendingCount];
+    SiftDownPendingInit(World->PendingInits, PendingCount, 0);
+
+    if (WorldPackRecordIsReady(Pack, Next.Chunk->WorldP))
+    {
+      World->InFlightInits[World->InFlightInitCount++] = Next.Chunk;
+      Batch[BatchCount++] = InitWorldChunkJob(Next.Chunk);
+
+      // NOTE(Jesse): Close the gap between the heap and the stalled run
+      World->PendingInits[PendingCount] = World->PendingInits[PendingCount + StalledCount];
+    }
+    else
+    {
+      World->PendingInits[PendingCount] = Next;
+      ++StalledCount;
+    }
+  }
+
+  World->PendingInitCount = PendingCount + StalledCount;
+  return BatchCount;
+}
+
+// NOTE(Jesse): Hands the closest pending chunks to the workers, keeping at
+// most WORLD_CHUNK_INIT_JOBS_PER_WORKER per worker in flight.  The work
+// queue is FIFO, so anything pushed to it is stuck in that order; keeping the
+// rest back here lets us re-sort it every frame as the camera moves and
+// drop chunks that were evicted before a worker ever saw them.
+//
+// Chunks with a record in the world pack don't go to a worker until the
+// reader thread has faulted the record in.  They're asked for in the same
+// closest-first order they'd be dispatched in.
+link_internal void
+DispatchChunkInitJobs(world *World, world_pack *Pack, work_queue *Queue, camera *Camera)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  for (u32 InFlightIndex = 0; InFlightIndex < World->InFlightInitCount; )
+  {
+    world_chunk *Chunk = World->InFlightInits[InFlightIndex];
+    if (NotSet(Chunk, Chunk_Queued))
+    {
+      World->InFlightInits[InFlightIndex] = World->InFlightInits[--World->InFlightInitCount];
+    }
+    else
+    {
+      ++InFlightIndex;
+    }
+  }
+
+  if (World->PendingInitCount == 0) { return; }
+
+  v3 CameraP = GetSimSpaceP(World, Camera->CurrentP);
+  v3 ChunkMid = V3(World->ChunkDim)/2.f;
+
+  u32 PendingCount = 0;
+  for (u32 PendingIndex = 0; PendingIndex < World->PendingInitCount; ++PendingIndex)
+  {
+    world_chunk *Chunk = World->PendingInits[PendingIndex].Chunk;
+
+    if (IsSet(Chunk, Chunk_Garbage))
+    {
+      // NOTE(Jesse): Evicted before it got started; it's sitting on
+      // World->EvictedChunks and CollectUnusedChunks frees it now that it's
+      // not queued anymore.
+      UnSetFlag(&Chunk->Flags, Chunk_Queued);
+      continue;
+    }
+
+    r32 Priority = DistanceSq(CameraP, GetSimSpaceP(World, Chunk) + ChunkMid);
+    if (!IsInFrustum(World, Camera, Chunk)) { Priority *= WORLD_CHUNK_INIT_OFFSCREEN_PENALTY; }
+
+    World->PendingInits[PendingCount++] = { .Chunk = Chunk, .Priority = Priority };
+  }
+
+  for (s32 HeapIndex = s32(PendingCount/2)-1; HeapIndex >= 0; --HeapIndex)
+  {
+    SiftDownPendingInit(World->PendingInits, PendingCount, u32(HeapIndex));
+  }
+
+  u32 MaxInFlight = GetWorkerThreadCount() * WORLD_CHUNK_INIT_JOBS_PER_WORKER;
+
+  // NOTE(Jesse): Everything we dispatch this frame goes in the queue in one go
+  work_queue_entry *Batch = Allocate(work_queue_entry, GetTranArena(), MaxInFlight);
+  u32 BatchCount = PopPendingChunkInits(World, Pack, PendingCount, MaxInFlight, Batch);
+
+  PushWorkQueueEntries(Queue, Batch, BatchCount);
+}
+
+// NOTE(Jesse): Asks the reader thread for the world pack records the camera
+// is heading towards, before UpdateWorldResidency gets there.  The velocity is
+// taken in canonical space so the world center moving under the camera doesn't
+// show up as motion, and anything that moved further than we'd read ahead in
+// one frame is treated as a teleport.
+link_internal void
+PredictWorldPackReads(world_pack *Pack, world *World, camera *Camera, r32 dt)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  if (Pack->Base == 0 || dt <= 0.f) { return; }
+
+  world_pack_stream *Stream = &Pack->Stream;
+
+  v3 ChunkDim = V3(World->ChunkDim);
+
+  canonical_position CameraP = Camera->CurrentP;
+  world_position ChunkDelta = CameraP.WorldP - Stream->LastCameraP.WorldP;
+  v3 Delta = (V3(ChunkDelta)*ChunkDim) + (CameraP.Offset - Stream->LastCameraP.Offset);
+  Stream->LastCameraP = CameraP;
+
+  b32 Teleported = Abs(ChunkDelta.x) > WORLD_PACK_READ_AHEAD_MAX_CHUNKS ||
+                   Abs(ChunkDelta.y) > WORLD_PACK_READ_AHEAD_MAX_CHUNKS ||
+                   Abs(ChunkDelta.z) > WORLD_PACK_READ_AHEAD_MAX_CHUNKS;
+  if (Teleported)
+  {
+    Stream->CameraVelocity = {};
+  }
+  else
+  {
+    Stream->CameraVelocity = (Stream->CameraVelocity*0.75f) + ((Delta/dt)*0.25f);
+  }
+
+  v3i MaxAhead = V3i(WORLD_PACK_READ_AHEAD_MAX_CHUNKS);
+  v3i Ahead = V3i((Stream->CameraVelocity*WORLD_PACK_READ_AHEAD_SECONDS) / ChunkDim);
+  Ahead = Max(V3i(-WORLD_PACK_READ_AHEAD_MAX_CHUNKS), Min(Ahead, MaxAhead));
+
+  if (Ahead == V3i(0)) { return; }
+
+  chunk_dimension Radius = World->VisibleRegion/2;
+  world_position PredictedCenter = World->Center + Ahead;
+  rect3i Predicted = Rect3iMinMax(PredictedCenter - Radius, PredictedCenter + Radius);
+
+  rect3i Slabs[6];
+  u32 SlabCount = SubtractRect3i(Predicted, World->ResidentRegion, Slabs);
+  for (u32 SlabIndex = 0; SlabIndex < SlabCount; ++SlabIndex)
+  {
+    rect3i *Slab = Slabs + SlabIndex;
+    for (s32 z = Slab->Min.z; z < Slab->Max.z; ++ z)
+    {
+      for (s32 y = Slab->Min.y; y < Slab->Max.y; ++ y)
+      {
+        for (s32 x = Slab->Min.x; x < Slab->Max.x; ++ x)
+        {
+          world_pack_entry *Entry = GetWorldPackEntry(Pack, World_Position(x,y,z));
+          if (Entry)
+          {
+            RequestWorldPackRecord(Pack, u32(Entry - Pack->Directory));
+          }
+        }
+      }
+    }
+  }
+}
+
+inline void
+QueueChunkForMeshRebuild(work_queue *Queue, world_chunk *Chunk)
+{
+  TIMED_FUNCTION();
+
+  // NOTE(Jesse): This is legal
+  /* Assert( NotSet(Chunk->Flags, Chunk_Queued) ); */
+
+  work_queue_entry Entry = {};
+
+  {
+    Entry.Type = type_work_queue_entry_rebuild_mesh;
+    work_queue_entry_rebuild_mesh *Job = SafeAccess(work_queue_entry_rebuild_mesh, &Entry);
+    Job->Chunk = Chunk;
+  }
+
+  SetFlag(&Chunk->Flags, Chunk_Queued);
+  PushWorkQueueEntry(Queue, &Entry);
+
+  return;
+}
+
+link_internal void
+QueueChunkForWriteBack(work_queue *Queue, world_chunk *Chunk)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  Assert( NotSet(Chunk->Flags, Chunk_Queued) );
+  Assert( IsSet(Chunk->Flags, Chunk_Dirty) );
+
+  work_queue_entry Entry = {};
+
+  {
+    Entry.Type = type_work_queue_entry_write_back_chunk;
+    work_queue_entry_write_back_chunk *Job = SafeAccess(work_queue_entry_write_back_chunk, &Entry);
+    Job->Chunk = Chunk;
+  }
+
+  SetFlag(&Chunk->Flags, Chunk_Queued);
+  PushWorkQueueEntry(Queue, &Entry);
+}
+
+// NOTE(Jesse): Runs on a worker.  Unlike the other chunk jobs this one has to
+// run on garbage chunks; getting their edits out is the whole point.
+link_internal void
+WriteBackWorldChunk(thread_local_state *Thread, world_chunk *Chunk)
+{
+  TIMED_FUNCTION();
+
+  Assert( IsSet(Chunk, Chunk_Queued) );
+  Assert( IsSet(Chunk, Chunk_VoxelsInitialized) );
+
+  // NOTE(Jesse): Cleared before we look at the voxels, so an edit that lands
+  // while we're serializing dirties the chunk again and gets its own write.
+  UnSetFlag(&Chunk->Flags, Chunk_Dirty);
+  FullBarrier;
+
+  umm RecordSize = 0;
+  u8 *Record = SerializeChunk(Chunk, Thread->TempMemory, WorldChunkFileFlag_MeshOmitted, &RecordSize);
+  PutWorldEdit(&Thread->EngineResources->WorldEdits, Chunk->WorldP, Record, u32(RecordSize));
+
+  FullBarrier;
+  UnSetFlag(&Chunk->Flags, Chunk_Queued);
+}
+
+// NOTE(Jesse): The blocks of chunk positions GatherChunksInFrustum tests on
+// the way down, largest first.  Each one has to divide the one before it.
+global_variable s32 Global_FrustumCullBlockDims[] = { 16, 4, 1 };
+
+link_internal s32
+FloorToMultiple(s32 Value, s32 Multiple)
+{
+  s32 Remainder = ((Value % Multiple) + Multiple) % Multiple;
+  s32 Result = Value - Remainder;
+  return Result;
+}
+
+// NOTE(Jesse): Appends every resident chunk in Block that might be in the
+// frustum to Result, and counts into Stats (ChunksVisible is the count).
+// Block is split into Global_FrustumCullBlockDims[Level] sized blocks,
+// aligned in world space; once a block is entirely inside the frustum none of
+// the chunks in it get tested.  Pass Level 0 and the whole region to start.
+link_internal void
+GatherChunksInFrustum( world *World, frustum *Frust, rect3i Block, u32 Level, b32 Inside,
+                       world_chunk **Result, chunk_cull_stats *Stats )
+{
+  b32 IsChunk = (Level == ArrayCount(Global_FrustumCullBlockDims));
+
+  world_chunk *Chunk = 0;
+  if (IsChunk)
+  {
+    Chunk = GetWorldChunkFromHashtable(World, Block.Min);
+    if (Chunk == 0) { return; }
+  }
+
+  if (Inside == False)
+  {
+    aabb BlockAABB = AABBMinMax(GetSimSpaceP(World, Block.Min), GetSimSpaceP(World, Block.Max));
+    frustum_test_result Test = TestFrustum(Frust, &BlockAABB);
+
+    if (IsChunk) { ++Stats->ChunksTested; }
+    else         { ++Stats->BlocksTested; }
+
+    if (Test == FrustumTest_Outside)
+    {
+      if (IsChunk == False) { ++Stats->BlocksCulled; }
+      return;
+    }
+
+    Inside = (Test == FrustumTest_Inside);
+  }
+
+  if (IsChunk)
+  {
+    Result[Stats->ChunksVisible++] = Chunk;
+  }
+  else
+  {
+    s32 Dim = Global_FrustumCullBlockDims[Level];
+    v3i Start = V3i(FloorToMultiple(Block.Min.x, Dim), FloorToMultiple(Block.Min.y, Dim), FloorToMultiple(Block.Min.z, Dim));
+
+    for (s32 z = Start.z; z < Block.Max.z; z += Dim)
+    {
+      for (s32 y = Start.y; y < Block.Max.y; y += Dim)
+      {
+        for (s32 x = Start.x; x < Block.Max.x; x += Dim)
+        {
+          v3i SubMin = V3i(x,y,z);
+          rect3i SubBlock = Rect3iMinMax(Max(SubMin, Block.Min), Min(SubMin + Dim, Block.Max));
+          GatherChunksInFrustum(World, Frust, SubBlock, Level+1, Inside, Result, Stats);
+        }
+      }
+    }
+  }
+}
+
+// NOTE(Jesse): Only chunks that are solid all the way through can occlude
+link_internal b32
+IsOccluder(world_chunk *Chunk)
+{
+  b32 Result = Chunk && IsSet(Chunk, Chunk_VoxelsInitialized) &&
+               Chunk->FilledCount == u32(Volume(Chunk->Dim));
+  return Result;
+}
+
+// NOTE(Jesse): Adds the solid chunks in Chunks to Buffer as occluders.  Runs
+// of them along x go in as one box, owned by the first chunk of the run that
+// could be on screen.  Returns the number of occluders added.
+link_internal u32
+CollectOccluders(occlusion_buffer *Buffer, world *World, frustum *Frust, world_chunk **Chunks, u32 ChunkCount)
+{
+  TIMED_FUNCTION();
+
+  u32 Result = 0;
+
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks[ChunkIndex];
+    if (IsOccluder(Chunk) == False) { continue; }
+
+    world_chunk *Prev = GetWorldChunkFromHashtable(World, Chunk->WorldP - V3i(1,0,0));
+    if (IsOccluder(Prev))
+    {
+      aabb PrevAABB = GetSimSpaceAABB(World, Prev);
+      if (TestFrustum(Frust, &PrevAABB) != FrustumTest_Outside) { continue; }
+    }
+
+    s32 RunLength = 1;
+    while (IsOccluder(GetWorldChunkFromHashtable(World, Chunk->WorldP + V3i(RunLength,0,0)))) { ++RunLength; }
+
+    v3 RunDim = V3(World->ChunkDim) * V3(r32(RunLength), 1.f, 1.f);
+    aabb Run = AABBMinDim(GetSimSpaceP(World, Chunk), RunDim);
+
+    if (AddOccluder(Buffer, &Run))
+    {
+      ++Result;
+    }
+    else
+    {
+      // NOTE(Jesse): Probably reaches past the near plane; the chunks that
+      // don't can still go in on their own
+      for (s32 RunIndex = 0; RunIndex < RunLength; ++RunIndex)
+      {
+        v3 MinP = GetSimSpaceP(World, Chunk->WorldP + V3i(RunIndex,0,0));
+        aabb Single = AABBMinDim(MinP, V3(World->ChunkDim));
+        Result += AddOccluder(Buffer, &Single);
+      }
+    }
+  }
+
+  return Result;
+}
+
+link_internal b32
+IsInsideRegion(rect3i Region, world_position P)
+{
+  b32 Result = P.x >= Region.Min.x && P.x < Region.Max.x &&
+               P.y >= Region.Min.y && P.y < Region.Max.y &&
+               P.z >= Region.Min.z && P.z < Region.Max.z;
+  return Result;
+}
+
+// NOTE(Jesse): The chunk positions a clipmap level covers around Center.  The
+// corner snaps to the next level's node size, so every node of the level
+// above is either entirely inside the region or entirely outside it.
+link_internal rect3i
+GetLodClipmapRegion(world_position Center, s32 Scale)
+{
+  v3i Dim = V3i(LOD_CLIPMAP_DIM_XY, LOD_CLIPMAP_DIM_XY, LOD_CLIPMAP_DIM_Z);
+  v3i Corner = Center - (Dim/2)*Scale;
+
+  s32 ParentScale = Scale*2;
+  v3i Min = V3i(FloorToMultiple(Corner.x, ParentScale), FloorToMultiple(Corner.y, ParentScale), FloorToMultiple(Corner.z, ParentScale));
+
+  rect3i Result = Rect3iMinMax(Min, Min + Dim*Scale);
+  return Result;
+}
+
+// NOTE(Jesse): Nodes are stored toroidally; P has to be a multiple of the
+// level's scale
+link_internal lod_clipmap_node *
+GetLodClipmapSlot(lod_clipmap_level *Level, world_position P)
+{
+  v3i Dim = V3i(LOD_CLIPMAP_DIM_XY, LOD_CLIPMAP_DIM_XY, LOD_CLIPMAP_DIM_Z);
+  v3i NodeP = P/Level->Scale;
+  v3i SlotP = V3i( ((NodeP.x % Dim.x) + Dim.x) % Dim.x,
+                   ((NodeP.y % Dim.y) + Dim.y) % Dim.y,
+                   ((NodeP.z % Dim.z) + Dim.z) % Dim.z );
+
+  lod_clipmap_node *Result = Level->Nodes + GetIndex(SlotP, Dim);
+  return Result;
+}
+
+// NOTE(Jesse): Zero unless the node at P is finished and can be drawn
+link_internal lod_clipmap_node *
+GetLodClipmapNode(lod_clipmap_level *Level, world_position P)
+{
+  lod_clipmap_node *Result = 0;
+
+  if (IsInsideRegion(Level->Region, P))
+  {
+    lod_clipmap_node *Node = GetLodClipmapSlot(Level, P);
+    if ( Node->Chunk.WorldP == P &&
+         IsSet(&Node->Chunk, Chunk_VoxelsInitialized) &&
+         NotSet(&Node->Chunk, Chunk_Queued) &&
+         NotSet(&Node->Chunk, Chunk_Garbage) )
+    {
+      Result = Node;
+    }
+  }
+
+  return Result;
+}
+
+link_internal aabb
+GetLodNodeAABB(world *World, world_position P, s32 Scale)
+{
+  aabb Result = AABBMinDim(GetSimSpaceP(World, P), V3(World->ChunkDim*Scale));
+  return Result;
+}
+
+// NOTE(Jesse): Pixels per voxel, per unit of distance from the eye
+link_internal r32
+GetLodErrorScale(camera *Camera, r32 ScreenHeight)
+{
+  r32 HalfFOV = Rads(Camera->Frust.FOV)/2.f;
+  r32 Result = ScreenHeight / (2.f*Sin(HalfFOV)/Cos(HalfFOV));
+  return Result;
+}
+
+// NOTE(Jesse): How big, in pixels, a voxel of a node Scale world voxels
+// across gets at the closest point of Box to the eye
+link_internal r32
+LodScreenError(aabb *Box, v3 EyeP, s32 Scale, r32 ErrorScale)
+{
+  v3 ToBox = EyeP - Box->Center;
+  v3 Outside = V3( Max(0.f, Abs(ToBox.x) - Box->Radius.x),
+                   Max(0.f, Abs(ToBox.y) - Box->Radius.y),
+                   Max(0.f, Abs(ToBox.z) - Box->Radius.z) );
+
+  r32 Distance = Max(r32(sqrt(r64(LengthSq(Outside)))), 1.f);
+  r32 Result = (r32(Scale)*ErrorScale)/Distance;
+  return Result;
+}
+
+// NOTE(Jesse): Can the node at P on LevelIndex be drawn as its eight
+// children instead?  Below level 0 the children are world chunks.
+link_internal b32
+LodChildrenAreReady(world *World, lod_clipmap *Clipmap, s32 LevelIndex, world_position P)
+{
+  s32 ChildScale = Clipmap->Levels[LevelIndex].Scale/2;
+
+  b32 Result = True;
+  for (s32 ChildIndex = 0; Result && ChildIndex < 8; ++ChildIndex)
+  {
+    v3i ChildP = P + V3i(ChildIndex&1, (ChildIndex>>1)&1, (ChildIndex>>2)&1)*ChildScale;
+    if (LevelIndex == 0)
+    {
+      world_chunk *Chunk = GetWorldChunkFromHashtable(World, ChildP);
+      Result = Chunk && IsSet(Chunk, Chunk_VoxelsInitialized) && NotSet(Chunk, Chunk_Queued);
+    }
+    else
+    {
+      Result = GetLodClipmapNode(Clipmap->Levels + LevelIndex - 1, ChildP) != 0;
+    }
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Picks what to draw for the node at P, and appends it to Result:
+// the node itself, or whatever its children pick if they're ready and the
+// node is too coarse from here.  Level -1 is the world chunks.
+link_internal void
+GatherLodClipmapNode( world *World, lod_clipmap *Clipmap, frustum *Frust, v3 EyeP, r32 ErrorScale,
+                      s32 LevelIndex, world_position P, lod_clipmap_draw_list *Result, chunk_cull_stats *Stats )
+{
+  if (LevelIndex < 0)
+  {
+    world_chunk *Chunk = GetWorldChunkFromHashtable(World, P);
+    if (Chunk == 0) { return; }
+
+    ++Stats->ChunksTested;
+    aabb ChunkAABB = GetSimSpaceAABB(World, Chunk);
+    if (TestFrustum(Frust, &ChunkAABB) != FrustumTest_Outside)
+    {
+      Result->Chunks[Result->ChunkCount++] = Chunk;
+    }
+    return;
+  }
+
+  lod_clipmap_level *Level = Clipmap->Levels + LevelIndex;
+  if (IsInsideRegion(Level->Region, P) == False) { return; }
+
+  aabb NodeAABB = GetLodNodeAABB(World, P, Level->Scale);
+
+  ++Stats->BlocksTested;
+  if (TestFrustum(Frust, &NodeAABB) == FrustumTest_Outside)
+  {
+    ++Stats->BlocksCulled;
+    return;
+  }
+
+  lod_clipmap_node *Node = GetLodClipmapNode(Level, P);
+
+  b32 Refine = (Node == 0);
+  if (Refine == False && LodScreenError(&NodeAABB, EyeP, Level->Scale, ErrorScale) > Clipmap->MaxScreenError)
+  {
+    Refine = LodChildrenAreReady(World, Clipmap, LevelIndex, P);
+  }
+
+  if (Refine)
+  {
+    s32 ChildScale = Level->Scale/2;
+    for (s32 ChildIndex = 0; ChildIndex < 8; ++ChildIndex)
+    {
+      v3i ChildP = P + V3i(ChildIndex&1, (ChildIndex>>1)&1, (ChildIndex>>2)&1)*ChildScale;
+      GatherLodClipmapNode(World, Clipmap, Frust, EyeP, ErrorScale, LevelIndex-1, ChildP, Result, Stats);
+    }
+  }
+  else if (HasMesh(&Node->Chunk.Meshes, MeshBit_Main))
+  {
+    Result->Nodes[Result->NodeCount++] = Node;
+  }
+}
+
+// NOTE(Jesse): Stands in for GatherChunksInFrustum when the world has a
+// clipmap.  Result has to have room for every resident chunk and every node.
+link_internal void
+GatherLodClipmap( world *World, lod_clipmap *Clipmap, frustum *Frust, v3 EyeP, r32 ErrorScale,
+                  lod_clipmap_draw_list *Result, chunk_cull_stats *Stats )
+{
+  TIMED_FUNCTION();
+
+  s32 TopIndex = LOD_CLIPMAP_LEVEL_COUNT-1;
+  lod_clipmap_level *Top = Clipmap->Levels + TopIndex;
+
+  for (s32 z = Top->Region.Min.z; z < Top->Region.Max.z; z += Top->Scale)
+  {
+    for (s32 y = Top->Region.Min.y; y < Top->Region.Max.y; y += Top->Scale)
+    {
+      for (s32 x = Top->Region.Min.x; x < Top->Region.Max.x; x += Top->Scale)
+      {
+        GatherLodClipmapNode(World, Clipmap, Frust, EyeP, ErrorScale, TopIndex, World_Position(x,y,z), Result, Stats);
+      }
+    }
+  }
+
+  Stats->ChunksVisible = Result->ChunkCount;
+  Stats->LodNodesVisible = Result->NodeCount;
+}
+
+link_internal void
+ReleaseLodClipmapNode(lod_clipmap_node *Node, tiered_mesh_freelist *MeshFreelist, memory_arena *Memory)
+{
+  world_chunk *Chunk = &Node->Chunk;
+  Assert ( NotSet(Chunk, Chunk_Queued) );
+
+  DeallocateMeshes(&Chunk->Meshes, MeshFreelist, Memory);
+
+#if PLATFORM_GL_IMPLEMENTATIONS
+  gpu_chunk_buffer *ChunkBuffer = &GetEngineResources()->Graphics->ChunkBuffer;
+  for (u32 MeshIndex = 0; MeshIndex < MeshIndex_Count; ++MeshIndex)
+  {
+    FreeGpuChunkSlab(ChunkBuffer, Chunk->GpuSlabs + MeshIndex);
+  }
+#endif
+  Chunk->Meshes.GpuDirtyMask = 0;
+
+  ClearWorldChunk(Chunk);
+}
+
+link_internal work_queue_entry
+InitLodNodeJob(lod_clipmap *Clipmap, lod_clipmap_node *Node)
+{
+  Assert( IsSet(&Node->Chunk, Chunk_Queued) );
+
+  work_queue_entry_init_lod_node Job = { .Clipmap = Clipmap, .Node = Node };
+  work_queue_entry Result = WorkQueueEntry(Job);
+  return Result;
+}
+
+// NOTE(Jesse): Moves the clipmap levels with the world center, and queues
+// every node that isn't built for where it is now.  Nodes that moved while
+// their job was in flight get marked garbage and are rebuilt once the job
+// lets go of them.  Coarse levels go first, since they cover the most ground.
+link_internal void
+UpdateLodClipmap(world *World, tiered_mesh_freelist *MeshFreelist, work_queue *Queue)
+{
+  TIMED_FUNCTION();
+  Assert ( ThreadLocal_ThreadIndex == 0 );
+
+  lod_clipmap *Clipmap = World->Clipmap;
+
+  u32 NodeCount = LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_Z;
+
+  u32 InFlightCount = 0;
+  for (u32 LevelIndex = 0; LevelIndex < LOD_CLIPMAP_LEVEL_COUNT; ++LevelIndex)
+  {
+    lod_clipmap_level *Level = Clipmap->Levels + LevelIndex;
+    for (u32 NodeIndex = 0; NodeIndex < NodeCount; ++NodeIndex)
+    {
+      InFlightCount += IsSet(&Level->Nodes[NodeIndex].Chunk, Chunk_Queued) ? 1 : 0;
+    }
+  }
+
+  u32 BatchCount = 0;
+  work_queue_entry *Batch = Allocate(work_queue_entry, GetTranArena(), LOD_CLIPMAP_MAX_IN_FLIGHT);
+
+  for (s32 LevelIndex = LOD_CLIPMAP_LEVEL_COUNT-1; LevelIndex >= 0; --LevelIndex)
+  {
+    lod_clipmap_level *Level = Clipmap->Levels + LevelIndex;
+    Level->Region = GetLodClipmapRegion(World->Center, Level->Scale);
+
+    for (s32 z = Level->Region.Min.z; z < Level->Region.Max.z; z += Level->Scale)
+    {
+      for (s32 y = Level->Region.Min.y; y < Level->Region.Max.y; y += Level->Scale)
+      {
+        for (s32 x = Level->Region.Min.x; x < Level->Region.Max.x; x += Level->Scale)
+        {
+          world_position P = World_Position(x,y,z);
+          lod_clipmap_node *Node = GetLodClipmapSlot(Level, P);
+          world_chunk *Chunk = &Node->Chunk;
+
+          b32 Current = (Chunk->WorldP == P) && NotSet(Chunk, Chunk_Garbage);
+
+          if (IsSet(Chunk, Chunk_Queued))
+          {
+            if (Current == False) { SetFlag(Chunk, Chunk_Garbage); }
+            continue;
+          }
+
+          if (Current && IsSet(Chunk, Chunk_VoxelsInitialized)) { continue; }
+
+          if (InFlightCount < LOD_CLIPMAP_MAX_IN_FLIGHT)
+          {
+            ReleaseLodClipmapNode(Node, MeshFreelist, World->Memory);
+
+            Chunk->WorldP = P;
+            SetFlag(Chunk, Chunk_Queued);
+
+            Batch[BatchCount++] = InitLodNodeJob(Clipmap, Node);
+            ++InFlightCount;
+          }
+        }
+      }
+    }
+  }
+
+  PushWorkQueueEntries(Queue, Batch, BatchCount);
+}
+
+// NOTE(Jesse): Noise has to be the noise the game initializes world chunks
+// with, or the clipmap won't line up with them.
+link_internal void
+EnableLodClipmap(world *World, lod_clipmap_noise Noise)
+{
+  CAssert(LOD_CLIPMAP_DIM_XY % 2 == 0);
+  CAssert(LOD_CLIPMAP_DIM_Z % 2 == 0);
+
+  Assert(World->VisibleRegion.x <= (LOD_CLIPMAP_DIM_XY-4)*2);
+  Assert(World->VisibleRegion.y <= (LOD_CLIPMAP_DIM_XY-4)*2);
+  Assert(World->VisibleRegion.z <= (LOD_CLIPMAP_DIM_Z-4)*2);
+
+  lod_clipmap *Clipmap = Allocate(lod_clipmap, World->Memory, 1);
+  Clipmap->Noise = Noise;
+  Clipmap->MaxScreenError = LOD_CLIPMAP_MAX_SCREEN_ERROR;
+
+  u32 NodeCount = LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_Z;
+  for (s32 LevelIndex = 0; LevelIndex < LOD_CLIPMAP_LEVEL_COUNT; ++LevelIndex)
+  {
+    lod_clipmap_level *Level = Clipmap->Levels + LevelIndex;
+    Level->Scale = 2 << LevelIndex;
+    Level->Nodes = AllocateAlignedProtection(lod_clipmap_node, World->Memory, NodeCount, CACHE_LINE_SIZE, False);
+
+    for (u32 NodeIndex = 0; NodeIndex < NodeCount; ++NodeIndex)
+    {
+      lod_clipmap_node *Node = Level->Nodes + NodeIndex;
+      Node->Scale = Level->Scale;
+      Node->Chunk.Dim = World->ChunkDim;
+    }
+  }
+
+  World->Clipmap = Clipmap;
+}
+
+link_internal u32
+RaycastNextAxis(v3 tNext)
+{
+  u32 Result = (tNext.x < tNext.y) ? (tNext.x < tNext.z ? 0 : 2)
+                                   : (tNext.y < tNext.z ? 1 : 2);
+  return Result;
+}
+
+// NOTE(Jesse): The voxel half of RaycastVoxels.  Walks Chunk from where the
+// ray enters it at tEnter until it leaves at tExit.  Positions are relative to
+// the ray origin's chunk, and ChunkOrigin is where Chunk starts.
+link_internal b32
+RaycastChunk( world_chunk *Chunk, v3 ChunkOrigin, v3 P0, v3 Dir, v3 InvDir, v3i Step,
+              r32 tEnter, r32 tExit, picked_voxel *Result )
+{
+  chunk_dimension Dim = Chunk->Dim;
+
+  // NOTE(Jesse): Clamped in case the entry point rounded off the face we came
+  // through
+  v3 EntryP = P0 + (Dir*tEnter) - ChunkOrigin;
+  v3i VoxelP = V3i( Min(Dim.x-1, Max(0, s32(Floor(EntryP.x)))),
+                    Min(Dim.y-1, Max(0, s32(Floor(EntryP.y)))),
+                    Min(Dim.z-1, Max(0, s32(Floor(EntryP.z)))) );
+
+  b32 Hit = False;
+  r32 tVoxel = tEnter;
+
+  if (Chunk->Voxels == 0)
+  {
+    Hit = IsSet(&Chunk->UniformVoxel, Voxel_Filled);
+  }
+  else
+  {
+    v3 tNext = {};
+    v3 tDelta = {};
+    for (u32 Axis = 0; Axis < 3; ++Axis)
+    {
+      if (Step.E[Axis] == 0)
+      {
+        tNext.E[Axis] = f32_MAX;
+      }
+      else
+      {
+        r32 Boundary = ChunkOrigin.E[Axis] + r32(VoxelP.E[Axis] + (Step.E[Axis] > 0 ? 1 : 0));
+        tNext.E[Axis] = (Boundary - P0.E[Axis])*InvDir.E[Axis];
+        tDelta.E[Axis] = Abs(InvDir.E[Axis]);
+      }
+    }
+
+    s32 Stride[3] = { Step.x, Step.y*Dim.x, Step.z*Dim.x*Dim.y };
+    s32 VoxelIndex = GetIndex(VoxelP, Dim);
+
+    for (;;)
+    {
+      if (Chunk->Voxels[VoxelIndex].Flags & Voxel_Filled) { Hit = True; break; }
+
+      u32 Axis = RaycastNextAxis(tNext);
+      tVoxel = tNext.E[Axis];
+      if (tVoxel >= tExit) { break; }
+
+      VoxelP.E[Axis] += Step.E[Axis];
+      if (VoxelP.E[Axis] < 0 || VoxelP.E[Axis] >= Dim.E[Axis]) { break; }
+
+      VoxelIndex += Stride[Axis];
+      tNext.E[Axis] += tDelta.E[Axis];
+    }
+  }
+
+  if (Hit)
+  {
+    Result->PickedChunk.Chunk = Chunk;
+    Result->PickedChunk.tChunk = tVoxel;
+    Result->VoxelRelP = V3(VoxelP) + V3(0.5f);
+  }
+
+  return Hit;
+}
+
+// NOTE(Jesse): Returns the first filled voxel the ray passes through, or one
+// with tChunk == f32_MAX if it doesn't hit one before MaxT.  Amanatides & Woo
+// 3D DDA, twice over: once across the chunks, skipping the empty and missing
+// ones, and once across the voxels of each chunk that could be hit.  Every
+// voxel the ray touches is visited, in order.
+//
+// Everything is done relative to the origin's chunk so rays far from the
+// world origin don't lose precision.  Only resident chunks can be hit.
+link_internal picked_voxel
+RaycastVoxels(world *World, canonical_position Origin, v3 Dir, r32 MaxT)
+{
+  picked_voxel Result = { .PickedChunk.tChunk = f32_MAX };
+
+  if (LengthSq(Dir) == 0.f) { return Result; }
+
+  chunk_dimension ChunkDim = World->ChunkDim;
+
+  Origin = Canonicalize(World, Origin);
+  v3 P0 = Origin.Offset;
+
+  rect3i Region = World->ResidentRegion;
+  v3i RegionMin = Region.Min - Origin.WorldP;
+  v3i RegionMax = Region.Max - Origin.WorldP;
+
+  v3i Step = {};
+  v3 InvDir = {};
+
+  // NOTE(Jesse): Clip the ray to the resident region
+  r32 tStart = 0.f;
+  r32 tEnd = MaxT;
+  for (u32 Axis = 0; Axis < 3; ++Axis)
+  {
+    r32 MinP = r32(RegionMin.E[Axis]*ChunkDim.E[Axis]);
+    r32 MaxP = r32(RegionMax.E[Axis]*ChunkDim.E[Axis]);
+
+    if (Dir.E[Axis] == 0.f)
+    {
+      if (P0.E[Axis] < MinP || P0.E[Axis] >= MaxP) { return Result; }
+    }
+    else
+    {
+      Step.E[Axis] = Dir.E[Axis] > 0.f ? 1 : -1;
+      InvDir.E[Axis] = 1.f/Dir.E[Axis];
+
+      r32 t0 = (MinP - P0.E[Axis])*InvDir.E[Axis];
+      r32 t1 = (MaxP - P0.E[Axis])*InvDir.E[Axis];
+      tStart = Max(tStart, Min(t0, t1));
+      tEnd   = Min(tEnd,   Max(t0, t1));
+    }
+  }
+
+  if (tStart >= tEnd) { return Result; }
+
+  v3 StartP = P0 + (Dir*tStart);
+  v3i ChunkP = {};
+  for (u32 Axis = 0; Axis < 3; ++Axis)
+  {
+    s32 Cell = s32(Floor(StartP.E[Axis]/r32(ChunkDim.E[Axis])));
+    ChunkP.E[Axis] = Min(RegionMax.E[Axis]-1, Max(RegionMin.E[Axis], Cell));
+  }
+
+  v3 tNext = {};
+  v3 tDelta = {};
+  for (u32 Axis = 0; Axis < 3; ++Axis)
+  {
+    if (Step.E[Axis] == 0)
+    {
+      tNext.E[Axis] = f32_MAX;
+    }
+    else
+    {
+      r32 Boundary = r32((ChunkP.E[Axis] + (Step.E[Axis] > 0 ? 1 : 0))*ChunkDim.E[Axis]);
+      tNext.E[Axis] = (Boundary - P0.E[Axis])*InvDir.E[Axis];
+      tDelta.E[Axis] = r32(ChunkDim.E[Axis])*Abs(InvDir.E[Axis]);
+    }
+  }
+
+  r32 tEnter = tStart;
+  for (;;)
+  {
+    u32 Axis = RaycastNextAxis(tNext);
+    r32 tExit = Min(tNext.E[Axis], tEnd);
+
+    world_chunk *Chunk = GetWorldChunkFromHashtable(World, Origin.WorldP + ChunkP);
+    if (Chunk && IsSet(Chunk, Chunk_VoxelsInitialized) && Chunk->FilledCount)
+    {
+      v3 ChunkOrigin = V3(ChunkP*ChunkDim);
+      if (RaycastChunk(Chunk, ChunkOrigin, P0, Dir, InvDir, Step, tEnter, tExit, &Result)) { break; }
+    }
+
+    if (tExit >= tEnd) { break; }
+
+    ChunkP.E[Axis] += Step.E[Axis];
+    if (ChunkP.E[Axis] < RegionMin.E[Axis] || ChunkP.E[Axis] >= RegionMax.E[Axis]) { break; }
+
+    tEnter = tExit;
+    tNext.E[Axis] += tDelta.E[Axis];
+  }
+
+  return Result;
+}
+
+link_internal void
+RaycastBatch(world *World, voxel_raycast *Rays, picked_voxel *Hits, u32 Count)
+{
+  TIMED_FUNCTION();
+
+  for (u32 RayIndex = 0; RayIndex < Count; ++RayIndex)
+  {
+    voxel_raycast *Ray = Rays + RayIndex;
+    Hits[RayIndex] = RaycastVoxels(World, Ray->Origin, Ray->Dir, Ray->MaxT);
+  }
+}
+
+// NOTE(Jesse): Casts Count rays, RAYCAST_BATCH_SIZE to a job, and waits for
+// them to finish.  We do the first batch ourselves and then help with the
+// rest.  The world can't change while the rays are out, so this is for the
+// main thread; with no Queue everything is cast right here.
+link_internal void
+RaycastMany(world *World, voxel_raycast *Rays, picked_voxel *Hits, u32 Count, work_queue *Queue, memory_arena *JobMemory)
+{
+  TIMED_FUNCTION();
+
+  if (Queue == 0 || Count <= RAYCAST_BATCH_SIZE)
+  {
+    RaycastBatch(World, Rays, Hits, Count);
+    return;
+  }
+
+  // NOTE(Jesse): Lives in JobMemory so it outlives the jobs
+  work_counter *Batches = Allocate(work_counter, JobMemory, 1);
+  InitWorkCounter(Batches, 1);
+
+  for (u32 FirstRay = RAYCAST_BATCH_SIZE; FirstRay < Count; FirstRay += RAYCAST_BATCH_SIZE)
+  {
+    work_queue_entry_raycast_batch Job = { .World = World,
+                                           .Rays = Rays + FirstRay,
+                                           .Hits = Hits + FirstRay,
+                                           .Count = Min(u32(RAYCAST_BATCH_SIZE), Count - FirstRay) };
+    work_queue_entry Entry = WorkQueueEntry(Job);
+    PushCountedWorkQueueEntry(Queue, &Entry, Batches, JobMemory);
+  }
+
+  RaycastBatch(World, Rays, Hits, RAYCAST_BATCH_SIZE);
+  SignalWorkCounter(Batches);
+
+  WaitForWorkCounterOnMainThread(Batches, Queue);
+}
+
+#if PLATFORM_GL_IMPLEMENTATIONS
+link_internal work_queue_entry_rebuild_mesh
+WorkQueueEntryRebuildMesh(world_chunk *Chunk)
+{
+  work_queue_entry_rebuild_mesh Result = { .Chunk = Chunk };
+  return Result;
+}
+
+link_internal work_queue_entry_update_world_region
+WorkQueueEntryUpdateWorldRegion(world_update_operation Op, u8 ColorIndex, picked_voxel *Location, f32 Radius, canonical_position MinP, canonical_position MaxP, world_chunk** ChunkBuffer, u32 ChunkCount)
+{
+  work_queue_entry_update_world_region Result =
+  {
+    .Op = Op,
+    .ColorIndex = ColorIndex,
+    .Location = *Location,
+    .Radius = Radius,
+    .ChunkBuffer = ChunkBuffer,
+    .ChunkCount = ChunkCount,
+    .MinP = MinP,
+    .MaxP = MaxP
+  };
+  return Result;
+}
+
+link_internal work_queue_entry_copy_buffer_ref
+WorkQueueEntryCopyBufferRef(threadsafe_geometry_buffer *Buf, world_chunk_mesh_bitfield MeshBit, untextured_3d_geometry_buffer* Dest, world_position ChunkP, camera* Camera, chunk_dimension WorldChunkDim)
+{
+  work_queue_entry_copy_buffer_ref Result = {};
+
+  Result.Buf = Buf;
+  Result.MeshBit = MeshBit;
+  Result.Dest = Dest;
+  Result.Basis = GetRenderP(WorldChunkDim, ChunkP, Camera);
+
+  return Result;
+}
+
+link_internal work_queue_entry_copy_buffer
 WorkQueueEntryCopyBuffer(untextured_3d_geometry_buffer **Src, untextured_3d_geometry_buffer* Dest, world_position ChunkP, camera* Camera, chunk_dimension WorldChunkDim)
 {
   TIMED_FUNCTION();
@@ -3184,6 +5407,32 @@ QueueChunkMeshForCopy(work_queue *Queue, untextured_3d_geometry_buffer **Src, un
   return;
 }
 
+// NOTE(Jesse): Uploads the mesh if it's been replaced since we last saw it.
+// This is the only place chunk geometry gets copied to the card; after that
+// the slab is drawn in place every frame.
+link_internal gpu_chunk_slab *
+SyncChunkMeshToGpu(gpu_chunk_buffer *ChunkBuffer, world_chunk *Chunk, world_chunk_mesh_bitfield MeshBit)
+{
+  threadsafe_geometry_buffer *Meshes = &Chunk->Meshes;
+  gpu_chunk_slab *Slab = Chunk->GpuSlabs + ToIndex(MeshBit);
+
+  if (Meshes->GpuDirtyMask & MeshBit)
+  {
+    untextured_3d_geometry_buffer *Mesh = TakeOwnershipSync(Meshes, MeshBit);
+
+    // NOTE(Jesse): If it didn't fit we leave it dirty and try again next
+    // frame; the old mesh keeps drawing in the meantime
+    if (UploadChunkMeshToGpu(ChunkBuffer, Slab, (packed_chunk_mesh*)Meshes->Packed[ToIndex(MeshBit)]))
+    {
+      UnSetGpuDirtyBit(Meshes, MeshBit);
+    }
+
+    ReleaseOwnership(Meshes, MeshBit, Mesh);
+  }
+
+  return Slab;
+}
+
 link_internal void
 BufferWorld( platform* Plat,
              untextured_3d_geometry_buffer* Dest,
@@ -3195,175 +5444,230 @@ BufferWorld( platform* Plat,
 
   work_queue_entry_copy_buffer_set CopySet = {};
 
-  v3i Radius = World->VisibleRegion/2;
-  v3i Min = World->Center - Radius;
-  v3i Max = World->Center + Radius;
+  camera *Camera = Graphics->Camera;
 
-  // NOTE(Jesse): Debug
-  /* Assert(Min == V3i(0)); */
-  /* Assert(Max == V3i(4)); */
+  // NOTE(Jesse): UpdateWorldResidency keeps the resident region in sync with
+  // the visible region, so every chunk we could draw is in there
+  chunk_cull_stats *Stats = &Graphics->ChunkCullStats;
+  *Stats = {};
 
-  for (s32 z = Min.z; z < Max.z; ++ z)
+  world_chunk **VisibleChunks = Allocate(world_chunk*, GetTranArena(), World->ChunkCount);
+
+  lod_clipmap_draw_list LodDrawList = {};
+  if (World->Clipmap)
   {
-    for (s32 y = Min.y; y < Max.y; ++ y)
-    {
-      for (s32 x = Min.x; x < Max.x; ++ x)
-      {
-        world_position P = World_Position(x,y,z);
-        world_chunk *Chunk = 0;
-        {
-          TIMED_NAMED_BLOCK("GetWorldChunk");
-          Chunk = GetWorldChunkFromHashtable( World, P );
-        }
+    LodDrawList.Chunks = VisibleChunks;
+    LodDrawList.Nodes = Allocate(lod_clipmap_node*, GetTranArena(), LOD_CLIPMAP_LEVEL_COUNT*LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_Z);
 
-#if 0
-        u32 ColorIndex = 0;
+    r32 ErrorScale = GetLodErrorScale(Camera, r32(Plat->WindowHeight));
+    GatherLodClipmap(World, World->Clipmap, &Camera->Frust, GetSimSpaceP(World, Camera->CurrentP), ErrorScale, &LodDrawList, Stats);
+  }
+  else
+  {
+    GatherChunksInFrustum(World, &Camera->Frust, World->ResidentRegion, 0, False, VisibleChunks, Stats);
+  }
 
-        if (Chunk)
-        {
-          if (Chunk->Flags == Chunk_Uninitialized)
-          {
-            ColorIndex = TEAL;
-          }
+  Assert(Stats->ChunksVisible <= World->ChunkCount);
+  Stats->ChunksCulled = World->ChunkCount - Stats->ChunksVisible;
 
-          if (IsSet(Chunk, Chunk_Queued))
-          {
-            ColorIndex = BLUE;
-          }
+  occlusion_buffer *Occlusion = Graphics->Occlusion;
+  BeginOcclusionBuffer(Occlusion, GetSimSpaceP(World, Camera->CurrentP), Camera->Front);
+  Stats->Occluders = CollectOccluders(Occlusion, World, &Camera->Frust, VisibleChunks, Stats->ChunksVisible);
+  RasterizeOcclusionBuffer(Occlusion, &Plat->HighPriority, GetEngineResources()->FrameJobMemory);
 
-          if (IsSet(Chunk, Chunk_VoxelsInitialized))
-          {
-            /* ColorIndex = GREEN; */
-          }
+  for (u32 ChunkIndex = 0; ChunkIndex < Stats->ChunksVisible; ++ChunkIndex)
+  {
+    world_chunk *Chunk = VisibleChunks[ChunkIndex];
 
-          if (IsSet(Chunk, Chunk_MeshComplete))
-          {
-            /* ColorIndex = GREEN; */
-          }
+#if 0
+    u32 ColorIndex = 0;
 
-          if (IsSet(Chunk, Chunk_Garbage))
-          {
-            ColorIndex = ORANGE;
-          }
+    if (Chunk->Flags == Chunk_Uninitialized)
+    {
+      ColorIndex = TEAL;
+    }
 
-        }
-        else
-        {
-          ColorIndex = RED;
-        }
+    if (IsSet(Chunk, Chunk_Queued))
+    {
+      ColorIndex = BLUE;
+    }
 
-        if (ColorIndex)
-        {
-          untextured_3d_geometry_buffer AABBDest = ReserveBufferSpace(Dest, VERTS_PER_AABB);
-          v3 MinP = GetRenderP(World->ChunkDim, Canonical_Position(V3(0,0,0), P), Graphics->Camera);
-          v3 MaxP = GetRenderP(World->ChunkDim, Canonical_Position(World->ChunkDim, P), Graphics->Camera);
-          DEBUG_DrawAABB(&AABBDest, MinP, MaxP, ColorIndex, 0.5f);
-          /* PushCopyJob(work_queue *Queue, work_queue_entry_copy_buffer_set *Set, work_queue_entry_copy_buffer *Job) */
-        }
+    if (IsSet(Chunk, Chunk_VoxelsInitialized))
+    {
+      /* ColorIndex = GREEN; */
+    }
+
+    if (IsSet(Chunk, Chunk_MeshComplete))
+    {
+      /* ColorIndex = GREEN; */
+    }
+
+    if (IsSet(Chunk, Chunk_Garbage))
+    {
+      ColorIndex = ORANGE;
+    }
+
+    if (ColorIndex)
+    {
+      untextured_3d_geometry_buffer AABBDest = ReserveBufferSpace(Dest, VERTS_PER_AABB);
+      v3 MinP = GetRenderP(World->ChunkDim, Canonical_Position(V3(0,0,0), Chunk->WorldP), Graphics->Camera);
+      v3 MaxP = GetRenderP(World->ChunkDim, Canonical_Position(World->ChunkDim, Chunk->WorldP), Graphics->Camera);
+      DEBUG_DrawAABB(&AABBDest, MinP, MaxP, ColorIndex, 0.5f);
+    }
 #endif
 
+    {
+      v3 CameraP = GetSimSpaceP(World, Camera->CurrentP);
+      v3 ChunkP = GetSimSpaceP(World, Chunk->WorldP);
 
-        camera *Camera = Graphics->Camera;
+      auto MeshBit = MeshBit_None;
+      if (HasMesh(&Chunk->Meshes, MeshBit_Main))
+      {
+        MeshBit = MeshBit_Main;
+      }
 
+      // NOTE(Jesse): The clipmap takes care of the distance
+      if (World->Clipmap == 0 && HasMesh(&Chunk->Meshes, MeshBit_Lod) && DistanceSq(CameraP, ChunkP) > Square(25*32))
+      {
+        MeshBit = MeshBit_Lod;
+      }
 
-        if (Chunk)
+      if (MeshBit != MeshBit_None)
+      {
+        aabb ChunkAABB = GetSimSpaceAABB(World, Chunk);
+        if (IsOccluded(Occlusion, &ChunkAABB))
         {
-          if (IsInFrustum(World, Camera, Chunk))
-          {
-            v3 CameraP = GetSimSpaceP(World, Camera->CurrentP);
-            v3 ChunkP = GetSimSpaceP(World, Chunk->WorldP);
-
-            auto MeshBit = MeshBit_None;
-            if (HasMesh(&Chunk->Meshes, MeshBit_Main))
-            {
-              MeshBit = MeshBit_Main;
-            }
+          ++Stats->ChunksOccluded;
+          Stats->VertsOccluded += Chunk->GpuSlabs[ToIndex(MeshBit)].UsedCount;
+          continue;
+        }
 
-            if (HasMesh(&Chunk->Meshes, MeshBit_Lod) && DistanceSq(CameraP, ChunkP) > Square(25*32))
-            {
-              MeshBit = MeshBit_Lod;
-            }
+        gpu_chunk_slab *Slab = SyncChunkMeshToGpu(&Graphics->ChunkBuffer, Chunk, MeshBit);
+        v3 Basis = GetRenderP(World->ChunkDim, Chunk->WorldP, Camera);
+        PushGpuChunkDrawCommand(&Graphics->ChunkBuffer, Slab, Basis);
 
-            if (MeshBit != MeshBit_None)
-            {
-              auto CopyJob = WorkQueueEntryCopyBufferRef(&Chunk->Meshes, MeshBit, Dest, Chunk->WorldP, Graphics->Camera, World->ChunkDim);
-              auto Entry = WorkQueueEntry(&CopyJob);
-              PushWorkQueueEntry(&Plat->HighPriority, &Entry);
-            }
+        Stats->VertsDrawn += Slab->UsedCount;
+      }
 
-            /* if (Chunk->SelectedMeshes & MeshIndex_Main) */
-            {
-              Assert(Dest->End);
-              /* untextured_3d_geometry_buffer *Mesh = (untextured_3d_geometry_buffer *)TakeOwnershipSync((volatile void**)&Chunk->Mesh); */
-              /* untextured_3d_geometry_buffer *Mesh = GetMeshFor(&Chunk->Meshes, MeshBit_Main); */
-              /* u32 Count = Mesh->At; */
-              /* ReplaceMesh(Chunk, MeshBit_Main, Mesh); */
-              /* Replace((volatile void**)&Chunk->Mesh, (void*)Mesh); */
-
-              /* if (Chunk->Meshes.MeshMask & MeshBit_Main) */
+      /* if (Chunk->SelectedMeshes & MeshIndex_Main) */
+      {
+        Assert(Dest->End);
+        /* untextured_3d_geometry_buffer *Mesh = (untextured_3d_geometry_buffer *)TakeOwnershipSync((volatile void**)&Chunk->Mesh); */
+        /* untextured_3d_geometry_buffer *Mesh = GetMeshFor(&Chunk->Meshes, MeshBit_Main); */
+        /* u32 Count = Mesh->At; */
+        /* ReplaceMesh(Chunk, MeshBit_Main, Mesh); */
+        /* Replace((volatile void**)&Chunk->Mesh, (void*)Mesh); */
+
+        /* if (Chunk->Meshes.MeshMask & MeshBit_Main) */
 #if 0
-              if (Count < Kilobytes(16))
-              {
-                PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
-              }
-              else
-              {
-                auto Entry = WorkQueueEntry(&CopyJob);
-                PushWorkQueueEntry(&Plat->HighPriority, &Entry);
-              }
+        if (Count < Kilobytes(16))
+        {
+          PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
+        }
+        else
+        {
+          auto Entry = WorkQueueEntry(&CopyJob);
+          PushWorkQueueEntry(&Plat->HighPriority, &Entry);
+        }
 #endif
-            }
+      }
 
 #if 0
-            if (Chunk->SelectedMeshes & MeshIndex_Lod)
-            {
-              work_queue_entry_copy_buffer CopyJob = WorkQueueEntryCopyBuffer(&Chunk->LodMesh, Dest, Chunk->WorldP, Graphics->Camera, World->ChunkDim);
-              PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
-            }
+      if (Chunk->SelectedMeshes & MeshIndex_Lod)
+      {
+        work_queue_entry_copy_buffer CopyJob = WorkQueueEntryCopyBuffer(&Chunk->LodMesh, Dest, Chunk->WorldP, Graphics->Camera, World->ChunkDim);
+        PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
+      }
 
-            if (Chunk->SelectedMeshes & MeshIndex_Debug)
-            {
-              work_queue_entry_copy_buffer CopyJob = WorkQueueEntryCopyBuffer(&Chunk->DebugMesh, Dest, Chunk->WorldP, Graphics->Camera, World->ChunkDim);
-              PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
-            }
+      if (Chunk->SelectedMeshes & MeshIndex_Debug)
+      {
+        work_queue_entry_copy_buffer CopyJob = WorkQueueEntryCopyBuffer(&Chunk->DebugMesh, Dest, Chunk->WorldP, Graphics->Camera, World->ChunkDim);
+        PushCopyJob(&Plat->HighPriority, &CopySet, &CopyJob);
+      }
 #endif
 
 #if 1
-            umm StandingSpotCount = AtElements(&Chunk->StandingSpots);
-            /* DebugLine("drawing (%u) standing spots", StandingSpotCount); */
-            for (u32 SpotIndex = 0; SpotIndex < StandingSpotCount; ++SpotIndex)
-            {
-              v3i *Spot = Chunk->StandingSpots.Start + SpotIndex;
-              v3 RenderSpot = GetRenderP(World->ChunkDim, Canonical_Position(*Spot, Chunk->WorldP), Graphics->Camera);
-              DrawStandingSpot(Dest, RenderSpot, V3(Global_StandingSpotDim));
-            }
+      umm StandingSpotCount = AtElements(&Chunk->StandingSpots);
+      /* DebugLine("drawing (%u) standing spots", StandingSpotCount); */
+      for (u32 SpotIndex = 0; SpotIndex < StandingSpotCount; ++SpotIndex)
+      {
+        v3i *Spot = Chunk->StandingSpots.Start + SpotIndex;
+        v3 RenderSpot = GetRenderP(World->ChunkDim, Canonical_Position(*Spot, Chunk->WorldP), Graphics->Camera);
+        DrawStandingSpot(Dest, RenderSpot, V3(Global_StandingSpotDim));
+      }
 #endif
 
-          }
-        }
-        else
-        {
-          Chunk = GetWorldChunkFor(World->Memory, World, P);
-          if (Chunk)
-          { QueueChunkForInit(&Plat->LowPriority, Chunk);  }
-          else
-          { InvalidCodePath(); }
-        }
-      }
     }
   }
 
-  if (CopySet.Count > 0)
+  for (u32 NodeIndex = 0; NodeIndex < LodDrawList.NodeCount; ++NodeIndex)
+  {
+    lod_clipmap_node *Node = LodDrawList.Nodes[NodeIndex];
+    world_chunk *Chunk = &Node->Chunk;
+
+    aabb NodeAABB = GetLodNodeAABB(World, Chunk->WorldP, Node->Scale);
+    if (IsOccluded(Occlusion, &NodeAABB))
+    {
+      ++Stats->LodNodesOccluded;
+      Stats->VertsOccluded += Chunk->GpuSlabs[ToIndex(MeshBit_Main)].UsedCount;
+      continue;
+    }
+
+    gpu_chunk_slab *Slab = SyncChunkMeshToGpu(&Graphics->ChunkBuffer, Chunk, MeshBit_Main);
+    v3 Basis = GetRenderP(World->ChunkDim, Chunk->WorldP, Camera);
+    PushGpuChunkDrawCommand(&Graphics->ChunkBuffer, Slab, Basis);
+
+    Stats->VertsDrawn += Slab->UsedCount;
+  }
+
+  if (CopySet.Count > 0)
+  {
+    engine_resources *Engine = GetEngineResources();
+    work_queue_entry Entry = WorkQueueEntry(&CopySet);
+    PushCountedWorkQueueEntry(&Plat->HighPriority, &Entry, &Engine->FrameJobs, Engine->FrameJobMemory);
+  }
+
+  return;
+}
+
+// NOTE(Jesse): Hands out a block that's done with, or allocates one out of
+// Memory if none are big enough.  Blocks stay on the world forever, so there
+// are only ever as many as there have been edits in flight at once.
+link_internal world_update_block *
+GetWorldUpdateBlock(world *World, u32 ChunkCount, memory_arena *Memory)
+{
+  Assert(ThreadLocal_ThreadIndex == 0);
+
+  world_update_block *Result = 0;
+  for (world_update_block *Block = World->UpdateBlocks; Block; Block = Block->Next)
+  {
+    if (WorkCounterIsDone(&Block->Finished) && Block->ChunkCapacity >= ChunkCount)
+    {
+      Result = Block;
+      break;
+    }
+  }
+
+  if (Result == 0)
   {
-    work_queue_entry Entry = WorkQueueEntry(&CopySet);
-    PushWorkQueueEntry(&Plat->HighPriority, &Entry);
+    Result = AllocateAligned(world_update_block, Memory, 1, CACHE_LINE_SIZE);
+    Result->ChunkCapacity = Max(ChunkCount, 1u);
+    Result->ChunkBuffer = AllocateAligned(world_chunk*, Memory, Result->ChunkCapacity, CACHE_LINE_SIZE);
+    Result->MeshRebuildJobs = Allocate(work_job, Memory, Result->ChunkCapacity);
+
+    Result->Next = World->UpdateBlocks;
+    World->UpdateBlocks = Result;
   }
 
-  return;
+  InitWorkCounter(&Result->Finished, 1);
+  return Result;
 }
 
+// NOTE(Jesse): If Done is passed it's signaled once the voxels are changed
+// and every touched chunk has its new mesh.  It has to be initialized, and
+// counting this update, before calling.
 link_internal void
-QueueWorldUpdateForRegion(platform *Plat, world *World, picked_voxel *Location, world_update_operation Op, u8 ColorIndex, f32 Radius, memory_arena *Memory)
+QueueWorldUpdateForRegion(platform *Plat, world *World, picked_voxel *Location, world_update_operation Op, u8 ColorIndex, f32 Radius, memory_arena *Memory, work_counter *Done = 0)
 {
   TIMED_FUNCTION();
 
@@ -3398,8 +5702,8 @@ QueueWorldUpdateForRegion(platform *Plat, world *World, picked_voxel *Location,
   world_position Delta = MaxP.WorldP - MinP.WorldP + 1;
   u32 TotalChunkCount = Abs(Volume(Delta));
 
-  // TODO(Jesse)(leak): Each one of these gets leaked at the moment
-  world_chunk **Buffer = AllocateAligned(world_chunk*, Memory, TotalChunkCount, CACHE_LINE_SIZE);
+  world_update_block *Block = GetWorldUpdateBlock(World, TotalChunkCount, Memory);
+  world_chunk **Buffer = Block->ChunkBuffer;
 
   u32 ChunkIndex = 0;
   for (s32 zChunk = MinP.WorldP.z; zChunk <= MaxP.WorldP.z; ++zChunk)
@@ -3412,6 +5716,9 @@ QueueWorldUpdateForRegion(platform *Plat, world *World, picked_voxel *Location,
         world_chunk *Chunk = GetWorldChunkFromHashtable(World, ChunkP);
         if (Chunk)
         {
+          // NOTE(Jesse): The update job writes straight into the voxels
+          DecompressChunkVoxels(World, Chunk);
+
           Assert(ChunkIndex < TotalChunkCount);
           Buffer[ChunkIndex++] = Chunk;
         }
@@ -3419,11 +5726,19 @@ QueueWorldUpdateForRegion(platform *Plat, world *World, picked_voxel *Location,
     }
   }
 
-  work_queue_entry Entry = {
-    .Type = type_work_queue_entry_update_world_region,
-    .work_queue_entry_update_world_region = WorkQueueEntryUpdateWorldRegion(Op, ColorIndex, Location, Radius, MinP, MaxP, Buffer, ChunkIndex),
-  };
-  PushWorkQueueEntry(&Plat->LowPriority, &Entry);
+  work_job *Job = &Block->Job;
+  *Job = {};
+
+  work_queue_entry_update_world_region Update = WorkQueueEntryUpdateWorldRegion(Op, ColorIndex, Location, Radius, MinP, MaxP, Buffer, ChunkIndex);
+  Update.Job = Job;
+  Update.MeshRebuildJobs = Block->MeshRebuildJobs;
+  Update.Done = Done;
+
+  Job->Entry = WorkQueueEntry(Update);
+  Job->Queue = &Plat->LowPriority;
+  Job->Signal = &Block->Finished;
+
+  PushWorkJob(Job);
 }
 
 link_internal u32
@@ -3445,7 +5760,8 @@ MapIntoQueryBox(v3 SimSpaceVoxP, v3 SimSpaceQueryMinP, voxel_position SimSpaceQu
 link_internal void
 DoWorldUpdate(work_queue *Queue, world *World, world_chunk **ChunkBuffer, u32 ChunkCount,
               picked_voxel *Location, canonical_position MinP, canonical_position MaxP,
-              world_update_operation Op, u8 NewColor, f32 Radius, thread_local_state *Thread)
+              world_update_operation Op, u8 NewColor, f32 Radius, thread_local_state *Thread,
+              work_counter *MeshRebuilds = 0, work_job *MeshRebuildJobs = 0)
 {
   TIMED_FUNCTION();
 
@@ -3770,14 +6086,71 @@ DoWorldUpdate(work_queue *Queue, world *World, world_chunk **ChunkBuffer, u32 Ch
 
     /* DebugLine("End StandingSpotCount(%d)", AtElements(&Chunk->StandingSpots)); */
 
+    SetFlag(&Chunk->Flags, Chunk_Dirty);
+
     UnSetFlag(&Chunk->Flags, Chunk_Queued);
     /* QueueChunkForInit(Queue, Chunk); */
     /* QueueChunkForMeshRebuild(Queue, Chunk); */
-    QueueChunkForMeshRebuild(Queue, Chunk);
+    if (MeshRebuildJobs)
+    {
+      work_job *RebuildJob = MeshRebuildJobs + ChunkIndex;
+      RebuildJob->Entry = WorkQueueEntry(WorkQueueEntryRebuildMesh(Chunk));
+      RebuildJob->Queue = Queue;
+      RebuildJob->Signal = MeshRebuilds;
+
+      SetFlag(&Chunk->Flags, Chunk_Queued);
+      PushWorkJob(RebuildJob);
+    }
+    else
+    {
+      QueueChunkForMeshRebuild(Queue, Chunk);
+    }
   }
 
 }
 
+// NOTE(Jesse): The update_world_region job.  When it's run as a work_job it
+// yields until the mesh rebuilds it kicked off are done, so whoever's waiting
+// on it sees the finished edit, and the worker runs other jobs (likely those
+// same rebuilds) in the meantime.
+link_internal void
+RunWorldUpdateJob(work_queue *Queue, world *World, work_queue_entry_update_world_region *Job, thread_local_state *Thread)
+{
+  TIMED_FUNCTION();
+
+  work_job *Self = Job->Job;
+  u32 ResumePoint = Self ? Self->ResumePoint : 0;
+
+  switch (ResumePoint)
+  {
+    case 0:
+    {
+      work_counter *MeshRebuilds = 0;
+      if (Self)
+      {
+        MeshRebuilds = &Job->MeshRebuilds;
+        InitWorkCounter(MeshRebuilds, Job->ChunkCount);
+      }
+
+      picked_voxel Location = Job->Location;
+      DoWorldUpdate(Queue, World, Job->ChunkBuffer, Job->ChunkCount, &Location, Job->MinP, Job->MaxP, Job->Op, Job->ColorIndex, Job->Radius, Thread, MeshRebuilds, Job->MeshRebuildJobs);
+
+      if (Self) { YieldWorkJob(Self, MeshRebuilds, 1); }
+    } break;
+
+    case 1:
+    {
+      // NOTE(Jesse): The meshes are rebuilt.  Returning without yielding
+      // hands the job's storage back to the world, so this is the last we
+      // can touch it.
+      Assert(WorkCounterIsDone(&Job->MeshRebuilds));
+      if (Job->Done) { SignalWorkCounter(Job->Done); }
+    } break;
+
+    InvalidDefaultCase;
+  }
+}
+
 link_internal standing_spot_buffer
 GetStandingSpotsWithinRadius(world *World, canonical_position P, r32 Radius, memory_arena *TempMemory)
 {
@@ -3901,78 +6274,7 @@ RayTraceCollision(engine_resources *Resources, canonical_position AbsRayOrigin,
   UNPACK_ENGINE_RESOURCES(Resources);
   Assert(Length(RayDir) <= 1.0001f);
 
-  /* { */
-  /*   untextured_3d_geometry_buffer VoxelMesh = ReserveBufferSpace(&GpuMap->Buffer, VERTS_PER_VOXEL); */
-  /*   v3 RenderP = GetRenderP(World->ChunkDim, AbsRayOrigin, Camera); */
-  /*   DrawVoxel( &VoxelMesh, RenderP, V4(1,1,0,1), V3(11.f) ); */
-  /* } */
-
-  b32 Collision = False;
-  v3 WorldChunkDim = V3(World->ChunkDim);
-
-  picked_world_chunk_static_buffer AllChunksBuffer = {};
-
-  maybe_ray MaybeRay = ComputeRayFromCursor(Plat, &gBuffer->ViewProjection, Camera, World->ChunkDim);
-  if (MaybeRay.Tag == Maybe_Yes) { GetChunksIntersectingRay(World, &MaybeRay.Ray, &AllChunksBuffer); }
-
-
-  v3 Advance = MaybeRay.Ray.Dir;
-  // b32 Hit = False;
-
-  BubbleSort((sort_key_f*)AllChunksBuffer.E, (u32)AllChunksBuffer.At);
-
-  picked_voxel Result = { .PickedChunk.tChunk =  f32_MAX };
-  for (s64 ClosestChunkIndex = s64(AllChunksBuffer.At)-1; ClosestChunkIndex > -1; --ClosestChunkIndex)
-  {
-    r32 tChunk = (r32)AllChunksBuffer.E[ClosestChunkIndex].tChunk;
-    world_chunk *ClosestChunk = AllChunksBuffer.E[ClosestChunkIndex].Chunk;
-
-    if (ClosestChunk->FilledCount == 0) continue;
-
-    /* { */
-    /*   untextured_3d_geometry_buffer AABBMesh = ReserveBufferSpace(&GpuMap->Buffer, VERTS_PER_AABB); */
-    /*   DEBUG_DrawChunkAABB(&AABBMesh, Graphics, ClosestChunk, World->ChunkDim, RED); */
-    /* } */
-
-    v3 CollisionP = MaybeRay.Ray.Origin + (MaybeRay.Ray.Dir*tChunk);
-
-    v3 StartP = CollisionP + (Advance*0.1f);
-
-    v3 AtP = StartP - (ClosestChunk->WorldP*World->ChunkDim);
-
-    u32 AxisIndex = 0;
-    for (;;)
-    {
-      if ( AtP.x < 0 || AtP.x >= WorldChunkDim.x ||
-           AtP.y < 0 || AtP.y >= WorldChunkDim.y ||
-           AtP.z < 0 || AtP.z >= WorldChunkDim.z )
-      {
-        // Hit = False;
-        break;
-      }
-
-      // TODO(Jesse): Instead of trucating, make ClosestCentroid(AtP)
-      voxel_position LocalTestP = Voxel_Position(AtP);
-      if (IsFilledInChunk(ClosestChunk, LocalTestP, World->ChunkDim))
-      {
-        // Hit = True;
-        ClosestChunkIndex = -1;
-
-        /* v3 MinP =  V3(ClosestChunk->WorldP * World->ChunkDim); */
-        /* v3 VoxelP = MinP + Truncate(AtP); */
-
-        Result.PickedChunk.tChunk = tChunk;
-        Result.PickedChunk.Chunk = ClosestChunk;
-        Result.VoxelRelP = AtP;
-
-        break;
-      }
-
-      AtP.E[AxisIndex] += Advance.E[AxisIndex];
-      AxisIndex = (AxisIndex + 1) % 3;
-    }
-  }
-
+  picked_voxel Result = RaycastVoxels(World, AbsRayOrigin, RayDir, f32_MAX);
   return Result;
 }
 
@@ -4043,7 +6345,8 @@ MousePickVoxel(engine_resources *Resources)
 
 #if 1
 
-    Result = RayTraceCollision( Resources, Camera->CurrentP, MaybeRay.Ray.Dir);
+    canonical_position RayOrigin = Canonical_Position(World->ChunkDim, MaybeRay.Ray.Origin, World_Position(0));
+    Result = RayTraceCollision( Resources, RayOrigin, MaybeRay.Ray.Dir);
 
     if (Result.PickedChunk.tChunk != f32_MAX)
     {
@@ -4111,7 +6414,7 @@ MousePickVoxel(engine_resources *Resources)
       v3i TileChunkOffset = Voxel_Position(PickedVoxel.VoxelRelP);
       v3i TileChunkDim = Chunk_Dimension(8, 8, 2);
       /* boundary_voxels* TempBoundingPoints = AllocateBoundaryVoxels((u32)Volume(TileChunkDim), TranArena); */
-      standing_spot Spot = ComputeStandingSpotFor8x8x2_V2(PickedVoxel.PickedChunk.Chunk->Voxels, World->ChunkDim, TileChunkOffset, TileChunkDim); //, TempBoundingPoints);
+      standing_spot Spot = ComputeStandingSpotFor8x8x2_V2(GetDenseChunkVoxels(PickedVoxel.PickedChunk.Chunk, GetTranArena()), World->ChunkDim, TileChunkOffset, TileChunkDim); //, TempBoundingPoints);
     }
 
 
@@ -4359,29 +6662,63 @@ DrawPickedChunks(renderer_2d* Group, render_entity_to_texture_group *PickedChunk
 }
 #endif // DEBUG_SYSTEM_API
 
-link_internal void
-InitializeChunkWithNoise(chunk_init_callback NoiseCallback, thread_local_state *Thread, world_chunk *DestChunk, chunk_dimension WorldChunkDim, native_file *AssetFile, s32 Frequency, s32 Amplititude, s32 zMin, chunk_init_flags Flags, void* UserData)
+// NOTE(Jesse): Loads a chunk the player has edited from world_edits, through
+// the same record path the world pack uses.  The voxels went out
+// boundary-marked, so the mesh gets rebuilt straight from them.  Returns False
+// if the chunk was never edited; otherwise the caller builds the LOD and
+// finishes the chunk off.
+link_internal b32
+InitializeEditedChunk(thread_local_state *Thread, world_chunk *DestChunk, chunk_dimension WorldChunkDim)
 {
+  u32 RecordSize = 0;
+  u8 *Record = CopyWorldEdit(&Thread->EngineResources->WorldEdits, DestChunk->WorldP, Thread->TempMemory, &RecordSize);
+  if (Record == 0) { return False; }
+
   TIMED_FUNCTION();
 
-  // @runtime_assert_chunk_aprons_are_valid
-  Assert(Global_ChunkApronDim.x == Global_ChunkApronMinDim.x + Global_ChunkApronMaxDim.x);
-  Assert(Global_ChunkApronDim.y == Global_ChunkApronMinDim.y + Global_ChunkApronMaxDim.y);
-  Assert(Global_ChunkApronDim.z == Global_ChunkApronMinDim.z + Global_ChunkApronMaxDim.z);
+  world_chunk_view View = {};
+  b32 Result = ParseWorldChunkRecord(Record, RecordSize, &View) &&
+               View.VoxelElementCount == u32(Volume(WorldChunkDim));
 
-  Assert(!ChunkIsGarbage(DestChunk));
+  if (Result)
+  {
+    Result = DeserializeChunk(&View, DestChunk, &Thread->EngineResources->PackedMeshFreelist, Thread->PermMemory);
+  }
 
-  // TODO(Jesse): Pretty sure this is unnecessary
-  ClearChunkVoxels(DestChunk->Voxels, DestChunk->Dim);
+  if (Result == False)
+  {
+    // NOTE(Jesse): Fall back to generating it; better than a hole
+    SoftError("Couldn't load edited chunk (%d, %d, %d)", DestChunk->WorldP.x, DestChunk->WorldP.y, DestChunk->WorldP.z);
+  }
+
+  return Result;
+}
+
+// NOTE(Jesse): Noise stage.  Fills the synthetic chunk (the chunk plus its
+// apron) with noise, and merges in whatever the asset pack has for it.
+link_internal void
+GenerateChunkInitNoise(chunk_init_pipeline *Pipeline, chunk_init_callback NoiseCallback, thread_local_state *Thread, world_pack *AssetPack, s32 Frequency, s32 Amplititude, s32 zMin, void* UserData)
+{
+  TIMED_FUNCTION();
 
-  untextured_3d_geometry_buffer* PrimaryMesh = 0;
-  untextured_3d_geometry_buffer* LodMesh = 0;
-  untextured_3d_geometry_buffer* DebugMesh = 0;
+  world_chunk *DestChunk = Pipeline->DestChunk;
+  chunk_dimension WorldChunkDim = Pipeline->WorldChunkDim;
 
   chunk_dimension SynChunkDim = WorldChunkDim + Global_ChunkApronDim;
   chunk_dimension SynChunkP = DestChunk->WorldP;
 
-  world_chunk *SyntheticChunk = AllocateWorldChunk(Thread->TempMemory, SynChunkP, SynChunkDim );
+  world_chunk *SyntheticChunk = 0;
+  if (Pipeline->Scratch)
+  {
+    SyntheticChunk = &Pipeline->Scratch->SyntheticChunk;
+    ClearWorldChunk(SyntheticChunk);
+    ClearChunkVoxels(SyntheticChunk->Voxels, SynChunkDim);
+    SyntheticChunk->WorldP = SynChunkP;
+  }
+  else
+  {
+    SyntheticChunk = AllocateWorldChunk(Thread->TempMemory, SynChunkP, SynChunkDim );
+  }
 
   u32 SyntheticChunkSum = NoiseCallback( Thread->PerlinNoise,
                                          SyntheticChunk, SynChunkDim, Global_ChunkApronMinDim,
@@ -4389,89 +6726,187 @@ InitializeChunkWithNoise(chunk_init_callback NoiseCallback, thread_local_state *
                                          WorldChunkDim, UserData );
 
 
-  if (AssetFile && AssetFile->Handle)
+  world_chunk_view AssetView = {};
+  if (AssetPack && GetWorldChunkView(AssetPack, DestChunk->WorldP, &AssetView))
+  {
+    // NOTE(Jesse): Merge straight out of the mapped pack; raw voxels are
+    // never copied anywhere but the synthetic chunk, encoded ones are decoded
+    // into temp memory first.
+    world_chunk AssetChunk = {};
+    AssetChunk.Dim = SynChunkDim;
+    AssetChunk.Voxels = GetWorldChunkViewVoxels(&AssetView, Thread->TempMemory);
+
+    if (AssetChunk.Voxels)
+    {
+      Assert(AssetView.VoxelElementCount == u32(Volume(SynChunkDim)));
+      MergeChunksOffset(&AssetChunk, SyntheticChunk, {});
+      /* MergeChunksOffset(AssetChunk, SyntheticChunk, Global_HalfChunkApronDim); */
+    }
+    else
+    {
+      SoftError("Couldn't decode voxels for chunk (%d, %d, %d)", DestChunk->WorldP.x, DestChunk->WorldP.y, DestChunk->WorldP.z);
+    }
+  }
+
+  Pipeline->SyntheticChunk = SyntheticChunk;
+  Pipeline->SynChunkDim = SynChunkDim;
+  Pipeline->SyntheticChunkSum = SyntheticChunkSum;
+}
+
+// NOTE(Jesse): For edited chunks.  Swaps the generated interior of the
+// synthetic chunk for the voxels that were loaded, and marks it, so the LOD
+// stage sees the edits with the same apron generation would have given it.
+// The chunk keeps the voxels and mesh it was loaded with.
+link_internal void
+OverlayEditedChunkVoxels(chunk_init_pipeline *Pipeline)
+{
+  TIMED_FUNCTION();
+
+  world_chunk *DestChunk = Pipeline->DestChunk;
+  world_chunk *SyntheticChunk = Pipeline->SyntheticChunk;
+  chunk_dimension SynChunkDim = Pipeline->SynChunkDim;
+
+  DimIterator(x, y, z, Pipeline->WorldChunkDim)
   {
-    world_chunk *AssetChunk = AllocateWorldChunk(Thread->TempMemory, {}, WorldChunkDim+Global_ChunkApronDim);
+    voxel_position P = Voxel_Position(x, y, z);
+    voxel *Dest = SyntheticChunk->Voxels + GetIndex(P + Global_ChunkApronMinDim, SynChunkDim);
+    *Dest = DestChunk->Voxels[GetIndex(P, Pipeline->WorldChunkDim)];
+    Dest->Flags &= ~VoxelFaceMask;
+  }
 
-    DeserializeChunk(AssetFile, AssetChunk, &Thread->EngineResources->MeshFreelist, Thread->PermMemory);
-    CloseFile(AssetFile);
-    Assert(AssetChunk->Dim == SynChunkDim);
-    MergeChunksOffset(AssetChunk, SyntheticChunk, {});
-    /* MergeChunksOffset(AssetChunk, SyntheticChunk, Global_HalfChunkApronDim); */
+  u32 SyntheticChunkSum = 0;
+  for (s32 VoxelIndex = 0; VoxelIndex < Volume(SynChunkDim); ++VoxelIndex)
+  {
+    SyntheticChunkSum += SyntheticChunk->Voxels[VoxelIndex].Flags & Voxel_Filled;
   }
+  Pipeline->SyntheticChunkSum = SyntheticChunkSum;
+
+  MarkBoundaryVoxels_NoExteriorFaces(SyntheticChunk->Voxels, SynChunkDim, {}, SynChunkDim);
+  SetFlag(SyntheticChunk, Chunk_VoxelsInitialized);
+}
 
+// NOTE(Jesse): Mark stage.  Marks boundary voxels and copies the interior of
+// the synthetic chunk into the real one, after which its voxels are readable.
+link_internal void
+MarkChunkInitVoxels(chunk_init_pipeline *Pipeline)
+{
+  TIMED_FUNCTION();
+
+  world_chunk *DestChunk = Pipeline->DestChunk;
+  world_chunk *SyntheticChunk = Pipeline->SyntheticChunk;
+  chunk_dimension SynChunkDim = Pipeline->SynChunkDim;
 
   MarkBoundaryVoxels_NoExteriorFaces(SyntheticChunk->Voxels, SynChunkDim, {}, SynChunkDim);
 
-  CopyChunkOffset(SyntheticChunk, SynChunkDim, DestChunk, WorldChunkDim, Global_ChunkApronMinDim);
+  CopyChunkOffset(SyntheticChunk, SynChunkDim, DestChunk, Pipeline->WorldChunkDim, Global_ChunkApronMinDim);
 
   FullBarrier;
 
   SetFlag(DestChunk, Chunk_VoxelsInitialized);
   SetFlag(SyntheticChunk, Chunk_VoxelsInitialized);
+}
+
+// NOTE(Jesse): Mesh stage.  Builds the main mesh from the marked voxels, and
+// the standing spots if they were asked for.
+link_internal void
+BuildChunkInitMesh(chunk_init_pipeline *Pipeline, thread_local_state *Thread)
+{
+  TIMED_FUNCTION();
+
+  world_chunk *DestChunk = Pipeline->DestChunk;
+  chunk_dimension WorldChunkDim = Pipeline->WorldChunkDim;
 
   // NOTE(Jesse): A fully filled chunk can still have boundary voxels on its
   // exterior edge, so that does not preclude it from going through BuildWorldChunkMesh
   if ( DestChunk->FilledCount > 0) // && DestChunk->FilledCount < (u32)Volume(WorldChunkDim))
   {
-    untextured_3d_geometry_buffer *TempMesh = AllocateTempWorldChunkMesh(Thread->TempMemory);
-    BuildWorldChunkMeshFromMarkedVoxels_Greedy(DestChunk->Voxels, WorldChunkDim, {}, WorldChunkDim, TempMesh, Thread->TempMemory);
+    chunk_scratch *Scratch = Pipeline->Scratch;
+    packed_chunk_mesh *TempMesh = GetTempPackedChunkMesh(Scratch ? Scratch->PrimaryMesh : 0, Thread->TempMemory);
+    BuildWorldChunkMeshFromMarkedVoxels(DestChunk->Voxels, WorldChunkDim, {}, WorldChunkDim, TempMesh, Thread->TempMemory);
 
     if (TempMesh->At)
     {
-      PrimaryMesh = GetPermMeshForChunk(&Thread->EngineResources->MeshFreelist, TempMesh, Thread->PermMemory);
-      DeepCopy(TempMesh, PrimaryMesh);
+      Pipeline->PrimaryMesh = GetPermPackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, TempMesh->At, Thread->PermMemory);
+      DeepCopy(TempMesh, Pipeline->PrimaryMesh);
     }
   }
 
-
-
-  if (Flags & ChunkInitFlag_ComputeStandingSpots)
+  if (Pipeline->Flags & ChunkInitFlag_ComputeStandingSpots)
   {
-    ComputeStandingSpots( SynChunkDim, SyntheticChunk, {{1,1,0}}, {{0,0,1}}, Global_StandingSpotDim,
+    ComputeStandingSpots( Pipeline->SynChunkDim, Pipeline->SyntheticChunk, {{1,1,0}}, {{0,0,1}}, Global_StandingSpotDim,
                           WorldChunkDim, 0, &DestChunk->StandingSpots,
                           Thread->TempMemory);
   }
+}
+
+// NOTE(Jesse): LOD stage.  Only reads the synthetic chunk, so it doesn't care
+// whether the mesh stage has run.
+link_internal void
+BuildChunkInitLodMesh(chunk_init_pipeline *Pipeline, thread_local_state *Thread)
+{
+  TIMED_FUNCTION();
+
+  world_chunk *DestChunk = Pipeline->DestChunk;
+  world_chunk *SyntheticChunk = Pipeline->SyntheticChunk;
+  chunk_dimension WorldChunkDim = Pipeline->WorldChunkDim;
+  chunk_dimension SynChunkDim = Pipeline->SynChunkDim;
 
-  if (SyntheticChunkSum && (Flags & ChunkInitFlag_GenSmoothLODs) )
+  chunk_scratch *Scratch = Pipeline->Scratch;
+
+  if (Pipeline->SyntheticChunkSum && (Pipeline->Flags & ChunkInitFlag_GenSmoothLODs) )
   {
-    untextured_3d_geometry_buffer *TempMesh = AllocateTempWorldChunkMesh(Thread->TempMemory);
-    ComputeLodMesh( Thread, DestChunk, WorldChunkDim, SyntheticChunk, SynChunkDim, TempMesh, True);
+    untextured_3d_geometry_buffer *TempMesh = GetTempChunkMesh(Scratch ? Scratch->LodMesh : 0, Thread->TempMemory);
+    ComputeLodMesh( Thread, DestChunk, WorldChunkDim, SyntheticChunk, SynChunkDim, TempMesh, True, Scratch ? Scratch->BoundaryVoxels : 0);
 
+    // NOTE(Jesse): The smooth LOD is free-form triangles, so it gets packed
+    // here rather than as it's built
     if (TempMesh->At)
     {
-      LodMesh = GetPermMeshForChunk(&Thread->EngineResources->MeshFreelist, TempMesh, Thread->PermMemory);
-      DeepCopy(TempMesh, LodMesh);
+      palette_lookup *Lookup = GetChunkScratchPaletteLookup(Scratch, Thread->TempMemory);
+      Pipeline->LodMesh = GetPermPackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, TempMesh->At, Thread->PermMemory);
+      PackChunkMesh(Lookup, TempMesh, Pipeline->LodMesh);
     }
   }
 
-  if (SyntheticChunkSum && (Flags & ChunkInitFlag_GenMipMapLODs) )
+  if (Pipeline->SyntheticChunkSum && (Pipeline->Flags & ChunkInitFlag_GenMipMapLODs) )
   {
-    untextured_3d_geometry_buffer *TempMesh = AllocateTempWorldChunkMesh(Thread->TempMemory);
+    packed_chunk_mesh *TempMesh = GetTempPackedChunkMesh(Scratch ? Scratch->MipMesh : 0, Thread->TempMemory);
     BuildMipMesh(SyntheticChunk->Voxels, SynChunkDim, Global_ChunkApronMinDim, Global_ChunkApronMinDim+WorldChunkDim, TempMesh, Thread->TempMemory);
     if (TempMesh->At)
     {
-      LodMesh = GetPermMeshForChunk(&Thread->EngineResources->MeshFreelist, TempMesh, Thread->PermMemory);
-      DeepCopy(TempMesh, LodMesh);
+      if (Pipeline->LodMesh) { DeallocatePackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, Pipeline->LodMesh); }
+      Pipeline->LodMesh = GetPermPackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, TempMesh->At, Thread->PermMemory);
+      DeepCopy(TempMesh, Pipeline->LodMesh);
     }
   }
+}
+
+// NOTE(Jesse): Publishes the meshes the stages built and marks the chunk done
+link_internal void
+FinishChunkInit(chunk_init_pipeline *Pipeline, thread_local_state *Thread)
+{
+  world_chunk *DestChunk = Pipeline->DestChunk;
+
+  packed_chunk_mesh* PrimaryMesh = Pipeline->PrimaryMesh;
+  packed_chunk_mesh* LodMesh = Pipeline->LodMesh;
+  untextured_3d_geometry_buffer* DebugMesh = Pipeline->DebugMesh;
 
   FullBarrier;
 
   if (PrimaryMesh)
   {
     if (PrimaryMesh->At)
-    { Ensure( AtomicReplaceMesh(&DestChunk->Meshes, MeshBit_Main, PrimaryMesh, PrimaryMesh->Timestamp) == 0); }
+    { Ensure( AtomicReplacePackedMesh(&DestChunk->Meshes, MeshBit_Main, PrimaryMesh, PrimaryMesh->Timestamp) == 0); }
     else
-    { DeallocateMesh(PrimaryMesh, &Thread->EngineResources->MeshFreelist, Thread->PermMemory); }
+    { DeallocatePackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, PrimaryMesh); }
   }
 
   if (LodMesh)
   {
     if (LodMesh->At)
-    { Ensure( AtomicReplaceMesh(&DestChunk->Meshes, MeshBit_Lod, LodMesh, LodMesh->Timestamp) == 0); }
+    { Ensure( AtomicReplacePackedMesh(&DestChunk->Meshes, MeshBit_Lod, LodMesh, LodMesh->Timestamp) == 0); }
     else
-    { DeallocateMesh(LodMesh, &Thread->EngineResources->MeshFreelist, Thread->PermMemory); }
+    { DeallocatePackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, LodMesh); }
   }
 
   if (DebugMesh)
@@ -4482,17 +6917,205 @@ InitializeChunkWithNoise(chunk_init_callback NoiseCallback, thread_local_state *
     { DeallocateMesh(DebugMesh, &Thread->EngineResources->MeshFreelist, Thread->PermMemory); }
   }
 
+  // NOTE(Jesse): Only all-empty or all-solid chunks can be uniform, so skip
+  // the scan for everything else
+  s32 DestVolume = Volume(Pipeline->WorldChunkDim);
+  if ( DestChunk->FilledCount == 0 || DestChunk->FilledCount == u32(DestVolume) )
+  {
+    if (VoxelsAreUniform(DestChunk->Voxels, DestVolume))
+    {
+      DestChunk->UniformVoxel = DestChunk->Voxels[0];
+      SetFlag(DestChunk, Chunk_VoxelsUniform);
+    }
+  }
 
   FinalizeChunkInitialization(DestChunk);
+}
+
+// NOTE(Jesse): Noise and mark have to run in order, but after that the mesh
+// and LOD stages only read the synthetic chunk, so the LOD stage goes on our
+// own deque where an idle worker can steal it while we build the mesh.  If
+// nobody did we take it back and build it ourselves; we never run anything
+// else in the meantime, so inits don't nest.  The pipeline, the synthetic
+// chunk and the scratch all live until we return, so they're fine to share;
+// the two stages use different buffers out of the scratch.
+//
+// Off a worker (no deque) the stages just run back to back.
+link_internal void
+InitializeChunkWithNoise(chunk_init_callback NoiseCallback, thread_local_state *Thread, world_chunk *DestChunk, chunk_dimension WorldChunkDim, world_pack *AssetPack, s32 Frequency, s32 Amplititude, s32 zMin, chunk_init_flags Flags, void* UserData)
+{
+  TIMED_FUNCTION();
+
+  // @runtime_assert_chunk_aprons_are_valid
+  Assert(Global_ChunkApronDim.x == Global_ChunkApronMinDim.x + Global_ChunkApronMaxDim.x);
+  Assert(Global_ChunkApronDim.y == Global_ChunkApronMinDim.y + Global_ChunkApronMaxDim.y);
+  Assert(Global_ChunkApronDim.z == Global_ChunkApronMinDim.z + Global_ChunkApronMaxDim.z);
+
+  Assert(!ChunkIsGarbage(DestChunk));
+
+  chunk_init_pipeline Pipeline = {};
+  Pipeline.DestChunk = DestChunk;
+  Pipeline.WorldChunkDim = WorldChunkDim;
+  Pipeline.Flags = Flags;
+  Pipeline.Scratch = AcquireChunkScratch(Thread, WorldChunkDim + Global_ChunkApronDim);
+
+  // NOTE(Jesse): Edits replace the generated voxels outright.  The noise is
+  // still needed for the apron if there's a LOD to build.
+  if (InitializeEditedChunk(Thread, DestChunk, WorldChunkDim))
+  {
+    if (Flags & (ChunkInitFlag_GenSmoothLODs|ChunkInitFlag_GenMipMapLODs))
+    {
+      GenerateChunkInitNoise(&Pipeline, NoiseCallback, Thread, AssetPack, Frequency, Amplititude, zMin, UserData);
+      OverlayEditedChunkVoxels(&Pipeline);
+      BuildChunkInitLodMesh(&Pipeline, Thread);
+    }
+
+    FinishChunkInit(&Pipeline, Thread);
+    ReleaseChunkScratch(Pipeline.Scratch);
+    return;
+  }
+
+  // TODO(Jesse): Pretty sure this is unnecessary
+  ClearChunkVoxels(DestChunk->Voxels, DestChunk->Dim);
+
+  GenerateChunkInitNoise(&Pipeline, NoiseCallback, Thread, AssetPack, Frequency, Amplititude, zMin, UserData);
+  MarkChunkInitVoxels(&Pipeline);
+
+  b32 WantsLod = Pipeline.SyntheticChunkSum && (Flags & (ChunkInitFlag_GenSmoothLODs|ChunkInitFlag_GenMipMapLODs));
+
+  work_stealing_deque *Local = WantsLod ? GetLocalWorkStealingDeque(&Thread->EngineResources->Plat->LowPriority) : 0;
+
+  work_queue_entry_build_chunk_lod Job = { .Pipeline = &Pipeline };
+  work_queue_entry LodEntry = WorkQueueEntry(Job);
+
+  if (Local && PushWorkStealingDeque(Local, &LodEntry))
+  {
+    WakeParkedWorkers(Global_WorkerParking, 1);
+
+    BuildChunkInitMesh(&Pipeline, Thread);
+
+    // NOTE(Jesse): It's the last thing we pushed, so if it's still in our
+    // deque it's the one we get back; otherwise someone stole it and is
+    // already partway through it.
+    work_queue_entry Entry;
+    if (PopWorkStealingDeque(Local, &Entry))
+    {
+      if (Entry.Type == type_work_queue_entry_build_chunk_lod && Entry.work_queue_entry_build_chunk_lod.Pipeline == &Pipeline)
+      {
+        BuildChunkInitLodMesh(&Pipeline, Thread);
+        Pipeline.LodDone = True;
+      }
+      else
+      {
+        Ensure( PushWorkStealingDeque(Local, &Entry) );
+      }
+    }
+
+    while (!Pipeline.LodDone) { FullBarrier; }
+  }
+  else
+  {
+    BuildChunkInitMesh(&Pipeline, Thread);
+    if (WantsLod) { BuildChunkInitLodMesh(&Pipeline, Thread); }
+  }
+
+  FinishChunkInit(&Pipeline, Thread);
+
+  ReleaseChunkScratch(Pipeline.Scratch);
 
   return;
 }
 
 // TODO(Jesse): Probably remove this globally
 link_internal void
-InitializeWorldChunkPerlinPlane(thread_local_state *Thread, world_chunk *DestChunk, chunk_dimension WorldChunkDim, native_file *AssetFile, s32 Frequency, s32 Amplititude, s32 zMin, chunk_init_flags Flags)
+InitializeWorldChunkPerlinPlane(thread_local_state *Thread, world_chunk *DestChunk, chunk_dimension WorldChunkDim, world_pack *AssetPack, s32 Frequency, s32 Amplititude, s32 zMin, chunk_init_flags Flags)
+{
+  InitializeChunkWithNoise( Noise_Perlin2D, Thread, DestChunk, DestChunk->Dim, AssetPack, Frequency, Amplititude, zMin, Flags, 0);
+}
+
+// NOTE(Jesse): Builds the mesh for a clipmap node.  The voxels are sampled
+// every Scale world voxels, meshed like any other chunk, and the mesh scaled
+// back up.  The x/y apron is cleared before marking so the edges of the node
+// get walls; they hang down over the cracks where it meets a node of another
+// level.
+link_internal void
+InitializeLodClipmapNode(thread_local_state *Thread, lod_clipmap *Clipmap, lod_clipmap_node *Node)
 {
-  InitializeChunkWithNoise( Noise_Perlin2D, Thread, DestChunk, DestChunk->Dim, AssetFile, Frequency, Amplititude, zMin, Flags, 0);
+  TIMED_FUNCTION();
+
+  world_chunk *DestChunk = &Node->Chunk;
+
+  if (ChunkIsGarbage(DestChunk))
+  {
+    FinalizeChunkInitialization(DestChunk);
+    return;
+  }
+
+  chunk_dimension WorldChunkDim = DestChunk->Dim;
+  chunk_dimension SynChunkDim = WorldChunkDim + Global_ChunkApronDim;
+
+  chunk_scratch *Scratch = AcquireChunkScratch(Thread, SynChunkDim);
+
+  world_chunk *SyntheticChunk = 0;
+  if (Scratch)
+  {
+    SyntheticChunk = &Scratch->SyntheticChunk;
+    ClearWorldChunk(SyntheticChunk);
+    ClearChunkVoxels(SyntheticChunk->Voxels, SynChunkDim);
+  }
+  else
+  {
+    SyntheticChunk = AllocateWorldChunk(Thread->TempMemory, DestChunk->WorldP, SynChunkDim);
+  }
+
+  u32 SyntheticChunkSum = Noise_FBM2D_Lod( SyntheticChunk->Voxels, SynChunkDim, DestChunk->WorldP, Node->Scale,
+                                           &Clipmap->Noise, GRASS_GREEN, WorldChunkDim );
+
+  // NOTE(Jesse): Nothing but air, or nothing but rock; neither has a surface
+  if (SyntheticChunkSum > 0 && SyntheticChunkSum < u32(Volume(SynChunkDim)))
+  {
+    for (s32 z = 0; z < SynChunkDim.z; ++z)
+    {
+      for (s32 y = 0; y < SynChunkDim.y; ++y)
+      {
+        for (s32 x = 0; x < SynChunkDim.x; ++x)
+        {
+          b32 InApron = x < Global_ChunkApronMinDim.x || x >= SynChunkDim.x - Global_ChunkApronMaxDim.x ||
+                        y < Global_ChunkApronMinDim.y || y >= SynChunkDim.y - Global_ChunkApronMaxDim.y;
+          if (InApron)
+          {
+            SyntheticChunk->Voxels[GetIndex(Voxel_Position(x,y,z), SynChunkDim)] = {};
+          }
+        }
+      }
+    }
+
+    MarkBoundaryVoxels_NoExteriorFaces(SyntheticChunk->Voxels, SynChunkDim, {}, SynChunkDim);
+
+    world_chunk *Interior = AllocateWorldChunk(Thread->TempMemory, DestChunk->WorldP, WorldChunkDim);
+    CopyChunkOffset(SyntheticChunk, SynChunkDim, Interior, WorldChunkDim, Global_ChunkApronMinDim);
+
+    if (Interior->FilledCount)
+    {
+      packed_chunk_mesh *TempMesh = GetTempPackedChunkMesh(Scratch ? Scratch->PrimaryMesh : 0, Thread->TempMemory);
+      BuildWorldChunkMeshFromMarkedVoxels(Interior->Voxels, WorldChunkDim, {}, WorldChunkDim, TempMesh, Thread->TempMemory);
+
+      if (TempMesh->At)
+      {
+        ScalePackedChunkMesh(TempMesh, s32(Node->Scale));
+
+        packed_chunk_mesh *Mesh = GetPermPackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, TempMesh->At, Thread->PermMemory);
+        DeepCopy(TempMesh, Mesh);
+
+        FullBarrier;
+        Ensure( AtomicReplacePackedMesh(&DestChunk->Meshes, MeshBit_Main, Mesh, Mesh->Timestamp) == 0);
+      }
+    }
+  }
+
+  ReleaseChunkScratch(Scratch);
+
+  FinalizeChunkInitialization(DestChunk);
 }
 
 link_internal void
@@ -4500,22 +7123,85 @@ RebuildWorldChunkMesh(thread_local_state *Thread, world_chunk *Chunk)
 {
   Assert( IsSet(Chunk->Flags, Chunk_VoxelsInitialized) );
 
-  untextured_3d_geometry_buffer *NewMesh = 0;
+  packed_chunk_mesh *NewMesh = 0;
 
   {
-    untextured_3d_geometry_buffer *TempMesh = AllocateTempWorldChunkMesh(Thread->TempMemory);
-    BuildWorldChunkMeshFromMarkedVoxels_Greedy( Chunk->Voxels, Chunk->Dim, {}, Chunk->Dim, TempMesh, GetTranArena() );
+    chunk_scratch *Scratch = AcquireChunkScratch(Thread, Chunk->Dim + Global_ChunkApronDim);
+    packed_chunk_mesh *TempMesh = GetTempPackedChunkMesh(Scratch ? Scratch->PrimaryMesh : 0, Thread->TempMemory);
+    voxel *Voxels = GetDenseChunkVoxels(Chunk, GetTranArena());
+    BuildWorldChunkMeshFromMarkedVoxels( Voxels, Chunk->Dim, {}, Chunk->Dim, TempMesh, GetTranArena() );
 
     if (TempMesh->At)
     {
-      NewMesh = GetPermMeshForChunk(&Thread->EngineResources->MeshFreelist, TempMesh, Thread->PermMemory);
+      NewMesh = GetPermPackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, TempMesh->At, Thread->PermMemory);
       DeepCopy(TempMesh, NewMesh);
     }
+
+    ReleaseChunkScratch(Scratch);
   }
 
   umm Timestamp = NewMesh ? NewMesh->Timestamp : __rdtsc();
-  untextured_3d_geometry_buffer *Replaced = AtomicReplaceMesh(&Chunk->Meshes, MeshBit_Main, NewMesh, Timestamp);
-  if (Replaced) { DeallocateMesh(Replaced, &Thread->EngineResources->MeshFreelist, Thread->PermMemory); }
+  packed_chunk_mesh *Replaced = AtomicReplacePackedMesh(&Chunk->Meshes, MeshBit_Main, NewMesh, Timestamp);
+  if (Replaced) { DeallocatePackedChunkMesh(&Thread->EngineResources->PackedMeshFreelist, Replaced); }
+
+  // NOTE(Jesse): QueueChunkForMeshRebuild set this; if we leave it set an
+  // edited chunk can never be written back or freed
+  FullBarrier;
+  UnSetFlag(&Chunk->Flags, Chunk_Queued);
 }
 
 #endif // PLATFORM_GL_IMPLEMENTATIONa
+
+// NOTE(Jesse): The jobs the engine pushes for itself.  RunWorkQueueEntry hands
+// these off here before the game's callback sees anything, so games don't
+// have to know they exist.  Returns False for anything that isn't one.
+link_internal b32
+RunEngineWorkQueueEntry(work_queue_entry *Entry, thread_local_state *Thread)
+{
+  b32 Result = True;
+
+  switch (Entry->Type)
+  {
+    case type_work_queue_entry_rasterize_occluders:
+    {
+      volatile work_queue_entry_rasterize_occluders *Job = SafeAccess(work_queue_entry_rasterize_occluders, Entry);
+      RasterizeOcclusionBand(Job->Buffer, Job->BandIndex);
+    } break;
+
+    case type_work_queue_entry_raycast_batch:
+    {
+      volatile work_queue_entry_raycast_batch *Job = SafeAccess(work_queue_entry_raycast_batch, Entry);
+      RaycastBatch(Job->World, Job->Rays, Job->Hits, Job->Count);
+    } break;
+
+    case type_work_queue_entry_write_back_chunk:
+    {
+      volatile work_queue_entry_write_back_chunk *Job = SafeAccess(work_queue_entry_write_back_chunk, Entry);
+      WriteBackWorldChunk(Thread, Job->Chunk);
+    } break;
+
+#if PLATFORM_GL_IMPLEMENTATIONS
+    case type_work_queue_entry_init_lod_node:
+    {
+      volatile work_queue_entry_init_lod_node *Job = SafeAccess(work_queue_entry_init_lod_node, Entry);
+      InitializeLodClipmapNode(Thread, Job->Clipmap, Job->Node);
+    } break;
+
+    case type_work_queue_entry_build_chunk_lod:
+    {
+      volatile work_queue_entry_build_chunk_lod *Job = SafeAccess(work_queue_entry_build_chunk_lod, Entry);
+      chunk_init_pipeline *Pipeline = Job->Pipeline;
+      BuildChunkInitLodMesh(Pipeline, Thread);
+
+      // NOTE(Jesse): The pipeline's on the owner's stack; it's gone as soon
+      // as this is set
+      FullBarrier;
+      Pipeline->LodDone = True;
+    } break;
+#endif
+
+    default: { Result = False; } break;
+  }
+
+  return Result;
+}
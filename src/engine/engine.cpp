@@ -13,6 +13,7 @@
 #include <engine/cpp/triangle.cpp>
 
 #include <engine/cpp/camera.cpp>
+#include <engine/cpp/occlusion.cpp>
 #include <engine/cpp/lod.cpp>
 
 #if PLATFORM_GL_IMPLEMENTATIONS
@@ -25,6 +26,7 @@
 #endif
 
 #include <engine/cpp/ui.cpp>
+#include <engine/cpp/noise.cpp>
 #include <engine/cpp/world_chunk.cpp>
 #include <engine/cpp/world.cpp>
 #include <engine/cpp/physics.cpp>
@@ -21,6 +21,7 @@
 #include <engine/headers/mesh.h>
 #include <engine/headers/world_chunk.h>
 #include <engine/headers/work_queue.h>
+#include <engine/headers/occlusion.h>
 #include <engine/headers/asset.h>
 #include <engine/headers/animation.h>
 #include <engine/headers/model.h>
@@ -39,9 +39,69 @@
 // u32        : 4      : 'NORM'
 // normls[f7] : f7*f10 : normal elements data
 //
-// // TODO(Jesse): Add the standing_spot computations
+// u32        : 4      : 'SPOT'
+// v3i[f11]   : f11*f12 : standing spot elements data
 //
 
+//
+// world_chunk_3 file layout
+//
+// Same record shape as v2, except the voxels go through a codec, the mesh can
+// be left out entirely (the loader rebuilds it from the voxels) and the
+// checksum is real.
+
+// -- Header
+
+// name : type : description
+//
+// f1   : u32  : 'WHNK'
+// f2   : u32  : version number (3)
+// f3   : u64  : ComputeWorldChunkChecksum of every byte after the header
+//
+// f4   : u32  : voxel element count (decoded)
+// f5   : u32  : byte count of the encoded voxel data, padded to 4 bytes
+// f6   : u32  : elements in the SPOT array
+// f7   : u32  : element count in each (VERT, COLO, NORM) array
+//
+// f8   : u8   : 'VERT' (vertex)  element size
+// f9   : u8   : 'COLO' (colors)  element size
+// f10  : u8   : 'NORM' (normals) element size
+// f11  : u8   : 'SPOT' (standing spots) element size
+// f12  : u8   : size of voxel element (decoded)
+// f13  : u8   : world_chunk_voxel_codec
+// f14  : u8   : world_chunk_file_flag bits
+// f15  : u8   : pad
+
+// -- Data
+
+// type       : bytes  : description
+//
+// u32        : 4      : 'VOXD'
+// u8[f5]     : f5     : encoded voxel data
+//
+// u32        : 4      : 'VERT'  -- The mesh arrays are only present when f7 > 0
+// vertex[f7] : f7*f8  : vertex elements data
+//
+// u32        : 4      : 'COLO'
+// colors[f7] : f7*f9  : color elements data
+//
+// u32        : 4      : 'NORM'
+// normls[f7] : f7*f10 : normal elements data
+//
+// u32        : 4      : 'SPOT'
+// v3i[f6]    : f6*f11 : standing spot elements data
+
+//
+// VoxelCodec_RLE stream
+//
+// A sequence of packets, each a LEB128 varint token followed by voxels.  The
+// low bit of the token says what kind of packet it is, the rest is a count.
+//
+// (Count<<1)|0 : one voxel, repeated Count times
+// (Count<<1)|1 : Count voxels, stored verbatim
+//
+// Voxels are stored whole (Flags, Color) so the face bits round-trip exactly.
+
 enum world_chunk_file_tag
 {
   // v1
@@ -93,9 +153,236 @@ struct world_chunk_file_header_v2
   u8 VoxelElementSize;
   u8 pad[3];
 };
+
+enum world_chunk_voxel_codec
+{
+  VoxelCodec_Raw,
+  VoxelCodec_RLE,
+};
+
+enum world_chunk_file_flag
+{
+  // NOTE(Jesse): The mesh was left out on purpose; rebuild it on load
+  WorldChunkFileFlag_MeshOmitted = (1 << 0),
+};
+
+struct world_chunk_file_header_v3
+{
+  u32 WHNK; // WorldChunkFileTag_WHNK
+  u32 Version = 3;
+  u64 Checksum;
+
+  u32 VoxelElementCount;
+  u32 VoxelByteCount;
+  u32 StandingSpotElementCount;
+  u32 MeshElementCount;
+
+  u8 VertexElementSize;
+  u8 ColorElementSize;
+  u8 NormalElementSize;
+  u8 StandingSpotElementSize;
+
+  u8 VoxelElementSize;
+  u8 VoxelCodec; // world_chunk_voxel_codec
+  u8 Flags;      // world_chunk_file_flag
+  u8 pad;
+};
+#pragma pack(pop)
+
+// NOTE(Jesse): The pack validates records against the smaller of the two, and
+// every version starts with the WHNK/Version pair
+CAssert(sizeof(world_chunk_file_header_v2) == sizeof(world_chunk_file_header_v3));
+
+typedef world_chunk_file_header_v3 world_chunk_file_header;
+
+//
+// world.pack file layout
+//
+// Every chunk of a world in one file.  The directory is sorted by
+// world_position (z, then y, then x) so finding a chunk is a binary search,
+// and each chunk record starts on a page boundary so the whole file can be
+// mapped and read in place.  The chunk records are exactly what SerializeChunk
+// writes; see the world_chunk_3 layout above.  Packs written before v3 hold v2
+// records, which still load.
+
+// -- Header
+
+// name : type : description
+//
+// f1   : u32  : 'WPAK'
+// f2   : u32  : version number
+// f3   : u32  : chunk count
+// f4   : u32  : page size the chunk records are aligned to
+
+// -- Directory
+
+// type                 : bytes  : description
+//
+// world_pack_entry[f3] : f3*32  : sorted directory
+
+// -- Data
+
+// One chunk record (v2 or v3) per directory entry, each starting on an f4
+// boundary
+
+#define WORLD_PACK_PAGE_SIZE (4096)
+
+enum world_pack_file_tag
+{
+  WorldPackFileTag_WPAK = 'KAPW',
+};
+
+#pragma pack(push, 1)
+struct world_pack_file_header
+{
+  u32 WPAK; // WorldPackFileTag_WPAK
+  u32 Version = 1;
+  u32 ChunkCount;
+  u32 PageSize;
+};
+
+struct world_pack_entry
+{
+  world_position WorldP;
+  u32 Pad;
+
+  u64 Offset; // NOTE(Jesse): From the start of the file
+  u64 Size;
+};
+#pragma pack(pop)
+CAssert(sizeof(world_pack_entry) == 32);
+
+enum world_pack_record_state
+{
+  WorldPackRecord_Cold,      // Nobody has asked for it
+  WorldPackRecord_Requested, // Waiting on the reader thread
+  WorldPackRecord_Resident,  // The reader thread has faulted its pages in
+};
+
+// NOTE(Jesse): The I/O stage in front of chunk init.  The main thread asks for
+// records and the reader thread faults them in, so the workers that run chunk
+// init never take a page fault that has to go to disk.  The request ring has
+// exactly one producer (the main thread) and one consumer (the reader).
+struct world_pack_stream
+{
+  volatile u8 *RecordStates; // world_pack_record_state, one per directory entry
+
+  volatile u32 Requests[WORLD_PACK_STREAM_QUEUE_SIZE];
+  volatile u32 EnqueueIndex;
+  volatile u32 DequeueIndex;
+
+  volatile b32 ExitRequested;
+  volatile b32 ReaderRunning;
+
+  // NOTE(Jesse): Main thread only; used to predict where the camera is going
+  canonical_position LastCameraP;
+  v3 CameraVelocity;
+};
+
+struct world_pack
+{
+  // NOTE(Jesse): The whole file, mapped read-only
+  u8 *Base;
+  umm Size;
+
+  world_pack_file_header *Header;
+  world_pack_entry *Directory;
+
+  world_pack_stream Stream;
+};
+
+// NOTE(Jesse): Points straight into a mapped world_pack; nothing is copied,
+// and it's only valid while the pack is open.  The header fields are pulled
+// out here so callers don't care which record version they're looking at.
+// Use GetWorldChunkViewVoxels to get at the voxels, since they may be encoded.
+struct world_chunk_view
+{
+  u32 Version;
+  u32 Flags; // world_chunk_file_flag
+
+  u32 VoxelElementCount;
+  u32 MeshElementCount;
+  u32 StandingSpotElementCount;
+
+  world_chunk_voxel_codec VoxelCodec;
+  u8 *EncodedVoxels;
+  u32 EncodedVoxelByteCount;
+
+  v3 *Verts;
+  v4 *Colors;
+  v3 *Normals;
+
+  voxel_position *StandingSpots;
+};
+
+//
+// world.edits file layout
+//
+// An append-only journal of chunks the player has changed.  A chunk gets a
+// new entry every time it's written back, and the last entry for a position
+// wins.  Entries that fail their checksum are skipped on load.
+
+// type                      : bytes : description
+//
+// world_edit_journal_entry  : 20    : position and record size
+// u8[RecordSize]            : ...   : a world_chunk_3 record, mesh omitted
+// ...                                 repeated to the end of the file
+
+enum world_edit_file_tag
+{
+  WorldEditFileTag_WEDT = 'TDEW',
+};
+
+#pragma pack(push, 1)
+struct world_edit_journal_entry
+{
+  u32 WEDT; // WorldEditFileTag_WEDT
+  world_position WorldP;
+  u32 RecordSize;
+};
 #pragma pack(pop)
+CAssert(sizeof(world_edit_journal_entry) == 20);
 
-typedef world_chunk_file_header_v2 world_chunk_file_header;
+struct world_edit_record
+{
+  world_position WorldP;
+
+  u8 *Record; // NOTE(Jesse): Allocated out of world_edits::Heap
+  u32 RecordSize;
+
+  world_edit_record *Next;
+};
+
+// NOTE(Jesse): Every chunk that's been edited, keyed by position.  Chunk init
+// loads from here instead of generating, so edits survive the chunk being
+// evicted.  Written by the write-back jobs, read by the chunk init jobs; the
+// lock covers the table, the heap and the journal.
+struct world_edits
+{
+  bonsai_futex Lock;
+
+  world_edit_record **Table; // WORLD_EDIT_HASH_SIZE buckets
+  volatile u32 RecordCount;
+
+  heap_allocator Heap;
+
+  // NOTE(Jesse): Empty if edits aren't being persisted
+  counted_string JournalFilename;
+
+  // NOTE(Jesse): Records in the journal that a later one for the same chunk
+  // replaced.  Reset when the journal gets compacted.
+  u32 SupersededCount;
+
+  // NOTE(Jesse): Main thread only
+  r32 SecondsSinceWriteBack;
+};
+
+link_internal counted_string
+GetWorldEditsFilename(counted_string AssetPath, memory_arena *Memory)
+{
+  counted_string Result = FormatCountedString(Memory, CSz("%S/world.edits"), AssetPath);
+  return Result;
+}
 
 struct asset
 {
@@ -107,9 +394,9 @@ poof(buffer(asset))
 #include <generated/buffer_asset.h>
 
 link_internal counted_string
-GetAssetFilenameFor(counted_string AssetPath, world_position WorldP, memory_arena *Memory)
+GetWorldPackFilename(counted_string AssetPath, memory_arena *Memory)
 {
-  counted_string Result = FormatCountedString(Memory, CSz("%S/world_chunk_%d_%d_%d"), AssetPath, WorldP.x, WorldP.y, WorldP.z);
+  counted_string Result = FormatCountedString(Memory, CSz("%S/world.pack"), AssetPath);
   return Result;
 }
 
@@ -24,10 +24,46 @@ struct frustum
   float width;
   float FOV;
 
+  // NOTE(Jesse): All six normals point into the frustum
   plane Top;
   plane Bot;
   plane Left;
   plane Right;
+  plane Near;
+  plane Far;
+};
+
+enum frustum_test_result
+{
+  FrustumTest_Outside,
+  FrustumTest_Intersecting,
+  FrustumTest_Inside,
+};
+
+// NOTE(Jesse): What BufferWorld culled last frame.  Blocks are the 16^3 and
+// 4^3 groups of chunk positions tested before any chunk inside them is.
+// ChunksVisible and ChunksCulled are from the frustum test alone; chunks that
+// pass it and are then hidden by the occlusion buffer count in ChunksOccluded.
+// With the LOD clipmap on, the blocks are clipmap nodes, and chunks only
+// count where the clipmap picked full resolution.
+struct chunk_cull_stats
+{
+  u32 BlocksTested;
+  u32 BlocksCulled;
+
+  u32 ChunksTested;
+  u32 ChunksVisible;
+  u32 ChunksCulled;
+
+  u32 Occluders;
+  u32 ChunksOccluded;
+
+  u32 LodNodesVisible;
+  u32 LodNodesOccluded;
+
+  // NOTE(Jesse): Mesh elements drawn, and left undrawn by occlusion
+  u32 VertsDrawn;
+  u32 VertsOccluded;
 };
 
 struct camera
@@ -64,3 +64,34 @@ struct entity
   update_callback Update;
   void* UserData;
 };
+
+#define ENTITY_BROADPHASE_NOT_FILED (u32_MAX)
+#define ENTITY_BROADPHASE_LARGE     (u32_MAX-1)
+
+// NOTE(Jesse): One per entity table slot.  AABB is sim space, as of the last
+// time the slot was filed.
+struct entity_broadphase_node
+{
+  entity *Entity;
+  aabb AABB;
+  v3i Cell;
+
+  u32 Bucket; // ENTITY_BROADPHASE_NOT_FILED, ENTITY_BROADPHASE_LARGE or an index into Buckets
+  u32 Next;   // The next node in the same bucket
+};
+
+// NOTE(Jesse): Spawned entities hashed by the sim space cell the min corner
+// of their AABB lands in.  Since nothing filed in a cell is bigger than one,
+// an AABB can only touch entities filed in the cells it covers or the ones
+// just below them.  Rebuilt at the top of SimulateEntities, and kept current
+// as each entity is simulated.
+struct entity_broadphase
+{
+  entity_broadphase_node *Nodes; // TOTAL_ENTITY_COUNT
+  u32 *Buckets;                  // ENTITY_BROADPHASE_BUCKET_COUNT, the first node in each
+
+  u32 *Large; // Slots too big to file in a cell
+  u32 LargeCount;
+
+  u32 PairsTested; // Since the last rebuild
+};
@@ -7,6 +7,51 @@ struct post_processing_group
   u32 ColorBuffer;
 };
 
+struct gpu_chunk_draw_command
+{
+  u32 FirstElement;
+  u32 ElementCount;
+  u32 QuadCount; // Drawn with the QuadIndexHandle when non-zero
+  v3 Basis;
+};
+
+struct gpu_chunk_slab_tier
+{
+  u32 *FreeSlabs;
+  u32 FreeCount;
+  u32 Capacity;
+};
+
+// NOTE(Jesse): Chunk meshes are uploaded once into a slab of this buffer when
+// they're installed and drawn in place with a per-chunk basis uniform, instead
+// of being re-copied into the per-frame gpu_mapped_element_buffer.
+//
+// Slabs come in GPU_CHUNK_SLAB_TIER_COUNT tiers of
+// WORLD_CHUNK_MESH_MIN_SIZE*(TierIndex+1) elements; the same tiering the
+// tiered_mesh_freelist uses for the CPU-side copies.
+struct gpu_chunk_buffer
+{
+  u32 VertexHandle; // packed_chunk_vertex
+
+  // NOTE(Jesse): Static u16 index buffer of QuadIndexCount/6 quads laid out
+  // as (0,1,2) (2,1,3).  Slabs are drawn by offsetting the attribute pointer
+  // to the start of the slab, so it only has to be big enough for the
+  // largest slab.
+  u32 QuadIndexHandle;
+  u32 QuadIndexCount;
+  texture *PaletteTexture;
+
+  u32 ElementCount;
+  u32 ElementsReserved;
+
+  gpu_chunk_slab_tier Tiers[GPU_CHUNK_SLAB_TIER_COUNT];
+
+  gpu_chunk_draw_command *DrawCommands;
+  u32 DrawCommandCount;
+};
+
+struct occlusion_buffer;
+
 struct graphics
 {
   camera *Camera;
@@ -20,5 +65,10 @@ struct graphics
   gpu_mapped_element_buffer GpuBuffers[2];
   u32 GpuBufferWriteIndex;
 
+  gpu_chunk_buffer ChunkBuffer;
+
+  chunk_cull_stats ChunkCullStats;
+  occlusion_buffer *Occlusion;
+
   memory_arena *Memory;
 };
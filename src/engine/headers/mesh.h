@@ -31,6 +31,7 @@ struct mesh_freelist
 #define TIERED_MESH_FREELIST_MAX_ELEMENTS (32)
 #define ELEMENTS_PER_TEMP_MESH    (WORLD_CHUNK_MESH_MIN_SIZE*TIERED_MESH_FREELIST_MAX_ELEMENTS)
 #define WORLD_CHUNK_MESH_MIN_SIZE (1024)
+CAssert(TIERED_MESH_FREELIST_MAX_ELEMENTS == GPU_CHUNK_SLAB_TIER_COUNT);
 
 poof( staticbuffer(mesh_freelist, {TIERED_MESH_FREELIST_MAX_ELEMENTS}, {tiered_mesh_freelist}) )
 #include <generated/tiered_mesh_freelist.h>
@@ -53,6 +54,70 @@ TryGetTierForSize(tiered_mesh_freelist *TieredFreelist, u32 Size)
   return Result;
 }
 
+// NOTE(Jesse): The vertex format chunk meshes are built in and stored in on the card.
+//
+// X, Y, Z are the chunk-local position in fixed point with
+// PACKED_CHUNK_VERTEX_PRECISION steps per voxel, offset by
+// PACKED_CHUNK_VERTEX_BIAS voxels so LOD meshes can go slightly negative.
+//
+// NormalAndColor is the palette index of the color in the low 8 bits and the
+// index of the axis-aligned normal (see PackedChunkVertexNormals) in the
+// next 3.  This must be kept in sync with gBuffer.vertexshader and
+// DepthRTT.vertexshader
+struct packed_chunk_vertex
+{
+  u16 X;
+  u16 Y;
+  u16 Z;
+  u16 NormalAndColor;
+};
+CAssert(sizeof(packed_chunk_vertex) == 8);
+
+#define PACKED_CHUNK_VERTEX_PRECISION (64.f)
+#define PACKED_CHUNK_VERTEX_BIAS      (64.f)
+
+
+// NOTE(Jesse): Maps float colors back to palette indices for PackChunkMesh.
+// It fills in as it goes, so each worker keeps its own in its chunk_scratch.
+#define PALETTE_LOOKUP_TABLE_SIZE (1024)
+struct palette_lookup_entry
+{
+  u32 Key; // 0 is an empty slot, otherwise rgb | (1<<24)
+  u8 ColorIndex;
+};
+
+struct palette_lookup
+{
+  v4 *Palette;
+  u32 PaletteCount;
+  palette_lookup_entry Entries[PALETTE_LOOKUP_TABLE_SIZE];
+};
+
+// NOTE(Jesse): A chunk mesh in the format it's drawn in.  The world chunk
+// meshers write these directly, so uploading one is a straight copy.
+//
+// QuadCount is non-zero when the mesh is all quads, stored 4 verts apiece in
+// the order the gpu_chunk_buffer quad indices expect; otherwise the verts are
+// plain triangles.
+struct packed_chunk_mesh
+{
+  packed_chunk_vertex *Verts;
+  u32 At;
+  u32 End;
+  u32 QuadCount;
+
+  u64 Timestamp;
+
+  packed_chunk_mesh *NextFree;
+};
+
+// NOTE(Jesse): Same tiering as tiered_mesh_freelist
+struct packed_chunk_mesh_freelist
+{
+  bonsai_futex Lock;
+  packed_chunk_mesh *FirstFree[TIERED_MESH_FREELIST_MAX_ELEMENTS];
+};
+
 inline void
 BufferVertsDirect(
     untextured_2d_geometry_buffer *Dest,
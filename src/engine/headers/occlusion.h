@@ -0,0 +1,33 @@
+// NOTE(Jesse): In pixels, and 1/depth at each corner
+struct occluder_triangle
+{
+  v2 P[3];
+  r32 InvDepth[3];
+};
+
+// NOTE(Jesse): A small depth buffer BufferWorld draws occluders into on the
+// CPU, then tests chunks against before it draws them.
+//
+// It's drawn from the camera's eye with a projection of its own; only the eye
+// has to match the real camera, since anything that lands outside the buffer
+// is treated as visible.  It holds 1/depth, which is linear across a triangle
+// in screen space, and zero means there's nothing there.
+struct occlusion_buffer
+{
+  // NOTE(Jesse): Sim space.  Enabled is false when the view is degenerate, in
+  // which case nothing is occluded.
+  b32 Enabled;
+  v3 EyeP;
+  v3 Front;
+  v3 Right;
+  v3 Up;
+
+  r32 *InvDepth; // OCCLUSION_BUFFER_WIDTH*OCCLUSION_BUFFER_HEIGHT, row major
+
+  occluder_triangle *Triangles; // OCCLUSION_MAX_OCCLUDERS*6
+  u32 TriangleCount;
+  u32 OccluderCount;
+
+  // NOTE(Jesse): One job per band; lives here so it outlives the jobs
+  work_counter Bands;
+};
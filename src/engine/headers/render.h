@@ -68,6 +68,8 @@ struct g_buffer_render_group
 
   shader LightingShader;
   shader gBufferShader;
+  s32 ChunkBasisUniform;
+  s32 UsePackedVerticesUniform;
 
   m4 ViewProjection;
 };
@@ -76,6 +78,8 @@ struct shadow_render_group
 {
   u32 FramebufferName;
   s32 MVP_ID;
+  s32 ChunkBasis_ID;
+  s32 UsePackedVertices_ID;
 
   shader DebugTextureShader;
   shader DepthShader;
@@ -1,5 +1,39 @@
 
 struct game_state;
+struct work_queue_entry;
+
+// NOTE(Jesse): A Chase-Lev deque.  The worker that owns it pushes and pops at
+// Bottom without contending with anyone; other workers steal from Top with a
+// compare-exchange.  Top and Bottom count up forever and are reduced to a slot
+// index on use.
+struct work_stealing_deque
+{
+  volatile u32 Top;
+  u8 Pad[CACHE_LINE_SIZE - sizeof(u32)];
+
+  volatile u32 Bottom;
+  work_queue_entry *Entries; // WORK_STEALING_DEQUE_SIZE
+};
+
+// NOTE(Jesse): Where idle workers sleep.  A worker bumps ParkedCount, checks
+// for work one more time, then sleeps on the semaphore.  Anyone who pushes a
+// job posts the semaphore once for each worker it takes off ParkedCount, so
+// only as many workers wake up as there are jobs for.
+struct worker_parking
+{
+  semaphore Semaphore;
+  volatile u32 ParkedCount;
+
+  // NOTE(Jesse): When the most recent wake was posted; workers measure their
+  // wake latency against it
+  volatile u64 LastWakeCycles;
+};
+
+// NOTE(Jesse): Set by the loader, and by Bonsai_OnLibraryLoad in the game lib.
+// Zero means nobody's parked, ever (tests, tools).
+global_variable worker_parking *Global_WorkerParking;
+
+struct chunk_scratch;
 
 struct thread_startup_params
 {
@@ -17,6 +51,26 @@ struct thread_startup_params
   work_queue *LowPriority;
   work_queue *HighPriority;
 
+  // NOTE(Jesse): Jobs this worker pushes while running a job go here instead
+  // of the shared queues, one deque per priority.  Idle workers steal them.
+  work_stealing_deque LowPriorityDeque;
+  work_stealing_deque HighPriorityDeque;
+
+  // NOTE(Jesse): Everyone's params, indexed by ThreadIndex, so we know who to
+  // steal from.  Index 0 is the main thread, which never owns work.
+  thread_startup_params *AllThreads;
+
+  worker_parking *Parking;
+
+  // NOTE(Jesse): Written by this worker only
+  u32 WakeCount;
+  u64 TotalWakeLatencyCycles;
+  u64 MaxWakeLatencyCycles;
+
+  // NOTE(Jesse): Built lazily by this thread the first time it inits a chunk;
+  // see AcquireChunkScratch
+  chunk_scratch *ChunkScratch;
+
   volatile s32 ThreadIndex;
   /* volatile u32 ThreadId; */
   /* volatile thread_handle ThreadHandle; */
@@ -197,3 +197,13 @@ global_variable v3 BottomFaceNormalData[] =
   {{0, 0, -1}},
 };
 
+
+// NOTE(Jesse): Which of the six verts each *FaceVertexData helper emits are
+// the corners of the face, ordered so the quad indices the gpu_chunk_buffer
+// draws with, (0,1,2) (2,1,3), keep the winding of the two triangles.
+global_variable u32 RightFaceQuadVerts[]  = { 2, 0, 1, 4 };
+global_variable u32 LeftFaceQuadVerts[]   = { 2, 0, 1, 4 };
+global_variable u32 BackFaceQuadVerts[]   = { 0, 1, 2, 5 };
+global_variable u32 FrontFaceQuadVerts[]  = { 0, 1, 2, 5 };
+global_variable u32 TopFaceQuadVerts[]    = { 0, 1, 2, 5 };
+global_variable u32 BottomFaceQuadVerts[] = { 0, 1, 2, 3 };
@@ -1,3 +1,20 @@
+struct work_job;
+
+// NOTE(Jesse): Counts jobs that haven't finished yet.  When it gets to zero
+// the jobs chained on with PushWorkJobAfter are pushed.  Counters fire once;
+// InitWorkCounter them again before reuse.
+struct work_counter
+{
+  volatile u32 Pending;
+
+  // NOTE(Jesse): Covers Continuations.  Fired is set once the last signal
+  // has taken them and let go of the lock, so a counter that reads as done
+  // can be reused right away.
+  bonsai_futex Lock;
+  work_job *Continuations;
+  volatile b32 Fired;
+};
+
 struct work_queue_entry_copy_buffer_ref
 {
   threadsafe_geometry_buffer *Buf;
@@ -76,6 +93,14 @@ struct work_queue_entry_update_world_region
 
   world_chunk **ChunkBuffer;
   u32 ChunkCount;
+
+  // NOTE(Jesse): Set when the update runs as a work_job, in which case it
+  // waits for the mesh rebuilds it kicks off before it counts as done, then
+  // signals Done (if there is one).  MeshRebuildJobs is ChunkCount long.
+  work_job *Job;
+  work_job *MeshRebuildJobs;
+  work_counter MeshRebuilds;
+  work_counter *Done;
 };
 
 struct work_queue_entry_init_asset
@@ -83,6 +108,51 @@ struct work_queue_entry_init_asset
   world_chunk *Chunk;
 };
 
+struct work_queue_entry_write_back_chunk
+{
+  world_chunk *Chunk;
+};
+
+// NOTE(Jesse): Wraps a job that signals a work_counter when it's done.  The
+// engine unwraps these before they get to the game's worker callback.
+struct work_queue_entry_run_job
+{
+  work_job *Job;
+};
+
+struct occlusion_buffer;
+struct work_queue_entry_rasterize_occluders
+{
+  occlusion_buffer *Buffer;
+  u32 BandIndex;
+};
+
+struct lod_clipmap;
+struct lod_clipmap_node;
+struct work_queue_entry_init_lod_node
+{
+  lod_clipmap *Clipmap;
+  lod_clipmap_node *Node;
+};
+
+// NOTE(Jesse): The LOD stage of a chunk init, for an idle worker to steal
+// while the one doing the init builds the mesh
+struct chunk_init_pipeline;
+struct work_queue_entry_build_chunk_lod
+{
+  chunk_init_pipeline *Pipeline;
+};
+
+struct world;
+struct voxel_raycast;
+struct work_queue_entry_raycast_batch
+{
+  world *World;
+  voxel_raycast *Rays;
+  picked_voxel *Hits;
+  u32 Count;
+};
+
 // struct work_queue_entry__align_to_cache_line_helper_struct
 // {
   // NOTE(Jesse): This is just to ensure the union size is a multiple of a
@@ -101,6 +171,12 @@ poof(
     work_queue_entry_update_world_region
     work_queue_entry_rebuild_mesh
     work_queue_entry_sim_particle_system
+    work_queue_entry_write_back_chunk
+    work_queue_entry_run_job
+    work_queue_entry_rasterize_occluders
+    work_queue_entry_init_lod_node
+    work_queue_entry_raycast_batch
+    work_queue_entry_build_chunk_lod
   }
 )
 #include <generated/d_union_work_queue_entry.h>
@@ -122,6 +198,58 @@ WorkQueueEntry( particle_system *System, untextured_3d_geometry_buffer *Dest, v3
 
 
 
+struct work_job
+{
+  work_queue_entry Entry;
+
+  work_queue *Queue;    // Where it goes once it's ready to run
+  work_counter *Signal; // Decremented once it's done; may be 0
+
+  work_job *Next;       // Used while it's waiting on a counter
+
+  // NOTE(Jesse): A job can return early and ask to be run again once a
+  // counter fires (see YieldWorkJob).  It picks up from ResumePoint, which is
+  // 0 the first time it runs.  Anything it needs to keep has to live in
+  // Entry, since the stack and the thread's temp memory are gone by then.
+  work_counter *YieldedOn;
+  u32 ResumePoint;
+};
+
+// NOTE(Jesse): The storage behind a QueueWorldUpdateForRegion job, which has
+// to outlive the call.  The world keeps these and hands them out again once
+// Finished fires, which RunWorkQueueEntry does after it's let go of Job.
+struct world_update_block
+{
+  work_job Job;
+  work_counter Finished;
+
+  u32 ChunkCapacity;
+  world_chunk **ChunkBuffer;
+  work_job *MeshRebuildJobs;
+
+  world_update_block *Next;
+};
+
+// NOTE(Jesse): See InitQueue
+link_inline volatile u32 *
+GetWorkQueueSequences(work_queue *Queue)
+{
+  volatile u32 *Result = ((volatile u32*)Queue->Entries) - WORK_QUEUE_SIZE;
+  return Result;
+}
+
+link_internal b32
+DequeueWorkQueueEntry(work_queue *Queue, work_queue_entry *Result);
+
+link_internal void
+PushWorkQueueEntries(work_queue *Queue, work_queue_entry *Entries, u32 Count);
+
+link_internal b32
+RunEngineWorkQueueEntry(work_queue_entry *Entry, thread_local_state *Thread);
+
+link_internal void
+RunWorkQueueEntry(work_queue_entry *Entry, thread_local_state *Thread, bonsai_worker_thread_callback GameWorkerThreadCallback);
+
 link_internal void
 DrainQueue(work_queue* Queue, thread_local_state* Thread, bonsai_worker_thread_callback GameWorkerThreadCallback)
 {
@@ -131,21 +259,13 @@ DrainQueue(work_queue* Queue, thread_local_state* Thread, bonsai_worker_thread_c
   {
     WORKER_THREAD_ADVANCE_DEBUG_SYSTEM();
 
-    // NOTE(Jesse): Must read and comared DequeueIndex instead of calling QueueIsEmpty
-    u32 DequeueIndex = Queue->DequeueIndex;
-    if (DequeueIndex == Queue->EnqueueIndex)
+    work_queue_entry Entry;
+    if (!DequeueWorkQueueEntry(Queue, &Entry))
     {
       break;
     }
 
-    b32 Exchanged = AtomicCompareExchange( &Queue->DequeueIndex,
-                                           GetNextQueueIndex(DequeueIndex),
-                                           DequeueIndex );
-    if ( Exchanged )
-    {
-      volatile work_queue_entry* Entry = Queue->Entries + DequeueIndex;
-      GameWorkerThreadCallback(Entry, Thread);
-    }
+    RunWorkQueueEntry(&Entry, Thread, GameWorkerThreadCallback);
   }
 }
 
@@ -8,6 +8,15 @@ enum chunk_flag
   // This is an optimization to tell the thread queue to not initialize chunks
   // we've already moved away from.
   Chunk_Garbage           = 1 << 3,
+
+  // NOTE(Jesse): Set by the worker that initialized the chunk when every voxel
+  // came out the same.  The main thread then hands the dense voxel block back
+  // to the world and the chunk is represented by UniformVoxel alone.
+  Chunk_VoxelsUniform     = 1 << 4,
+
+  // NOTE(Jesse): Set by DoWorldUpdate.  The voxels differ from what chunk init
+  // would produce and have to be written back before the chunk is freed.
+  Chunk_Dirty             = 1 << 5,
 };
 
 enum voxel_flag
@@ -156,7 +165,19 @@ ToIndex(world_chunk_mesh_bitfield Bit)
 struct threadsafe_geometry_buffer
 {
   volatile u32 MeshMask;
+
+  // NOTE(Jesse): Set when a mesh is replaced, cleared by the main thread when
+  // it uploads the mesh to the gpu_chunk_buffer.  Only ever modified while
+  // holding the corresponding mesh futex.
+  volatile u32 GpuDirtyMask;
+
   volatile untextured_3d_geometry_buffer *E[MeshIndex_Count];
+
+  // NOTE(Jesse): Meshes the world chunk meshers built, already in the format
+  // the gpu_chunk_buffer draws.  Guarded by the same futexes as E, and
+  // preferred over E when both are set.
+  volatile packed_chunk_mesh *Packed[MeshIndex_Count];
+
   bonsai_futex Futexes[MeshIndex_Count];
 };
 
@@ -178,18 +199,39 @@ enum chunk_init_flags
 
 #define WORLD_CHUNK_STANDING_SPOT_COUNT (32)
 
+// NOTE(Jesse): A range of the gpu_chunk_buffer holding one of the chunks
+// meshes.  ElementCount == 0 means the slab is not allocated.
+struct gpu_chunk_slab
+{
+  u32 FirstElement;
+  u32 ElementCount; // Capacity of the slab
+  u32 UsedCount;    // Elements of the mesh actually uploaded
+  u32 QuadCount;    // Non-zero if the slab holds 4 verts per quad, drawn indexed
+};
+
 #pragma pack(push, 1)
 struct current_triangles;
 struct world_chunk
 {
   chunk_flag Flags;
   chunk_dimension Dim; // TODO(Jesse): can be 3x u8 instead of 3x s32
+
+  // NOTE(Jesse): Null for uniform chunks, in which case every voxel is
+  // UniformVoxel.  Use GetVoxel / IsFilledInChunk / GetDenseChunkVoxels
+  // instead of poking at this directly on chunks that live in the world.
   voxel *Voxels;
+  voxel UniformVoxel;
 
   threadsafe_geometry_buffer Meshes;
+  gpu_chunk_slab GpuSlabs[MeshIndex_Count];
+
   voxel_position_cursor StandingSpots;
 
   world_position WorldP;
+
+  // NOTE(Jesse): Index into World->ResidentChunks while the chunk is in the world
+  u32 ResidentIndex;
+
   u32 FilledCount;
   b32 Picked;
   b32 DrawBoundingVoxels;
@@ -208,18 +250,81 @@ struct world_chunk
 /* CAssert(sizeof(world_chunk) == CACHE_LINE_SIZE); */
 #pragma pack(pop)
 
+// NOTE(Jesse): The buffers chunk init needs every time it runs, kept per
+// thread and reused from job to job instead of coming out of temp memory.
+// Each thread builds its own out of its own arena, so the pages are first
+// touched by (and land on the node of) the core the thread is pinned to.
+struct boundary_voxels;
+struct chunk_scratch
+{
+  memory_arena *Memory;
+  b32 InUse;
+
+  chunk_dimension SynChunkDim;
+  world_chunk SyntheticChunk;
+
+  packed_chunk_mesh *PrimaryMesh;
+  untextured_3d_geometry_buffer *LodMesh;
+  packed_chunk_mesh *MipMesh;
+
+  boundary_voxels *BoundaryVoxels;
+
+  palette_lookup PaletteLookup;
+
+  // NOTE(Jesse): Jobs that got the scratch buffers, and times the buffers had
+  // to be allocated instead (building the scratch, or it wasn't available)
+  u32 Reuses;
+  u32 Allocations;
+};
+
+// NOTE(Jesse): What the chunk init stages (noise, mark, mesh, LOD) hand to
+// each other.  The synthetic chunk and the meshes in here are only valid until
+// the job ends; they're either in Scratch or in temp memory.  The LOD stage
+// can run on another thread; it only writes LodMesh and the LOD stats on
+// DestChunk.
+struct chunk_init_pipeline
+{
+  world_chunk *DestChunk;
+  chunk_dimension WorldChunkDim;
+  chunk_init_flags Flags;
+
+  // NOTE(Jesse): Zero if this thread's scratch wasn't available
+  chunk_scratch *Scratch;
+
+  world_chunk *SyntheticChunk;
+  chunk_dimension SynChunkDim;
+  u32 SyntheticChunkSum;
+
+  packed_chunk_mesh *PrimaryMesh;
+  packed_chunk_mesh *LodMesh;
+  untextured_3d_geometry_buffer *DebugMesh;
+
+  // NOTE(Jesse): Set by whoever ran the LOD stage, once it's done
+  volatile b32 LodDone;
+};
+
 struct picked_world_chunk
 {
   world_chunk *Chunk;
   r32 tChunk; // f32_MAX indicates not picked
 };
 
+// NOTE(Jesse): From RaycastVoxels, tChunk is how far along the ray the hit
+// voxel starts, and VoxelRelP is its center.
 struct picked_voxel
 {
   picked_world_chunk PickedChunk;
   v3 VoxelRelP; // Relative to origin of chunk
 };
 
+// NOTE(Jesse): Dir doesn't have to be normalized; MaxT is in multiples of it
+struct voxel_raycast
+{
+  canonical_position Origin;
+  v3 Dir;
+  r32 MaxT;
+};
+
 link_internal u32
 Volume(world_chunk* Chunk)
 {
@@ -228,20 +333,127 @@ Volume(world_chunk* Chunk)
   return Result;
 }
 
+// NOTE(Jesse): Returns the chunks voxels as a dense array; uniform chunks get
+// expanded into Temp.  For readers (the mesher, serialization) only; writes
+// to the result of a uniform chunk are lost.
+link_internal voxel *
+GetDenseChunkVoxels(world_chunk *Chunk, memory_arena *Temp)
+{
+  voxel *Result = Chunk->Voxels;
+  if (Result == 0)
+  {
+    u32 VoxelCount = Volume(Chunk);
+    Result = Allocate(voxel, Temp, VoxelCount);
+    for (u32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+    {
+      Result[VoxelIndex] = Chunk->UniformVoxel;
+    }
+  }
+  return Result;
+}
+
+struct pending_chunk_init
+{
+  world_chunk *Chunk;
+  r32 Priority; // NOTE(Jesse): Lower goes first
+};
+
+// NOTE(Jesse): Terrain beyond the visible region.  Nodes are world_chunks
+// that never keep their voxels; they're sampled straight from the noise every
+// Scale voxels, meshed, and the mesh scaled back up to world voxels relative
+// to WorldP.  See LOD_CLIPMAP_LEVEL_COUNT.
+struct lod_clipmap_node
+{
+  world_chunk Chunk;
+  s32 Scale;
+};
+
+struct lod_clipmap_level
+{
+  s32 Scale;
+
+  // NOTE(Jesse): World chunk positions the nodes cover this frame.  A node
+  // lives in the slot its position lands on modulo the grid, so only the
+  // nodes that fell off one side get rebuilt when the region moves.
+  rect3i Region;
+  lod_clipmap_node *Nodes;
+};
+
+// NOTE(Jesse): Has to match the noise the game initializes chunks with; see
+// Noise_FBM2D
+struct lod_clipmap_noise
+{
+  s32 Frequency;
+  s32 Amplitude;
+  s32 zMin;
+  u32 Octaves;
+};
+
+struct lod_clipmap
+{
+  lod_clipmap_noise Noise;
+  r32 MaxScreenError;
+
+  lod_clipmap_level Levels[LOD_CLIPMAP_LEVEL_COUNT];
+};
+
+// NOTE(Jesse): What GatherLodClipmap decided to draw; full resolution chunks
+// and nodes never overlap
+struct lod_clipmap_draw_list
+{
+  world_chunk **Chunks;
+  u32 ChunkCount;
+
+  lod_clipmap_node **Nodes;
+  u32 NodeCount;
+};
+
 enum world_flag
 {
   WorldFlag_WorldCenterFollowsCameraTarget = (1 << 0),
 };
 
+struct world_update_block;
 struct world
 {
+  // NOTE(Jesse): Open-addressed, Robin Hood probed.  HashSize is a power of two
   u32 HashSize;
-  world_chunk **ChunkHashMemory[2];
+  u32 ChunkCount;
   world_chunk **ChunkHash;
 
+  // NOTE(Jesse): Every chunk in ChunkHash packed densely, ChunkCount long.
+  // This is what gets walked for rendering, instead of looking up every
+  // position in the visible region.
+  world_chunk **ResidentChunks;
+
+  // NOTE(Jesse): The chunk positions UpdateWorldResidency populated last.
+  // When Center moves we only visit the slabs that entered and left.
+  rect3i ResidentRegion;
+
+  // NOTE(Jesse): Chunks that were evicted while a worker had them queued.
+  // They're freed once the worker lets go of them.
+  world_chunk **EvictedChunks;
+  u32 EvictedChunkCount;
+
+  // NOTE(Jesse): Where CollectUnusedChunks left off in ResidentChunks
+  u32 ResidentSweepCursor;
+
+  // NOTE(Jesse): Chunks waiting to be handed to a worker, kept as a min-heap
+  // on Priority, and the ones that have been handed out but aren't done.
+  // Both sets of chunks are flagged Chunk_Queued.
+  pending_chunk_init *PendingInits;
+  u32 PendingInitCount;
+
+  world_chunk **InFlightInits;
+  u32 InFlightInitCount;
+
   world_chunk **FreeChunks;
   umm FreeChunkCount;
 
+  // NOTE(Jesse): Dense voxel blocks released by uniform chunks
+  voxel **FreeVoxelBlocks;
+  umm FreeVoxelBlockCount;
+
   v3i Center;
   v3i VisibleRegion; // The number of chunks in xyz we're going to update and render
 
@@ -250,6 +462,13 @@ struct world
   memory_arena* Memory;
 
   world_flag Flags;
+
+  // NOTE(Jesse): Null unless the game called EnableLodClipmap
+  lod_clipmap *Clipmap;
+
+  // NOTE(Jesse): Every block QueueWorldUpdateForRegion has allocated, in
+  // flight or not.  Main thread only.
+  world_update_block *UpdateBlocks;
 };
 
 struct standing_spot
@@ -395,5 +614,42 @@ GetPermMeshForChunk(mesh_freelist*, u32, memory_arena*);
 link_internal untextured_3d_geometry_buffer*
 GetPermMeshForChunk(tiered_mesh_freelist*, u32 , memory_arena* );
 
+link_internal untextured_3d_geometry_buffer*
+GetPermMeshForChunk(tiered_mesh_freelist*, untextured_3d_geometry_buffer*, memory_arena* );
+
+link_internal untextured_3d_geometry_buffer*
+AllocateTempWorldChunkMesh(memory_arena* TempMemory);
+
+link_internal packed_chunk_mesh *
+GetPermPackedChunkMesh(packed_chunk_mesh_freelist *, u32 , memory_arena *);
+
+link_internal packed_chunk_mesh *
+AllocateTempPackedChunkMesh(memory_arena *TempMemory);
+
+link_internal void
+DeepCopy(packed_chunk_mesh *Src, packed_chunk_mesh *Dest);
+
+link_internal void
+InitPaletteLookup(palette_lookup *Lookup, v4 *Palette, u32 PaletteCount);
+
+link_internal void
+PackChunkMesh(palette_lookup *Lookup, untextured_3d_geometry_buffer *Src, packed_chunk_mesh *Dest);
+
+link_internal packed_chunk_mesh *
+ReplacePackedMesh(threadsafe_geometry_buffer *, world_chunk_mesh_bitfield , packed_chunk_mesh *, u64 );
+
+link_internal packed_chunk_mesh *
+AtomicReplacePackedMesh(threadsafe_geometry_buffer *, world_chunk_mesh_bitfield , packed_chunk_mesh *, u64 );
+
+inline u32
+GetWorldChunkHash(world_position P);
+
+link_internal void
+QueueChunkForWriteBack(work_queue *Queue, world_chunk *Chunk);
+
+link_internal void
+BuildWorldChunkMeshFromMarkedVoxels( voxel *Voxels, chunk_dimension SrcChunkDim, chunk_dimension SrcChunkMin, chunk_dimension SrcChunkMax,
+                                     packed_chunk_mesh *DestGeometry, memory_arena *TempMemory, v4* ColorPallette = DefaultPalette );
+
 /* link_internal untextured_3d_geometry_buffer * */
 /* SetMesh(world_chunk *Chunk, world_chunk_mesh_bitfield MeshBit, mesh_freelist *MeshFreelist, memory_arena *PermMemory); */
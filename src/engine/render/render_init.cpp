@@ -155,7 +155,7 @@ SetDrawBuffers(framebuffer *FBO)
 }
 
 shader
-CreateGbufferShader(memory_arena *GraphicsMemory, m4 *ViewProjection, camera *Camera)
+CreateGbufferShader(memory_arena *GraphicsMemory, m4 *ViewProjection, camera *Camera, texture *ColorPalette)
 {
   shader Shader = LoadShaders( CSz("gBuffer.vertexshader"), CSz("gBuffer.fragmentshader") );
 
@@ -173,6 +173,9 @@ CreateGbufferShader(memory_arena *GraphicsMemory, m4 *ViewProjection, camera *Ca
   *Current = GetUniform(GraphicsMemory, &Shader, &Camera->Frust.nearClip, "NearClip");
   Current = &(*Current)->Next;
 
+  *Current = GetUniform(GraphicsMemory, &Shader, ColorPalette, "ColorPalette");
+  Current = &(*Current)->Next;
+
   return Shader;
 }
 
@@ -284,6 +287,8 @@ InitializeShadowGroup(shadow_render_group *SG, memory_arena *GraphicsMemory, v2i
 
   SG->DepthShader = LoadShaders( CSz("DepthRTT.vertexshader"), CSz("DepthRTT.fragmentshader") );
   SG->MVP_ID = GetShaderUniform(&SG->DepthShader, "depthMVP");
+  SG->ChunkBasis_ID = GetShaderUniform(&SG->DepthShader, "ChunkBasis");
+  SG->UsePackedVertices_ID = GetShaderUniform(&SG->DepthShader, "UsePackedVertices");
 
   AssertNoGlErrors;
 
@@ -352,8 +357,13 @@ GraphicsInit(memory_arena *GraphicsMemory)
   Result->Camera = Allocate(camera, GraphicsMemory, 1);
   StandardCamera(Result->Camera, 1000.f, 600.f, {});
 
-  AllocateGpuElementBuffer(Result->GpuBuffers + 0, (u32)Megabytes(32));
-  AllocateGpuElementBuffer(Result->GpuBuffers + 1, (u32)Megabytes(32));
+  // NOTE(Jesse): World chunks live in the ChunkBuffer, so these only have to
+  // hold entities, particles and debug geometry.
+  AllocateGpuElementBuffer(Result->GpuBuffers + 0, (u32)Megabytes(8));
+  AllocateGpuElementBuffer(Result->GpuBuffers + 1, (u32)Megabytes(8));
+
+  AllocateGpuChunkBuffer(&Result->ChunkBuffer, (u32)GPU_CHUNK_BUFFER_ELEMENTS, GraphicsMemory);
+  Result->Occlusion = AllocateOcclusionBuffer(GraphicsMemory);
 
   /* MapGpuElementBuffer(Result->GpuBuffers+0); */
   /* FlushBuffersToCard(Result->GpuBuffers+0); */
@@ -402,7 +412,10 @@ GraphicsInit(memory_arena *GraphicsMemory)
                        &SG->Sun.Position, &SG->Sun.Color);
 
   gBuffer->gBufferShader =
-    CreateGbufferShader(GraphicsMemory, &gBuffer->ViewProjection, Result->Camera);
+    CreateGbufferShader(GraphicsMemory, &gBuffer->ViewProjection, Result->Camera, Result->ChunkBuffer.PaletteTexture);
+
+  gBuffer->ChunkBasisUniform = GetShaderUniform(&gBuffer->gBufferShader, "ChunkBasis");
+  gBuffer->UsePackedVerticesUniform = GetShaderUniform(&gBuffer->gBufferShader, "UsePackedVertices");
 
   AoGroup->Shader =
     MakeSsaoShader(GraphicsMemory, gBuffer->Textures, SsaoNoiseTexture,
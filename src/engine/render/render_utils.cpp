@@ -15,6 +15,12 @@ global_variable m4 NdcToScreenSpace =
   GL.DrawArrays(GL_TRIANGLES, 0, (s32)VertexCount);  \
   END_BLOCK(); } while (0)
 
+#define DrawQuads(QuadCount) do {                                               \
+  TIMED_BLOCK("DrawQuads");                                                     \
+  DEBUG_TRACK_DRAW_CALL(__FUNCTION__, (QuadCount)*4);                           \
+  GL.DrawElements(GL_TRIANGLES, (s32)((QuadCount)*6), GL_UNSIGNED_SHORT, (void*)0); \
+  END_BLOCK(); } while (0)
+
 v3
 Unproject(v2 ScreenP, r32 ClipZDepth, v2 ScreenDim, m4 *InvViewProj)
 {
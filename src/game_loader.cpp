@@ -37,6 +37,40 @@ LibIsNew(const char *LibPath, s64 *LastLibTime)
   return Result;
 }
 
+#if _WIN32
+link_internal b32
+PlatformPinThreadToCore(u32 CoreIndex)
+{
+  b32 Result = False;
+  if (CoreIndex < 64)
+  {
+    Result = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << CoreIndex) != 0;
+  }
+  return Result;
+}
+#elif __linux__
+#include <pthread.h>
+#include <sched.h>
+
+link_internal b32
+PlatformPinThreadToCore(u32 CoreIndex)
+{
+  cpu_set_t Set;
+  CPU_ZERO(&Set);
+  CPU_SET(CoreIndex, &Set);
+
+  b32 Result = pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set) == 0;
+  return Result;
+}
+#else
+// NOTE(Jesse): macOS only takes affinity hints, so don't bother
+link_internal b32
+PlatformPinThreadToCore(u32 CoreIndex)
+{
+  return False;
+}
+#endif
+
 link_internal THREAD_MAIN_RETURN
 ThreadMain(void *Input)
 {
@@ -49,41 +83,49 @@ ThreadMain(void *Input)
   thread_local_state *Thread = GetThreadLocalState(ThreadLocal_ThreadIndex);
   /* Assert(Thread == ThreadParams->ThreadLocalState); */
 
+#if PIN_WORKER_THREADS
+  // NOTE(Jesse): Has to happen before this thread touches any of the memory
+  // it keeps for itself (the chunk scratch), so that memory is allocated on
+  // the node this core is on.  Core 0 is left for the main thread.
+  u32 CoreIndex = u32(ThreadParams->ThreadIndex) % PlatformGetLogicalCoreCount();
+  if (!PlatformPinThreadToCore(CoreIndex))
+  {
+    Info("Couldn't pin worker (%d) to core (%u)", ThreadParams->ThreadIndex, CoreIndex);
+  }
+#endif
+
   DEBUG_REGISTER_THREAD(ThreadParams);
 
   if (ThreadParams->InitProc) { ThreadParams->InitProc(Global_ThreadStates, ThreadParams->ThreadIndex); }
 
   while (FutexNotSignaled(ThreadParams->WorkerThreadsExitFutex))
   {
-#if 0
-    // This is a pointer to a single semaphore for all queues, so only sleeping
-    // on one is sufficient, and equal to sleeping on all, because they all
-    // point to the same semaphore
-    ThreadSleep( ThreadParams->HighPriority->GlobalQueueSemaphore );
-#else
+    // NOTE(Jesse): Workers sleep on Global_WorkerParking when there's nothing
+    // for them, and whoever pushes a job wakes them
     for (;;)
     {
       WORKER_THREAD_ADVANCE_DEBUG_SYSTEM();
 
       /* TIMED_NAMED_BLOCK("CheckForWorkAndSleep"); */
 
-      if (!QueueIsEmpty(ThreadParams->HighPriority)) break;
-
-      if ( ! FutexIsSignaled(ThreadParams->HighPriorityModeFutex) &&
-           ! QueueIsEmpty(ThreadParams->LowPriority) ) break;
+      if (WorkerHasWork(ThreadParams)) break;
 
-      if ( FutexIsSignaled(ThreadParams->WorkerThreadsSuspendFutex) ) break;
-
-      if ( FutexIsSignaled(ThreadParams->WorkerThreadsExitFutex) ) break;
-
-      SleepMs(1);
+      ParkWorker(ThreadParams);
     }
-#endif
 
     WaitOnFutex(ThreadParams->WorkerThreadsSuspendFutex);
 
+    // NOTE(Jesse): High priority jobs we push land on our own deque, and we
+    // stay counted until it's empty, so WaitForWorkerThreads still means every
+    // high priority job is done.
     AtomicIncrement(ThreadParams->HighPriorityWorkerCount);
-    DrainQueue( ThreadParams->HighPriority, Thread, GameWorkerThreadCallback );
+    {
+      work_queue_entry Entry;
+      while (GetNextWorkerJob(ThreadParams, ThreadParams->HighPriority, True, &Entry))
+      {
+        RunWorkQueueEntry(&Entry, Thread, GameWorkerThreadCallback);
+      }
+    }
     AtomicDecrement(ThreadParams->HighPriorityWorkerCount);
 
 #if 1
@@ -105,6 +147,7 @@ ThreadMain(void *Input)
       WORKER_THREAD_ADVANCE_DEBUG_SYSTEM();
 
       if ( ! QueueIsEmpty(ThreadParams->HighPriority)) break;
+      if ( ! WorkStealingDequeIsEmpty(&ThreadParams->HighPriorityDeque)) break;
 
       if ( FutexIsSignaled(ThreadParams->HighPriorityModeFutex) ) break;
 
@@ -112,22 +155,14 @@ ThreadMain(void *Input)
 
       if ( FutexIsSignaled(ThreadParams->WorkerThreadsSuspendFutex) ) break;
 
-      // NOTE(Jesse): Must read and comared DequeueIndex instead of calling QueueIsEmpty
-      u32 DequeueIndex = LowPriority->DequeueIndex;
-      if (DequeueIndex == LowPriority->EnqueueIndex)
+      work_queue_entry Entry;
+      if (!GetNextWorkerJob(ThreadParams, LowPriority, False, &Entry))
       {
         break;
       }
 
-      b32 Exchanged = AtomicCompareExchange( &LowPriority->DequeueIndex,
-                                              GetNextQueueIndex(DequeueIndex),
-                                              DequeueIndex );
-      if ( Exchanged )
-      {
-        volatile work_queue_entry *Entry = LowPriority->Entries+DequeueIndex;
-        GameWorkerThreadCallback(Entry, Thread);
-        Ensure( RewindArena(Thread->TempMemory) );
-      }
+      RunWorkQueueEntry(&Entry, Thread, GameWorkerThreadCallback);
+      Ensure( RewindArena(Thread->TempMemory) );
     }
   }
 
@@ -136,6 +171,15 @@ ThreadMain(void *Input)
   return 0;
 }
 
+// NOTE(Jesse): Parked workers don't look at the futex until they're woken
+link_internal void
+SignalAndWaitForParkedWorkers(bonsai_futex *Futex)
+{
+  SignalFutex(Futex);
+  WakeAllParkedWorkers(Global_WorkerParking);
+  SignalAndWaitForWorkers(Futex);
+}
+
 link_internal void
 LaunchWorkerThreads(platform *Plat, engine_resources *EngineResources, bonsai_worker_thread_init_callback WorkerThreadInit, bonsai_worker_thread_callback WorkerThreadCallback)
 {
@@ -161,6 +205,8 @@ LaunchWorkerThreads(platform *Plat, engine_resources *EngineResources, bonsai_wo
     Params->ThreadIndex = ThreadIndex;
     Params->HighPriority = &Plat->HighPriority;
     Params->LowPriority = &Plat->LowPriority;
+    Params->AllThreads = Plat->Threads;
+    Params->Parking = Global_WorkerParking;
     Params->InitProc = WorkerThreadInit;
     Params->GameWorkerThreadCallback = WorkerThreadCallback;
     Params->EngineResources = EngineResources;
@@ -192,7 +238,21 @@ PlatformInit(platform *Plat, memory_arena *Memory)
   InitQueue(&Plat->LowPriority, Plat->Memory); //, &Plat->QueueSemaphore);
   InitQueue(&Plat->HighPriority, Plat->Memory); //, &Plat->QueueSemaphore);
 
-  Plat->Threads = Allocate(thread_startup_params, Plat->Memory, TotalThreadCount);
+  Plat->Threads = AllocateAligned(thread_startup_params, Plat->Memory, TotalThreadCount, CACHE_LINE_SIZE);
+
+  Global_WorkerParking = AllocateAligned(worker_parking, Plat->Memory, 1, CACHE_LINE_SIZE);
+  InitWorkerParking(Global_WorkerParking);
+
+  // NOTE(Jesse): The main thread (index 0) doesn't get deques; what it pushes
+  // goes straight to the shared queues
+  for ( s32 ThreadIndex = 1;
+            ThreadIndex < TotalThreadCount;
+          ++ThreadIndex )
+  {
+    thread_startup_params *Params = Plat->Threads + ThreadIndex;
+    InitWorkStealingDeque(&Params->LowPriorityDeque, Plat->Memory);
+    InitWorkStealingDeque(&Params->HighPriorityDeque, Plat->Memory);
+  }
 
 #if BONSAI_NETWORK_IMPLEMENTATION
   Plat->ServerState = ServerInit(GameMemory);
@@ -330,6 +390,7 @@ main( s32 ArgCount, const char ** Args )
   DEBUG_REGISTER_NAMED_ARENA(TranArena, 0, "game_loader TranArena");
 
   PlatformInit(&Plat, PlatMemory);
+  EngineResources.WorkerParking = Global_WorkerParking;
 
 #if BONSAI_INTERNAL
   // debug_recording_state *Debug_RecordingState = Allocate(debug_recording_state, GameMemory, 1);
@@ -365,6 +426,8 @@ main( s32 ArgCount, const char ** Args )
   engine_api EngineApi = {};
   if (!InitializeEngineApi(&EngineApi, GameLib)) { Error("Initializing EngineApi :( "); return 1; }
 
+  EngineResources.GameWorkerThreadCallback = GameApi.WorkerMain;
+
   Ensure( EngineApi.OnLibraryLoad(&EngineResources) );
   Ensure( EngineApi.Init(&EngineResources) );
 
@@ -416,13 +479,14 @@ main( s32 ArgCount, const char ** Args )
     if ( LibIsNew(GameLibName, &LastGameLibTime) )
     {
       Info("Reloading Game Lib");
-      SignalAndWaitForWorkers(&Plat.WorkerThreadsSuspendFutex);
+      SignalAndWaitForParkedWorkers(&Plat.WorkerThreadsSuspendFutex);
 
       CloseLibrary(GameLib);
       GameLib = OpenLibrary(GameLibName);
 
       Ensure(InitializeEngineApi(&EngineApi, GameLib));
       Ensure(InitializeGameApi(&GameApi, GameLib));
+      EngineResources.GameWorkerThreadCallback = GameApi.WorkerMain;
 
       Ensure( EngineApi.OnLibraryLoad(&EngineResources) );
 
@@ -433,7 +497,7 @@ main( s32 ArgCount, const char ** Args )
 #if DEBUG_SYSTEM_API
     if ( LibIsNew(DEFAULT_DEBUG_LIB, &LastDebugLibTime) )
     {
-      SignalAndWaitForWorkers(&Plat.WorkerThreadsSuspendFutex);
+      SignalAndWaitForParkedWorkers(&Plat.WorkerThreadsSuspendFutex);
 
       debug_state *Cached = Global_DebugStatePointer;
       Global_DebugStatePointer = 0;
@@ -485,8 +549,16 @@ main( s32 ArgCount, const char ** Args )
 
     Ensure( EngineApi.FrameEnd(&EngineResources) );
 
+    // NOTE(Jesse): FrameJobs is the real join; the drain and wait catch
+    // anything the game pushed without counting it.
+    WaitForWorkCounter(&EngineResources.FrameJobs, &Plat.HighPriority, &MainThread, GameApi.WorkerMain);
     DrainQueue(&Plat.HighPriority, &MainThread,GameApi.WorkerMain);
     WaitForWorkerThreads(&Plat.HighPriorityWorkerCount);
+    UnsignalFutex(&Plat.HighPriorityModeFutex);
+
+    // NOTE(Jesse): Low priority jobs pushed during the frame didn't wake
+    // anyone for good, since they weren't allowed to run yet
+    if (!QueueIsEmpty(&Plat.LowPriority)) { WakeAllParkedWorkers(Global_WorkerParking); }
 
     Ensure( EngineApi.Render(&EngineResources) );
 
@@ -531,9 +603,12 @@ main( s32 ArgCount, const char ** Args )
 
   Info("Shutting Down");
 
-  SignalAndWaitForWorkers(&Plat.WorkerThreadsExitFutex);
+  SignalAndWaitForParkedWorkers(&Plat.WorkerThreadsExitFutex);
   UnsignalFutex(&Plat.WorkerThreadsExitFutex);
 
+  PrintWorkerWakeLatency(&Plat);
+  PrintChunkScratchStats(&Plat);
+
   Terminate(&Os, &Plat);
 
   Info("Exiting");
@@ -67,6 +67,445 @@ TestChunkCopy(memory_arena *Memory)
   }
 }
 
+link_internal void
+FillRandomVoxels(random_series *Entropy, voxel *Voxels, s32 VoxelCount)
+{
+  for (s32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+  {
+    u32 Bits = RandomU32(Entropy);
+
+    // NOTE(Jesse): Unfilled voxels must not carry face flags, but filled ones
+    // can have any garbage in them; marking is supposed to overwrite it.
+    u8 Flags = (Bits & 1) ? u8(Voxel_Filled | ((Bits >> 8) & 0xfe)) : u8((Bits >> 8) & Voxel_MarkBit);
+
+    Voxels[VoxelIndex].Flags = Flags;
+    Voxels[VoxelIndex].Color = u8(Bits >> 16);
+  }
+}
+
+link_internal b32
+VoxelsAreEqual(voxel *A, voxel *B, s32 VoxelCount)
+{
+  b32 Result = True;
+  for (s32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+  {
+    Result &= (A[VoxelIndex] == B[VoxelIndex]);
+  }
+  return Result;
+}
+
+void
+TestMarkBoundaryVoxels(memory_arena *Memory)
+{
+  random_series Entropy = {54392};
+
+  for (u32 Iteration = 0; Iteration < 64; ++Iteration)
+  {
+    chunk_dimension Dim = Voxel_Position( s32(1 + RandomU32(&Entropy) % 70),
+                                          s32(1 + RandomU32(&Entropy) % 20),
+                                          s32(1 + RandomU32(&Entropy) % 20) );
+
+    chunk_dimension MinP = Voxel_Position( s32(RandomU32(&Entropy) % 3),
+                                           s32(RandomU32(&Entropy) % 3),
+                                           s32(RandomU32(&Entropy) % 3) );
+
+    chunk_dimension MaxP = Dim - Voxel_Position( s32(RandomU32(&Entropy) % 3), s32(RandomU32(&Entropy) % 3), 0 );
+
+    s32 VoxelCount = s32(Volume(Dim));
+
+    voxel *Reference = Allocate(voxel, Memory, VoxelCount);
+    voxel *Vectorized = Allocate(voxel, Memory, VoxelCount);
+
+    FillRandomVoxels(&Entropy, Reference, VoxelCount);
+    MemCopy((u8*)Reference, (u8*)Vectorized, umm(VoxelCount)*sizeof(voxel));
+
+    MarkBoundaryVoxels_MakeExteriorFaces_Scalar(Reference, Dim, MinP, MaxP);
+    MarkBoundaryVoxels_MakeExteriorFaces(Vectorized, Dim, MinP, MaxP);
+    TestThat( VoxelsAreEqual(Reference, Vectorized, VoxelCount) );
+
+    FillRandomVoxels(&Entropy, Reference, VoxelCount);
+    MemCopy((u8*)Reference, (u8*)Vectorized, umm(VoxelCount)*sizeof(voxel));
+
+    MarkBoundaryVoxels_NoExteriorFaces_Scalar(Reference, Dim, MinP, MaxP);
+    MarkBoundaryVoxels_NoExteriorFaces(Vectorized, Dim, MinP, MaxP);
+    TestThat( VoxelsAreEqual(Reference, Vectorized, VoxelCount) );
+  }
+}
+
+// NOTE(Jesse): Which quad covers each (face, voxel) of a mesh, so the output of
+// two meshers can be compared without caring what order the quads came out in
+struct mesher_quad_cell
+{
+  u64 Quad;
+  v3 Color;
+};
+
+link_internal u32
+GetMesherTestFaceIndex(v3 Normal)
+{
+  u32 Result = 0;
+  for (u32 Axis = 0; Axis < 3; ++Axis)
+  {
+    if (Normal.E[Axis] != 0.f) { Result = (Axis*2) + (Normal.E[Axis] < 0.f); }
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Returns False if a quad lands outside the mesh or on top of
+// another one
+link_internal b32
+RasterizeMeshQuads(untextured_3d_geometry_buffer *Mesh, chunk_dimension MeshDim, mesher_quad_cell *Cells)
+{
+  b32 Result = (Mesh->At % VERTS_PER_FACE) == 0;
+
+  s32 CellsPerFace = Volume(MeshDim);
+  for (u32 FaceBase = 0; Result && FaceBase < Mesh->At; FaceBase += VERTS_PER_FACE)
+  {
+    v3 MinP = Mesh->Verts[FaceBase];
+    v3 MaxP = MinP;
+    for (u32 VertIndex = FaceBase+1; VertIndex < FaceBase+VERTS_PER_FACE; ++VertIndex)
+    {
+      MinP = Min(MinP, Mesh->Verts[VertIndex]);
+      MaxP = Max(MaxP, Mesh->Verts[VertIndex]);
+    }
+
+    v3 Normal = Mesh->Normals[FaceBase];
+    u32 FaceIndex = GetMesherTestFaceIndex(Normal);
+    u32 Axis = FaceIndex/2;
+
+    // NOTE(Jesse): Faces on the positive side of a voxel sit on its far edge
+    voxel_position MinCell = Voxel_Position(MinP);
+    voxel_position MaxCell = Voxel_Position(MaxP);
+    if (Normal.E[Axis] > 0.f) { MinCell.E[Axis] -= 1; }
+    else                      { MaxCell.E[Axis] += 1; }
+
+    u64 Key = u64(FaceIndex+1);
+    for (u32 KeyAxis = 0; KeyAxis < 3; ++KeyAxis)
+    {
+      Key |= u64(MinCell.E[KeyAxis]) << (8 + (KeyAxis*8));
+      Key |= u64(MaxCell.E[KeyAxis]) << (32 + (KeyAxis*8));
+    }
+
+    for (s32 z = MinCell.z; Result && z < MaxCell.z; ++z)
+    {
+      for (s32 y = MinCell.y; Result && y < MaxCell.y; ++y)
+      {
+        for (s32 x = MinCell.x; Result && x < MaxCell.x; ++x)
+        {
+          voxel_position P = Voxel_Position(x,y,z);
+          Result = IsInsideDim(MeshDim, P);
+          if (Result)
+          {
+            mesher_quad_cell *Cell = Cells + (s32(FaceIndex)*CellsPerFace) + GetIndex(P, MeshDim);
+            Result = Cell->Quad == 0;
+            Cell->Quad = Key;
+            Cell->Color = Mesh->Colors[FaceBase].rgb;
+          }
+        }
+      }
+    }
+  }
+
+  return Result;
+}
+
+link_internal b32
+PackedVertMatches(packed_chunk_vertex *Vert, untextured_3d_geometry_buffer *Mesh, u32 VertIndex)
+{
+  v3 P = Mesh->Verts[VertIndex];
+  b32 Result = Vert->X == PackChunkVertexComponent(P.x) &&
+               Vert->Y == PackChunkVertexComponent(P.y) &&
+               Vert->Z == PackChunkVertexComponent(P.z) &&
+               (Vert->NormalAndColor >> 8) == GetPackedNormalIndex(Mesh->Normals[VertIndex]) &&
+               GetColorData(DefaultPalette, Vert->NormalAndColor & 0xff).rgb == Mesh->Colors[VertIndex].rgb;
+  return Result;
+}
+
+// NOTE(Jesse): True if packed verts A, B, C are the float triangle starting
+// at VertIndex, starting from any of its corners
+link_internal b32
+PackedTriangleMatches(packed_chunk_vertex *A, packed_chunk_vertex *B, packed_chunk_vertex *C, untextured_3d_geometry_buffer *Mesh, u32 VertIndex)
+{
+  b32 Result = False;
+  for (u32 Rotation = 0; Result == False && Rotation < 3; ++Rotation)
+  {
+    Result = PackedVertMatches(A, Mesh, VertIndex + ((Rotation+0)%3)) &&
+             PackedVertMatches(B, Mesh, VertIndex + ((Rotation+1)%3)) &&
+             PackedVertMatches(C, Mesh, VertIndex + ((Rotation+2)%3));
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Checks the packed mesh, drawn with the quad indices, is the
+// same triangles as the float one the same mesher built
+link_internal b32
+PackedMeshMatches(packed_chunk_mesh *Packed, untextured_3d_geometry_buffer *Mesh)
+{
+  b32 Result = Packed->QuadCount*VERTS_PER_FACE == Mesh->At &&
+               Packed->At == Packed->QuadCount*4;
+
+  for (u32 QuadIndex = 0; Result && QuadIndex < Packed->QuadCount; ++QuadIndex)
+  {
+    packed_chunk_vertex *Q = Packed->Verts + (QuadIndex*4);
+    u32 FaceBase = QuadIndex*VERTS_PER_FACE;
+    Result = PackedTriangleMatches(Q+0, Q+1, Q+2, Mesh, FaceBase) &&
+             PackedTriangleMatches(Q+2, Q+1, Q+3, Mesh, FaceBase+3);
+  }
+
+  return Result;
+}
+
+enum mesher_test_shape
+{
+  MesherTestShape_Empty,
+  MesherTestShape_Solid,
+  MesherTestShape_Checkerboard,
+  MesherTestShape_Terrain,
+  MesherTestShape_Noise,
+  MesherTestShape_Swiss,
+
+  MesherTestShape_Count,
+};
+
+link_internal void
+FillMesherTestVoxels(random_series *Entropy, voxel *Voxels, chunk_dimension Dim, mesher_test_shape Shape)
+{
+  for (s32 z = 0; z < Dim.z; ++z)
+  {
+    for (s32 y = 0; y < Dim.y; ++y)
+    {
+      for (s32 x = 0; x < Dim.x; ++x)
+      {
+        b32 Filled = False;
+        u8 Color = GRASS_GREEN;
+
+        switch (Shape)
+        {
+          case MesherTestShape_Empty: {} break;
+
+          case MesherTestShape_Solid: { Filled = True; } break;
+
+          case MesherTestShape_Checkerboard: { Filled = ((x+y+z) & 1) == 0; } break;
+
+          // NOTE(Jesse): Steps that are 4 voxels across, banded in color by height
+          case MesherTestShape_Terrain:
+          {
+            s32 Height = (((x/4)*7 + (y/4)*3) % (Dim.z+1));
+            Filled = z < Height;
+            Color = u8(GRASS_GREEN + (z/3)%3);
+          } break;
+
+          // NOTE(Jesse): Half full, in two colors
+          case MesherTestShape_Noise:
+          {
+            u32 Bits = RandomU32(Entropy);
+            Filled = Bits & 1;
+            Color = u8(GRASS_GREEN + ((Bits >> 1) & 1));
+          } break;
+
+          // NOTE(Jesse): Mostly full, one color, so the runs are long and
+          // get broken up in awkward places
+          case MesherTestShape_Swiss:
+          {
+            Filled = (RandomU32(Entropy) % 16) != 0;
+          } break;
+
+          InvalidCase(MesherTestShape_Count);
+        }
+
+        voxel *V = Voxels + GetIndex(Voxel_Position(x,y,z), Dim);
+        V->Flags = Filled ? Voxel_Filled : Voxel_Empty;
+        V->Color = Filled ? Color : 0;
+      }
+    }
+  }
+}
+
+link_internal u32
+CountMarkedFaces(voxel *Voxels, s32 VoxelCount)
+{
+  u32 Result = 0;
+  for (s32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+  {
+    Result += CountBitsSet_Kernighan(u32(Voxels[VoxelIndex].Flags & VoxelFaceMask));
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Meshes the same marked voxels with both meshers and checks they
+// produce the same quads.  Accumulates how long each one took into Cycles.
+link_internal void
+TestMesherEquivalence(random_series *Entropy, chunk_dimension Dim, mesher_test_shape Shape, b32 Apron, u64 *Cycles)
+{
+  memory_arena *Memory = GetTranArena();
+
+  s32 VoxelCount = Volume(Dim);
+  voxel *Voxels = Allocate(voxel, Memory, VoxelCount);
+  FillMesherTestVoxels(Entropy, Voxels, Dim, Shape);
+
+  // NOTE(Jesse): With an apron we mesh the inside of the voxels like a world
+  // chunk does, otherwise all of them like a model does
+  chunk_dimension MinP = Apron ? Voxel_Position(1) : Voxel_Position(0);
+  chunk_dimension MaxP = Apron ? Dim - Voxel_Position(1) : Dim;
+  if (Apron)
+  {
+    MarkBoundaryVoxels_NoExteriorFaces(Voxels, Dim, {}, Dim);
+  }
+  else
+  {
+    MarkBoundaryVoxels_MakeExteriorFaces(Voxels, Dim, {}, Dim);
+  }
+
+  chunk_dimension MeshDim = MaxP - MinP;
+  u32 MaxVerts = (CountMarkedFaces(Voxels, VoxelCount)+1)*VERTS_PER_FACE;
+
+  untextured_3d_geometry_buffer *Greedy = AllocateMesh(Memory, MaxVerts);
+  untextured_3d_geometry_buffer *Binary = AllocateMesh(Memory, MaxVerts);
+
+  u64 Start = __rdtsc();
+  BuildWorldChunkMeshFromMarkedVoxels_Greedy(Voxels, Dim, MinP, MaxP, Greedy, Memory);
+  Cycles[ChunkMesher_Greedy] += __rdtsc() - Start;
+
+  Start = __rdtsc();
+  BuildWorldChunkMeshFromMarkedVoxels_BinaryGreedy(Voxels, Dim, MinP, MaxP, Binary, Memory);
+  Cycles[ChunkMesher_BinaryGreedy] += __rdtsc() - Start;
+
+  s32 CellCount = 6*Volume(MeshDim);
+  mesher_quad_cell *GreedyCells = Allocate(mesher_quad_cell, Memory, CellCount);
+  mesher_quad_cell *BinaryCells = Allocate(mesher_quad_cell, Memory, CellCount);
+
+  TestThat( Greedy->At == Binary->At );
+  TestThat( RasterizeMeshQuads(Greedy, MeshDim, GreedyCells) );
+  TestThat( RasterizeMeshQuads(Binary, MeshDim, BinaryCells) );
+
+  u32 Mismatches = 0;
+  for (s32 CellIndex = 0; CellIndex < CellCount; ++CellIndex)
+  {
+    Mismatches += GreedyCells[CellIndex].Quad != BinaryCells[CellIndex].Quad ||
+                  !(GreedyCells[CellIndex].Color == BinaryCells[CellIndex].Color);
+  }
+  TestThat( Mismatches == 0 );
+
+  // NOTE(Jesse): World chunks get meshed straight into packed meshes
+  {
+    packed_chunk_mesh *Packed = AllocatePackedChunkMesh(Memory, MaxVerts);
+    BuildWorldChunkMeshFromMarkedVoxels_BinaryGreedy(Voxels, Dim, MinP, MaxP, Packed, Memory);
+    TestThat( PackedMeshMatches(Packed, Binary) );
+
+    // NOTE(Jesse): Smooth LODs and meshes out of records get packed after the
+    // fact, as triangles
+    palette_lookup *Lookup = Allocate(palette_lookup, Memory, 1);
+    InitPaletteLookup(Lookup, DefaultPalette, ArrayCount(DefaultPalette));
+
+    packed_chunk_mesh *Repacked = AllocatePackedChunkMesh(Memory, MaxVerts);
+    PackChunkMesh(Lookup, Binary, Repacked);
+    TestThat( Repacked->At == Binary->At && Repacked->QuadCount == 0 );
+
+    u32 RepackMismatches = 0;
+    for (u32 VertIndex = 0; VertIndex < Repacked->At; ++VertIndex)
+    {
+      RepackMismatches += !PackedVertMatches(Repacked->Verts + VertIndex, Binary, VertIndex);
+    }
+    TestThat( RepackMismatches == 0 );
+  }
+
+  if (Shape == MesherTestShape_Empty) { TestThat(Greedy->At == 0); }
+
+  // NOTE(Jesse): A solid block without an apron is one quad per side
+  if (Shape == MesherTestShape_Solid && Apron == False) { TestThat(Binary->At == 6*VERTS_PER_FACE); }
+
+  RewindArena(Memory);
+}
+
+void
+TestBinaryGreedyMesher()
+{
+  random_series Entropy = {80085};
+
+  u64 Cycles[2] = {};
+
+  // NOTE(Jesse): Degenerate and awkward sizes, every shape, with and without
+  // an apron.  The meshed part can be up to BINARY_MESHER_MAX_DIM across.
+  chunk_dimension EdgeDims[] =
+  {
+    Chunk_Dimension(1, 1, 1),
+    Chunk_Dimension(3, 3, 3),
+    Chunk_Dimension(64, 1, 1),
+    Chunk_Dimension(1, 64, 1),
+    Chunk_Dimension(1, 1, 64),
+    Chunk_Dimension(17, 33, 5),
+    Chunk_Dimension(64, 64, 4),
+    Chunk_Dimension(66, 66, 6),
+  };
+
+  for (u32 DimIndex = 0; DimIndex < ArrayCount(EdgeDims); ++DimIndex)
+  {
+    chunk_dimension Dim = EdgeDims[DimIndex];
+    for (u32 Shape = 0; Shape < MesherTestShape_Count; ++Shape)
+    {
+      if (Dim <= Voxel_Position(BINARY_MESHER_MAX_DIM))
+      {
+        TestMesherEquivalence(&Entropy, Dim, mesher_test_shape(Shape), False, Cycles);
+      }
+
+      if (Dim >= Voxel_Position(3))
+      {
+        TestMesherEquivalence(&Entropy, Dim, mesher_test_shape(Shape), True, Cycles);
+      }
+    }
+  }
+
+  for (u32 Iteration = 0; Iteration < 64; ++Iteration)
+  {
+    chunk_dimension Dim = Chunk_Dimension( s32(1 + RandomU32(&Entropy) % 64),
+                                           s32(1 + RandomU32(&Entropy) % 64),
+                                           s32(1 + RandomU32(&Entropy) % 16) );
+
+    mesher_test_shape Shape = mesher_test_shape(MesherTestShape_Terrain + (RandomU32(&Entropy) % 3));
+    TestMesherEquivalence(&Entropy, Dim, Shape, False, Cycles);
+  }
+
+  // NOTE(Jesse): World chunk sized, with the apron
+  Cycles[ChunkMesher_Greedy] = 0;
+  Cycles[ChunkMesher_BinaryGreedy] = 0;
+
+  u32 BenchCount = 32;
+  for (u32 Iteration = 0; Iteration < BenchCount; ++Iteration)
+  {
+    mesher_test_shape Shape = (Iteration & 1) ? MesherTestShape_Terrain : MesherTestShape_Swiss;
+    TestMesherEquivalence(&Entropy, Chunk_Dimension(34, 34, 36), Shape, True, Cycles);
+  }
+
+  DebugLine("Meshing (%u) 32x32x32 chunks", BenchCount);
+  DebugLine("  Greedy       : (%.0f) cycles/chunk", r64(Cycles[ChunkMesher_Greedy])/r64(BenchCount));
+  DebugLine("  BinaryGreedy : (%.0f) cycles/chunk", r64(Cycles[ChunkMesher_BinaryGreedy])/r64(BenchCount));
+}
+
+void
+TestBatchedPerlinNoise()
+{
+  random_series Entropy = {3453};
+
+  for (u32 Iteration = 0; Iteration < 4096; ++Iteration)
+  {
+    f32 InX[16], InY[16], InZ[16], Batched[16];
+    for (u32 Lane = 0; Lane < 16; ++Lane)
+    {
+      InX[Lane] = RandomBilateral(&Entropy)*1000.f;
+      InY[Lane] = RandomBilateral(&Entropy)*1000.f;
+      InZ[Lane] = RandomBilateral(&Entropy)*1000.f;
+    }
+
+    PerlinNoise_16x(InX, InY, InZ, Batched);
+
+    for (u32 Lane = 0; Lane < 16; ++Lane)
+    {
+      r32 Scalar = PerlinNoise(InX[Lane], InY[Lane], InZ[Lane]);
+      TestThat( Abs(Scalar - Batched[Lane]) < 0.0001f );
+    }
+  }
+}
+
 s32
 main(s32 ArgCount, const char** Args)
 {
@@ -75,6 +514,9 @@ main(s32 ArgCount, const char** Args)
   memory_arena *Memory = AllocateArena(Megabytes(32));
 
   TestChunkCopy(Memory);
+  TestMarkBoundaryVoxels(Memory);
+  TestBatchedPerlinNoise();
+  TestBinaryGreedyMesher();
 
   TestSuiteEnd();
 }
@@ -0,0 +1,280 @@
+
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+
+#define BENCH_CHUNK_COUNT (64)
+#define BENCH_DECODE_PASSES (8)
+
+// NOTE(Jesse): The v2 record, exactly as SerializeChunk used to write it, so
+// we have something to measure v3 against.
+
+link_internal u8 *
+LegacySerializeChunk_v2(world_chunk *Chunk, memory_arena *Memory, umm *RecordSize)
+{
+  world_chunk_file_header_v2 Header = MakeWorldChunkFileHeader_v2(Chunk);
+
+  umm MeshElementSize = umm(Header.VertexElementSize) + Header.ColorElementSize + Header.NormalElementSize;
+  umm MaxRecordSize = sizeof(Header) +
+                      sizeof(u32) + (Header.VoxelElementCount*Header.VoxelElementSize) +
+                      (3*sizeof(u32)) + (Header.MeshElementCount*MeshElementSize) +
+                      sizeof(u32) + (Header.StandingSpotElementCount*Header.StandingSpotElementSize);
+
+  u8 *Result = Allocate(u8, Memory, MaxRecordSize);
+  u8 *At = WriteChunkRecordBytes(Result, &Header, sizeof(Header));
+
+  At = WriteChunkRecordTag(At, WorldChunkFileTag_VOXD);
+  At = WriteChunkRecordBytes(At, Chunk->Voxels, Header.VoxelElementCount*Header.VoxelElementSize);
+
+  if (Header.MeshElementCount)
+  {
+    untextured_3d_geometry_buffer *Mesh = Chunk->Meshes.E[MeshIndex_Main];
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_VERT);
+    At = WriteChunkRecordBytes(At, Mesh->Verts, Header.MeshElementCount*Header.VertexElementSize);
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_COLO);
+    At = WriteChunkRecordBytes(At, Mesh->Colors, Header.MeshElementCount*Header.ColorElementSize);
+
+    At = WriteChunkRecordTag(At, WorldChunkFileTag_NORM);
+    At = WriteChunkRecordBytes(At, Mesh->Normals, Header.MeshElementCount*Header.NormalElementSize);
+  }
+
+  At = WriteChunkRecordTag(At, WorldChunkFileTag_SPOT);
+  At = WriteChunkRecordBytes(At, Chunk->StandingSpots.Start, Header.StandingSpotElementCount*Header.StandingSpotElementSize);
+
+  *RecordSize = umm(At-Result);
+  Assert(*RecordSize <= MaxRecordSize);
+  return Result;
+}
+
+// NOTE(Jesse): Rolling heightfield with a few colour bands, marked the same
+// way chunk init does it.  Meshed into a float mesh, since that's what records
+// store.
+link_internal void
+SynthesizeTerrainChunk(world_chunk *Chunk, memory_arena *Memory)
+{
+  chunk_dimension Dim = Chunk->Dim;
+  world_position P = Chunk->WorldP;
+
+  for (s32 y = 0; y < Dim.y; ++y)
+  {
+    for (s32 x = 0; x < Dim.x; ++x)
+    {
+      r32 WorldX = r32((P.x*Dim.x) + x);
+      r32 WorldY = r32((P.y*Dim.y) + y);
+      r32 Noise = PerlinNoise(WorldX/48.f, WorldY/48.f, 0.5f);
+      s32 Height = s32(Noise*r32(Dim.z*2)) - (P.z*Dim.z);
+
+      for (s32 z = 0; z < Dim.z && z < Height; ++z)
+      {
+        voxel *V = Chunk->Voxels + GetIndex(Voxel_Position(x, y, z), Dim);
+        V->Flags = Voxel_Filled;
+        V->Color = (z < Height-3) ? DARK_GREY : GRASS_GREEN;
+        ++Chunk->FilledCount;
+      }
+    }
+  }
+
+  MarkBoundaryVoxels_NoExteriorFaces(Chunk->Voxels, Dim, {}, Dim);
+  SetFlag(Chunk, Chunk_VoxelsInitialized);
+
+  if (Chunk->FilledCount)
+  {
+    untextured_3d_geometry_buffer *Mesh = AllocateTempWorldChunkMesh(Memory);
+    BuildWorldChunkMeshFromMarkedVoxels_Greedy(Chunk->Voxels, Dim, {}, Dim, Mesh, Memory);
+    if (Mesh->At)
+    {
+      Ensure( AtomicReplaceMesh(&Chunk->Meshes, MeshBit_Main, Mesh, Mesh->Timestamp) == 0 );
+    }
+  }
+}
+
+struct chunk_record
+{
+  u8 *Bytes;
+  umm Size;
+};
+
+link_internal void
+BenchmarkChunkRecords(const char *Name, chunk_record *Records, world_chunk **Chunks, u32 ChunkCount, memory_arena *Memory)
+{
+  u64 TotalBytes = 0;
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    TotalBytes += Records[ChunkIndex].Size;
+  }
+
+  world_chunk *Dest = AllocateWorldChunk(Memory, {}, Chunks[0]->Dim);
+
+  u64 DecodedBytes = 0;
+  r64 Start = GetHighPrecisionClock();
+  for (u32 Pass = 0; Pass < BENCH_DECODE_PASSES; ++Pass)
+  {
+    for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+    {
+      world_chunk_view View;
+      TestThat( ParseWorldChunkRecord(Records[ChunkIndex].Bytes, Records[ChunkIndex].Size, &View) );
+      TestThat( DeserializeChunk(&View, Dest, 0, Memory) );
+      DecodedBytes += View.VoxelElementCount*sizeof(voxel);
+
+      RewindArena(GetTranArena());
+    }
+  }
+  r64 ElapsedMs = GetHighPrecisionClock() - Start;
+
+  // NOTE(Jesse): Make sure we decoded the right thing while we're here
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk_view View;
+    TestThat( ParseWorldChunkRecord(Records[ChunkIndex].Bytes, Records[ChunkIndex].Size, &View) );
+    TestThat( DeserializeChunk(&View, Dest, 0, Memory) );
+
+    u32 VoxelCount = u32(Volume(Dest));
+    for (u32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+    {
+      TestThat( VoxelsAreIdentical(Dest->Voxels + VoxelIndex, Chunks[ChunkIndex]->Voxels + VoxelIndex) );
+    }
+
+    RewindArena(GetTranArena());
+  }
+
+  r64 MBPerSecond = (r64(DecodedBytes)/r64(Megabytes(1))) / Max(ElapsedMs/1000.0, 0.000001);
+  DebugLine("  %-16s : (%8.0f) bytes/chunk  decode (%8.2f) MB/s", Name, r64(TotalBytes)/r64(ChunkCount), MBPerSecond);
+}
+
+link_internal void
+BenchmarkChunkFormats(memory_arena *Memory)
+{
+  world_chunk *Chunks[BENCH_CHUNK_COUNT];
+  chunk_record V2[BENCH_CHUNK_COUNT];
+  chunk_record V3[BENCH_CHUNK_COUNT];
+  chunk_record V3NoMesh[BENCH_CHUNK_COUNT];
+
+  for (u32 ChunkIndex = 0; ChunkIndex < BENCH_CHUNK_COUNT; ++ChunkIndex)
+  {
+    world_position P = World_Position(s32(ChunkIndex % 8), s32(ChunkIndex / 8), s32(ChunkIndex % 2));
+    Chunks[ChunkIndex] = AllocateWorldChunk(Memory, P, Chunk_Dimension(32, 32, 32));
+    SynthesizeTerrainChunk(Chunks[ChunkIndex], Memory);
+
+    V2[ChunkIndex].Bytes       = LegacySerializeChunk_v2(Chunks[ChunkIndex], Memory, &V2[ChunkIndex].Size);
+    V3[ChunkIndex].Bytes       = SerializeChunk(Chunks[ChunkIndex], Memory, 0, &V3[ChunkIndex].Size);
+    V3NoMesh[ChunkIndex].Bytes = SerializeChunk(Chunks[ChunkIndex], Memory, WorldChunkFileFlag_MeshOmitted, &V3NoMesh[ChunkIndex].Size);
+
+    RewindArena(GetTranArena());
+  }
+
+  DebugLine("%u terrain chunks, 32x32x32", BENCH_CHUNK_COUNT);
+  BenchmarkChunkRecords("v2",              V2,       Chunks, BENCH_CHUNK_COUNT, Memory);
+  BenchmarkChunkRecords("v3",              V3,       Chunks, BENCH_CHUNK_COUNT, Memory);
+  BenchmarkChunkRecords("v3 (mesh omitted)", V3NoMesh, Chunks, BENCH_CHUNK_COUNT, Memory);
+
+  // NOTE(Jesse): What dropping the mesh costs on load
+  {
+    r64 Start = GetHighPrecisionClock();
+    for (u32 ChunkIndex = 0; ChunkIndex < BENCH_CHUNK_COUNT; ++ChunkIndex)
+    {
+      world_chunk *Chunk = Chunks[ChunkIndex];
+      packed_chunk_mesh *Mesh = AllocateTempPackedChunkMesh(GetTranArena());
+      BuildWorldChunkMeshFromMarkedVoxels(Chunk->Voxels, Chunk->Dim, {}, Chunk->Dim, Mesh, GetTranArena());
+
+      // NOTE(Jesse): Same faces as the stored mesh, at 4 verts apiece
+      u32 ExpectedQuads = HasMesh(&Chunk->Meshes, MeshBit_Main) ? Chunk->Meshes.E[MeshIndex_Main]->At/VERTS_PER_FACE : 0;
+      TestThat( Mesh->QuadCount == ExpectedQuads );
+      TestThat( Mesh->At == Mesh->QuadCount*4 );
+
+      RewindArena(GetTranArena());
+    }
+    r64 ElapsedMs = GetHighPrecisionClock() - Start;
+    DebugLine("  remesh on load    : (%8.3f) ms/chunk", ElapsedMs/r64(BENCH_CHUNK_COUNT));
+  }
+}
+
+link_internal void
+TestVoxelCodec(memory_arena *Memory)
+{
+  random_series Entropy = {7741};
+
+  for (u32 Iteration = 0; Iteration < 256; ++Iteration)
+  {
+    u32 VoxelCount = 1 + (RandomU32(&Entropy) % 4096);
+    voxel *Voxels = Allocate(voxel, Memory, VoxelCount);
+
+    // NOTE(Jesse): Runs of random length, some long, some a single voxel,
+    // so both packet kinds and every split point get exercised.
+    for (u32 VoxelIndex = 0; VoxelIndex < VoxelCount; )
+    {
+      u32 RunLength = 1 + (RandomU32(&Entropy) % ((RandomU32(&Entropy) & 1) ? 3 : 300));
+      voxel V = { u8(RandomU32(&Entropy) % 4), u8(RandomU32(&Entropy) % 3) };
+      for (u32 RunIndex = 0; RunIndex < RunLength && VoxelIndex < VoxelCount; ++RunIndex)
+      {
+        Voxels[VoxelIndex++] = V;
+      }
+    }
+
+    u8 *Encoded = Allocate(u8, Memory, GetEncodedVoxelByteCountBound(VoxelCount));
+    u32 EncodedByteCount = EncodeVoxels_RLE(Voxels, VoxelCount, Encoded);
+    TestThat( EncodedByteCount <= GetEncodedVoxelByteCountBound(VoxelCount) );
+    TestThat( (EncodedByteCount % sizeof(u32)) == 0 );
+
+    voxel *Decoded = Allocate(voxel, Memory, VoxelCount);
+    TestThat( DecodeVoxels_RLE(Encoded, EncodedByteCount, Decoded, VoxelCount) );
+
+    for (u32 VoxelIndex = 0; VoxelIndex < VoxelCount; ++VoxelIndex)
+    {
+      TestThat( VoxelsAreIdentical(Voxels + VoxelIndex, Decoded + VoxelIndex) );
+    }
+
+    // NOTE(Jesse): Truncated input must fail, not run off the end
+    if (EncodedByteCount > sizeof(u32))
+    {
+      TestThat( DecodeVoxels_RLE(Encoded, EncodedByteCount/2, Decoded, VoxelCount) == False );
+    }
+  }
+}
+
+link_internal void
+TestChunkRecordChecksum(memory_arena *Memory)
+{
+  world_chunk *Chunk = AllocateWorldChunk(Memory, World_Position(3, 1, 0), Chunk_Dimension(32, 32, 32));
+  SynthesizeTerrainChunk(Chunk, Memory);
+
+  umm RecordSize = 0;
+  u8 *Record = SerializeChunk(Chunk, Memory, 0, &RecordSize);
+
+  world_chunk_view View;
+  TestThat( ParseWorldChunkRecord(Record, RecordSize, &View) );
+  TestThat( View.Version == 3 );
+
+  random_series Entropy = {1204};
+  for (u32 Iteration = 0; Iteration < 64; ++Iteration)
+  {
+    umm ByteIndex = sizeof(world_chunk_file_header_v3) + (RandomU32(&Entropy) % (RecordSize - sizeof(world_chunk_file_header_v3)));
+    u8 Bit = u8(1 << (RandomU32(&Entropy) % 8));
+
+    Record[ByteIndex] ^= Bit;
+    TestThat( ParseWorldChunkRecord(Record, RecordSize, &View) == False );
+    Record[ByteIndex] ^= Bit;
+  }
+
+  TestThat( ParseWorldChunkRecord(Record, RecordSize, &View) );
+  TestThat( ParseWorldChunkRecord(Record, RecordSize-1, &View) == False );
+
+  RewindArena(GetTranArena());
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("ChunkFormat", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Gigabytes(1));
+
+  Global_ThreadStates = Initialize_ThreadLocal_ThreadStates((s32)GetTotalThreadCount(), 0, Memory);
+  SetThreadLocal_ThreadIndex(0);
+
+  TestVoxelCodec(Memory);
+  TestChunkRecordChecksum(Memory);
+  BenchmarkChunkFormats(Memory);
+
+  TestSuiteEnd();
+}
@@ -0,0 +1,375 @@
+
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+
+// NOTE(Jesse): The hash and linear probing the world used before the Robin
+// Hood table, kept here so we can compare against it.
+
+link_internal u32
+LegacyWorldChunkHash(world_position P, chunk_dimension VisibleRegion, u32 WorldHashSize)
+{
+  s32 WHS_Factor = (s32)WorldHashSize / (Volume(VisibleRegion))+1;
+
+  s32 xFactor = WHS_Factor;
+  s32 yFactor = WHS_Factor * VisibleRegion.x;
+  s32 zFactor = WHS_Factor * VisibleRegion.x * VisibleRegion.y;
+
+  u32 I = u32((P.x * xFactor) ^ (P.y * yFactor) ^ (P.z * zFactor));
+
+  u32 HashIndex = I % WorldHashSize;
+  return HashIndex;
+}
+
+struct legacy_chunk_hashtable
+{
+  world_chunk **Slots;
+  u32 HashSize;
+  chunk_dimension VisibleRegion;
+};
+
+link_internal u32
+LegacyInsert(legacy_chunk_hashtable *Table, world_chunk *Chunk)
+{
+  u32 Probes = 0;
+  u32 HashIndex = LegacyWorldChunkHash(Chunk->WorldP, Table->VisibleRegion, Table->HashSize);
+  while (Table->Slots[HashIndex])
+  {
+    HashIndex = (HashIndex + 1) % Table->HashSize;
+    ++Probes;
+  }
+  Table->Slots[HashIndex] = Chunk;
+  return Probes;
+}
+
+link_internal world_chunk *
+LegacyLookup(legacy_chunk_hashtable *Table, world_position P)
+{
+  u32 HashIndex = LegacyWorldChunkHash(P, Table->VisibleRegion, Table->HashSize);
+
+  world_chunk *Result = Table->Slots[HashIndex];
+  while (Result && Result->WorldP != P)
+  {
+    HashIndex = (HashIndex + 1) % Table->HashSize;
+    Result = Table->Slots[HashIndex];
+  }
+  return Result;
+}
+
+link_internal void
+BenchmarkChunkHashtables(memory_arena *Memory, chunk_dimension VisibleRegion)
+{
+  world_position Center = World_Position(37, -12, 3);
+  world_position Min = Center - VisibleRegion/2;
+
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  world_chunk *Chunks = Allocate(world_chunk, Memory, ChunkCount);
+
+  world World = {};
+  AllocateWorldChunkHashtable(&World, Memory, VisibleRegion);
+
+  legacy_chunk_hashtable Legacy = {};
+  Legacy.VisibleRegion = VisibleRegion;
+  Legacy.HashSize = ChunkCount*4;
+  Legacy.Slots = Allocate(world_chunk*, Memory, Legacy.HashSize);
+
+  u64 LegacyProbeSum = 0;
+  u32 LegacyProbeMax = 0;
+
+  u32 ChunkIndex = 0;
+  for (s32 z = 0; z < VisibleRegion.z; ++z)
+  {
+    for (s32 y = 0; y < VisibleRegion.y; ++y)
+    {
+      for (s32 x = 0; x < VisibleRegion.x; ++x)
+      {
+        world_chunk *Chunk = Chunks + ChunkIndex++;
+        Chunk->WorldP = Min + World_Position(x, y, z);
+
+        TestThat( InsertChunkIntoWorld(&World, Chunk) );
+
+        u32 Probes = LegacyInsert(&Legacy, Chunk);
+        LegacyProbeSum += Probes;
+        LegacyProbeMax = Max(LegacyProbeMax, Probes);
+      }
+    }
+  }
+
+  u64 ProbeSum = 0;
+  u32 ProbeMax = 0;
+  for (u32 SlotIndex = 0; SlotIndex < World.HashSize; ++SlotIndex)
+  {
+    world_chunk *Chunk = World.ChunkHash[SlotIndex];
+    if (Chunk)
+    {
+      u32 Distance = GetWorldChunkProbeDistance(&World, Chunk, SlotIndex);
+      ProbeSum += Distance;
+      ProbeMax = Max(ProbeMax, Distance);
+    }
+  }
+
+  // NOTE(Jesse): Same access pattern as BufferWorld; every position in the
+  // visible region, in z/y/x order.
+  u64 LegacyCycles = 0;
+  u64 Cycles = 0;
+  {
+    u64 Start = __rdtsc();
+    for (s32 z = 0; z < VisibleRegion.z; ++z)
+    {
+      for (s32 y = 0; y < VisibleRegion.y; ++y)
+      {
+        for (s32 x = 0; x < VisibleRegion.x; ++x)
+        {
+          world_position P = Min + World_Position(x, y, z);
+          world_chunk *Chunk = LegacyLookup(&Legacy, P);
+          TestThat(Chunk && Chunk->WorldP == P);
+        }
+      }
+    }
+    LegacyCycles = __rdtsc() - Start;
+  }
+
+  {
+    u64 Start = __rdtsc();
+    for (s32 z = 0; z < VisibleRegion.z; ++z)
+    {
+      for (s32 y = 0; y < VisibleRegion.y; ++y)
+      {
+        for (s32 x = 0; x < VisibleRegion.x; ++x)
+        {
+          world_position P = Min + World_Position(x, y, z);
+          world_chunk *Chunk = GetWorldChunkFromHashtable(&World, P);
+          TestThat(Chunk && Chunk->WorldP == P);
+        }
+      }
+    }
+    Cycles = __rdtsc() - Start;
+  }
+
+  TestThat( GetWorldChunkFromHashtable(&World, Min - World_Position(1)) == 0 );
+
+  DebugLine("VisibleRegion (%d, %d, %d) : %u chunks", VisibleRegion.x, VisibleRegion.y, VisibleRegion.z, ChunkCount);
+  DebugLine("  Legacy     : avg probe (%.2f) max probe (%u) lookup sweep (%.2f) cycles/chunk", r64(LegacyProbeSum)/r64(ChunkCount), LegacyProbeMax, r64(LegacyCycles)/r64(ChunkCount));
+  DebugLine("  Robin Hood : avg probe (%.2f) max probe (%u) lookup sweep (%.2f) cycles/chunk", r64(ProbeSum)/r64(ChunkCount), ProbeMax, r64(Cycles)/r64(ChunkCount));
+
+  // NOTE(Jesse): Slide the visible region along x a chunk at a time, evicting
+  // the trailing slab and inserting the leading one, and make sure nothing
+  // gets lost along the way.
+  for (s32 Step = 0; Step < 4; ++Step)
+  {
+    for (u32 SlotIndex = 0; SlotIndex < World.HashSize; )
+    {
+      world_chunk *Chunk = World.ChunkHash[SlotIndex];
+      if (Chunk && Chunk->WorldP.x == Min.x)
+      {
+        RemoveChunkFromWorld(&World, SlotIndex);
+        Chunk->WorldP.x += VisibleRegion.x;
+        TestThat( InsertChunkIntoWorld(&World, Chunk) );
+      }
+      else
+      {
+        ++SlotIndex;
+      }
+    }
+
+    Min.x += 1;
+
+    for (s32 z = 0; z < VisibleRegion.z; ++z)
+    {
+      for (s32 y = 0; y < VisibleRegion.y; ++y)
+      {
+        for (s32 x = 0; x < VisibleRegion.x; ++x)
+        {
+          world_position P = Min + World_Position(x, y, z);
+          world_chunk *Chunk = GetWorldChunkFromHashtable(&World, P);
+          TestThat(Chunk && Chunk->WorldP == P);
+        }
+      }
+    }
+
+    TestThat( World.ChunkCount == ChunkCount );
+
+    for (u32 ResidentIndex = 0; ResidentIndex < World.ChunkCount; ++ResidentIndex)
+    {
+      TestThat( World.ResidentChunks[ResidentIndex]->ResidentIndex == ResidentIndex );
+    }
+  }
+}
+
+link_internal b32
+ContainsPosition(rect3i Rect, v3i P)
+{
+  b32 Result = P >= Rect.Min && P < Rect.Max;
+  return Result;
+}
+
+// NOTE(Jesse): Every position of A that's not in B must land in exactly one
+// of the slabs, and nothing else may.
+link_internal void
+TestSubtractRect3i(random_series *Entropy)
+{
+  for (u32 Iteration = 0; Iteration < 256; ++Iteration)
+  {
+    v3i AMin = V3i(s32(RandomU32(Entropy) % 8), s32(RandomU32(Entropy) % 8), s32(RandomU32(Entropy) % 8));
+    v3i BMin = V3i(s32(RandomU32(Entropy) % 8), s32(RandomU32(Entropy) % 8), s32(RandomU32(Entropy) % 8));
+    v3i ADim = V3i(s32(RandomU32(Entropy) % 6), s32(RandomU32(Entropy) % 6), s32(RandomU32(Entropy) % 6));
+    v3i BDim = V3i(s32(RandomU32(Entropy) % 6), s32(RandomU32(Entropy) % 6), s32(RandomU32(Entropy) % 6));
+
+    rect3i A = Rect3iMinMax(AMin, AMin + ADim);
+    rect3i B = Rect3iMinMax(BMin, BMin + BDim);
+
+    rect3i Slabs[6];
+    u32 SlabCount = SubtractRect3i(A, B, Slabs);
+    TestThat(SlabCount <= 6);
+
+    for (s32 z = 0; z < 16; ++z)
+    {
+      for (s32 y = 0; y < 16; ++y)
+      {
+        for (s32 x = 0; x < 16; ++x)
+        {
+          v3i P = V3i(x, y, z);
+
+          u32 Hits = 0;
+          for (u32 SlabIndex = 0; SlabIndex < SlabCount; ++SlabIndex)
+          {
+            if (ContainsPosition(Slabs[SlabIndex], P)) { ++Hits; }
+          }
+
+          u32 Expected = (ContainsPosition(A, P) && !ContainsPosition(B, P)) ? 1 : 0;
+          TestThat(Hits == Expected);
+        }
+      }
+    }
+  }
+}
+
+// NOTE(Jesse): Counts how many times Chunk shows up in the pending list and
+// the jobs we dispatched; every chunk has to be in exactly one of them.
+link_internal u32
+CountPendingOrDispatched(world *World, work_queue_entry *Batch, u32 BatchCount, world_chunk *Chunk)
+{
+  u32 Result = 0;
+  for (u32 PendingIndex = 0; PendingIndex < World->PendingInitCount; ++PendingIndex)
+  {
+    Result += World->PendingInits[PendingIndex].Chunk == Chunk;
+  }
+  for (u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+  {
+    Result += SafeAccess(work_queue_entry_init_world_chunk, Batch + BatchIndex)->Chunk == Chunk;
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Sorted by priority, which is already a valid heap
+link_internal void
+PushPendingInits(world *World, world_chunk *Chunks, u32 ChunkCount)
+{
+  World->PendingInitCount = 0;
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks + ChunkIndex;
+    World->PendingInits[World->PendingInitCount++] = { .Chunk = Chunk, .Priority = r32(Chunk->WorldP.x) };
+  }
+}
+
+// NOTE(Jesse): Several chunks in the same frame whose records aren't resident
+// yet; none of them may get lost or dispatched twice.
+link_internal void
+TestPendingInitStalls(memory_arena *Memory)
+{
+  u32 ChunkCount = 32;
+
+  world World = {};
+  World.PendingInits = Allocate(pending_chunk_init, Memory, ChunkCount);
+  World.InFlightInits = Allocate(world_chunk*, Memory, ChunkCount);
+
+  world_pack_file_header Header = { .WPAK = WorldPackFileTag_WPAK, .ChunkCount = ChunkCount };
+
+  world_pack Pack = {};
+  Pack.Base = (u8*)&Header;
+  Pack.Header = &Header;
+  Pack.Directory = Allocate(world_pack_entry, Memory, ChunkCount);
+  Pack.Stream.RecordStates = Allocate(u8, Memory, ChunkCount);
+
+  world_chunk *Chunks = Allocate(world_chunk, Memory, ChunkCount);
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks + ChunkIndex;
+    Chunk->WorldP = World_Position(s32(ChunkIndex), 0, 0);
+    Chunk->Flags = Chunk_Queued;
+
+    Pack.Directory[ChunkIndex].WorldP = Chunk->WorldP;
+
+    // NOTE(Jesse): Every third record is resident, the rest haven't been
+    // asked for yet
+    Pack.Stream.RecordStates[ChunkIndex] = (ChunkIndex % 3 == 0) ? WorldPackRecord_Resident : WorldPackRecord_Cold;
+  }
+
+  work_queue_entry *Batch = Allocate(work_queue_entry, Memory, ChunkCount);
+
+  // NOTE(Jesse): First with room for everything, then with the in-flight
+  // limit stopping us part way through the heap
+  u32 Limits[] = { ChunkCount, 4 };
+  for (u32 LimitIndex = 0; LimitIndex < ArrayCount(Limits); ++LimitIndex)
+  {
+    PushPendingInits(&World, Chunks, ChunkCount);
+    u32 PendingCount = World.PendingInitCount;
+
+    World.InFlightInitCount = 0;
+    u32 BatchCount = PopPendingChunkInits(&World, &Pack, PendingCount, Limits[LimitIndex], Batch);
+
+    TestThat(BatchCount == Min(Limits[LimitIndex], (ChunkCount+2)/3));
+    TestThat(World.PendingInitCount + BatchCount == PendingCount);
+
+    for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+    {
+      TestThat( CountPendingOrDispatched(&World, Batch, BatchCount, Chunks + ChunkIndex) == 1 );
+    }
+
+    for (u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+    {
+      world_chunk *Chunk = SafeAccess(work_queue_entry_init_world_chunk, Batch + BatchIndex)->Chunk;
+      TestThat(Chunk->WorldP.x % 3 == 0);
+    }
+  }
+
+  // NOTE(Jesse): Once the reader has caught up, the rest all go
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    Pack.Stream.RecordStates[ChunkIndex] = WorldPackRecord_Resident;
+  }
+
+  PushPendingInits(&World, Chunks, ChunkCount);
+  World.InFlightInitCount = 0;
+  u32 BatchCount = PopPendingChunkInits(&World, &Pack, World.PendingInitCount, ChunkCount, Batch);
+
+  TestThat(BatchCount == ChunkCount);
+  TestThat(World.PendingInitCount == 0);
+  for (u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+  {
+    world_chunk *Chunk = SafeAccess(work_queue_entry_init_world_chunk, Batch + BatchIndex)->Chunk;
+    TestThat(Chunk->WorldP.x == s32(BatchIndex));
+  }
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("ChunkHashtable", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  BenchmarkChunkHashtables(Memory, Chunk_Dimension(16, 16, 8));
+  BenchmarkChunkHashtables(Memory, Chunk_Dimension(64, 64, 8));
+  BenchmarkChunkHashtables(Memory, Chunk_Dimension(96, 96, 16));
+
+  random_series Entropy = {43};
+  TestSubtractRect3i(&Entropy);
+
+  Global_ThreadStates = Initialize_ThreadLocal_ThreadStates((s32)GetTotalThreadCount(), 0, Memory);
+  SetThreadLocal_ThreadIndex(0);
+
+  TestPendingInitStalls(Memory);
+
+  TestSuiteEnd();
+}
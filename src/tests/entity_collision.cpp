@@ -0,0 +1,140 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+
+link_internal void
+SpawnTestEntity(world *World, entity *Entity, entity_type Type, v3 Radius, random_series *Entropy, v3 ArenaDim)
+{
+  Entity->State = EntityState_Spawned;
+  Entity->Type = Type;
+  Entity->CollisionVolumeRadius = Radius;
+
+  v3 SimP = V3(RandomUnilateral(Entropy), RandomUnilateral(Entropy), RandomUnilateral(Entropy)) * ArenaDim;
+  Entity->P = Canonicalize(World->ChunkDim, SimP, World->Center);
+}
+
+// NOTE(Jesse): What DoEntityCollisions did before there was a broadphase
+link_internal u32
+BruteForceCollisions(world *World, entity **EntityTable, entity *Entity)
+{
+  u32 Result = 0;
+  for (u32 Slot = 0; Slot < TOTAL_ENTITY_COUNT; ++Slot)
+  {
+    entity *TestEntity = EntityTable[Slot];
+    if (TestEntity != Entity && GetCollision(World, Entity, TestEntity))
+    {
+      ++Result;
+    }
+  }
+  return Result;
+}
+
+// NOTE(Jesse): Enemies hang around in a box while projectiles fly through it.
+// Every frame the broadphase is rebuilt, each projectile is moved and
+// refiled, and then asks what it hit; the same thing SimulateEntities does.
+link_internal void
+BenchmarkEntityCollisions(memory_arena *Memory, u32 EnemyCount, u32 ProjectileCount, v3 ArenaDim, u32 FrameCount)
+{
+  Assert(EnemyCount + ProjectileCount + 1 <= TOTAL_ENTITY_COUNT);
+
+  random_series Entropy = {1337};
+
+  world World = {};
+  World.ChunkDim = Chunk_Dimension(32, 32, 32);
+  World.Center = World_Position(0);
+
+  entity *Entities = Allocate(entity, Memory, TOTAL_ENTITY_COUNT);
+  entity **EntityTable = Allocate(entity*, Memory, TOTAL_ENTITY_COUNT);
+  for (u32 Slot = 0; Slot < TOTAL_ENTITY_COUNT; ++Slot)
+  {
+    EntityTable[Slot] = Entities + Slot;
+  }
+
+  v3 *Velocities = Allocate(v3, Memory, TOTAL_ENTITY_COUNT);
+
+  u32 Slot = 0;
+  for (u32 EnemyIndex = 0; EnemyIndex < EnemyCount; ++EnemyIndex)
+  {
+    v3 Radius = V3(1.f) + V3(RandomUnilateral(&Entropy), RandomUnilateral(&Entropy), RandomUnilateral(&Entropy))*2.f;
+    SpawnTestEntity(&World, Entities + Slot++, EntityType_Enemy, Radius, &Entropy, ArenaDim);
+  }
+
+  u32 FirstProjectile = Slot;
+  for (u32 ProjectileIndex = 0; ProjectileIndex < ProjectileCount; ++ProjectileIndex)
+  {
+    Velocities[Slot] = V3(RandomBilateral(&Entropy), RandomBilateral(&Entropy), RandomBilateral(&Entropy))*3.f;
+    SpawnTestEntity(&World, Entities + Slot++, EntityType_PlayerProjectile, V3(0.25f), &Entropy, ArenaDim);
+  }
+
+  // NOTE(Jesse): Too big to file in a cell
+  SpawnTestEntity(&World, Entities + Slot++, EntityType_Static, V3(ENTITY_BROADPHASE_CELL_DIM), &Entropy, ArenaDim);
+
+  entity_broadphase Broadphase = {};
+  InitEntityBroadphase(&Broadphase, Memory);
+
+  u64 TotalPairs = 0;
+  u64 TotalHits = 0;
+  u64 Cycles = 0;
+  u32 Mismatches = 0;
+
+  for (u32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+  {
+    u64 HitsThisFrame = 0;
+
+    u64 Start = __rdtsc();
+    BuildEntityBroadphase(&World, &Broadphase, EntityTable);
+    for (u32 ProjectileSlot = FirstProjectile; ProjectileSlot < FirstProjectile + ProjectileCount; ++ProjectileSlot)
+    {
+      entity *Projectile = EntityTable[ProjectileSlot];
+      Projectile->P.Offset += Velocities[ProjectileSlot];
+      Projectile->P = Canonicalize(World.ChunkDim, Projectile->P);
+      UpdateEntityBroadphase(&World, &Broadphase, ProjectileSlot);
+
+      HitsThisFrame += DoEntityCollisions(&World, &Broadphase, Projectile).Count;
+    }
+    Cycles += __rdtsc() - Start;
+
+    TotalPairs += Broadphase.PairsTested;
+    TotalHits += HitsThisFrame;
+
+    for (u32 ProjectileSlot = FirstProjectile; ProjectileSlot < FirstProjectile + ProjectileCount; ++ProjectileSlot)
+    {
+      entity *Projectile = EntityTable[ProjectileSlot];
+      Mismatches += DoEntityCollisions(&World, &Broadphase, Projectile).Count != BruteForceCollisions(&World, EntityTable, Projectile);
+    }
+
+    // NOTE(Jesse): Projectiles that leave the box come back in the other side
+    for (u32 ProjectileSlot = FirstProjectile; ProjectileSlot < FirstProjectile + ProjectileCount; ++ProjectileSlot)
+    {
+      entity *Projectile = EntityTable[ProjectileSlot];
+      v3 SimP = GetSimSpaceP(&World, Projectile);
+      for (u32 Axis = 0; Axis < 3; ++Axis)
+      {
+        if (SimP.E[Axis] < 0.f)              { SimP.E[Axis] += ArenaDim.E[Axis]; }
+        if (SimP.E[Axis] > ArenaDim.E[Axis]) { SimP.E[Axis] -= ArenaDim.E[Axis]; }
+      }
+      Projectile->P = Canonicalize(World.ChunkDim, SimP, World.Center);
+    }
+  }
+
+  TestThat(Mismatches == 0);
+  TestThat(TotalHits > 0);
+
+  r64 Frames = r64(FrameCount);
+  u64 BruteForcePairs = u64(ProjectileCount)*u64(TOTAL_ENTITY_COUNT-1);
+  DebugLine("%u enemies %u projectiles in (%.0f, %.0f, %.0f), %u frames", EnemyCount, ProjectileCount, r64(ArenaDim.x), r64(ArenaDim.y), r64(ArenaDim.z), FrameCount);
+  DebugLine("  (%.1f) pairs tested/frame, down from (%.0f), (%.1f) hits/frame, (%.0f) cycles/frame",
+            r64(TotalPairs)/Frames, r64(BruteForcePairs), r64(TotalHits)/Frames, r64(Cycles)/Frames);
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("EntityCollision", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  BenchmarkEntityCollisions(Memory, 512,  1024, V3(256, 256, 64), 64);
+  BenchmarkEntityCollisions(Memory, 1024, 1000, V3(128, 128, 32), 64);
+
+  TestSuiteEnd();
+}
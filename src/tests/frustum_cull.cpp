@@ -0,0 +1,116 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+#include <tests/test_utils.h>
+
+// NOTE(Jesse): What IsInFrustum did before it tested the whole AABB; the
+// center of the chunk against the four side planes.
+link_internal b32
+LegacyIsInFrustum(world *World, camera *Camera, world_chunk *Chunk)
+{
+  v3 TestP = GetSimSpaceP(World, Chunk) + V3(World->ChunkDim)/2.f;
+
+  b32 Result = (DistanceToPlane(&Camera->Frust.Top, TestP)   > 0) &&
+               (DistanceToPlane(&Camera->Frust.Bot, TestP)   > 0) &&
+               (DistanceToPlane(&Camera->Frust.Left, TestP)  > 0) &&
+               (DistanceToPlane(&Camera->Frust.Right, TestP) > 0);
+  return Result;
+}
+
+// NOTE(Jesse): Orbits the camera around the world center for FrameCount
+// frames and culls the resident chunks three ways each frame.  The
+// hierarchical pass has to come up with exactly the chunks the flat AABB pass
+// does.
+link_internal void
+BenchmarkFrustumCulling(memory_arena *Memory, chunk_dimension VisibleRegion, u32 FrameCount)
+{
+  world World = {};
+  world_chunk *Chunks = InitTestWorld(&World, Memory, Chunk_Dimension(32, 32, 32), VisibleRegion);
+
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  b32 *FlatVisible = Allocate(b32, Memory, ChunkCount);
+  world_chunk **Visible = Allocate(world_chunk*, Memory, ChunkCount);
+
+  camera Camera = {};
+  Camera.Frust.farClip = 1000.f;
+  Camera.Frust.nearClip = 1.f;
+  Camera.Frust.width = 30.f;
+  Camera.Frust.FOV = 45.f;
+  Camera.DistanceFromTarget = 300.f;
+  Camera.Pitch = PI32*0.6f;
+
+  canonical_position Target = Canonical_Position(V3(0), World.Center);
+  Camera.CurrentP = Target;
+
+  u64 LegacyVisible = 0;
+  u64 FlatVisibleCount = 0;
+  u64 FlatCycles = 0;
+  u64 Cycles = 0;
+
+  chunk_cull_stats Total = {};
+
+  for (u32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+  {
+    Camera.Yaw = (2.f*PI32*r32(FrameIndex))/r32(FrameCount);
+    UpdateCameraP(&World, Target, &Camera);
+
+    {
+      u64 Start = __rdtsc();
+      for (u32 Index = 0; Index < ChunkCount; ++Index)
+      {
+        FlatVisible[Index] = IsInFrustum(&World, &Camera, Chunks + Index);
+        FlatVisibleCount += FlatVisible[Index];
+      }
+      FlatCycles += __rdtsc() - Start;
+    }
+
+    for (u32 Index = 0; Index < ChunkCount; ++Index)
+    {
+      LegacyVisible += LegacyIsInFrustum(&World, &Camera, Chunks + Index);
+    }
+
+    chunk_cull_stats Stats = {};
+    {
+      u64 Start = __rdtsc();
+      GatherChunksInFrustum(&World, &Camera.Frust, World.ResidentRegion, 0, False, Visible, &Stats);
+      Cycles += __rdtsc() - Start;
+    }
+    Stats.ChunksCulled = World.ChunkCount - Stats.ChunksVisible;
+
+    u32 FlatCount = 0;
+    for (u32 Index = 0; Index < ChunkCount; ++Index) { FlatCount += FlatVisible[Index]; }
+
+    TestThat(Stats.ChunksVisible == FlatCount);
+    for (u32 VisibleIndex = 0; VisibleIndex < Stats.ChunksVisible; ++VisibleIndex)
+    {
+      TestThat( FlatVisible[Visible[VisibleIndex] - Chunks] );
+    }
+
+    Total.BlocksTested  += Stats.BlocksTested;
+    Total.BlocksCulled  += Stats.BlocksCulled;
+    Total.ChunksTested  += Stats.ChunksTested;
+    Total.ChunksVisible += Stats.ChunksVisible;
+    Total.ChunksCulled  += Stats.ChunksCulled;
+  }
+
+  r64 Frames = r64(FrameCount);
+  DebugLine("VisibleRegion (%d, %d, %d) : %u chunks, %u frames", VisibleRegion.x, VisibleRegion.y, VisibleRegion.z, ChunkCount, FrameCount);
+  DebugLine("  Center point : (%.1f) visible/frame", r64(LegacyVisible)/Frames);
+  DebugLine("  Flat AABB    : (%u) chunks tested/frame (%.1f) visible/frame (%.0f) cycles/frame", ChunkCount, r64(FlatVisibleCount)/Frames, r64(FlatCycles)/Frames);
+  DebugLine("  Hierarchical : (%.1f) blocks tested (%.1f) culled, (%.1f) chunks tested (%.1f) culled (%.1f) visible/frame (%.0f) cycles/frame",
+            r64(Total.BlocksTested)/Frames, r64(Total.BlocksCulled)/Frames,
+            r64(Total.ChunksTested)/Frames, r64(Total.ChunksCulled)/Frames, r64(Total.ChunksVisible)/Frames,
+            r64(Cycles)/Frames);
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("FrustumCull", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  BenchmarkFrustumCulling(Memory, Chunk_Dimension(32, 32, 8), 64);
+  BenchmarkFrustumCulling(Memory, Chunk_Dimension(64, 64, 16), 64);
+
+  TestSuiteEnd();
+}
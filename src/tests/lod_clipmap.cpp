@@ -0,0 +1,225 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+#include <tests/test_utils.h>
+
+struct reference_chunk
+{
+  world_position P;
+  world_chunk *Chunk;
+};
+
+// NOTE(Jesse): The synthetic chunk chunk init would fill for P
+link_internal world_chunk *
+GetReferenceChunk(memory_arena *Memory, reference_chunk *Cache, u32 *CacheCount, world_position P, lod_clipmap_noise *Params, chunk_dimension WorldChunkDim)
+{
+  for (u32 CacheIndex = 0; CacheIndex < *CacheCount; ++CacheIndex)
+  {
+    if (Cache[CacheIndex].P == P) { return Cache[CacheIndex].Chunk; }
+  }
+
+  chunk_dimension SynChunkDim = WorldChunkDim + Global_ChunkApronDim;
+  world_chunk *Chunk = AllocateWorldChunk(Memory, P, SynChunkDim);
+  Noise_FBM2D(0, Chunk, SynChunkDim, Global_ChunkApronMinDim, GRASS_GREEN, Params->Frequency, Params->Amplitude, Params->zMin, WorldChunkDim, (void*)&Params->Octaves);
+
+  Cache[(*CacheCount)++] = { .P = P, .Chunk = Chunk };
+  return Chunk;
+}
+
+// NOTE(Jesse): Every voxel of a node has to be the world voxel it stands for
+link_internal void
+TestLodNoiseMatchesChunks(memory_arena *Memory, world_position NodeP, s32 Scale)
+{
+  chunk_dimension WorldChunkDim = Chunk_Dimension(32, 32, 32);
+  chunk_dimension SynChunkDim = WorldChunkDim + Global_ChunkApronDim;
+  lod_clipmap_noise Params = { .Frequency = 50, .Amplitude = 15, .zMin = -5, .Octaves = 1 };
+
+  voxel *Voxels = Allocate(voxel, Memory, Volume(SynChunkDim));
+  u32 Sum = Noise_FBM2D_Lod(Voxels, SynChunkDim, NodeP, Scale, &Params, GRASS_GREEN, WorldChunkDim);
+
+  u32 CacheCount = 0;
+  reference_chunk *Cache = Allocate(reference_chunk, Memory, 512);
+
+  u32 Filled = 0;
+  u32 Mismatches = 0;
+  for (s32 z = 0; z < SynChunkDim.z; ++z)
+  {
+    for (s32 y = 0; y < SynChunkDim.y; ++y)
+    {
+      for (s32 x = 0; x < SynChunkDim.x; ++x)
+      {
+        v3i WorldVoxel = NodeP*WorldChunkDim + (V3i(x,y,z) - Global_ChunkApronMinDim)*Scale;
+        world_position ChunkP = V3i( FloorToMultiple(WorldVoxel.x, WorldChunkDim.x)/WorldChunkDim.x,
+                                     FloorToMultiple(WorldVoxel.y, WorldChunkDim.y)/WorldChunkDim.y,
+                                     FloorToMultiple(WorldVoxel.z, WorldChunkDim.z)/WorldChunkDim.z );
+
+        world_chunk *Reference = GetReferenceChunk(Memory, Cache, &CacheCount, ChunkP, &Params, WorldChunkDim);
+        v3i ReferenceP = WorldVoxel - (ChunkP*WorldChunkDim) + Global_ChunkApronMinDim;
+
+        voxel *Expected = Reference->Voxels + GetIndex(ReferenceP, SynChunkDim);
+        voxel *Got = Voxels + GetIndex(Voxel_Position(x,y,z), SynChunkDim);
+
+        Mismatches += (Expected->Flags & Voxel_Filled) != (Got->Flags & Voxel_Filled);
+        Filled += (Got->Flags & Voxel_Filled) ? 1 : 0;
+      }
+    }
+  }
+
+  TestThat(Mismatches == 0);
+  TestThat(Sum == Filled);
+
+  // NOTE(Jesse): Otherwise we didn't test much
+  TestThat(Sum > 0);
+  TestThat(Sum < u32(Volume(SynChunkDim)));
+}
+
+// NOTE(Jesse): Chunks and nodes GatherLodClipmap picks must never cover the
+// same spot.  Every node is built, and every resident chunk initialized.
+link_internal void
+TestLodClipmapGather(memory_arena *Memory, chunk_dimension VisibleRegion, u32 FrameCount)
+{
+  world World = {};
+  World.Memory = Memory;
+  world_chunk *Chunks = InitTestWorld(&World, Memory, Chunk_Dimension(32, 32, 32), VisibleRegion);
+
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    Chunks[ChunkIndex].Flags = Chunk_VoxelsInitialized;
+  }
+
+  EnableLodClipmap(&World, { .Frequency = 50, .Amplitude = 15, .zMin = -5, .Octaves = 1 });
+  lod_clipmap *Clipmap = World.Clipmap;
+
+  u32 NodeCount = LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_XY*LOD_CLIPMAP_DIM_Z;
+  for (s32 LevelIndex = 0; LevelIndex < LOD_CLIPMAP_LEVEL_COUNT; ++LevelIndex)
+  {
+    lod_clipmap_level *Level = Clipmap->Levels + LevelIndex;
+    Level->Region = GetLodClipmapRegion(World.Center, Level->Scale);
+
+    u32 Placed = 0;
+    for (s32 z = Level->Region.Min.z; z < Level->Region.Max.z; z += Level->Scale)
+    {
+      for (s32 y = Level->Region.Min.y; y < Level->Region.Max.y; y += Level->Scale)
+      {
+        for (s32 x = Level->Region.Min.x; x < Level->Region.Max.x; x += Level->Scale)
+        {
+          lod_clipmap_node *Node = GetLodClipmapSlot(Level, World_Position(x,y,z));
+          TestThat(Node->Chunk.Flags == Chunk_Uninitialized);
+
+          Node->Chunk.WorldP = World_Position(x,y,z);
+          Node->Chunk.Flags = Chunk_VoxelsInitialized;
+          Node->Chunk.Meshes.MeshMask = MeshBit_Main;
+          ++Placed;
+        }
+      }
+    }
+    TestThat(Placed == NodeCount);
+
+    // NOTE(Jesse): Level 0 has to cover everything that's resident
+    if (LevelIndex == 0)
+    {
+      TestThat(World.ResidentRegion.Min >= Level->Region.Min);
+      TestThat(Level->Region.Max >= World.ResidentRegion.Max);
+    }
+  }
+
+  lod_clipmap_level *Top = Clipmap->Levels + LOD_CLIPMAP_LEVEL_COUNT-1;
+  v3i CoverageDim = Top->Region.Max - Top->Region.Min;
+  u8 *Coverage = Allocate(u8, Memory, Volume(CoverageDim));
+
+  lod_clipmap_draw_list DrawList = {};
+  DrawList.Chunks = Allocate(world_chunk*, Memory, ChunkCount);
+  DrawList.Nodes = Allocate(lod_clipmap_node*, Memory, NodeCount*LOD_CLIPMAP_LEVEL_COUNT);
+
+  camera Camera = {};
+  Camera.Frust.farClip = 10000.f;
+  Camera.Frust.nearClip = 1.f;
+  Camera.Frust.width = 30.f;
+  Camera.Frust.FOV = 45.f;
+  Camera.DistanceFromTarget = 300.f;
+  Camera.Pitch = PI32*0.6f;
+
+  canonical_position Target = Canonical_Position(V3(0), World.Center);
+
+  r32 ErrorScale = GetLodErrorScale(&Camera, 1080.f);
+
+  u64 TotalChunks = 0;
+  u64 TotalNodes = 0;
+  u64 TotalCovered = 0;
+  u64 Cycles = 0;
+
+  for (u32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+  {
+    Camera.Yaw = (2.f*PI32*r32(FrameIndex))/r32(FrameCount);
+    UpdateCameraP(&World, Target, &Camera);
+    Camera.CurrentP = Camera.TargetP;
+    UpdateCameraP(&World, Target, &Camera);
+
+    v3 EyeP = GetSimSpaceP(&World, Camera.CurrentP);
+
+    DrawList.ChunkCount = 0;
+    DrawList.NodeCount = 0;
+    chunk_cull_stats Stats = {};
+    {
+      u64 Start = __rdtsc();
+      GatherLodClipmap(&World, Clipmap, &Camera.Frust, EyeP, ErrorScale, &DrawList, &Stats);
+      Cycles += __rdtsc() - Start;
+    }
+
+    TestThat(Stats.ChunksVisible > 0);
+    TestThat(Stats.LodNodesVisible > 0);
+
+    ZeroMemory(Coverage, umm(Volume(CoverageDim)));
+
+    u32 Overlaps = 0;
+    u32 Covered = 0;
+    for (u32 DrawIndex = 0; DrawIndex < DrawList.ChunkCount + DrawList.NodeCount; ++DrawIndex)
+    {
+      b32 IsChunk = DrawIndex < DrawList.ChunkCount;
+      world_position P = IsChunk ? DrawList.Chunks[DrawIndex]->WorldP : DrawList.Nodes[DrawIndex - DrawList.ChunkCount]->Chunk.WorldP;
+      s32 Scale = IsChunk ? 1 : DrawList.Nodes[DrawIndex - DrawList.ChunkCount]->Scale;
+
+      for (s32 z = 0; z < Scale; ++z)
+      {
+        for (s32 y = 0; y < Scale; ++y)
+        {
+          for (s32 x = 0; x < Scale; ++x)
+          {
+            v3i CellP = P + V3i(x,y,z) - Top->Region.Min;
+            u8 *Cell = Coverage + GetIndex(CellP, CoverageDim);
+            Overlaps += (*Cell != 0);
+            *Cell = 1;
+            ++Covered;
+          }
+        }
+      }
+    }
+
+    TestThat(Overlaps == 0);
+
+    TotalChunks  += DrawList.ChunkCount;
+    TotalNodes   += DrawList.NodeCount;
+    TotalCovered += Covered;
+  }
+
+  r64 Frames = r64(FrameCount);
+  DebugLine("VisibleRegion (%d, %d, %d) : %u resident chunks, %u nodes a level, %u frames", VisibleRegion.x, VisibleRegion.y, VisibleRegion.z, ChunkCount, NodeCount, FrameCount);
+  DebugLine("  (%.1f) chunks (%.1f) nodes drawn/frame, standing in for (%.1f) chunks, (%.0f) cycles/frame",
+            r64(TotalChunks)/Frames, r64(TotalNodes)/Frames, r64(TotalCovered)/Frames, r64(Cycles)/Frames);
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("LodClipmap", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  TestLodNoiseMatchesChunks(Memory, World_Position(-2, 2, 0), 1);
+  TestLodNoiseMatchesChunks(Memory, World_Position(-2, 2, 0), 2);
+  TestLodNoiseMatchesChunks(Memory, World_Position(4, -8, 0), 4);
+
+  TestLodClipmapGather(Memory, Chunk_Dimension(16, 16, 4), 64);
+
+  TestSuiteEnd();
+}
@@ -0,0 +1,146 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+#include <tests/test_utils.h>
+
+link_internal void
+TestOccluderBox(memory_arena *Memory)
+{
+  occlusion_buffer *Buffer = AllocateOcclusionBuffer(Memory);
+
+  BeginOcclusionBuffer(Buffer, V3(0), V3(1,0,0));
+  TestThat(Buffer->Enabled);
+
+  aabb Wall = AABBMinMax(V3(10, -3, -3), V3(20, 3, 3));
+  TestThat( AddOccluder(Buffer, &Wall) );
+  RasterizeOcclusionBuffer(Buffer, 0, 0);
+
+  aabb Behind = AABBMinMax(V3(40, -1, -1), V3(44, 1, 1));
+  TestThat( IsOccluded(Buffer, &Behind) );
+
+  aabb InFront = AABBMinMax(V3(5, -1, -1), V3(6, 1, 1));
+  TestThat( IsOccluded(Buffer, &InFront) == False );
+
+  aabb PokesOut = AABBMinMax(V3(8, -1, -1), V3(25, 1, 1));
+  TestThat( IsOccluded(Buffer, &PokesOut) == False );
+
+  aabb Wider = AABBMinMax(V3(40, -16, -1), V3(44, 16, 1));
+  TestThat( IsOccluded(Buffer, &Wider) == False );
+
+  aabb BehindEye = AABBMinMax(V3(-44, -1, -1), V3(-40, 1, 1));
+  TestThat( IsOccluded(Buffer, &BehindEye) == False );
+
+  // NOTE(Jesse): Looking straight down is where the camera basis falls over
+  BeginOcclusionBuffer(Buffer, V3(0), V3(0,0,-1));
+  TestThat(Buffer->Enabled);
+
+  aabb Ground = AABBMinMax(V3(-10, -10, -20), V3(10, 10, -10));
+  TestThat( AddOccluder(Buffer, &Ground) );
+  RasterizeOcclusionBuffer(Buffer, 0, 0);
+
+  aabb Below = AABBMinMax(V3(-2, -2, -50), V3(2, 2, -40));
+  TestThat( IsOccluded(Buffer, &Below) );
+}
+
+// NOTE(Jesse): The lower half of the world is solid and the camera orbits
+// above it looking down at the horizon.  Nothing at or above the surface can
+// be occluded; most of what's under it should be.
+link_internal void
+BenchmarkOcclusionCulling(memory_arena *Memory, chunk_dimension VisibleRegion, u32 FrameCount)
+{
+  world World = {};
+  world_chunk *Chunks = InitTestWorld(&World, Memory, Chunk_Dimension(32, 32, 32), VisibleRegion);
+
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  world_chunk **Visible = Allocate(world_chunk*, Memory, ChunkCount);
+
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks + ChunkIndex;
+    Chunk->Flags = Chunk_VoxelsInitialized;
+    Chunk->FilledCount = Chunk->WorldP.z < 0 ? u32(Volume(World.ChunkDim)) : 0;
+  }
+
+  occlusion_buffer *Buffer = AllocateOcclusionBuffer(Memory);
+
+  camera Camera = {};
+  Camera.Frust.farClip = 1000.f;
+  Camera.Frust.nearClip = 1.f;
+  Camera.Frust.width = 30.f;
+  Camera.Frust.FOV = 45.f;
+  Camera.DistanceFromTarget = 300.f;
+  Camera.Pitch = PI32*0.6f;
+
+  canonical_position Target = Canonical_Position(V3(0), World.Center);
+
+  u64 TotalVisible = 0;
+  u64 TotalOccluded = 0;
+  u64 TotalOccluders = 0;
+  u64 TotalTriangles = 0;
+  u64 RasterCycles = 0;
+  u64 TestCycles = 0;
+
+  for (u32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+  {
+    Camera.Yaw = (2.f*PI32*r32(FrameIndex))/r32(FrameCount);
+    UpdateCameraP(&World, Target, &Camera);
+    Camera.CurrentP = Camera.TargetP;
+    UpdateCameraP(&World, Target, &Camera);
+
+    v3 EyeP = GetSimSpaceP(&World, Camera.CurrentP);
+    TestThat(EyeP.z > 0.f);
+
+    chunk_cull_stats Stats = {};
+    GatherChunksInFrustum(&World, &Camera.Frust, World.ResidentRegion, 0, False, Visible, &Stats);
+
+    {
+      u64 Start = __rdtsc();
+      BeginOcclusionBuffer(Buffer, EyeP, Camera.Front);
+      Stats.Occluders = CollectOccluders(Buffer, &World, &Camera.Frust, Visible, Stats.ChunksVisible);
+      RasterizeOcclusionBuffer(Buffer, 0, 0);
+      RasterCycles += __rdtsc() - Start;
+    }
+
+    {
+      u64 Start = __rdtsc();
+      for (u32 VisibleIndex = 0; VisibleIndex < Stats.ChunksVisible; ++VisibleIndex)
+      {
+        world_chunk *Chunk = Visible[VisibleIndex];
+        aabb ChunkAABB = GetSimSpaceAABB(&World, Chunk);
+        if (IsOccluded(Buffer, &ChunkAABB))
+        {
+          ++Stats.ChunksOccluded;
+          TestThat(Chunk->WorldP.z < -1);
+        }
+      }
+      TestCycles += __rdtsc() - Start;
+    }
+
+    TestThat(Stats.ChunksOccluded > 0);
+
+    TotalVisible   += Stats.ChunksVisible;
+    TotalOccluded  += Stats.ChunksOccluded;
+    TotalOccluders += Stats.Occluders;
+    TotalTriangles += Buffer->TriangleCount;
+  }
+
+  r64 Frames = r64(FrameCount);
+  DebugLine("VisibleRegion (%d, %d, %d) : %u chunks, %u frames", VisibleRegion.x, VisibleRegion.y, VisibleRegion.z, ChunkCount, FrameCount);
+  DebugLine("  (%.1f) in frustum, (%.1f) occluded, (%.1f) drawn/frame", r64(TotalVisible)/Frames, r64(TotalOccluded)/Frames, r64(TotalVisible - TotalOccluded)/Frames);
+  DebugLine("  (%.1f) occluders (%.1f) triangles, (%.0f) cycles building, (%.0f) cycles testing/frame",
+            r64(TotalOccluders)/Frames, r64(TotalTriangles)/Frames, r64(RasterCycles)/Frames, r64(TestCycles)/Frames);
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("Occlusion", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  TestOccluderBox(Memory);
+
+  BenchmarkOcclusionCulling(Memory, Chunk_Dimension(32, 32, 8), 64);
+  BenchmarkOcclusionCulling(Memory, Chunk_Dimension(64, 64, 16), 64);
+
+  TestSuiteEnd();
+}
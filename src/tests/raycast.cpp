@@ -0,0 +1,234 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+#include <tests/test_utils.h>
+
+// NOTE(Jesse): Where the ray enters [MinP, MaxP), or f32_MAX if it doesn't
+// before MaxT
+link_internal r32
+RayEntersBox(v3 Origin, v3 Dir, v3 MinP, v3 MaxP, r32 MaxT)
+{
+  r32 tEnter = 0.f;
+  r32 tExit = MaxT;
+  for (u32 Axis = 0; Axis < 3; ++Axis)
+  {
+    if (Dir.E[Axis] == 0.f)
+    {
+      if (Origin.E[Axis] < MinP.E[Axis] || Origin.E[Axis] >= MaxP.E[Axis]) { return f32_MAX; }
+    }
+    else
+    {
+      r32 t0 = (MinP.E[Axis] - Origin.E[Axis])/Dir.E[Axis];
+      r32 t1 = (MaxP.E[Axis] - Origin.E[Axis])/Dir.E[Axis];
+      tEnter = Max(tEnter, Min(t0, t1));
+      tExit  = Min(tExit,  Max(t0, t1));
+    }
+  }
+
+  r32 Result = tEnter < tExit ? tEnter : f32_MAX;
+  return Result;
+}
+
+// NOTE(Jesse): Tests the ray against every filled voxel in the world
+link_internal r32
+ReferenceRaycast(world *World, v3 Origin, v3 Dir, r32 MaxT, v3i *HitVoxel)
+{
+  r32 Result = f32_MAX;
+  for (u32 ChunkIndex = 0; ChunkIndex < World->ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = World->ResidentChunks[ChunkIndex];
+    if (Chunk->FilledCount == 0) { continue; }
+
+    v3i ChunkMin = Chunk->WorldP*World->ChunkDim;
+    if (RayEntersBox(Origin, Dir, V3(ChunkMin), V3(ChunkMin + World->ChunkDim), MaxT) == f32_MAX) { continue; }
+
+    for (s32 VoxelIndex = 0; VoxelIndex < Volume(World->ChunkDim); ++VoxelIndex)
+    {
+      voxel *Voxel = Chunk->Voxels ? Chunk->Voxels + VoxelIndex : &Chunk->UniformVoxel;
+      if ((Voxel->Flags & Voxel_Filled) == 0) { continue; }
+
+      v3i VoxelP = ChunkMin + GetPosition(VoxelIndex, World->ChunkDim);
+      r32 t = RayEntersBox(Origin, Dir, V3(VoxelP), V3(VoxelP + 1), MaxT);
+      if (t < Result)
+      {
+        Result = t;
+        *HitVoxel = VoxelP;
+      }
+    }
+  }
+  return Result;
+}
+
+// NOTE(Jesse): What RayTraceCollision did before; marches each chunk the ray
+// touches by adding one component of Dir at a time, round robin
+link_internal b32
+LegacyRaycast(world *World, v3 Origin, v3 Dir, world_chunk **Chunks, r32 *tChunks, v3i *HitVoxel)
+{
+  u32 ChunkCount = 0;
+  for (u32 ChunkIndex = 0; ChunkIndex < World->ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = World->ResidentChunks[ChunkIndex];
+    v3 ChunkMin = V3(Chunk->WorldP*World->ChunkDim);
+    r32 t = RayEntersBox(Origin, Dir, ChunkMin, ChunkMin + V3(World->ChunkDim), f32_MAX);
+    if (t == f32_MAX) { continue; }
+
+    u32 Insert = ChunkCount++;
+    while (Insert && tChunks[Insert-1] > t)
+    {
+      Chunks[Insert] = Chunks[Insert-1];
+      tChunks[Insert] = tChunks[Insert-1];
+      --Insert;
+    }
+    Chunks[Insert] = Chunk;
+    tChunks[Insert] = t;
+  }
+
+  v3 ChunkDim = V3(World->ChunkDim);
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks[ChunkIndex];
+    if (Chunk->FilledCount == 0) { continue; }
+
+    v3 AtP = Origin + (Dir*tChunks[ChunkIndex]) + (Dir*0.1f) - V3(Chunk->WorldP*World->ChunkDim);
+
+    u32 AxisIndex = 0;
+    while ( AtP.x >= 0 && AtP.x < ChunkDim.x &&
+            AtP.y >= 0 && AtP.y < ChunkDim.y &&
+            AtP.z >= 0 && AtP.z < ChunkDim.z )
+    {
+      if (IsFilledInChunk(Chunk, Voxel_Position(AtP), World->ChunkDim))
+      {
+        *HitVoxel = (Chunk->WorldP*World->ChunkDim) + Voxel_Position(AtP);
+        return True;
+      }
+
+      AtP.E[AxisIndex] += Dir.E[AxisIndex];
+      AxisIndex = (AxisIndex + 1) % 3;
+    }
+  }
+
+  return False;
+}
+
+link_internal void
+TestRaycast(memory_arena *Memory, chunk_dimension VisibleRegion, u32 RayCount)
+{
+  random_series Entropy = {8675309};
+
+  world World = {};
+  world_chunk *Chunks = InitTestWorld(&World, Memory, Chunk_Dimension(16, 16, 16), VisibleRegion, True);
+
+  chunk_dimension Radius = VisibleRegion/2;
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  s32 ChunkVolume = Volume(World.ChunkDim);
+
+  // NOTE(Jesse): Most chunks are empty, a few are uniformly solid, and the
+  // rest are sparsely filled
+  for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+  {
+    world_chunk *Chunk = Chunks + ChunkIndex;
+    Chunk->Flags = Chunk_VoxelsInitialized;
+
+    u32 Kind = RandomU32(&Entropy) % 32;
+    if (Kind == 0)
+    {
+      Chunk->Voxels = 0;
+      Chunk->UniformVoxel.Flags = Voxel_Filled;
+      Chunk->FilledCount = u32(ChunkVolume);
+    }
+    else if (Kind > 21)
+    {
+      for (s32 VoxelIndex = 0; VoxelIndex < ChunkVolume; ++VoxelIndex)
+      {
+        if (RandomU32(&Entropy) % 64 == 0)
+        {
+          Chunk->Voxels[VoxelIndex].Flags = Voxel_Filled;
+          ++Chunk->FilledCount;
+        }
+      }
+    }
+  }
+
+  voxel_raycast *Rays = Allocate(voxel_raycast, Memory, RayCount);
+  picked_voxel *Hits = Allocate(picked_voxel, Memory, RayCount);
+
+  v3 WorldRadius = V3(Radius*World.ChunkDim);
+  for (u32 RayIndex = 0; RayIndex < RayCount; ++RayIndex)
+  {
+    // NOTE(Jesse): Some start outside the world, some go straight down an axis
+    v3 Origin = V3(RandomBilateral(&Entropy), RandomBilateral(&Entropy), RandomBilateral(&Entropy)) * WorldRadius * 1.25f;
+    v3 Dir = V3(RandomBilateral(&Entropy), RandomBilateral(&Entropy), RandomBilateral(&Entropy));
+    if (RayIndex % 8 == 0) { Dir.E[RayIndex % 3] = 0.f; }
+    if (RayIndex % 16 == 0) { Dir = V3(0.f); Dir.E[(RayIndex/16) % 3] = 1.f; }
+
+    Rays[RayIndex].Origin = Canonical_Position(World.ChunkDim, Origin, World_Position(0));
+    Rays[RayIndex].Dir = Normalize(Dir);
+    Rays[RayIndex].MaxT = (RayIndex % 4 == 0) ? 24.f : f32_MAX;
+  }
+
+  u64 Cycles = 0;
+  {
+    u64 Start = __rdtsc();
+    RaycastMany(&World, Rays, Hits, RayCount, 0, 0);
+    Cycles = __rdtsc() - Start;
+  }
+
+  world_chunk **LegacyChunks = Allocate(world_chunk*, Memory, ChunkCount);
+  r32 *LegacytChunks = Allocate(r32, Memory, ChunkCount);
+
+  u32 HitCount = 0;
+  u32 Mismatches = 0;
+  u32 LegacyMismatches = 0;
+  u64 LegacyCycles = 0;
+  for (u32 RayIndex = 0; RayIndex < RayCount; ++RayIndex)
+  {
+    voxel_raycast *Ray = Rays + RayIndex;
+    picked_voxel *Hit = Hits + RayIndex;
+    v3 Origin = V3(Ray->Origin.WorldP*World.ChunkDim) + Ray->Origin.Offset;
+
+    v3i Expected = {};
+    r32 tExpected = ReferenceRaycast(&World, Origin, Ray->Dir, Ray->MaxT, &Expected);
+
+    b32 Matches = (Hit->PickedChunk.tChunk == f32_MAX) == (tExpected == f32_MAX);
+    if (Matches && tExpected != f32_MAX)
+    {
+      ++HitCount;
+
+      v3i Got = (Hit->PickedChunk.Chunk->WorldP*World.ChunkDim) + Voxel_Position(Hit->VoxelRelP);
+
+      // NOTE(Jesse): A ray through an edge or corner can enter several voxels
+      // at once; any of them will do
+      Matches = (Got == Expected) || Abs(Hit->PickedChunk.tChunk - tExpected) < 0.0001f;
+    }
+    Mismatches += !Matches;
+
+    if (Ray->MaxT == f32_MAX)
+    {
+      v3i LegacyHit = {};
+      u64 Start = __rdtsc();
+      b32 LegacyHitSomething = LegacyRaycast(&World, Origin, Ray->Dir, LegacyChunks, LegacytChunks, &LegacyHit);
+      LegacyCycles += __rdtsc() - Start;
+
+      LegacyMismatches += (LegacyHitSomething != (tExpected != f32_MAX)) || (LegacyHitSomething && LegacyHit != Expected);
+    }
+  }
+
+  TestThat(Mismatches == 0);
+  TestThat(HitCount > 0);
+  TestThat(HitCount < RayCount);
+
+  DebugLine("VisibleRegion (%d, %d, %d) : %u chunks, %u rays, (%u) hit", VisibleRegion.x, VisibleRegion.y, VisibleRegion.z, ChunkCount, RayCount, HitCount);
+  DebugLine("  DDA    : (%.0f) cycles/ray", r64(Cycles)/r64(RayCount));
+  DebugLine("  Legacy : (%.0f) cycles/ray, wrong on (%u) of the unbounded rays", r64(LegacyCycles)/r64(RayCount - RayCount/4), LegacyMismatches);
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("Raycast", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Megabytes(256));
+
+  TestRaycast(Memory, Chunk_Dimension(8, 8, 8), 2048);
+
+  TestSuiteEnd();
+}
@@ -0,0 +1,43 @@
+// NOTE(Jesse): Sets World up with every chunk in VisibleRegion resident,
+// centered on the origin.  The chunks come back in the order they went in (z,
+// then y, then x); they're zeroed but for WorldP and Dim, and only get voxels
+// when AllocateVoxels is set.  Fill them in afterwards.
+link_internal world_chunk *
+InitTestWorld(world *World, memory_arena *Memory, chunk_dimension ChunkDim, chunk_dimension VisibleRegion, b32 AllocateVoxels = False)
+{
+  World->ChunkDim = ChunkDim;
+  World->VisibleRegion = VisibleRegion;
+  World->Center = World_Position(0);
+  AllocateWorldChunkHashtable(World, Memory, VisibleRegion);
+
+  chunk_dimension Radius = VisibleRegion/2;
+  World->ResidentRegion = Rect3iMinMax(World->Center - Radius, World->Center + Radius);
+
+  u32 ChunkCount = u32(Volume(VisibleRegion));
+  world_chunk *Chunks = Allocate(world_chunk, Memory, ChunkCount);
+
+  u32 ChunkIndex = 0;
+  for (s32 z = World->ResidentRegion.Min.z; z < World->ResidentRegion.Max.z; ++z)
+  {
+    for (s32 y = World->ResidentRegion.Min.y; y < World->ResidentRegion.Max.y; ++y)
+    {
+      for (s32 x = World->ResidentRegion.Min.x; x < World->ResidentRegion.Max.x; ++x)
+      {
+        world_chunk *Chunk = Chunks + ChunkIndex++;
+        if (AllocateVoxels)
+        {
+          AllocateWorldChunk(Chunk, Memory, World_Position(x, y, z), ChunkDim);
+        }
+        else
+        {
+          Chunk->WorldP = World_Position(x, y, z);
+          Chunk->Dim = ChunkDim;
+        }
+        TestThat( InsertChunkIntoWorld(World, Chunk) );
+      }
+    }
+  }
+  TestThat(ChunkIndex == ChunkCount);
+
+  return Chunks;
+}
@@ -0,0 +1,500 @@
+#include <bonsai_types.h>
+#include <bonsai_stdlib/test/utils.h>
+
+#define BENCH_ENTRIES_PER_PRODUCER (1 << 15)
+#define BENCH_BATCH_SIZE (32)
+#define BENCH_MAX_THREADS_PER_SIDE (8)
+
+// NOTE(Jesse): The queue as it was before the sequence-numbered ring, so we
+// have something to measure against.  Producers serialize on a futex;
+// consumers claim an index and read the slot after they've given it back.
+
+struct legacy_work_queue
+{
+  volatile u32 EnqueueIndex;
+  volatile u32 DequeueIndex;
+  volatile work_queue_entry *Entries;
+  bonsai_futex EnqueueFutex;
+};
+
+link_internal u32
+LegacyNextQueueIndex(u32 Index)
+{
+  u32 Result = (Index + 1) % WORK_QUEUE_SIZE;
+  return Result;
+}
+
+link_internal void
+LegacyPushWorkQueueEntry(legacy_work_queue *Queue, work_queue_entry *Entry)
+{
+  AcquireFutex(&Queue->EnqueueFutex);
+
+  while (LegacyNextQueueIndex(Queue->EnqueueIndex) == Queue->DequeueIndex)
+  {
+    SleepMs(1);
+  }
+
+  volatile work_queue_entry* Dest = Queue->Entries + Queue->EnqueueIndex;
+  Clear(Dest);
+  MemCopy((u8*)Entry, (u8*)Dest, sizeof(work_queue_entry));
+
+  FullBarrier;
+
+  AtomicExchange(&Queue->EnqueueIndex, LegacyNextQueueIndex(Queue->EnqueueIndex));
+
+  FullBarrier;
+
+  ReleaseFutex(&Queue->EnqueueFutex);
+}
+
+link_internal b32
+LegacyDequeueWorkQueueEntry(legacy_work_queue *Queue, work_queue_entry *Result)
+{
+  for (;;)
+  {
+    u32 DequeueIndex = Queue->DequeueIndex;
+    if (DequeueIndex == Queue->EnqueueIndex) { return False; }
+
+    if (AtomicCompareExchange(&Queue->DequeueIndex, LegacyNextQueueIndex(DequeueIndex), DequeueIndex))
+    {
+      MemCopy((u8*)(Queue->Entries + DequeueIndex), (u8*)Result, sizeof(work_queue_entry));
+      return True;
+    }
+  }
+}
+
+enum bench_queue_kind
+{
+  BenchQueue_Legacy,
+  BenchQueue_Ring,
+  BenchQueue_RingBatched,
+};
+
+struct bench_queue_shared
+{
+  bench_queue_kind Kind;
+  legacy_work_queue *Legacy;
+  work_queue *Ring;
+
+  u32 ProducerCount;
+
+  volatile u32 Go;
+  volatile u32 ProducersDone;
+  volatile u32 ConsumersDone;
+
+  // NOTE(Jesse): One per consumer, written when it finishes
+  u64 Consumed[BENCH_MAX_THREADS_PER_SIDE];
+  u64 IdSum[BENCH_MAX_THREADS_PER_SIDE];
+};
+
+struct bench_queue_thread
+{
+  bench_queue_shared *Shared;
+  u32 Index;
+  b32 Producer;
+};
+
+link_internal work_queue_entry
+BenchEntry(u64 Id)
+{
+  work_queue_entry Result = {};
+  Result.Type = type_work_queue_entry_init_world_chunk;
+  Result.work_queue_entry_init_world_chunk.Chunk = (world_chunk*)umm(Id);
+  return Result;
+}
+
+link_internal u64
+BenchEntryId(work_queue_entry *Entry)
+{
+  u64 Result = u64(umm(Entry->work_queue_entry_init_world_chunk.Chunk));
+  return Result;
+}
+
+link_internal THREAD_MAIN_RETURN
+BenchQueueThreadMain(void *Input)
+{
+  bench_queue_thread *Thread = (bench_queue_thread*)Input;
+  bench_queue_shared *Shared = Thread->Shared;
+
+  while (!Shared->Go) { FullBarrier; }
+
+  if (Thread->Producer)
+  {
+    u64 FirstId = u64(Thread->Index)*BENCH_ENTRIES_PER_PRODUCER;
+
+    work_queue_entry Batch[BENCH_BATCH_SIZE];
+    for (u32 At = 0; At < BENCH_ENTRIES_PER_PRODUCER; At += BENCH_BATCH_SIZE)
+    {
+      for (u32 BatchIndex = 0; BatchIndex < BENCH_BATCH_SIZE; ++BatchIndex)
+      {
+        Batch[BatchIndex] = BenchEntry(FirstId + At + BatchIndex);
+      }
+
+      switch (Shared->Kind)
+      {
+        case BenchQueue_Legacy:
+        {
+          for (u32 BatchIndex = 0; BatchIndex < BENCH_BATCH_SIZE; ++BatchIndex)
+          {
+            LegacyPushWorkQueueEntry(Shared->Legacy, Batch + BatchIndex);
+          }
+        } break;
+
+        case BenchQueue_Ring:
+        {
+          for (u32 BatchIndex = 0; BatchIndex < BENCH_BATCH_SIZE; ++BatchIndex)
+          {
+            PushWorkQueueEntry(Shared->Ring, Batch + BatchIndex);
+          }
+        } break;
+
+        case BenchQueue_RingBatched:
+        {
+          PushWorkQueueEntries(Shared->Ring, Batch, BENCH_BATCH_SIZE);
+        } break;
+      }
+    }
+
+    AtomicIncrement(&Shared->ProducersDone);
+  }
+  else
+  {
+    u64 Consumed = 0;
+    u64 IdSum = 0;
+
+    for (;;)
+    {
+      // NOTE(Jesse): Read before we try, so an empty queue after every
+      // producer is done really means we're finished
+      u32 ProducersDone = Shared->ProducersDone;
+
+      work_queue_entry Entry;
+      b32 Got = Shared->Kind == BenchQueue_Legacy ?
+                LegacyDequeueWorkQueueEntry(Shared->Legacy, &Entry) :
+                DequeueWorkQueueEntry(Shared->Ring, &Entry);
+
+      if (Got)
+      {
+        ++Consumed;
+        IdSum += BenchEntryId(&Entry);
+      }
+      else if (ProducersDone == Shared->ProducerCount)
+      {
+        break;
+      }
+    }
+
+    Shared->Consumed[Thread->Index] = Consumed;
+    Shared->IdSum[Thread->Index] = IdSum;
+
+    FullBarrier;
+    AtomicIncrement(&Shared->ConsumersDone);
+  }
+
+  return 0;
+}
+
+link_internal const char *
+BenchQueueName(bench_queue_kind Kind)
+{
+  const char *Result = 0;
+  switch (Kind)
+  {
+    case BenchQueue_Legacy:      { Result = "Legacy (futex)  "; } break;
+    case BenchQueue_Ring:        { Result = "Ring            "; } break;
+    case BenchQueue_RingBatched: { Result = "Ring (batch 32) "; } break;
+  }
+  return Result;
+}
+
+link_internal void
+BenchmarkWorkQueue(bench_queue_kind Kind, legacy_work_queue *Legacy, work_queue *Ring, u32 ThreadsPerSide)
+{
+  bench_queue_shared Shared = {};
+  Shared.Kind = Kind;
+  Shared.Legacy = Legacy;
+  Shared.Ring = Ring;
+  Shared.ProducerCount = ThreadsPerSide;
+
+  bench_queue_thread Threads[BENCH_MAX_THREADS_PER_SIDE*2];
+  for (u32 ThreadIndex = 0; ThreadIndex < ThreadsPerSide*2; ++ThreadIndex)
+  {
+    bench_queue_thread *Thread = Threads + ThreadIndex;
+    Thread->Shared = &Shared;
+    Thread->Index = ThreadIndex % ThreadsPerSide;
+    Thread->Producer = ThreadIndex < ThreadsPerSide;
+
+    PlatformCreateThread( BenchQueueThreadMain, Thread, s32(ThreadIndex+1) );
+  }
+
+  u64 Start = __rdtsc();
+  Shared.Go = True;
+
+  while (Shared.ConsumersDone < ThreadsPerSide) { FullBarrier; }
+  u64 Cycles = __rdtsc() - Start;
+
+  u64 EntryCount = u64(ThreadsPerSide)*BENCH_ENTRIES_PER_PRODUCER;
+
+  u64 Consumed = 0;
+  u64 IdSum = 0;
+  for (u32 ConsumerIndex = 0; ConsumerIndex < ThreadsPerSide; ++ConsumerIndex)
+  {
+    Consumed += Shared.Consumed[ConsumerIndex];
+    IdSum += Shared.IdSum[ConsumerIndex];
+  }
+
+  // NOTE(Jesse): Ids are 0 .. EntryCount-1
+  u64 ExpectedIdSum = (EntryCount*(EntryCount-1))/2;
+  b32 Correct = Consumed == EntryCount && IdSum == ExpectedIdSum;
+
+  // NOTE(Jesse): The legacy queue reads a slot after handing it back, so it
+  // can lose entries when the ring wraps.  Only hold the new one to it.
+  if (Kind != BenchQueue_Legacy)
+  {
+    TestThat(Correct);
+  }
+
+  DebugLine("  %s : producers (%u) consumers (%u) : (%.1f) cycles/entry %s",
+            BenchQueueName(Kind), ThreadsPerSide, ThreadsPerSide,
+            r64(Cycles)/r64(EntryCount), Correct ? "" : "(LOST OR DUPLICATED ENTRIES)");
+}
+
+// NOTE(Jesse): Single threaded; everything comes out in the order it went in,
+// across a few laps of the ring, pushed one at a time and in batches
+link_internal void
+TestWorkQueueOrdering(work_queue *Queue)
+{
+  u32 BatchSize = 100;
+  work_queue_entry *Batch = Allocate(work_queue_entry, GetTranArena(), BatchSize);
+
+  u64 NextPushId = 0;
+  u64 NextPopId = 0;
+  for (u32 BatchNumber = 0; NextPushId < WORK_QUEUE_SIZE*3; ++BatchNumber)
+  {
+    for (u32 BatchIndex = 0; BatchIndex < BatchSize; ++BatchIndex)
+    {
+      Batch[BatchIndex] = BenchEntry(NextPushId++);
+    }
+
+    if (BatchNumber % 2)
+    {
+      PushWorkQueueEntries(Queue, Batch, BatchSize);
+    }
+    else
+    {
+      for (u32 BatchIndex = 0; BatchIndex < BatchSize; ++BatchIndex)
+      {
+        PushWorkQueueEntry(Queue, Batch + BatchIndex);
+      }
+    }
+
+    work_queue_entry Entry;
+    while (DequeueWorkQueueEntry(Queue, &Entry))
+    {
+      TestThat(BenchEntryId(&Entry) == NextPopId);
+      ++NextPopId;
+    }
+  }
+
+  TestThat(NextPopId == NextPushId);
+  TestThat(QueueIsEmpty(Queue));
+}
+
+// NOTE(Jesse): Single threaded; the owner gets jobs back newest first and a
+// thief gets them oldest first, and a full deque refuses the push
+link_internal void
+TestWorkStealingDeque(memory_arena *Memory)
+{
+  work_stealing_deque Deque = {};
+  InitWorkStealingDeque(&Deque, Memory);
+
+  for (u32 Lap = 0; Lap < 3; ++Lap)
+  {
+    for (u64 Id = 0; Id < WORK_STEALING_DEQUE_SIZE; ++Id)
+    {
+      work_queue_entry Entry = BenchEntry(Id);
+      TestThat(PushWorkStealingDeque(&Deque, &Entry));
+    }
+
+    work_queue_entry Overflow = BenchEntry(0);
+    TestThat(PushWorkStealingDeque(&Deque, &Overflow) == False);
+
+    work_queue_entry Entry;
+    TestThat(StealWorkStealingDeque(&Deque, &Entry));
+    TestThat(BenchEntryId(&Entry) == 0);
+
+    for (u64 Id = WORK_STEALING_DEQUE_SIZE-1; Id > 0; --Id)
+    {
+      TestThat(PopWorkStealingDeque(&Deque, &Entry));
+      TestThat(BenchEntryId(&Entry) == Id);
+    }
+
+    TestThat(PopWorkStealingDeque(&Deque, &Entry) == False);
+    TestThat(StealWorkStealingDeque(&Deque, &Entry) == False);
+    TestThat(WorkStealingDequeIsEmpty(&Deque));
+  }
+}
+
+global_variable u64 Global_JobsRun[8];
+global_variable u32 Global_JobsRunCount;
+
+link_internal void
+RecordJobCallback(volatile work_queue_entry *Entry, thread_local_state *Thread)
+{
+  Global_JobsRun[Global_JobsRunCount++] = BenchEntryId((work_queue_entry*)Entry);
+}
+
+// NOTE(Jesse): Single threaded; a continuation isn't pushed until both the
+// jobs it waits on have run, and chaining onto a finished counter pushes
+// right away
+link_internal void
+TestWorkCounters(work_queue *Queue)
+{
+  thread_local_state *Thread = GetThreadLocalState(0);
+
+  work_counter First = {};
+  work_counter Second = {};
+  InitWorkCounter(&First, 2);
+  InitWorkCounter(&Second, 1);
+
+  work_job Jobs[3] = {};
+  for (u32 JobIndex = 0; JobIndex < 3; ++JobIndex)
+  {
+    Jobs[JobIndex].Entry = BenchEntry(JobIndex);
+    Jobs[JobIndex].Queue = Queue;
+  }
+  Jobs[0].Signal = &First;
+  Jobs[1].Signal = &First;
+  Jobs[2].Signal = &Second;
+
+  PushWorkJobAfter(&First, Jobs + 2);
+  PushWorkJob(Jobs + 0);
+
+  work_queue_entry Entry;
+  TestThat(DequeueWorkQueueEntry(Queue, &Entry));
+  RunWorkQueueEntry(&Entry, Thread, RecordJobCallback);
+
+  TestThat(WorkCounterIsDone(&First) == False);
+  TestThat(QueueIsEmpty(Queue));
+
+  PushWorkJob(Jobs + 1);
+  TestThat(DequeueWorkQueueEntry(Queue, &Entry));
+  RunWorkQueueEntry(&Entry, Thread, RecordJobCallback);
+
+  TestThat(WorkCounterIsDone(&First));
+  TestThat(WorkCounterIsDone(&Second) == False);
+
+  WaitForWorkCounter(&Second, Queue, Thread, RecordJobCallback);
+  TestThat(WorkCounterIsDone(&Second));
+
+  TestThat(Global_JobsRunCount == 3);
+  TestThat(Global_JobsRun[0] == 0);
+  TestThat(Global_JobsRun[1] == 1);
+  TestThat(Global_JobsRun[2] == 2);
+
+  work_job Late = {};
+  Late.Entry = BenchEntry(3);
+  Late.Queue = Queue;
+  PushWorkJobAfter(&First, &Late);
+  TestThat(DequeueWorkQueueEntry(Queue, &Entry));
+  RunWorkQueueEntry(&Entry, Thread, RecordJobCallback);
+  TestThat(Global_JobsRun[3] == 3);
+
+  TestThat(QueueIsEmpty(Queue));
+}
+
+global_variable work_job *Global_YieldingJob;
+global_variable work_counter *Global_YieldingJobWaitsOn;
+
+link_internal void
+YieldingJobCallback(volatile work_queue_entry *Entry, thread_local_state *Thread)
+{
+  if (Global_YieldingJob && Entry == &Global_YieldingJob->Entry && Global_YieldingJob->ResumePoint == 0)
+  {
+    YieldWorkJob(Global_YieldingJob, Global_YieldingJobWaitsOn, 1);
+  }
+  else
+  {
+    RecordJobCallback(Entry, Thread);
+  }
+}
+
+// NOTE(Jesse): Single threaded; a job that yields on a counter doesn't signal
+// its own counter, and runs again from its resume point once the counter fires
+link_internal void
+TestYieldingJobs(work_queue *Queue)
+{
+  thread_local_state *Thread = GetThreadLocalState(0);
+  Global_JobsRunCount = 0;
+
+  work_counter Child = {};
+  work_counter Parent = {};
+  InitWorkCounter(&Child, 1);
+  InitWorkCounter(&Parent, 1);
+
+  work_job ParentJob = {};
+  ParentJob.Entry = BenchEntry(10);
+  ParentJob.Queue = Queue;
+  ParentJob.Signal = &Parent;
+
+  work_job ChildJob = {};
+  ChildJob.Entry = BenchEntry(11);
+  ChildJob.Queue = Queue;
+  ChildJob.Signal = &Child;
+
+  Global_YieldingJob = &ParentJob;
+  Global_YieldingJobWaitsOn = &Child;
+
+  PushWorkJob(&ParentJob);
+
+  work_queue_entry Entry;
+  TestThat(DequeueWorkQueueEntry(Queue, &Entry));
+  RunWorkQueueEntry(&Entry, Thread, YieldingJobCallback);
+
+  TestThat(Global_JobsRunCount == 0);
+  TestThat(WorkCounterIsDone(&Parent) == False);
+  TestThat(QueueIsEmpty(Queue));
+
+  PushWorkJob(&ChildJob);
+  WaitForWorkCounter(&Parent, Queue, Thread, YieldingJobCallback);
+
+  TestThat(ParentJob.ResumePoint == 1);
+  TestThat(Global_JobsRunCount == 2);
+  TestThat(Global_JobsRun[0] == 11);
+  TestThat(Global_JobsRun[1] == 10);
+  TestThat(QueueIsEmpty(Queue));
+
+  Global_YieldingJob = 0;
+}
+
+s32
+main(s32 ArgCount, const char** Args)
+{
+  TestSuiteBegin("WorkQueue", ArgCount, Args);
+
+  memory_arena *Memory = AllocateArena(Gigabytes(1));
+
+  Global_ThreadStates = Initialize_ThreadLocal_ThreadStates((s32)GetTotalThreadCount(), 0, Memory);
+  SetThreadLocal_ThreadIndex(0);
+
+  work_queue Ring = {};
+  InitQueue(&Ring, Memory);
+
+  TestWorkQueueOrdering(&Ring);
+  TestWorkStealingDeque(Memory);
+  TestWorkCounters(&Ring);
+  TestYieldingJobs(&Ring);
+
+  legacy_work_queue Legacy = {};
+  Legacy.Entries = Allocate(work_queue_entry, Memory, WORK_QUEUE_SIZE);
+
+  u32 MaxThreadsPerSide = Max(1u, Min(u32(BENCH_MAX_THREADS_PER_SIDE), PlatformGetLogicalCoreCount()/2));
+  for (u32 ThreadsPerSide = 1; ThreadsPerSide <= MaxThreadsPerSide; ThreadsPerSide *= 2)
+  {
+    BenchmarkWorkQueue(BenchQueue_Legacy,      &Legacy, &Ring, ThreadsPerSide);
+    BenchmarkWorkQueue(BenchQueue_Ring,        &Legacy, &Ring, ThreadsPerSide);
+    BenchmarkWorkQueue(BenchQueue_RingBatched, &Legacy, &Ring, ThreadsPerSide);
+  }
+
+  TestSuiteEnd();
+}
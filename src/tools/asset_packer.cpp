@@ -18,7 +18,7 @@ s32 main(s32 ArgCount, const char **Args)
 
   if (ArgCount < 3)
   {
-    Error("Please supply a path to the model to pack, followed by the path to output to.");
+    Error("Please supply a path to the model to pack, followed by the path of the world pack to write.");
   }
 
   world_position Origin = {};
@@ -156,7 +156,19 @@ s32 main(s32 ArgCount, const char **Args)
     /*   AtomicReplaceMesh( &Chunk->Meshes, MeshBit_Main, Mesh, __rdtsc() ); */
     /* } */
     Chunk->WorldP += Origin;
-    SerializeChunk(Chunk, OutputPath);
+  }
+
+  world_chunk **ChunkPointers = Allocate(world_chunk*, Memory, TotalChunkCount);
+  for (s32 ChunkIndex = 0; ChunkIndex < TotalChunkCount; ++ChunkIndex)
+  {
+    ChunkPointers[ChunkIndex] = Chunks + ChunkIndex;
+  }
+
+  // NOTE(Jesse): These chunks never get a mesh; chunk init merges their
+  // voxels into the world and meshes the result.
+  if (!SerializeWorldPack(OutputPath, ChunkPointers, u32(TotalChunkCount), 0))
+  {
+    Error("Writing world pack (%S)", OutputPath);
   }
 
 }